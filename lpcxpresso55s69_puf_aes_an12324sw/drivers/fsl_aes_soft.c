@@ -0,0 +1,1101 @@
+/*
+ * Copyright 2026 asvin.io
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <string.h>
+#include "fsl_aes_soft.h"
+
+#if AES_SOFT_HAS_AESNI
+#include <wmmintrin.h>
+#endif
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+
+/*! Number of blocks encrypted together by the multi-block modes (CBC decryption, CTR). */
+#define AES_SOFT_PAR_BLOCKS 8
+
+#define AES_SOFT_ROR(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+#define AES_SOFT_GET32(p) \
+    (((uint32_t)(p)[0] << 24) | ((uint32_t)(p)[1] << 16) | ((uint32_t)(p)[2] << 8) | (uint32_t)(p)[3])
+#define AES_SOFT_PUT32(p, v)           \
+    do                                 \
+    {                                  \
+        (p)[0] = (uint8_t)((v) >> 24); \
+        (p)[1] = (uint8_t)((v) >> 16); \
+        (p)[2] = (uint8_t)((v) >> 8);  \
+        (p)[3] = (uint8_t)(v);         \
+    } while (0)
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+
+static const uint8_t s_aesSbox[256] = {
+    0x63, 0x7c, 0x77, 0x7b, 0xf2, 0x6b, 0x6f, 0xc5, 0x30, 0x01, 0x67, 0x2b, 0xfe, 0xd7, 0xab, 0x76, 0xca, 0x82, 0xc9,
+    0x7d, 0xfa, 0x59, 0x47, 0xf0, 0xad, 0xd4, 0xa2, 0xaf, 0x9c, 0xa4, 0x72, 0xc0, 0xb7, 0xfd, 0x93, 0x26, 0x36, 0x3f,
+    0xf7, 0xcc, 0x34, 0xa5, 0xe5, 0xf1, 0x71, 0xd8, 0x31, 0x15, 0x04, 0xc7, 0x23, 0xc3, 0x18, 0x96, 0x05, 0x9a, 0x07,
+    0x12, 0x80, 0xe2, 0xeb, 0x27, 0xb2, 0x75, 0x09, 0x83, 0x2c, 0x1a, 0x1b, 0x6e, 0x5a, 0xa0, 0x52, 0x3b, 0xd6, 0xb3,
+    0x29, 0xe3, 0x2f, 0x84, 0x53, 0xd1, 0x00, 0xed, 0x20, 0xfc, 0xb1, 0x5b, 0x6a, 0xcb, 0xbe, 0x39, 0x4a, 0x4c, 0x58,
+    0xcf, 0xd0, 0xef, 0xaa, 0xfb, 0x43, 0x4d, 0x33, 0x85, 0x45, 0xf9, 0x02, 0x7f, 0x50, 0x3c, 0x9f, 0xa8, 0x51, 0xa3,
+    0x40, 0x8f, 0x92, 0x9d, 0x38, 0xf5, 0xbc, 0xb6, 0xda, 0x21, 0x10, 0xff, 0xf3, 0xd2, 0xcd, 0x0c, 0x13, 0xec, 0x5f,
+    0x97, 0x44, 0x17, 0xc4, 0xa7, 0x7e, 0x3d, 0x64, 0x5d, 0x19, 0x73, 0x60, 0x81, 0x4f, 0xdc, 0x22, 0x2a, 0x90, 0x88,
+    0x46, 0xee, 0xb8, 0x14, 0xde, 0x5e, 0x0b, 0xdb, 0xe0, 0x32, 0x3a, 0x0a, 0x49, 0x06, 0x24, 0x5c, 0xc2, 0xd3, 0xac,
+    0x62, 0x91, 0x95, 0xe4, 0x79, 0xe7, 0xc8, 0x37, 0x6d, 0x8d, 0xd5, 0x4e, 0xa9, 0x6c, 0x56, 0xf4, 0xea, 0x65, 0x7a,
+    0xae, 0x08, 0xba, 0x78, 0x25, 0x2e, 0x1c, 0xa6, 0xb4, 0xc6, 0xe8, 0xdd, 0x74, 0x1f, 0x4b, 0xbd, 0x8b, 0x8a, 0x70,
+    0x3e, 0xb5, 0x66, 0x48, 0x03, 0xf6, 0x0e, 0x61, 0x35, 0x57, 0xb9, 0x86, 0xc1, 0x1d, 0x9e, 0xe1, 0xf8, 0x98, 0x11,
+    0x69, 0xd9, 0x8e, 0x94, 0x9b, 0x1e, 0x87, 0xe9, 0xce, 0x55, 0x28, 0xdf, 0x8c, 0xa1, 0x89, 0x0d, 0xbf, 0xe6, 0x42,
+    0x68, 0x41, 0x99, 0x2d, 0x0f, 0xb0, 0x54, 0xbb, 0x16,
+};
+
+/*! T-tables, generated on first use of kAES_SOFT_Table. Te1..Te3 and Td1..Td3 are rotations of Te0 and Td0. */
+static uint8_t s_aesInvSbox[256];
+static uint32_t s_aesTe0[256];
+static uint32_t s_aesTd0[256];
+static bool s_aesTablesReady;
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+
+static uint32_t aes_soft_xtime(uint32_t x)
+{
+    return ((x << 1) ^ ((x >> 7) * 0x1bu)) & 0xffu;
+}
+
+static uint32_t aes_soft_mul(uint32_t x, uint32_t y)
+{
+    uint32_t r = 0;
+
+    while (y)
+    {
+        if (y & 1u)
+        {
+            r ^= x;
+        }
+        x = aes_soft_xtime(x);
+        y >>= 1;
+    }
+
+    return r;
+}
+
+/*!
+ * @brief Generates inverse S-box, Te0 and Td0.
+ */
+static void aes_soft_gen_tables(void)
+{
+    uint32_t s, i;
+
+    if (s_aesTablesReady)
+    {
+        return;
+    }
+
+    for (i = 0; i < 256u; i++)
+    {
+        s_aesInvSbox[s_aesSbox[i]] = (uint8_t)i;
+    }
+
+    for (i = 0; i < 256u; i++)
+    {
+        s = s_aesSbox[i];
+        s_aesTe0[i] = (aes_soft_mul(s, 2) << 24) | (s << 16) | (s << 8) | aes_soft_mul(s, 3);
+        s = s_aesInvSbox[i];
+        s_aesTd0[i] = (aes_soft_mul(s, 14) << 24) | (aes_soft_mul(s, 9) << 16) | (aes_soft_mul(s, 13) << 8) |
+                      aes_soft_mul(s, 11);
+    }
+
+    s_aesTablesReady = true;
+}
+
+/*******************************************************************************
+ * Bitsliced implementation
+ *
+ * Two blocks are processed in eight 32-bit words, word b holds bit b of all 32 bytes. Byte of row r and
+ * column c of block k is at bit 8 * r + 2 * c + k, so that a row is one byte lane of the word: ShiftRows rotates
+ * within byte lanes and MixColumns rotates whole words by multiples of 8 bits.
+ ******************************************************************************/
+
+static void aes_soft_bs_pack(uint32_t q[8], const uint8_t *b0, const uint8_t *b1)
+{
+    memset(q, 0, 8 * sizeof(uint32_t));
+
+    for (uint32_t k = 0; k < 2u; k++)
+    {
+        const uint8_t *b = k ? b1 : b0;
+
+        for (uint32_t i = 0; i < AES_SOFT_BLOCK_SIZE; i++)
+        {
+            uint32_t pos = 8u * (i & 3u) + 2u * (i >> 2) + k;
+
+            for (uint32_t bit = 0; bit < 8u; bit++)
+            {
+                q[bit] |= (((uint32_t)b[i] >> bit) & 1u) << pos;
+            }
+        }
+    }
+}
+
+static void aes_soft_bs_unpack(const uint32_t q[8], uint8_t *b0, uint8_t *b1)
+{
+    for (uint32_t k = 0; k < 2u; k++)
+    {
+        uint8_t *b = k ? b1 : b0;
+
+        for (uint32_t i = 0; i < AES_SOFT_BLOCK_SIZE; i++)
+        {
+            uint32_t pos = 8u * (i & 3u) + 2u * (i >> 2) + k;
+            uint32_t v = 0;
+
+            for (uint32_t bit = 0; bit < 8u; bit++)
+            {
+                v |= ((q[bit] >> pos) & 1u) << bit;
+            }
+            b[i] = (uint8_t)v;
+        }
+    }
+}
+
+/*!
+ * @brief S-box of all 32 bytes, Boyar-Peralta circuit.
+ */
+static void aes_soft_bs_sbox(uint32_t q[8])
+{
+    uint32_t x0, x1, x2, x3, x4, x5, x6, x7;
+    uint32_t y1, y2, y3, y4, y5, y6, y7, y8, y9, y10, y11, y12, y13, y14, y15, y16, y17, y18, y19, y20, y21;
+    uint32_t z0, z1, z2, z3, z4, z5, z6, z7, z8, z9, z10, z11, z12, z13, z14, z15, z16, z17;
+    uint32_t t0, t1, t2, t3, t4, t5, t6, t7, t8, t9, t10, t11, t12, t13, t14, t15, t16, t17, t18, t19, t20, t21, t22,
+        t23, t24, t25, t26, t27, t28, t29, t30, t31, t32, t33, t34, t35, t36, t37, t38, t39, t40, t41, t42, t43, t44,
+        t45, t46, t47, t48, t49, t50, t51, t52, t53, t54, t55, t56, t57, t58, t59, t60, t61, t62, t63, t64, t65, t66,
+        t67;
+    uint32_t s0, s1, s2, s3, s4, s5, s6, s7;
+
+    x0 = q[7];
+    x1 = q[6];
+    x2 = q[5];
+    x3 = q[4];
+    x4 = q[3];
+    x5 = q[2];
+    x6 = q[1];
+    x7 = q[0];
+
+    /* top linear transformation */
+    y14 = x3 ^ x5;
+    y13 = x0 ^ x6;
+    y9 = x0 ^ x3;
+    y8 = x0 ^ x5;
+    t0 = x1 ^ x2;
+    y1 = t0 ^ x7;
+    y4 = y1 ^ x3;
+    y12 = y13 ^ y14;
+    y2 = y1 ^ x0;
+    y5 = y1 ^ x6;
+    y3 = y5 ^ y8;
+    t1 = x4 ^ y12;
+    y15 = t1 ^ x5;
+    y20 = t1 ^ x1;
+    y6 = y15 ^ x7;
+    y10 = y15 ^ t0;
+    y11 = y20 ^ y9;
+    y7 = x7 ^ y11;
+    y17 = y10 ^ y11;
+    y19 = y10 ^ y8;
+    y16 = t0 ^ y11;
+    y21 = y13 ^ y16;
+    y18 = x0 ^ y16;
+
+    /* non-linear section */
+    t2 = y12 & y15;
+    t3 = y3 & y6;
+    t4 = t3 ^ t2;
+    t5 = y4 & x7;
+    t6 = t5 ^ t2;
+    t7 = y13 & y16;
+    t8 = y5 & y1;
+    t9 = t8 ^ t7;
+    t10 = y2 & y7;
+    t11 = t10 ^ t7;
+    t12 = y9 & y11;
+    t13 = y14 & y17;
+    t14 = t13 ^ t12;
+    t15 = y8 & y10;
+    t16 = t15 ^ t12;
+    t17 = t4 ^ t14;
+    t18 = t6 ^ t16;
+    t19 = t9 ^ t14;
+    t20 = t11 ^ t16;
+    t21 = t17 ^ y20;
+    t22 = t18 ^ y19;
+    t23 = t19 ^ y21;
+    t24 = t20 ^ y18;
+
+    t25 = t21 ^ t22;
+    t26 = t21 & t23;
+    t27 = t24 ^ t26;
+    t28 = t25 & t27;
+    t29 = t28 ^ t22;
+    t30 = t23 ^ t24;
+    t31 = t22 ^ t26;
+    t32 = t31 & t30;
+    t33 = t32 ^ t24;
+    t34 = t23 ^ t33;
+    t35 = t27 ^ t33;
+    t36 = t24 & t35;
+    t37 = t36 ^ t34;
+    t38 = t27 ^ t36;
+    t39 = t29 & t38;
+    t40 = t25 ^ t39;
+
+    t41 = t40 ^ t37;
+    t42 = t29 ^ t33;
+    t43 = t29 ^ t40;
+    t44 = t33 ^ t37;
+    t45 = t42 ^ t41;
+    z0 = t44 & y15;
+    z1 = t37 & y6;
+    z2 = t33 & x7;
+    z3 = t43 & y16;
+    z4 = t40 & y1;
+    z5 = t29 & y7;
+    z6 = t42 & y11;
+    z7 = t45 & y17;
+    z8 = t41 & y10;
+    z9 = t44 & y12;
+    z10 = t37 & y3;
+    z11 = t33 & y4;
+    z12 = t43 & y13;
+    z13 = t40 & y5;
+    z14 = t29 & y2;
+    z15 = t42 & y9;
+    z16 = t45 & y14;
+    z17 = t41 & y8;
+
+    /* bottom linear transformation */
+    t46 = z15 ^ z16;
+    t47 = z10 ^ z11;
+    t48 = z5 ^ z13;
+    t49 = z9 ^ z10;
+    t50 = z2 ^ z12;
+    t51 = z2 ^ z5;
+    t52 = z7 ^ z8;
+    t53 = z0 ^ z3;
+    t54 = z6 ^ z7;
+    t55 = z16 ^ z17;
+    t56 = z12 ^ t48;
+    t57 = t50 ^ t53;
+    t58 = z4 ^ t46;
+    t59 = z3 ^ t54;
+    t60 = t46 ^ t57;
+    t61 = z14 ^ t57;
+    t62 = t52 ^ t58;
+    t63 = t49 ^ t58;
+    t64 = z4 ^ t59;
+    t65 = t61 ^ t62;
+    t66 = z1 ^ t63;
+    s0 = t59 ^ t63;
+    s6 = t56 ^ ~t62;
+    s7 = t48 ^ ~t60;
+    t67 = t64 ^ t65;
+    s3 = t53 ^ t66;
+    s4 = t51 ^ t66;
+    s5 = t47 ^ t65;
+    s1 = t64 ^ ~s3;
+    s2 = t55 ^ ~t67;
+
+    q[7] = s0;
+    q[6] = s1;
+    q[5] = s2;
+    q[4] = s3;
+    q[3] = s4;
+    q[2] = s5;
+    q[1] = s6;
+    q[0] = s7;
+}
+
+/*!
+ * @brief Inverse of the S-box affine transformation, including its constant.
+ */
+static void aes_soft_bs_inv_affine(uint32_t q[8])
+{
+    uint32_t y[8];
+
+    for (uint32_t i = 0; i < 8u; i++)
+    {
+        y[i] = q[(i + 2u) & 7u] ^ q[(i + 5u) & 7u] ^ q[(i + 7u) & 7u];
+    }
+    y[0] = ~y[0];
+    y[2] = ~y[2];
+    memcpy(q, y, sizeof(y));
+}
+
+/*!
+ * @brief Inverse S-box, the forward S-box surrounded by the inverse affine transformation.
+ */
+static void aes_soft_bs_inv_sbox(uint32_t q[8])
+{
+    aes_soft_bs_inv_affine(q);
+    aes_soft_bs_sbox(q);
+    aes_soft_bs_inv_affine(q);
+}
+
+static void aes_soft_bs_shift_rows(uint32_t q[8])
+{
+    for (uint32_t i = 0; i < 8u; i++)
+    {
+        uint32_t x = q[i];
+
+        q[i] = (x & 0x000000ffu) | ((x >> 2) & 0x00003f00u) | ((x << 6) & 0x0000c000u) | ((x >> 4) & 0x000f0000u) |
+               ((x << 4) & 0x00f00000u) | ((x >> 6) & 0x03000000u) | ((x << 2) & 0xfc000000u);
+    }
+}
+
+static void aes_soft_bs_inv_shift_rows(uint32_t q[8])
+{
+    for (uint32_t i = 0; i < 8u; i++)
+    {
+        uint32_t x = q[i];
+
+        q[i] = (x & 0x000000ffu) | ((x << 2) & 0x0000fc00u) | ((x >> 6) & 0x00000300u) | ((x >> 4) & 0x000f0000u) |
+               ((x << 4) & 0x00f00000u) | ((x << 6) & 0xc0000000u) | ((x >> 2) & 0x3f000000u);
+    }
+}
+
+/*!
+ * @brief Multiplies all bytes by x in GF(2^8).
+ */
+static void aes_soft_bs_xtime(uint32_t q[8])
+{
+    uint32_t hi = q[7];
+
+    q[7] = q[6];
+    q[6] = q[5];
+    q[5] = q[4];
+    q[4] = q[3] ^ hi;
+    q[3] = q[2] ^ hi;
+    q[2] = q[1];
+    q[1] = q[0] ^ hi;
+    q[0] = hi;
+}
+
+static void aes_soft_bs_mix_columns(uint32_t q[8])
+{
+    uint32_t b[8];
+    uint32_t rest[8];
+
+    /* 2 * a0 ^ 3 * a1 ^ a2 ^ a3 = 2 * (a0 ^ a1) ^ a1 ^ a2 ^ a3, rotating by 8 bits selects the next row */
+    for (uint32_t i = 0; i < 8u; i++)
+    {
+        uint32_t a1 = AES_SOFT_ROR(q[i], 8);
+
+        b[i] = q[i] ^ a1;
+        rest[i] = a1 ^ AES_SOFT_ROR(q[i], 16) ^ AES_SOFT_ROR(q[i], 24);
+    }
+    aes_soft_bs_xtime(b);
+    for (uint32_t i = 0; i < 8u; i++)
+    {
+        q[i] = b[i] ^ rest[i];
+    }
+}
+
+static void aes_soft_bs_inv_mix_columns(uint32_t q[8])
+{
+    uint32_t t[8];
+
+    /* InvMixColumns = MixColumns * (5, 0, 4, 0): a0 ^= 4 * (a0 ^ a2) for each row */
+    for (uint32_t i = 0; i < 8u; i++)
+    {
+        t[i] = q[i] ^ AES_SOFT_ROR(q[i], 16);
+    }
+    aes_soft_bs_xtime(t);
+    aes_soft_bs_xtime(t);
+    for (uint32_t i = 0; i < 8u; i++)
+    {
+        q[i] ^= t[i];
+    }
+    aes_soft_bs_mix_columns(q);
+}
+
+static void aes_soft_bs_add_key(uint32_t q[8], const uint32_t sk[8])
+{
+    for (uint32_t i = 0; i < 8u; i++)
+    {
+        q[i] ^= sk[i];
+    }
+}
+
+static void aes_soft_bs_encrypt(const aes_soft_ctx_t *ctx, uint32_t q[8])
+{
+    aes_soft_bs_add_key(q, ctx->impl_keys.sliced[0]);
+    for (uint32_t r = 1; r < ctx->rounds; r++)
+    {
+        aes_soft_bs_sbox(q);
+        aes_soft_bs_shift_rows(q);
+        aes_soft_bs_mix_columns(q);
+        aes_soft_bs_add_key(q, ctx->impl_keys.sliced[r]);
+    }
+    aes_soft_bs_sbox(q);
+    aes_soft_bs_shift_rows(q);
+    aes_soft_bs_add_key(q, ctx->impl_keys.sliced[ctx->rounds]);
+}
+
+static void aes_soft_bs_decrypt(const aes_soft_ctx_t *ctx, uint32_t q[8])
+{
+    aes_soft_bs_add_key(q, ctx->impl_keys.sliced[ctx->rounds]);
+    for (uint32_t r = ctx->rounds - 1u; r > 0u; r--)
+    {
+        aes_soft_bs_inv_shift_rows(q);
+        aes_soft_bs_inv_sbox(q);
+        aes_soft_bs_add_key(q, ctx->impl_keys.sliced[r]);
+        aes_soft_bs_inv_mix_columns(q);
+    }
+    aes_soft_bs_inv_shift_rows(q);
+    aes_soft_bs_inv_sbox(q);
+    aes_soft_bs_add_key(q, ctx->impl_keys.sliced[0]);
+}
+
+/*!
+ * @brief S-box of the four bytes of a word in constant time, used by the key schedule of all implementations.
+ */
+static uint32_t aes_soft_sub_word(uint32_t w)
+{
+    uint8_t b[AES_SOFT_BLOCK_SIZE] = {0};
+    uint32_t q[8];
+
+    AES_SOFT_PUT32(b, w);
+    aes_soft_bs_pack(q, b, b);
+    aes_soft_bs_sbox(q);
+    aes_soft_bs_unpack(q, b, b);
+
+    return AES_SOFT_GET32(b);
+}
+
+/*******************************************************************************
+ * T-table implementation
+ ******************************************************************************/
+
+static void aes_soft_table_encrypt(const aes_soft_ctx_t *ctx, const uint8_t *in, uint8_t *out)
+{
+    const uint32_t *rk = ctx->rk;
+    uint32_t s0, s1, s2, s3, t0, t1, t2, t3;
+
+    s0 = AES_SOFT_GET32(in) ^ rk[0];
+    s1 = AES_SOFT_GET32(in + 4) ^ rk[1];
+    s2 = AES_SOFT_GET32(in + 8) ^ rk[2];
+    s3 = AES_SOFT_GET32(in + 12) ^ rk[3];
+
+    for (uint32_t r = 1; r < ctx->rounds; r++)
+    {
+        rk += 4;
+        t0 = s_aesTe0[s0 >> 24] ^ AES_SOFT_ROR(s_aesTe0[(s1 >> 16) & 0xffu], 8) ^
+             AES_SOFT_ROR(s_aesTe0[(s2 >> 8) & 0xffu], 16) ^ AES_SOFT_ROR(s_aesTe0[s3 & 0xffu], 24) ^ rk[0];
+        t1 = s_aesTe0[s1 >> 24] ^ AES_SOFT_ROR(s_aesTe0[(s2 >> 16) & 0xffu], 8) ^
+             AES_SOFT_ROR(s_aesTe0[(s3 >> 8) & 0xffu], 16) ^ AES_SOFT_ROR(s_aesTe0[s0 & 0xffu], 24) ^ rk[1];
+        t2 = s_aesTe0[s2 >> 24] ^ AES_SOFT_ROR(s_aesTe0[(s3 >> 16) & 0xffu], 8) ^
+             AES_SOFT_ROR(s_aesTe0[(s0 >> 8) & 0xffu], 16) ^ AES_SOFT_ROR(s_aesTe0[s1 & 0xffu], 24) ^ rk[2];
+        t3 = s_aesTe0[s3 >> 24] ^ AES_SOFT_ROR(s_aesTe0[(s0 >> 16) & 0xffu], 8) ^
+             AES_SOFT_ROR(s_aesTe0[(s1 >> 8) & 0xffu], 16) ^ AES_SOFT_ROR(s_aesTe0[s2 & 0xffu], 24) ^ rk[3];
+        s0 = t0;
+        s1 = t1;
+        s2 = t2;
+        s3 = t3;
+    }
+
+    rk += 4;
+    t0 = ((uint32_t)s_aesSbox[s0 >> 24] << 24) ^ ((uint32_t)s_aesSbox[(s1 >> 16) & 0xffu] << 16) ^
+         ((uint32_t)s_aesSbox[(s2 >> 8) & 0xffu] << 8) ^ (uint32_t)s_aesSbox[s3 & 0xffu] ^ rk[0];
+    t1 = ((uint32_t)s_aesSbox[s1 >> 24] << 24) ^ ((uint32_t)s_aesSbox[(s2 >> 16) & 0xffu] << 16) ^
+         ((uint32_t)s_aesSbox[(s3 >> 8) & 0xffu] << 8) ^ (uint32_t)s_aesSbox[s0 & 0xffu] ^ rk[1];
+    t2 = ((uint32_t)s_aesSbox[s2 >> 24] << 24) ^ ((uint32_t)s_aesSbox[(s3 >> 16) & 0xffu] << 16) ^
+         ((uint32_t)s_aesSbox[(s0 >> 8) & 0xffu] << 8) ^ (uint32_t)s_aesSbox[s1 & 0xffu] ^ rk[2];
+    t3 = ((uint32_t)s_aesSbox[s3 >> 24] << 24) ^ ((uint32_t)s_aesSbox[(s0 >> 16) & 0xffu] << 16) ^
+         ((uint32_t)s_aesSbox[(s1 >> 8) & 0xffu] << 8) ^ (uint32_t)s_aesSbox[s2 & 0xffu] ^ rk[3];
+
+    AES_SOFT_PUT32(out, t0);
+    AES_SOFT_PUT32(out + 4, t1);
+    AES_SOFT_PUT32(out + 8, t2);
+    AES_SOFT_PUT32(out + 12, t3);
+}
+
+static void aes_soft_table_decrypt(const aes_soft_ctx_t *ctx, const uint8_t *in, uint8_t *out)
+{
+    const uint32_t *rk = ctx->impl_keys.drk;
+    uint32_t s0, s1, s2, s3, t0, t1, t2, t3;
+
+    s0 = AES_SOFT_GET32(in) ^ rk[0];
+    s1 = AES_SOFT_GET32(in + 4) ^ rk[1];
+    s2 = AES_SOFT_GET32(in + 8) ^ rk[2];
+    s3 = AES_SOFT_GET32(in + 12) ^ rk[3];
+
+    for (uint32_t r = 1; r < ctx->rounds; r++)
+    {
+        rk += 4;
+        t0 = s_aesTd0[s0 >> 24] ^ AES_SOFT_ROR(s_aesTd0[(s3 >> 16) & 0xffu], 8) ^
+             AES_SOFT_ROR(s_aesTd0[(s2 >> 8) & 0xffu], 16) ^ AES_SOFT_ROR(s_aesTd0[s1 & 0xffu], 24) ^ rk[0];
+        t1 = s_aesTd0[s1 >> 24] ^ AES_SOFT_ROR(s_aesTd0[(s0 >> 16) & 0xffu], 8) ^
+             AES_SOFT_ROR(s_aesTd0[(s3 >> 8) & 0xffu], 16) ^ AES_SOFT_ROR(s_aesTd0[s2 & 0xffu], 24) ^ rk[1];
+        t2 = s_aesTd0[s2 >> 24] ^ AES_SOFT_ROR(s_aesTd0[(s1 >> 16) & 0xffu], 8) ^
+             AES_SOFT_ROR(s_aesTd0[(s0 >> 8) & 0xffu], 16) ^ AES_SOFT_ROR(s_aesTd0[s3 & 0xffu], 24) ^ rk[2];
+        t3 = s_aesTd0[s3 >> 24] ^ AES_SOFT_ROR(s_aesTd0[(s2 >> 16) & 0xffu], 8) ^
+             AES_SOFT_ROR(s_aesTd0[(s1 >> 8) & 0xffu], 16) ^ AES_SOFT_ROR(s_aesTd0[s0 & 0xffu], 24) ^ rk[3];
+        s0 = t0;
+        s1 = t1;
+        s2 = t2;
+        s3 = t3;
+    }
+
+    rk += 4;
+    t0 = ((uint32_t)s_aesInvSbox[s0 >> 24] << 24) ^ ((uint32_t)s_aesInvSbox[(s3 >> 16) & 0xffu] << 16) ^
+         ((uint32_t)s_aesInvSbox[(s2 >> 8) & 0xffu] << 8) ^ (uint32_t)s_aesInvSbox[s1 & 0xffu] ^ rk[0];
+    t1 = ((uint32_t)s_aesInvSbox[s1 >> 24] << 24) ^ ((uint32_t)s_aesInvSbox[(s0 >> 16) & 0xffu] << 16) ^
+         ((uint32_t)s_aesInvSbox[(s3 >> 8) & 0xffu] << 8) ^ (uint32_t)s_aesInvSbox[s2 & 0xffu] ^ rk[1];
+    t2 = ((uint32_t)s_aesInvSbox[s2 >> 24] << 24) ^ ((uint32_t)s_aesInvSbox[(s1 >> 16) & 0xffu] << 16) ^
+         ((uint32_t)s_aesInvSbox[(s0 >> 8) & 0xffu] << 8) ^ (uint32_t)s_aesInvSbox[s3 & 0xffu] ^ rk[2];
+    t3 = ((uint32_t)s_aesInvSbox[s3 >> 24] << 24) ^ ((uint32_t)s_aesInvSbox[(s2 >> 16) & 0xffu] << 16) ^
+         ((uint32_t)s_aesInvSbox[(s1 >> 8) & 0xffu] << 8) ^ (uint32_t)s_aesInvSbox[s0 & 0xffu] ^ rk[3];
+
+    AES_SOFT_PUT32(out, t0);
+    AES_SOFT_PUT32(out + 4, t1);
+    AES_SOFT_PUT32(out + 8, t2);
+    AES_SOFT_PUT32(out + 12, t3);
+}
+
+/*******************************************************************************
+ * AES-NI implementation
+ ******************************************************************************/
+#if AES_SOFT_HAS_AESNI
+
+static bool aes_soft_has_aesni(void)
+{
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("aes") != 0;
+}
+
+__attribute__((target("aes,sse2"))) static void aes_soft_ni_keys(aes_soft_ctx_t *ctx)
+{
+    uint8_t *ek = ctx->impl_keys.ni[0];
+    uint8_t *dk = ctx->impl_keys.ni[1];
+    uint32_t n = ctx->rounds;
+
+    for (uint32_t i = 0; i < 4u * (n + 1u); i++)
+    {
+        AES_SOFT_PUT32(ek + 4u * i, ctx->rk[i]);
+    }
+
+    /* equivalent inverse cipher: reversed keys, InvMixColumns applied to the inner ones */
+    memcpy(dk, ek + 16u * n, 16);
+    for (uint32_t r = 1; r < n; r++)
+    {
+        _mm_storeu_si128((__m128i *)(dk + 16u * r),
+                         _mm_aesimc_si128(_mm_loadu_si128((const __m128i *)(ek + 16u * (n - r)))));
+    }
+    memcpy(dk + 16u * n, ek, 16);
+}
+
+__attribute__((target("aes,sse2"))) static void aes_soft_ni_blocks(
+    const aes_soft_ctx_t *ctx, bool decrypt, const uint8_t *in, uint8_t *out, size_t blocks)
+{
+    const uint8_t *k = ctx->impl_keys.ni[decrypt ? 1 : 0];
+    uint32_t n = ctx->rounds;
+    __m128i b0, b1, b2, b3, rk;
+
+    /* four independent blocks hide the latency of AESENC/AESDEC */
+    for (; blocks >= 4u; blocks -= 4u)
+    {
+        rk = _mm_loadu_si128((const __m128i *)k);
+        b0 = _mm_xor_si128(_mm_loadu_si128((const __m128i *)in), rk);
+        b1 = _mm_xor_si128(_mm_loadu_si128((const __m128i *)(in + 16)), rk);
+        b2 = _mm_xor_si128(_mm_loadu_si128((const __m128i *)(in + 32)), rk);
+        b3 = _mm_xor_si128(_mm_loadu_si128((const __m128i *)(in + 48)), rk);
+        for (uint32_t r = 1; r < n; r++)
+        {
+            rk = _mm_loadu_si128((const __m128i *)(k + 16u * r));
+            if (decrypt)
+            {
+                b0 = _mm_aesdec_si128(b0, rk);
+                b1 = _mm_aesdec_si128(b1, rk);
+                b2 = _mm_aesdec_si128(b2, rk);
+                b3 = _mm_aesdec_si128(b3, rk);
+            }
+            else
+            {
+                b0 = _mm_aesenc_si128(b0, rk);
+                b1 = _mm_aesenc_si128(b1, rk);
+                b2 = _mm_aesenc_si128(b2, rk);
+                b3 = _mm_aesenc_si128(b3, rk);
+            }
+        }
+        rk = _mm_loadu_si128((const __m128i *)(k + 16u * n));
+        if (decrypt)
+        {
+            b0 = _mm_aesdeclast_si128(b0, rk);
+            b1 = _mm_aesdeclast_si128(b1, rk);
+            b2 = _mm_aesdeclast_si128(b2, rk);
+            b3 = _mm_aesdeclast_si128(b3, rk);
+        }
+        else
+        {
+            b0 = _mm_aesenclast_si128(b0, rk);
+            b1 = _mm_aesenclast_si128(b1, rk);
+            b2 = _mm_aesenclast_si128(b2, rk);
+            b3 = _mm_aesenclast_si128(b3, rk);
+        }
+        _mm_storeu_si128((__m128i *)out, b0);
+        _mm_storeu_si128((__m128i *)(out + 16), b1);
+        _mm_storeu_si128((__m128i *)(out + 32), b2);
+        _mm_storeu_si128((__m128i *)(out + 48), b3);
+        in += 64;
+        out += 64;
+    }
+
+    for (; blocks; blocks--)
+    {
+        b0 = _mm_xor_si128(_mm_loadu_si128((const __m128i *)in), _mm_loadu_si128((const __m128i *)k));
+        for (uint32_t r = 1; r < n; r++)
+        {
+            rk = _mm_loadu_si128((const __m128i *)(k + 16u * r));
+            b0 = decrypt ? _mm_aesdec_si128(b0, rk) : _mm_aesenc_si128(b0, rk);
+        }
+        rk = _mm_loadu_si128((const __m128i *)(k + 16u * n));
+        b0 = decrypt ? _mm_aesdeclast_si128(b0, rk) : _mm_aesenclast_si128(b0, rk);
+        _mm_storeu_si128((__m128i *)out, b0);
+        in += 16;
+        out += 16;
+    }
+}
+
+/*!
+ * @brief Encrypts or decrypts full CTR blocks, counter blocks are built in registers.
+ */
+__attribute__((target("aes,sse2"))) static void aes_soft_ni_ctr(
+    const aes_soft_ctx_t *ctx, uint8_t *counter, const uint8_t *in, uint8_t *out, size_t blocks)
+{
+    const uint8_t *k = ctx->impl_keys.ni[0];
+    uint32_t n = ctx->rounds;
+    uint64_t hi = ((uint64_t)AES_SOFT_GET32(counter) << 32) | AES_SOFT_GET32(counter + 4);
+    uint64_t lo = ((uint64_t)AES_SOFT_GET32(counter + 8) << 32) | AES_SOFT_GET32(counter + 12);
+    __m128i b[4], rk;
+    size_t m;
+
+    while (blocks)
+    {
+        m = (blocks < 4u) ? blocks : 4u;
+        rk = _mm_loadu_si128((const __m128i *)k);
+        for (size_t i = 0; i < 4u; i++)
+        {
+            b[i] = _mm_xor_si128(
+                _mm_set_epi64x((long long)__builtin_bswap64(lo), (long long)__builtin_bswap64(hi)), rk);
+            if (i < m)
+            {
+                lo++;
+                hi += (lo == 0u);
+            }
+        }
+        for (uint32_t r = 1; r < n; r++)
+        {
+            rk = _mm_loadu_si128((const __m128i *)(k + 16u * r));
+            b[0] = _mm_aesenc_si128(b[0], rk);
+            b[1] = _mm_aesenc_si128(b[1], rk);
+            b[2] = _mm_aesenc_si128(b[2], rk);
+            b[3] = _mm_aesenc_si128(b[3], rk);
+        }
+        rk = _mm_loadu_si128((const __m128i *)(k + 16u * n));
+        for (size_t i = 0; i < m; i++)
+        {
+            b[i] = _mm_aesenclast_si128(b[i], rk);
+            _mm_storeu_si128((__m128i *)(out + 16u * i),
+                             _mm_xor_si128(b[i], _mm_loadu_si128((const __m128i *)(in + 16u * i))));
+        }
+        in += 16u * m;
+        out += 16u * m;
+        blocks -= m;
+    }
+
+    AES_SOFT_PUT32(counter, (uint32_t)(hi >> 32));
+    AES_SOFT_PUT32(counter + 4, (uint32_t)hi);
+    AES_SOFT_PUT32(counter + 8, (uint32_t)(lo >> 32));
+    AES_SOFT_PUT32(counter + 12, (uint32_t)lo);
+}
+
+#endif /* AES_SOFT_HAS_AESNI */
+
+/*******************************************************************************
+ * Common
+ ******************************************************************************/
+
+/*!
+ * @brief Encrypts or decrypts independent blocks with the context implementation.
+ *
+ * Input and output can be the same buffer.
+ */
+static void aes_soft_blocks(const aes_soft_ctx_t *ctx, bool decrypt, const uint8_t *in, uint8_t *out, size_t blocks)
+{
+    switch (ctx->impl)
+    {
+#if AES_SOFT_HAS_AESNI
+        case kAES_SOFT_AesNi:
+            aes_soft_ni_blocks(ctx, decrypt, in, out, blocks);
+            break;
+#endif
+        case kAES_SOFT_Bitsliced:
+        {
+            uint32_t q[8];
+            uint8_t last[AES_SOFT_BLOCK_SIZE];
+
+            while (blocks)
+            {
+                /* odd last block is processed together with a copy of itself */
+                bool pair = (blocks >= 2u);
+                const uint8_t *in1 = pair ? in + AES_SOFT_BLOCK_SIZE : in;
+                uint8_t *out1 = pair ? out + AES_SOFT_BLOCK_SIZE : last;
+
+                aes_soft_bs_pack(q, in, in1);
+                if (decrypt)
+                {
+                    aes_soft_bs_decrypt(ctx, q);
+                }
+                else
+                {
+                    aes_soft_bs_encrypt(ctx, q);
+                }
+                aes_soft_bs_unpack(q, out, out1);
+                if (!pair)
+                {
+                    break;
+                }
+                in += 2u * AES_SOFT_BLOCK_SIZE;
+                out += 2u * AES_SOFT_BLOCK_SIZE;
+                blocks -= 2u;
+            }
+            memset(q, 0, sizeof(q));
+            memset(last, 0, sizeof(last));
+            break;
+        }
+        default:
+            for (; blocks; blocks--)
+            {
+                if (decrypt)
+                {
+                    aes_soft_table_decrypt(ctx, in, out);
+                }
+                else
+                {
+                    aes_soft_table_encrypt(ctx, in, out);
+                }
+                in += AES_SOFT_BLOCK_SIZE;
+                out += AES_SOFT_BLOCK_SIZE;
+            }
+            break;
+    }
+}
+
+static void aes_soft_ctr_increment(uint8_t *counter)
+{
+    uint32_t carry = 1;
+
+    /* constant time, no early exit on the first byte without carry */
+    for (int i = AES_SOFT_BLOCK_SIZE - 1; i >= 0; i--)
+    {
+        carry += counter[i];
+        counter[i] = (uint8_t)carry;
+        carry >>= 8;
+    }
+}
+
+/*!
+ * brief Expands an AES key for the selected implementation.
+ *
+ * param[out] ctx Software AES context.
+ * param key AES key.
+ * param keySize AES key size in bytes. Shall equal 16, 24 or 32.
+ * param impl Implementation, kAES_SOFT_Auto selects AES_SOFT_DEFAULT_IMPL.
+ * return true on success, false if keySize or impl is invalid.
+ */
+bool AES_SOFT_SetKey(aes_soft_ctx_t *ctx, const uint8_t *key, size_t keySize, aes_soft_impl_t impl)
+{
+    uint32_t nk = (uint32_t)keySize / 4u;
+    uint32_t words;
+    uint32_t rcon = 1;
+    uint32_t t;
+
+    if ((keySize != 16u) && (keySize != 24u) && (keySize != 32u))
+    {
+        return false;
+    }
+
+    if (impl == kAES_SOFT_Auto)
+    {
+        impl = AES_SOFT_DEFAULT_IMPL;
+    }
+    if (impl == kAES_SOFT_Auto)
+    {
+        impl = kAES_SOFT_AesNi;
+    }
+    if (impl > kAES_SOFT_AesNi)
+    {
+        return false;
+    }
+#if AES_SOFT_HAS_AESNI
+    if ((impl == kAES_SOFT_AesNi) && !aes_soft_has_aesni())
+    {
+        impl = kAES_SOFT_Table;
+    }
+#else
+    if (impl == kAES_SOFT_AesNi)
+    {
+        impl = kAES_SOFT_Table;
+    }
+#endif
+
+    memset(ctx, 0, sizeof(*ctx));
+    ctx->impl = impl;
+    ctx->rounds = nk + 6u;
+    words = 4u * (ctx->rounds + 1u);
+
+    /* key schedule uses the bitsliced S-box, so no key dependent table lookups */
+    for (uint32_t i = 0; i < nk; i++)
+    {
+        ctx->rk[i] = AES_SOFT_GET32(key + 4u * i);
+    }
+    for (uint32_t i = nk; i < words; i++)
+    {
+        t = ctx->rk[i - 1u];
+        if ((i % nk) == 0u)
+        {
+            t = aes_soft_sub_word(AES_SOFT_ROR(t, 24)) ^ (rcon << 24);
+            rcon = aes_soft_xtime(rcon);
+        }
+        else if ((nk > 6u) && ((i % nk) == 4u))
+        {
+            t = aes_soft_sub_word(t);
+        }
+        ctx->rk[i] = ctx->rk[i - nk] ^ t;
+    }
+
+    switch (impl)
+    {
+#if AES_SOFT_HAS_AESNI
+        case kAES_SOFT_AesNi:
+            aes_soft_ni_keys(ctx);
+            break;
+#endif
+        case kAES_SOFT_Bitsliced:
+            for (uint32_t r = 0; r <= ctx->rounds; r++)
+            {
+                uint8_t b[AES_SOFT_BLOCK_SIZE];
+
+                for (uint32_t j = 0; j < 4u; j++)
+                {
+                    AES_SOFT_PUT32(b + 4u * j, ctx->rk[4u * r + j]);
+                }
+                aes_soft_bs_pack(ctx->impl_keys.sliced[r], b, b);
+                memset(b, 0, sizeof(b));
+            }
+            break;
+        default:
+            aes_soft_gen_tables();
+            /* equivalent inverse cipher: reversed keys, InvMixColumns applied to the inner ones */
+            for (uint32_t r = 0; r <= ctx->rounds; r++)
+            {
+                for (uint32_t j = 0; j < 4u; j++)
+                {
+                    t = ctx->rk[4u * (ctx->rounds - r) + j];
+                    if ((r != 0u) && (r != ctx->rounds))
+                    {
+                        t = s_aesTd0[s_aesSbox[t >> 24]] ^ AES_SOFT_ROR(s_aesTd0[s_aesSbox[(t >> 16) & 0xffu]], 8) ^
+                            AES_SOFT_ROR(s_aesTd0[s_aesSbox[(t >> 8) & 0xffu]], 16) ^
+                            AES_SOFT_ROR(s_aesTd0[s_aesSbox[t & 0xffu]], 24);
+                    }
+                    ctx->impl_keys.drk[4u * r + j] = t;
+                }
+            }
+            break;
+    }
+
+    return true;
+}
+
+/*!
+ * brief Encrypts AES on one or multiple 128-bit block(s).
+ *
+ * param ctx Software AES context.
+ * param plaintext Input plain text.
+ * param[out] ciphertext Output cipher text. Can be the same as plaintext.
+ * param size Size of input and output data in bytes. Must be multiple of 16 bytes.
+ */
+void AES_SOFT_EncryptEcb(const aes_soft_ctx_t *ctx, const uint8_t *plaintext, uint8_t *ciphertext, size_t size)
+{
+    aes_soft_blocks(ctx, false, plaintext, ciphertext, size / AES_SOFT_BLOCK_SIZE);
+}
+
+/*!
+ * brief Decrypts AES on one or multiple 128-bit block(s).
+ *
+ * param ctx Software AES context.
+ * param ciphertext Input cipher text.
+ * param[out] plaintext Output plain text. Can be the same as ciphertext.
+ * param size Size of input and output data in bytes. Must be multiple of 16 bytes.
+ */
+void AES_SOFT_DecryptEcb(const aes_soft_ctx_t *ctx, const uint8_t *ciphertext, uint8_t *plaintext, size_t size)
+{
+    aes_soft_blocks(ctx, true, ciphertext, plaintext, size / AES_SOFT_BLOCK_SIZE);
+}
+
+/*!
+ * brief Encrypts AES using CBC block mode.
+ *
+ * param ctx Software AES context.
+ * param plaintext Input plain text.
+ * param[out] ciphertext Output cipher text. Can be the same as plaintext.
+ * param size Size of input and output data in bytes. Must be multiple of 16 bytes.
+ * param iv Input initial vector.
+ */
+void AES_SOFT_EncryptCbc(const aes_soft_ctx_t *ctx,
+                         const uint8_t *plaintext,
+                         uint8_t *ciphertext,
+                         size_t size,
+                         const uint8_t iv[AES_SOFT_BLOCK_SIZE])
+{
+    uint8_t chain[AES_SOFT_BLOCK_SIZE];
+
+    memcpy(chain, iv, AES_SOFT_BLOCK_SIZE);
+
+    /* CBC encryption is serial, one block at a time */
+    for (; size >= AES_SOFT_BLOCK_SIZE; size -= AES_SOFT_BLOCK_SIZE)
+    {
+        for (uint32_t i = 0; i < AES_SOFT_BLOCK_SIZE; i++)
+        {
+            chain[i] ^= plaintext[i];
+        }
+        aes_soft_blocks(ctx, false, chain, chain, 1);
+        memcpy(ciphertext, chain, AES_SOFT_BLOCK_SIZE);
+        plaintext += AES_SOFT_BLOCK_SIZE;
+        ciphertext += AES_SOFT_BLOCK_SIZE;
+    }
+}
+
+/*!
+ * brief Decrypts AES using CBC block mode.
+ *
+ * param ctx Software AES context.
+ * param ciphertext Input cipher text.
+ * param[out] plaintext Output plain text. Can be the same as ciphertext.
+ * param size Size of input and output data in bytes. Must be multiple of 16 bytes.
+ * param iv Input initial vector.
+ */
+void AES_SOFT_DecryptCbc(const aes_soft_ctx_t *ctx,
+                         const uint8_t *ciphertext,
+                         uint8_t *plaintext,
+                         size_t size,
+                         const uint8_t iv[AES_SOFT_BLOCK_SIZE])
+{
+    uint8_t chain[AES_SOFT_BLOCK_SIZE];
+    uint8_t saved[AES_SOFT_PAR_BLOCKS * AES_SOFT_BLOCK_SIZE];
+    size_t blocks = size / AES_SOFT_BLOCK_SIZE;
+    size_t n;
+
+    memcpy(chain, iv, AES_SOFT_BLOCK_SIZE);
+
+    /* blocks are independent, decrypt several at once and keep cipher text for in-place operation */
+    while (blocks)
+    {
+        n = (blocks > AES_SOFT_PAR_BLOCKS) ? AES_SOFT_PAR_BLOCKS : blocks;
+        memcpy(saved, ciphertext, n * AES_SOFT_BLOCK_SIZE);
+        aes_soft_blocks(ctx, true, ciphertext, plaintext, n);
+        for (uint32_t i = 0; i < AES_SOFT_BLOCK_SIZE; i++)
+        {
+            plaintext[i] ^= chain[i];
+        }
+        for (uint32_t i = AES_SOFT_BLOCK_SIZE; i < n * AES_SOFT_BLOCK_SIZE; i++)
+        {
+            plaintext[i] ^= saved[i - AES_SOFT_BLOCK_SIZE];
+        }
+        memcpy(chain, &saved[(n - 1u) * AES_SOFT_BLOCK_SIZE], AES_SOFT_BLOCK_SIZE);
+        ciphertext += n * AES_SOFT_BLOCK_SIZE;
+        plaintext += n * AES_SOFT_BLOCK_SIZE;
+        blocks -= n;
+    }
+}
+
+/*!
+ * brief Encrypts or decrypts AES using CTR block mode.
+ *
+ * param ctx Software AES context.
+ * param input Input data.
+ * param[out] output Output data. Can be the same as input.
+ * param size Size of input and output data in bytes.
+ * param[in,out] counter Input counter (updates on return).
+ * param[out] counterlast Output cipher of last counter. NULL can be passed if not needed.
+ * param[out] szLeft Output number of bytes left unused in counterlast block. NULL can be passed if not needed.
+ */
+void AES_SOFT_CryptCtr(const aes_soft_ctx_t *ctx,
+                       const uint8_t *input,
+                       uint8_t *output,
+                       size_t size,
+                       uint8_t counter[AES_SOFT_BLOCK_SIZE],
+                       uint8_t counterlast[AES_SOFT_BLOCK_SIZE],
+                       size_t *szLeft)
+{
+    uint8_t keyStream[AES_SOFT_PAR_BLOCKS * AES_SOFT_BLOCK_SIZE];
+    size_t lastSize = size % AES_SOFT_BLOCK_SIZE;
+    size_t n = 0;
+    size_t actSz;
+
+#if AES_SOFT_HAS_AESNI
+    if (ctx->impl == kAES_SOFT_AesNi)
+    {
+        actSz = size - lastSize;
+        aes_soft_ni_ctr(ctx, counter, input, output, actSz / AES_SOFT_BLOCK_SIZE);
+        input += actSz;
+        output += actSz;
+        size = lastSize;
+    }
+#endif
+
+    while (size)
+    {
+        n = (size + AES_SOFT_BLOCK_SIZE - 1u) / AES_SOFT_BLOCK_SIZE;
+        if (n > AES_SOFT_PAR_BLOCKS)
+        {
+            n = AES_SOFT_PAR_BLOCKS;
+        }
+
+        for (size_t i = 0; i < n; i++)
+        {
+            memcpy(&keyStream[i * AES_SOFT_BLOCK_SIZE], counter, AES_SOFT_BLOCK_SIZE);
+            aes_soft_ctr_increment(counter);
+        }
+        aes_soft_blocks(ctx, false, keyStream, keyStream, n);
+
+        actSz = (size < n * AES_SOFT_BLOCK_SIZE) ? size : n * AES_SOFT_BLOCK_SIZE;
+        for (size_t i = 0; i < actSz; i++)
+        {
+            output[i] = input[i] ^ keyStream[i];
+        }
+        input += actSz;
+        output += actSz;
+        size -= actSz;
+    }
+
+    if (counterlast)
+    {
+        if (lastSize)
+        {
+            memcpy(counterlast, &keyStream[(n - 1u) * AES_SOFT_BLOCK_SIZE], AES_SOFT_BLOCK_SIZE);
+        }
+        else
+        {
+            memset(counterlast, 0, AES_SOFT_BLOCK_SIZE);
+        }
+    }
+    if (szLeft)
+    {
+        *szLeft = lastSize ? AES_SOFT_BLOCK_SIZE - lastSize : 0u;
+    }
+
+    memset(keyStream, 0, sizeof(keyStream));
+}
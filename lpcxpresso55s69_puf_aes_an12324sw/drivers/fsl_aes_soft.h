@@ -0,0 +1,168 @@
+/*
+ * Copyright 2026 asvin.io
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _FSL_AES_SOFT_H_
+#define _FSL_AES_SOFT_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*!
+ * @addtogroup aes_soft
+ * @{
+ */
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+
+/*! @brief AES block size in bytes. */
+#define AES_SOFT_BLOCK_SIZE 16
+
+/*! @brief Implementation used for kAES_SOFT_Auto.
+ *
+ * kAES_SOFT_Auto uses AES-NI when the host supports it and T-tables otherwise.
+ */
+#ifndef AES_SOFT_DEFAULT_IMPL
+#define AES_SOFT_DEFAULT_IMPL kAES_SOFT_Auto
+#endif
+
+/*! @brief Builds the AES-NI implementation, enabled by default on x86 with GCC or Clang. */
+#ifndef AES_SOFT_HAS_AESNI
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define AES_SOFT_HAS_AESNI 1
+#else
+#define AES_SOFT_HAS_AESNI 0
+#endif
+#endif
+
+/*! @brief Software AES implementation. */
+typedef enum _aes_soft_impl
+{
+    kAES_SOFT_Auto = 0U,      /*!< AES-NI if available, T-tables otherwise */
+    kAES_SOFT_Table = 1U,     /*!< 32-bit T-tables, fastest portable implementation, not constant time */
+    kAES_SOFT_Bitsliced = 2U, /*!< Bitsliced, two blocks in parallel, constant time */
+    kAES_SOFT_AesNi = 3U,     /*!< x86 AES-NI instructions, four blocks in parallel */
+} aes_soft_impl_t;
+
+/*! @brief Software AES context with the expanded key. */
+typedef struct _aes_soft_ctx
+{
+    uint32_t rk[60];      /*!< Encryption round keys, big endian words */
+    uint32_t rounds;      /*!< Number of rounds, 10, 12 or 14 */
+    aes_soft_impl_t impl; /*!< Implementation selected by AES_SOFT_SetKey() */
+    union
+    {
+        uint32_t drk[60];       /*!< kAES_SOFT_Table: equivalent inverse cipher round keys */
+        uint32_t sliced[15][8]; /*!< kAES_SOFT_Bitsliced: bitsliced round keys */
+        uint8_t ni[2][240];     /*!< kAES_SOFT_AesNi: encryption and decryption round keys in byte order */
+    } impl_keys;                /*!< Implementation specific round keys */
+} aes_soft_ctx_t;
+
+/*******************************************************************************
+ * API
+ ******************************************************************************/
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/*!
+ * @brief Expands an AES key for the selected implementation.
+ *
+ * kAES_SOFT_AesNi falls back to kAES_SOFT_Table if the host does not support AES-NI.
+ *
+ * @param[out] ctx Software AES context.
+ * @param key AES key.
+ * @param keySize AES key size in bytes. Shall equal 16, 24 or 32.
+ * @param impl Implementation, kAES_SOFT_Auto selects AES_SOFT_DEFAULT_IMPL.
+ * @return true on success, false if keySize or impl is invalid.
+ */
+bool AES_SOFT_SetKey(aes_soft_ctx_t *ctx, const uint8_t *key, size_t keySize, aes_soft_impl_t impl);
+
+/*!
+ * @brief Encrypts AES on one or multiple 128-bit block(s).
+ *
+ * @param ctx Software AES context.
+ * @param plaintext Input plain text.
+ * @param[out] ciphertext Output cipher text. Can be the same as plaintext.
+ * @param size Size of input and output data in bytes. Must be multiple of 16 bytes.
+ */
+void AES_SOFT_EncryptEcb(const aes_soft_ctx_t *ctx, const uint8_t *plaintext, uint8_t *ciphertext, size_t size);
+
+/*!
+ * @brief Decrypts AES on one or multiple 128-bit block(s).
+ *
+ * @param ctx Software AES context.
+ * @param ciphertext Input cipher text.
+ * @param[out] plaintext Output plain text. Can be the same as ciphertext.
+ * @param size Size of input and output data in bytes. Must be multiple of 16 bytes.
+ */
+void AES_SOFT_DecryptEcb(const aes_soft_ctx_t *ctx, const uint8_t *ciphertext, uint8_t *plaintext, size_t size);
+
+/*!
+ * @brief Encrypts AES using CBC block mode.
+ *
+ * @param ctx Software AES context.
+ * @param plaintext Input plain text.
+ * @param[out] ciphertext Output cipher text. Can be the same as plaintext.
+ * @param size Size of input and output data in bytes. Must be multiple of 16 bytes.
+ * @param iv Input initial vector.
+ */
+void AES_SOFT_EncryptCbc(const aes_soft_ctx_t *ctx,
+                         const uint8_t *plaintext,
+                         uint8_t *ciphertext,
+                         size_t size,
+                         const uint8_t iv[AES_SOFT_BLOCK_SIZE]);
+
+/*!
+ * @brief Decrypts AES using CBC block mode.
+ *
+ * @param ctx Software AES context.
+ * @param ciphertext Input cipher text.
+ * @param[out] plaintext Output plain text. Can be the same as ciphertext.
+ * @param size Size of input and output data in bytes. Must be multiple of 16 bytes.
+ * @param iv Input initial vector.
+ */
+void AES_SOFT_DecryptCbc(const aes_soft_ctx_t *ctx,
+                         const uint8_t *ciphertext,
+                         uint8_t *plaintext,
+                         size_t size,
+                         const uint8_t iv[AES_SOFT_BLOCK_SIZE]);
+
+/*!
+ * @brief Encrypts or decrypts AES using CTR block mode.
+ *
+ * Same semantics as HASHCRYPT_AES_CryptCtr(): the counter is a 128-bit big endian number, incremented once per
+ * block including the last incomplete one.
+ *
+ * @param ctx Software AES context.
+ * @param input Input data.
+ * @param[out] output Output data. Can be the same as input.
+ * @param size Size of input and output data in bytes.
+ * @param[in,out] counter Input counter (updates on return).
+ * @param[out] counterlast Output cipher of last counter. NULL can be passed if not needed.
+ * @param[out] szLeft Output number of bytes left unused in counterlast block. NULL can be passed if not needed.
+ */
+void AES_SOFT_CryptCtr(const aes_soft_ctx_t *ctx,
+                       const uint8_t *input,
+                       uint8_t *output,
+                       size_t size,
+                       uint8_t counter[AES_SOFT_BLOCK_SIZE],
+                       uint8_t counterlast[AES_SOFT_BLOCK_SIZE],
+                       size_t *szLeft);
+
+#if defined(__cplusplus)
+}
+#endif
+
+/*!
+ * @}
+ */
+
+#endif /* _FSL_AES_SOFT_H_ */
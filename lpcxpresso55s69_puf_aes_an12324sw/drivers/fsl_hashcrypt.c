@@ -15,6 +15,13 @@
 #define SHA_BLOCK_SIZE 64
 /*!< max number of blocks that can be proccessed in one run (master mode) */
 #define SHA_MASTER_MAX_BLOCKS 2048
+/*!< max number of AES blocks that can be proccessed in one run (master mode) */
+#define AES_MASTER_MAX_BLOCKS 2048
+/*!< number of CTR counter blocks encrypted at once by HASHCRYPT_AES_ProcessBatch() */
+#define AES_BATCH_CTR_BLOCKS 8
+/*!< HMAC inner and outer padding bytes */
+#define HMAC_IPAD 0x36u
+#define HMAC_OPAD 0x5cu
 
 /*!< Use standard C library memcpy  */
 #define hashcrypt_memcpy memcpy
@@ -46,6 +53,17 @@ typedef struct _hashcrypt_sha_ctx_internal
     hashcrypt_callback_t hashCallback; /*!< pointer to HASH callback function */
     void
         *userData; /*!< user data to be passed as an argument to callback function, once callback is invoked from isr */
+    const uint8_t *input;                      /*!< next block of non-blocking input */
+    uint32_t tailSize;                         /*!< bytes after the full blocks of non-blocking input */
+    bool busy;                                 /*!< true until the non-blocking update invokes the callback */
+    struct _hashcrypt_sha_ctx_internal *next;  /*!< next context in the queue of non-blocking hashes */
+    hashcrypt_sha_stats_t stats;               /*!< counters returned by HASHCRYPT_SHA_GetStats() */
+    hashcrypt_sha_progress_t progress;         /*!< progress callback of blocking updates, NULL if none */
+    void *progressData;                        /*!< user data passed to the progress callback */
+#if HASHCRYPT_SHA_SOFTWARE
+    bool software;                             /*!< true if the hash runs in soft instead of HASHCRYPT */
+    sha_soft_ctx_t soft;                       /*!< software hash context */
+#endif /* HASHCRYPT_SHA_SOFTWARE */
 } hashcrypt_sha_ctx_internal_t;
 
 /*!< SHA-1 and SHA-256 digest length in bytes  */
@@ -55,13 +73,52 @@ enum _hashcrypt_sha_digest_len
     kHASHCRYPT_OutLenSha256 = 32u,
 };
 
-/*!< pointer to hash context structure used by isr */
-static hashcrypt_hash_ctx_t *s_ctx;
+/*!< non-blocking hash whose AHB master run is in progress, NULL if none */
+static hashcrypt_sha_ctx_internal_t *volatile s_shaActive;
+
+/*!< non-blocking hashes waiting for HASHCRYPT, served from the head */
+static hashcrypt_sha_ctx_internal_t *s_shaQueue;
+
+/*!< hash context whose running hash is in HASHCRYPT, NULL if none */
+static hashcrypt_sha_ctx_internal_t *s_shaOwner;
+
+/*!< true while a blocking hash function uses HASHCRYPT, queued hashes are not started */
+static volatile bool s_shaHold;
+
+/*!< hook invoked between chunks of blocking hash updates, see HASHCRYPT_SHA_SetYieldHook() */
+static hashcrypt_yield_hook_t s_shaYield;
+static void *s_shaYieldData;
+
+/*!< pointer to AES handle used by isr, NULL if no non-blocking AES operation is in progress */
+static hashcrypt_handle_t *volatile s_aesHandle;
+
+/*!< streaming CTR context for which HASHCRYPT is still configured, NULL if the engine has been reconfigured since */
+static hashcrypt_ctr_stream_t *s_ctrOwner;
+
+/*!< prepared ECB handle for which HASHCRYPT is still configured, NULL if the engine has been reconfigured since */
+static const hashcrypt_aes_prepared_t *s_aesPrepared;
+
+/*!< aligned double buffer used to feed unaligned AES input to AHB master */
+static uint32_t s_aesStaging[2][HASHCRYPT_AES_STAGING_SIZE / sizeof(uint32_t)];
+
+/*!< aligned double buffer used to feed unaligned input of blocking hash updates to AHB master */
+static uint32_t s_shaStaging[2][HASHCRYPT_SHA_STAGING_BLOCKS * SHA_BLOCK_SIZE / sizeof(uint32_t)];
 
 /*!< macro for checking build time condition. It is used to assure the hashcrypt_sha_ctx_internal_t can fit into
  * hashcrypt_hash_ctx_t */
 #define BUILD_ASSERT(condition, msg) extern int msg[1 - 2 * (!(condition))] __attribute__((unused))
 
+BUILD_ASSERT(((HASHCRYPT_AES_STAGING_SIZE % HASHCRYPT_AES_BLOCK_SIZE) == 0) &&
+                 (HASHCRYPT_AES_STAGING_SIZE >= HASHCRYPT_AES_BLOCK_SIZE) &&
+                 (HASHCRYPT_AES_STAGING_SIZE <= ((AES_MASTER_MAX_BLOCKS - 1) * HASHCRYPT_AES_BLOCK_SIZE)),
+             hashcrypt_aes_staging_size);
+
+BUILD_ASSERT((HASHCRYPT_SHA_CHUNK_BLOCKS > 0) && (HASHCRYPT_SHA_CHUNK_BLOCKS < SHA_MASTER_MAX_BLOCKS),
+             hashcrypt_sha_chunk_blocks);
+
+BUILD_ASSERT((HASHCRYPT_SHA_STAGING_BLOCKS > 0) && (HASHCRYPT_SHA_STAGING_BLOCKS < SHA_MASTER_MAX_BLOCKS),
+             hashcrypt_sha_staging_blocks);
+
 /*******************************************************************************
  * Code
  ******************************************************************************/
@@ -103,6 +160,40 @@ static void ctrIncrement(uint8_t *input)
     }
 }
 
+/*!
+ * @brief Adds number of blocks to a 16 byte integer.
+ *
+ * This function adds blocks to a 16 byte big endian integer. The cost does not depend on the number of blocks.
+ *
+ * @param input Pointer to a 16 byte integer to be incremented.
+ * @param blocks Value to add.
+ */
+static void ctrAdd(uint8_t *input, uint32_t blocks)
+{
+    uint32_t low = ((uint32_t)input[12] << 24) | ((uint32_t)input[13] << 16) | ((uint32_t)input[14] << 8) | input[15];
+    uint32_t sum = low + blocks;
+    int i = 11;
+
+    input[12] = (uint8_t)(sum >> 24);
+    input[13] = (uint8_t)(sum >> 16);
+    input[14] = (uint8_t)(sum >> 8);
+    input[15] = (uint8_t)sum;
+
+    /* propagate carry to upper 96 bits */
+    if (sum < low)
+    {
+        while ((i >= 0) && (input[i] == (uint8_t)0xFFu))
+        {
+            input[i] = (uint8_t)0x00u;
+            i--;
+        }
+        if (i >= 0)
+        {
+            input[i] += (uint8_t)1u;
+        }
+    }
+}
+
 /*!
  * @brief LDM to SHA engine INDATA and ALIAS registers.
  *
@@ -186,6 +277,33 @@ static void hashcrypt_get_data(HASHCRYPT_Type *base, uint32_t *output, size_t ou
     hashcrypt_memcpy(output, digest, outputSize);
 }
 
+/*!
+ * @brief Checks if HASHCRYPT is held by the unfinished hash of another context.
+ *
+ * HASHCRYPT cannot save a running hash and load it back once it has been configured for another operation.
+ * The hash context that owns HASHCRYPT keeps it until HASHCRYPT_SHA_Finish() or HASHCRYPT_SHA_Abort().
+ *
+ * @param ctxInternal Hash context that needs HASHCRYPT, NULL for an AES operation.
+ * @return true if HASHCRYPT cannot be taken now.
+ */
+static bool hashcrypt_sha_engine_held(const hashcrypt_sha_ctx_internal_t *ctxInternal)
+{
+    return (NULL != s_shaOwner) && (s_shaOwner != ctxInternal);
+}
+
+/*!
+ * @brief Checks if a blocking AES operation cannot take HASHCRYPT now.
+ *
+ * HASHCRYPT is busy while a non-blocking AES operation or a non-blocking hash run is in progress, and held between
+ * the runs of an unfinished hash.
+ *
+ * @return true if HASHCRYPT is busy or held.
+ */
+static bool hashcrypt_aes_engine_busy(void)
+{
+    return (NULL != s_aesHandle) || (NULL != s_shaActive) || hashcrypt_sha_engine_held(NULL);
+}
+
 /*!
  * @brief Initialize the Hashcrypt engine for new operation.
  *
@@ -196,6 +314,10 @@ static void hashcrypt_get_data(HASHCRYPT_Type *base, uint32_t *output, size_t ou
  */
 static void hashcrypt_engine_init(HASHCRYPT_Type *base, hashcrypt_algo_t algo)
 {
+    /* any streaming CTR context or prepared handle loses the engine */
+    s_ctrOwner = NULL;
+    s_aesPrepared = NULL;
+
     /* NEW bit must be set before we switch from previous mode otherwise new mode will not work correctly */
     base->CTRL = HASHCRYPT_CTRL_NEW_HASH(1);
     base->CTRL = HASHCRYPT_CTRL_MODE(algo) | HASHCRYPT_CTRL_NEW_HASH(1);
@@ -235,80 +357,257 @@ static void hashcrypt_aes_load_userKey(HASHCRYPT_Type *base, hashcrypt_handle_t
 }
 
 /*!
- * @brief Performs AES encryption/decryption of one data block.
+ * @brief Configures the Hashcrypt engine for new AES operation.
  *
- * This function encrypts/decrypts one block of data with specified size.
+ * This function writes CRYPTCFG, starts new AES operation and loads user key if kHASHCRYPT_UserKey is selected.
+ * The caller has taken HASHCRYPT, see hashcrypt_aes_engine_init().
+ *
+ * @param base Hashcrypt peripheral base address.
+ * @param handle Handle used for this request.
+ * @param mode AES mode (ECB, CBC or CTR).
+ * @param direction AES_ENCRYPT or AES_DECRYPT.
+ */
+static void hashcrypt_aes_engine_config(HASHCRYPT_Type *base,
+                                        hashcrypt_handle_t *handle,
+                                        hashcrypt_aes_mode_t mode,
+                                        uint32_t direction)
+{
+    uint32_t keyType = (handle->keyType == kHASHCRYPT_UserKey) ? 0 : 1u;
+
+    base->CRYPTCFG = HASHCRYPT_CRYPTCFG_AESMODE(mode) | HASHCRYPT_CRYPTCFG_AESDECRYPT(direction) |
+                     HASHCRYPT_CRYPTCFG_AESSECRET(keyType) | HASHCRYPT_CRYPTCFG_AESKEYSZ(handle->keySize) |
+                     HASHCRYPT_CRYPTCFG_MSW1ST_OUT(1) | HASHCRYPT_CRYPTCFG_SWAPKEY(1) | HASHCRYPT_CRYPTCFG_SWAPDAT(1) |
+                     HASHCRYPT_CRYPTCFG_MSW1ST(1);
+
+    hashcrypt_engine_init(base, kHASHCRYPT_Aes);
+
+    /* load key if kHASHCRYPT_UserKey is selected */
+    if (handle->keyType == kHASHCRYPT_UserKey)
+    {
+        hashcrypt_aes_load_userKey(base, handle);
+    }
+}
+
+/*!
+ * @brief Configures the Hashcrypt engine for new blocking AES operation.
+ *
+ * @param base Hashcrypt peripheral base address.
+ * @param handle Handle used for this request.
+ * @param mode AES mode (ECB, CBC or CTR).
+ * @param direction AES_ENCRYPT or AES_DECRYPT.
+ * @return kStatus_Success, or kStatus_HASHCRYPT_Again if a non-blocking AES operation or hash run is in progress
+ * or HASHCRYPT is held by an unfinished hash.
+ */
+static status_t hashcrypt_aes_engine_init(HASHCRYPT_Type *base,
+                                          hashcrypt_handle_t *handle,
+                                          hashcrypt_aes_mode_t mode,
+                                          uint32_t direction)
+{
+    if (hashcrypt_aes_engine_busy())
+    {
+        return kStatus_HASHCRYPT_Again;
+    }
+
+    hashcrypt_aes_engine_config(base, handle, mode, direction);
+
+    return kStatus_Success;
+}
+
+/*!
+ * @brief Reads one AES output block from OUTDATA.
+ *
+ * This function waits for the engine to produce one output block and stores it to output buffer.
+ * The output buffer does not need to be word aligned.
+ *
+ * @param base Hashcrypt peripheral base address.
+ * @param[out] output output data (16 bytes), NULL if the block shall be discarded (MAC computation).
+ */
+static void hashcrypt_aes_get_block(HASHCRYPT_Type *base, uint8_t *output)
+{
+    uint32_t outBlk[HASHCRYPT_AES_BLOCK_SIZE / 4];
+
+    while (0 == (base->STATUS & HASHCRYPT_STATUS_DIGEST_AKA_OUTDATA_MASK))
+    {
+    }
+
+    for (int i = 0; i < 4; i++)
+    {
+        outBlk[i] = swap_bytes(base->OUTDATA0[i]);
+    }
+
+    if (output == NULL)
+    {
+        return;
+    }
+
+    if ((uint32_t)output & 0x3u)
+    {
+        hashcrypt_memcpy(output, outBlk, sizeof(outBlk));
+    }
+    else
+    {
+        for (int i = 0; i < 4; i++)
+        {
+            ((uint32_t *)output)[i] = outBlk[i];
+        }
+    }
+}
+
+/*!
+ * @brief Reports progress of a blocking AES operation.
+ *
+ * @param base Hashcrypt peripheral base address.
+ * @param handle Handle used for this request, NULL if progress is not reported.
+ * @param done Number of bytes processed so far.
+ * @param total Total number of bytes of the operation.
+ */
+static void hashcrypt_aes_progress(HASHCRYPT_Type *base, hashcrypt_handle_t *handle, size_t done, size_t total)
+{
+    if (handle && handle->aesProgress)
+    {
+        handle->aesProgress(base, handle, done, total, handle->progressUserData);
+    }
+}
+
+/*!
+ * @brief Performs AES encryption/decryption of unaligned input data.
+ *
+ * AHB master mode can only read word aligned data, so the input is staged through two aligned buffers of
+ * HASHCRYPT_AES_STAGING_SIZE bytes. While the engine processes one buffer, the next input chunk is copied
+ * into the other one, one AES block per output block, so the copy overlaps the engine run.
  *
  * @param base Hashcrypt peripheral base address.
+ * @param handle Handle used for this request, NULL if progress is not reported.
  * @param input input data
  * @param output output data
  * @param size size of data block to process in bytes (must be 16bytes multiple).
+ * @return kStatus_Success or kStatus_Fail if HASHCRYPT reports an error.
  */
-static status_t hashcrypt_aes_one_block(HASHCRYPT_Type *base, const uint8_t *input, uint8_t *output, size_t size)
+static status_t hashcrypt_aes_staged(
+    HASHCRYPT_Type *base, hashcrypt_handle_t *handle, const uint8_t *input, uint8_t *output, size_t size)
 {
-    status_t status = kStatus_Fail;
-    int idx = 0;
-
-    /* we use AHB master mode as much as possible */
-    /* however, it can work only with aligned input data */
-    /* so, if unaligned, we do memcpy to temp buffer on stack, which is aligned, and use AHB mode to read data in */
-    /* then we read data back to it and do memcpy to the output buffer */
-    if (((uint32_t)input & 0x3u) || ((uint32_t)output & 0x3u))
-    {
-        uint32_t temp[256 / sizeof(uint32_t)];
-        int cnt = 0;
-        while (size)
+    uint32_t *stage = s_aesStaging[0];
+    uint32_t *next = s_aesStaging[1];
+    uint32_t *tmp;
+    size_t total = size;
+    size_t done = 0;
+    size_t chunk = size >= HASHCRYPT_AES_STAGING_SIZE ? HASHCRYPT_AES_STAGING_SIZE : size;
+    size_t nextChunk;
+    size_t copied;
+
+    /* first chunk cannot overlap with anything */
+    hashcrypt_memcpy(stage, input, chunk);
+    input += chunk;
+    size -= chunk;
+
+    while (chunk)
+    {
+        /* only the last chunk can be shorter, so next chunk always fits into the current number of engine blocks */
+        nextChunk = size >= HASHCRYPT_AES_STAGING_SIZE ? HASHCRYPT_AES_STAGING_SIZE : size;
+        copied = 0;
+
+        base->MEMADDR = FSL_FEATURE_HASHCRYPT_ALIAS_OFFSET | HASHCRYPT_MEMADDR_BASE(stage);
+        base->MEMCTRL = HASHCRYPT_MEMCTRL_MASTER(1) | HASHCRYPT_MEMCTRL_COUNT(chunk / HASHCRYPT_AES_BLOCK_SIZE);
+
+        done += chunk;
+        while (chunk)
         {
-            size_t actSz = size >= 256u ? 256u : size;
-            size_t actSzOrig = actSz;
-            memcpy(temp, input + 256 * cnt, actSz);
-            size -= actSz;
-            base->MEMADDR = FSL_FEATURE_HASHCRYPT_ALIAS_OFFSET | HASHCRYPT_MEMADDR_BASE(temp);
-            base->MEMCTRL = HASHCRYPT_MEMCTRL_MASTER(1) | HASHCRYPT_MEMCTRL_COUNT(actSz / 16);
-            int outidx = 0;
-            while (actSz)
+            /* stage one block of the next chunk while the engine works on the current block */
+            if (copied < nextChunk)
+            {
+                hashcrypt_memcpy((uint8_t *)next + copied, input + copied, HASHCRYPT_AES_BLOCK_SIZE);
+                copied += HASHCRYPT_AES_BLOCK_SIZE;
+            }
+
+            hashcrypt_aes_get_block(base, output);
+            if (output)
             {
-                while (0 == (base->STATUS & HASHCRYPT_STATUS_DIGEST_AKA_OUTDATA_MASK))
-                {
-                }
-                for (int i = 0; i < 4; i++)
-                {
-                    (temp + outidx)[i] = swap_bytes(base->OUTDATA0[i]);
-                }
-                outidx += HASHCRYPT_AES_BLOCK_SIZE / 4;
-                actSz -= HASHCRYPT_AES_BLOCK_SIZE;
+                output += HASHCRYPT_AES_BLOCK_SIZE;
             }
-            memcpy(output + 256 * cnt, temp, actSzOrig);
-            cnt++;
+            chunk -= HASHCRYPT_AES_BLOCK_SIZE;
+        }
+
+        if (base->STATUS & HASHCRYPT_STATUS_ERROR_MASK)
+        {
+            return kStatus_Fail;
         }
+        hashcrypt_aes_progress(base, handle, done, total);
+
+        input += nextChunk;
+        size -= nextChunk;
+        chunk = nextChunk;
+
+        tmp = stage;
+        stage = next;
+        next = tmp;
     }
-    else
+
+    return kStatus_Success;
+}
+
+/*!
+ * @brief Performs AES encryption/decryption of one data block.
+ *
+ * This function encrypts/decrypts one block of data with specified size.
+ * Data of any size is processed in AHB master runs of at most AES_MASTER_MAX_BLOCKS - 1 blocks (MEMCTRL COUNT
+ * limit). HASHCRYPT keeps CBC chaining value and CTR counter between runs, so nothing is reloaded.
+ *
+ * @param base Hashcrypt peripheral base address.
+ * @param handle Handle used for this request, NULL if progress is not reported.
+ * @param input input data
+ * @param output output data, NULL to discard output blocks (MAC computation)
+ * @param size size of data block to process in bytes (must be 16bytes multiple).
+ */
+static status_t hashcrypt_aes_one_block(
+    HASHCRYPT_Type *base, hashcrypt_handle_t *handle, const uint8_t *input, uint8_t *output, size_t size)
+{
+    size_t total = size;
+    size_t done = 0;
+    size_t runSz;
+
+    /* we use AHB master mode as much as possible */
+    /* however, it can read only aligned input data */
+    /* so, if unaligned, input is staged through aligned buffers, see hashcrypt_aes_staged() */
+    /* output is read by CPU from OUTDATA registers and can be stored to unaligned address directly */
+    if ((uint32_t)input & 0x3u)
     {
+        return hashcrypt_aes_staged(base, handle, input, output, size);
+    }
+
+    while (size)
+    {
+        runSz = size;
+        if (runSz >= (AES_MASTER_MAX_BLOCKS * HASHCRYPT_AES_BLOCK_SIZE))
+        {
+            runSz = (AES_MASTER_MAX_BLOCKS - 1) * HASHCRYPT_AES_BLOCK_SIZE;
+        }
+
         base->MEMADDR = FSL_FEATURE_HASHCRYPT_ALIAS_OFFSET | HASHCRYPT_MEMADDR_BASE(input);
-        base->MEMCTRL = HASHCRYPT_MEMCTRL_MASTER(1) | HASHCRYPT_MEMCTRL_COUNT(size / 16);
-        while (size >= HASHCRYPT_AES_BLOCK_SIZE)
+        base->MEMCTRL = HASHCRYPT_MEMCTRL_MASTER(1) | HASHCRYPT_MEMCTRL_COUNT(runSz / HASHCRYPT_AES_BLOCK_SIZE);
+        input += runSz;
+        size -= runSz;
+        done += runSz;
+
+        while (runSz >= HASHCRYPT_AES_BLOCK_SIZE)
         {
             /* Get result */
-            while (0 == (base->STATUS & HASHCRYPT_STATUS_DIGEST_AKA_OUTDATA_MASK))
-            {
-            }
+            hashcrypt_aes_get_block(base, output);
 
-            for (int i = 0; i < 4; i++)
+            if (output)
             {
-                ((uint32_t *)output + idx)[i] = swap_bytes(base->OUTDATA0[i]);
+                output += HASHCRYPT_AES_BLOCK_SIZE;
             }
-
-            idx += HASHCRYPT_AES_BLOCK_SIZE / 4;
-            size -= HASHCRYPT_AES_BLOCK_SIZE;
+            runSz -= HASHCRYPT_AES_BLOCK_SIZE;
         }
-    }
 
-    if (0 == (base->STATUS & HASHCRYPT_STATUS_ERROR_MASK))
-    {
-        status = kStatus_Success;
+        if (base->STATUS & HASHCRYPT_STATUS_ERROR_MASK)
+        {
+            return kStatus_Fail;
+        }
+        hashcrypt_aes_progress(base, handle, done, total);
     }
 
-    return status;
+    return kStatus_Success;
 }
 
 /*!
@@ -331,6 +630,13 @@ static status_t hashcrypt_sha_check_input_alg(HASHCRYPT_Type *base, hashcrypt_al
         return kStatus_Success;
     }
 
+#if HASHCRYPT_SHA_SOFTWARE
+    if (algo == kHASHCRYPT_Sha512)
+    {
+        return kStatus_Success;
+    }
+#endif /* HASHCRYPT_SHA_SOFTWARE */
+
     return kStatus_InvalidArgument;
 }
 
@@ -378,132 +684,463 @@ static status_t hashcrypt_sha_check_context(HASHCRYPT_Type *base, hashcrypt_sha_
 }
 
 /*!
- * @brief Load 512-bit block (16 words) into SHA engine.
+ * @brief Makes HASHCRYPT compute the running hash of a context.
  *
- * This function aligns the input block and moves it into SHA engine INDATA.
- * CPU polls the WAITING bit and then moves data by using LDM and STM instructions.
+ * A context in init state starts a new hash. A context in update state continues only while HASHCRYPT still holds
+ * its running hash, which cannot be loaded back. A context cannot take HASHCRYPT from the unfinished hash of another
+ * context.
  *
- * @param base SHA peripheral base address.
- * @param blk 512-bit block
+ * @param base Hashcrypt peripheral base address.
+ * @param ctxInternal Internal context.
+ * @return kStatus_Success, kStatus_HASHCRYPT_Again if HASHCRYPT is held by another hash, or kStatus_Fail if the
+ * running hash has been lost.
  */
-static void hashcrypt_sha_one_block(HASHCRYPT_Type *base, const uint8_t *blk)
+static status_t hashcrypt_sha_take(HASHCRYPT_Type *base, hashcrypt_sha_ctx_internal_t *ctxInternal)
 {
-    uint32_t temp[SHA_BLOCK_SIZE / sizeof(uint32_t)];
-    const uint32_t *actBlk;
-
-    /* make sure the 512-bit block is word aligned */
-    if ((uintptr_t)blk & 0x3u)
+    if (s_shaOwner == ctxInternal)
     {
-        hashcrypt_memcpy(temp, blk, SHA_BLOCK_SIZE);
-        actBlk = (const uint32_t *)(uintptr_t)temp;
+        return kStatus_Success;
     }
-    else
+
+    if (hashcrypt_sha_engine_held(ctxInternal))
     {
-        actBlk = (const uint32_t *)(uintptr_t)blk;
+        return kStatus_HASHCRYPT_Again;
     }
 
-    /* poll waiting. */
-    while (0 == (base->STATUS & HASHCRYPT_STATUS_WAITING_MASK))
+    /* HASHCRYPT was reset, failed or aborted since the running hash was computed */
+    if (ctxInternal->state == kHASHCRYPT_HashUpdate)
     {
+        return kStatus_Fail;
     }
-    /* feed INDATA (and ALIASes). use STM instruction. */
-    hashcrypt_sha_ldm_stm_16_words(base, actBlk);
+
+    hashcrypt_engine_init(base, ctxInternal->algo);
+    ctxInternal->state = kHASHCRYPT_HashUpdate;
+    s_shaOwner = ctxInternal;
+
+    return kStatus_Success;
 }
 
+
 /*!
- * @brief Adds message to current hash.
- *
- * This function merges the message to fill the internal buffer, empties the internal buffer if
- * it becomes full, then process all remaining message data.
+ * @brief Removes the first queued non-blocking hash that can take HASHCRYPT.
  *
+ * This is the head of the queue, unless HASHCRYPT is held by an unfinished hash. Then only that hash can
+ * continue. Called with interrupts disabled.
  *
- * @param base SHA peripheral base address.
- * @param ctxInternal Internal context.
- * @param message Input message.
- * @param messageSize Size of input message in bytes.
- * @return kStatus_Success.
+ * @return Internal context, NULL if no queued hash can run.
  */
-static status_t hashcrypt_sha_process_message_data(HASHCRYPT_Type *base,
-                                                   hashcrypt_sha_ctx_internal_t *ctxInternal,
-                                                   const uint8_t *message,
-                                                   size_t messageSize)
+static hashcrypt_sha_ctx_internal_t *hashcrypt_sha_dequeue(void)
 {
-    /* first fill the internal buffer to full block */
-    if (ctxInternal->blksz)
-    {
-        size_t toCopy = SHA_BLOCK_SIZE - ctxInternal->blksz;
-        hashcrypt_memcpy(&ctxInternal->blk.b[ctxInternal->blksz], message, toCopy);
-        message += toCopy;
-        messageSize -= toCopy;
-
-        /* process full internal block */
-        hashcrypt_sha_one_block(base, &ctxInternal->blk.b[0]);
-    }
+    hashcrypt_sha_ctx_internal_t **link = &s_shaQueue;
+    hashcrypt_sha_ctx_internal_t *ctxInternal;
 
-    /* process all full blocks in message[] */
-    if (messageSize >= SHA_BLOCK_SIZE)
+    while (NULL != *link)
     {
-        if ((uintptr_t)message & 0x3u)
-        {
-            while (messageSize >= SHA_BLOCK_SIZE)
-            {
-                hashcrypt_sha_one_block(base, message);
-                message += SHA_BLOCK_SIZE;
-                messageSize -= SHA_BLOCK_SIZE;
-            }
-        }
-        else
+        ctxInternal = *link;
+        if (!hashcrypt_sha_engine_held(ctxInternal))
         {
-            /* poll waiting. */
-            while (0 == (base->STATUS & HASHCRYPT_STATUS_WAITING_MASK))
-            {
-            }
-            uint32_t blkNum = (messageSize >> 6); /* div by 64 bytes */
-            uint32_t blkBytes = blkNum * 64u;     /* number of bytes in 64 bytes blocks */
-            base->MEMADDR = FSL_FEATURE_HASHCRYPT_ALIAS_OFFSET | HASHCRYPT_MEMADDR_BASE(message);
-            base->MEMCTRL = HASHCRYPT_MEMCTRL_MASTER(1) | HASHCRYPT_MEMCTRL_COUNT(blkNum);
-            message += blkBytes;
-            messageSize -= blkBytes;
-            while (0 == (base->STATUS & HASHCRYPT_STATUS_DIGEST_AKA_OUTDATA_MASK))
-            {
-            }
+            *link = ctxInternal->next;
+            ctxInternal->next = NULL;
+            return ctxInternal;
         }
+        link = &ctxInternal->next;
     }
 
-    /* copy last incomplete message bytes into internal block */
-    hashcrypt_memcpy(&ctxInternal->blk.b[0], message, messageSize);
-    ctxInternal->blksz = messageSize;
-    return kStatus_Success;
+    return NULL;
 }
 
 /*!
- * @brief Finalize the running hash to make digest.
+ * @brief Adds a non-blocking hash at the end of the queue.
  *
- * This function empties the internal buffer, adds padding bits, and generates final digest.
+ * Called with interrupts disabled.
  *
- * @param base SHA peripheral base address.
  * @param ctxInternal Internal context.
- * @return kStatus_Success.
  */
-static status_t hashcrypt_sha_finalize(HASHCRYPT_Type *base, hashcrypt_sha_ctx_internal_t *ctxInternal)
+static void hashcrypt_sha_enqueue(hashcrypt_sha_ctx_internal_t *ctxInternal)
 {
-    hashcrypt_sha_block_t lastBlock;
+    hashcrypt_sha_ctx_internal_t **tail = &s_shaQueue;
 
-    memset(&lastBlock, 0, sizeof(hashcrypt_sha_block_t));
-
-    /* this is last call, so need to flush buffered message bytes along with padding */
-    if (ctxInternal->blksz <= 55u)
+    while (NULL != *tail)
     {
-        /* last data is 440 bits or less. */
-        hashcrypt_memcpy(&lastBlock.b[0], &ctxInternal->blk.b[0], ctxInternal->blksz);
-        lastBlock.b[ctxInternal->blksz] = (uint8_t)0x80U;
-        lastBlock.w[SHA_BLOCK_SIZE / 4 - 1] = swap_bytes(8u * ctxInternal->fullMessageSize);
-        hashcrypt_sha_one_block(base, &lastBlock.b[0]);
+        tail = &(*tail)->next;
     }
-    else
+    ctxInternal->next = NULL;
+    *tail = ctxInternal;
+}
+
+/*!
+ * @brief Removes the running and all queued non-blocking hashes, and the owner of HASHCRYPT.
+ *
+ * Called by HASHCRYPT_Init() and HASHCRYPT_Deinit() before HASHCRYPT is reset. The removed hashes are finished by
+ * hashcrypt_sha_fail_dropped() once the reset is done.
+ *
+ * @return List of the removed internal contexts, linked by next, NULL if none.
+ */
+static hashcrypt_sha_ctx_internal_t *hashcrypt_sha_drop_all(void)
+{
+    hashcrypt_sha_ctx_internal_t *dropped;
+    uint32_t regPrimask = DisableGlobalIRQ();
+
+    dropped = s_shaQueue;
+    if (NULL != s_shaActive)
     {
-        if (ctxInternal->blksz < SHA_BLOCK_SIZE)
-        {
+        s_shaActive->next = dropped;
+        dropped = s_shaActive;
+    }
+    s_shaActive = NULL;
+    s_shaQueue = NULL;
+    /* reset loses the running hash */
+    s_shaOwner = NULL;
+    EnableGlobalIRQ(regPrimask);
+
+    return dropped;
+}
+
+/*!
+ * @brief Finishes the hashes removed by hashcrypt_sha_drop_all().
+ *
+ * Each context is released and its callback, if any, is invoked with kStatus_Fail. The callback may start a new hash
+ * on the context.
+ *
+ * @param dropped List returned by hashcrypt_sha_drop_all().
+ */
+static void hashcrypt_sha_fail_dropped(hashcrypt_sha_ctx_internal_t *dropped)
+{
+    hashcrypt_sha_ctx_internal_t *ctxInternal;
+
+    while (NULL != dropped)
+    {
+        ctxInternal = dropped;
+        dropped = ctxInternal->next;
+        ctxInternal->next = NULL;
+        ctxInternal->busy = false;
+        if (NULL != ctxInternal->hashCallback)
+        {
+            ctxInternal->hashCallback(HASHCRYPT, (hashcrypt_hash_ctx_t *)ctxInternal, kStatus_Fail,
+                                      ctxInternal->userData);
+        }
+    }
+}
+
+/*!
+ * @brief Checks if a non-blocking hash has blocks left to hash.
+ *
+ * @param ctxInternal Internal context.
+ * @return true if the merged block in the context or full input blocks are left.
+ */
+static bool hashcrypt_sha_has_blocks(const hashcrypt_sha_ctx_internal_t *ctxInternal)
+{
+    return (ctxInternal->blksz == SHA_BLOCK_SIZE) || (ctxInternal->remainingBlcks > 0u);
+}
+
+/*!
+ * @brief Starts next AHB master run of a non-blocking hash.
+ *
+ * The block merged in the context from previous segments goes first. Aligned input runs in bursts limited to
+ * SHA_MASTER_MAX_BLOCKS - 1 blocks. Unaligned input is copied to the context block by block, as AHB master reads
+ * only word aligned memory.
+ * Called with interrupts disabled or from HASHCRYPT isr.
+ *
+ * @param base Hashcrypt peripheral base address.
+ * @param ctxInternal Internal context.
+ */
+static void hashcrypt_sha_start_run(HASHCRYPT_Type *base, hashcrypt_sha_ctx_internal_t *ctxInternal)
+{
+    const uint8_t *src = &ctxInternal->blk.b[0];
+    uint32_t numBlocks = 1;
+
+    /* cannot fail, hashcrypt_sha_dequeue() only returns a context that can take HASHCRYPT */
+    (void)hashcrypt_sha_take(base, ctxInternal);
+
+    if (ctxInternal->blksz == SHA_BLOCK_SIZE)
+    {
+        ctxInternal->blksz = 0;
+    }
+    else if ((uintptr_t)ctxInternal->input & 0x3u)
+    {
+        hashcrypt_memcpy(&ctxInternal->blk.b[0], ctxInternal->input, SHA_BLOCK_SIZE);
+        ctxInternal->input += SHA_BLOCK_SIZE;
+        ctxInternal->remainingBlcks--;
+    }
+    else
+    {
+        numBlocks = ctxInternal->remainingBlcks;
+        if (numBlocks >= SHA_MASTER_MAX_BLOCKS)
+        {
+            numBlocks = SHA_MASTER_MAX_BLOCKS - 1;
+        }
+        src = ctxInternal->input;
+        ctxInternal->input += numBlocks * SHA_BLOCK_SIZE;
+        ctxInternal->remainingBlcks -= numBlocks;
+    }
+
+    ctxInternal->stats.runs++;
+    s_shaActive = ctxInternal;
+
+    /* Enable digest and error interrupts and start hash */
+    base->INTENSET = HASHCRYPT_INTENCLR_DIGEST_MASK | HASHCRYPT_INTENCLR_ERROR_MASK;
+    base->MEMADDR = FSL_FEATURE_HASHCRYPT_ALIAS_OFFSET | HASHCRYPT_MEMADDR_BASE(src);
+    base->MEMCTRL = HASHCRYPT_MEMCTRL_MASTER(1) | HASHCRYPT_MEMCTRL_COUNT(numBlocks);
+}
+
+/*!
+ * @brief Starts the first queued non-blocking hash if HASHCRYPT is free.
+ *
+ * @param base Hashcrypt peripheral base address.
+ */
+static void hashcrypt_sha_schedule(HASHCRYPT_Type *base)
+{
+    hashcrypt_sha_ctx_internal_t *ctxInternal;
+    uint32_t regPrimask = DisableGlobalIRQ();
+
+    if ((NULL == s_shaActive) && (NULL == s_aesHandle) && !s_shaHold)
+    {
+        ctxInternal = hashcrypt_sha_dequeue();
+        if (NULL != ctxInternal)
+        {
+            hashcrypt_sha_start_run(base, ctxInternal);
+        }
+    }
+    EnableGlobalIRQ(regPrimask);
+}
+
+/*!
+ * @brief Drops the running hash of a context from HASHCRYPT.
+ *
+ * Queued hashes that waited for HASHCRYPT to be released are started.
+ *
+ * @param base Hashcrypt peripheral base address.
+ * @param ctxInternal Internal context which starts a new hash or has been finished.
+ */
+static void hashcrypt_sha_forget(HASHCRYPT_Type *base, hashcrypt_sha_ctx_internal_t *ctxInternal)
+{
+    uint32_t regPrimask = DisableGlobalIRQ();
+    if (s_shaOwner == ctxInternal)
+    {
+        s_shaOwner = NULL;
+    }
+    EnableGlobalIRQ(regPrimask);
+    hashcrypt_sha_schedule(base);
+}
+
+/*!
+ * @brief Suspends the queue of non-blocking hashes and waits until HASHCRYPT is free.
+ *
+ * A non-blocking hash in progress completes its current segment first.
+ *
+ * @param base Hashcrypt peripheral base address.
+ */
+static void hashcrypt_sha_hold(HASHCRYPT_Type *base)
+{
+    s_shaHold = true;
+    while ((NULL != s_shaActive) || (NULL != s_aesHandle))
+    {
+    }
+}
+
+/*!
+ * @brief Resumes the queue of non-blocking hashes.
+ *
+ * @param base Hashcrypt peripheral base address.
+ */
+static void hashcrypt_sha_release(HASHCRYPT_Type *base)
+{
+    s_shaHold = false;
+    hashcrypt_sha_schedule(base);
+}
+
+/*!
+ * @brief Load 512-bit block (16 words) into SHA engine.
+ *
+ * This function moves the word aligned input block into SHA engine INDATA.
+ * CPU polls the WAITING bit and then moves data by using LDM and STM instructions.
+ *
+ * @param base SHA peripheral base address.
+ * @param blk 512-bit block, word aligned
+ */
+static void hashcrypt_sha_one_block(HASHCRYPT_Type *base, const uint8_t *blk)
+{
+    /* poll waiting. */
+    while (0 == (base->STATUS & HASHCRYPT_STATUS_WAITING_MASK))
+    {
+    }
+    /* feed INDATA (and ALIASes). use STM instruction. */
+    hashcrypt_sha_ldm_stm_16_words(base, (const uint32_t *)(uintptr_t)blk);
+}
+
+/*!
+ * @brief Hashes full blocks of unaligned input.
+ *
+ * AHB master mode can only read word aligned data, so the input is realigned into two staging windows of
+ * HASHCRYPT_SHA_STAGING_BLOCKS blocks. While the engine hashes one window in a single AHB master run, the next
+ * input span is copied into the other one.
+ *
+ * @param base SHA peripheral base address.
+ * @param message Input message, any alignment.
+ * @param numBlocks Number of 64-byte blocks to hash, less than SHA_MASTER_MAX_BLOCKS.
+ */
+static void hashcrypt_sha_staged(HASHCRYPT_Type *base, const uint8_t *message, uint32_t numBlocks)
+{
+    uint32_t *stage = s_shaStaging[0];
+    uint32_t *next = s_shaStaging[1];
+    uint32_t *tmp;
+    uint32_t count = MIN(numBlocks, HASHCRYPT_SHA_STAGING_BLOCKS);
+    uint32_t nextCount;
+
+    /* first window cannot overlap with anything */
+    hashcrypt_memcpy(stage, message, count * SHA_BLOCK_SIZE);
+    message += count * SHA_BLOCK_SIZE;
+    numBlocks -= count;
+
+    while (count)
+    {
+        /* poll waiting. */
+        while (0 == (base->STATUS & HASHCRYPT_STATUS_WAITING_MASK))
+        {
+        }
+        base->MEMADDR = FSL_FEATURE_HASHCRYPT_ALIAS_OFFSET | HASHCRYPT_MEMADDR_BASE(stage);
+        base->MEMCTRL = HASHCRYPT_MEMCTRL_MASTER(1) | HASHCRYPT_MEMCTRL_COUNT(count);
+
+        /* stage the next window while the engine hashes the current one */
+        nextCount = MIN(numBlocks, HASHCRYPT_SHA_STAGING_BLOCKS);
+        hashcrypt_memcpy(next, message, nextCount * SHA_BLOCK_SIZE);
+        message += nextCount * SHA_BLOCK_SIZE;
+        numBlocks -= nextCount;
+
+        while (0 == (base->STATUS & HASHCRYPT_STATUS_DIGEST_AKA_OUTDATA_MASK))
+        {
+        }
+
+        count = nextCount;
+        tmp = stage;
+        stage = next;
+        next = tmp;
+    }
+}
+
+/*!
+ * @brief Reports a hashed chunk of a blocking update and yields.
+ *
+ * @param base SHA peripheral base address.
+ * @param ctxInternal Internal context.
+ * @param done Bytes of the update call hashed so far.
+ * @param total Size of the update call in bytes.
+ */
+static void hashcrypt_sha_chunk_done(HASHCRYPT_Type *base,
+                                     hashcrypt_sha_ctx_internal_t *ctxInternal,
+                                     size_t done,
+                                     size_t total)
+{
+    if (NULL != ctxInternal->progress)
+    {
+        ctxInternal->progress(base, (hashcrypt_hash_ctx_t *)ctxInternal, done, total, ctxInternal->progressData);
+    }
+    if (NULL != s_shaYield)
+    {
+        s_shaYield(s_shaYieldData);
+    }
+}
+
+/*!
+ * @brief Adds message to current hash.
+ *
+ * This function merges the message to fill the internal buffer, empties the internal buffer if
+ * it becomes full, then process all remaining message data in chunks of HASHCRYPT_SHA_CHUNK_BLOCKS blocks,
+ * below the AHB master count limit. Unaligned chunks are realigned through the staging windows, so only the
+ * merged head block and the tail copied into the internal buffer are handled one block at a time.
+ *
+ *
+ * @param base SHA peripheral base address.
+ * @param ctxInternal Internal context.
+ * @param message Input message.
+ * @param messageSize Size of input message in bytes.
+ * @return kStatus_Success.
+ */
+static status_t hashcrypt_sha_process_message_data(HASHCRYPT_Type *base,
+                                                   hashcrypt_sha_ctx_internal_t *ctxInternal,
+                                                   const uint8_t *message,
+                                                   size_t messageSize)
+{
+    size_t total = messageSize;
+
+    /* first fill the internal buffer to full block */
+    if (ctxInternal->blksz)
+    {
+        size_t toCopy = SHA_BLOCK_SIZE - ctxInternal->blksz;
+        hashcrypt_memcpy(&ctxInternal->blk.b[ctxInternal->blksz], message, toCopy);
+        message += toCopy;
+        messageSize -= toCopy;
+
+        /* process full internal block */
+        hashcrypt_sha_one_block(base, &ctxInternal->blk.b[0]);
+    }
+
+    /* process all full blocks in message[] */
+    while (messageSize >= SHA_BLOCK_SIZE)
+    {
+        uint32_t blkNum = MIN(messageSize >> 6, HASHCRYPT_SHA_CHUNK_BLOCKS); /* div by 64 bytes */
+        uint32_t blkBytes = blkNum * 64u;                                   /* number of bytes in 64 bytes blocks */
+
+        if ((uintptr_t)message & 0x3u)
+        {
+            hashcrypt_sha_staged(base, message, blkNum);
+        }
+        else
+        {
+            /* poll waiting. */
+            while (0 == (base->STATUS & HASHCRYPT_STATUS_WAITING_MASK))
+            {
+            }
+            base->MEMADDR = FSL_FEATURE_HASHCRYPT_ALIAS_OFFSET | HASHCRYPT_MEMADDR_BASE(message);
+            base->MEMCTRL = HASHCRYPT_MEMCTRL_MASTER(1) | HASHCRYPT_MEMCTRL_COUNT(blkNum);
+            while (0 == (base->STATUS & HASHCRYPT_STATUS_DIGEST_AKA_OUTDATA_MASK))
+            {
+            }
+        }
+        message += blkBytes;
+        messageSize -= blkBytes;
+
+        if (messageSize >= SHA_BLOCK_SIZE)
+        {
+            hashcrypt_sha_chunk_done(base, ctxInternal, total - messageSize, total);
+        }
+    }
+
+    /* copy last incomplete message bytes into internal block */
+    hashcrypt_memcpy(&ctxInternal->blk.b[0], message, messageSize);
+    ctxInternal->blksz = messageSize;
+    hashcrypt_sha_chunk_done(base, ctxInternal, total, total);
+    return kStatus_Success;
+}
+
+/*!
+ * @brief Finalize the running hash to make digest.
+ *
+ * This function empties the internal buffer, adds padding bits, and generates final digest.
+ *
+ * @param base SHA peripheral base address.
+ * @param ctxInternal Internal context.
+ * @return kStatus_Success.
+ */
+static status_t hashcrypt_sha_finalize(HASHCRYPT_Type *base, hashcrypt_sha_ctx_internal_t *ctxInternal)
+{
+    hashcrypt_sha_block_t lastBlock;
+
+    memset(&lastBlock, 0, sizeof(hashcrypt_sha_block_t));
+
+    /* this is last call, so need to flush buffered message bytes along with padding */
+    if (ctxInternal->blksz <= 55u)
+    {
+        /* last data is 440 bits or less. */
+        hashcrypt_memcpy(&lastBlock.b[0], &ctxInternal->blk.b[0], ctxInternal->blksz);
+        lastBlock.b[ctxInternal->blksz] = (uint8_t)0x80U;
+        lastBlock.w[SHA_BLOCK_SIZE / 4 - 1] = swap_bytes(8u * ctxInternal->fullMessageSize);
+        hashcrypt_sha_one_block(base, &lastBlock.b[0]);
+    }
+    else
+    {
+        if (ctxInternal->blksz < SHA_BLOCK_SIZE)
+        {
             ctxInternal->blk.b[ctxInternal->blksz] = (uint8_t)0x80U;
             for (uint32_t i = ctxInternal->blksz + 1u; i < SHA_BLOCK_SIZE; i++)
             {
@@ -602,6 +1239,20 @@ status_t HASHCRYPT_SHA_Init(HASHCRYPT_Type *base, hashcrypt_hash_ctx_t *ctx, has
 #endif /* HASHCRYPT_SHA_DO_WIPE_CONTEXT */
     ctxInternal->state = kHASHCRYPT_HashInit;
     ctxInternal->fullMessageSize = 0;
+    ctxInternal->next = NULL;
+    ctxInternal->busy = false;
+    memset(&ctxInternal->stats, 0, sizeof(ctxInternal->stats));
+    ctxInternal->progress = NULL;
+    ctxInternal->progressData = NULL;
+    hashcrypt_sha_forget(base, ctxInternal);
+#if HASHCRYPT_SHA_SOFTWARE
+    ctxInternal->software = false;
+    if ((algo == kHASHCRYPT_Sha512) && (0U == (base->CONFIG & HASHCRYPT_CONFIG_SHA512_MASK)))
+    {
+        ctxInternal->software = true;
+        (void)SHA_SOFT_Init(&ctxInternal->soft, kSHA_SOFT_Sha512, kSHA_SOFT_Auto);
+    }
+#endif /* HASHCRYPT_SHA_SOFTWARE */
     return kStatus_Success;
 }
 
@@ -622,7 +1273,6 @@ status_t HASHCRYPT_SHA_Init(HASHCRYPT_Type *base, hashcrypt_hash_ctx_t *ctx, has
  */
 status_t HASHCRYPT_SHA_Update(HASHCRYPT_Type *base, hashcrypt_hash_ctx_t *ctx, const uint8_t *input, size_t inputSize)
 {
-    bool isUpdateState;
     status_t status;
     hashcrypt_sha_ctx_internal_t *ctxInternal;
     size_t blockSize;
@@ -641,52 +1291,149 @@ status_t HASHCRYPT_SHA_Update(HASHCRYPT_Type *base, hashcrypt_hash_ctx_t *ctx, c
     }
 #endif /* HASHCRYPT_SHA_DO_CHECK_CONTEXT */
 
-    ctxInternal->fullMessageSize += inputSize;
+    /* non-blocking update of this context still in progress */
+    if (ctxInternal->busy)
+    {
+        return kStatus_HASHCRYPT_Again;
+    }
+
+#if HASHCRYPT_SHA_SOFTWARE
+    if (ctxInternal->software)
+    {
+        ctxInternal->fullMessageSize += inputSize;
+        ctxInternal->stats.bytes += inputSize;
+        for (size_t done = 0, chunk; done < inputSize; done += chunk)
+        {
+            chunk = MIN(inputSize - done, HASHCRYPT_SHA_CHUNK_BLOCKS * SHA_BLOCK_SIZE);
+            SHA_SOFT_Update(&ctxInternal->soft, input + done, chunk);
+            hashcrypt_sha_chunk_done(base, ctxInternal, done + chunk, inputSize);
+        }
+        return kStatus_Success;
+    }
+#endif /* HASHCRYPT_SHA_SOFTWARE */
+
     blockSize = SHA_BLOCK_SIZE;
     /* if we are still less than 64 bytes, keep only in context */
     if ((ctxInternal->blksz + inputSize) <= blockSize)
     {
         hashcrypt_memcpy((&ctxInternal->blk.b[0]) + ctxInternal->blksz, input, inputSize);
         ctxInternal->blksz += inputSize;
+        ctxInternal->fullMessageSize += inputSize;
+        ctxInternal->stats.bytes += inputSize;
         return kStatus_Success;
     }
-    else
+
+    /* start NEW hash or continue the running hash, non-blocking hashes wait meanwhile */
+    hashcrypt_sha_hold(base);
+    status = hashcrypt_sha_take(base, ctxInternal);
+    if (kStatus_Success == status)
     {
-        isUpdateState = ctxInternal->state == kHASHCRYPT_HashUpdate;
-        if (!isUpdateState)
-        {
-            /* start NEW hash */
-            hashcrypt_engine_init(base, ctxInternal->algo);
-            ctxInternal->state = kHASHCRYPT_HashUpdate;
-        }
-    }
+        ctxInternal->fullMessageSize += inputSize;
+        ctxInternal->stats.bytes += inputSize;
 
-    /* process message data */
-    status = hashcrypt_sha_process_message_data(base, ctxInternal, input, inputSize);
+        /* process message data */
+        status = hashcrypt_sha_process_message_data(base, ctxInternal, input, inputSize);
+    }
+    hashcrypt_sha_release(base);
     return status;
 }
 
+#if HASHCRYPT_SHA_SOFTWARE
 /*!
- * brief Finalize hashing
- *
- * Outputs the final hash (computed by HASHCRYPT_HASH_Update()) and erases the context.
+ * @brief Finishes a hash context running in software.
  *
- * param base HASHCRYPT peripheral base address
- * param[in,out] ctx Input hash context
- * param[out] output Output hash data
- * param[in,out] outputSize Optional parameter (can be passed as NULL). On function entry, it specifies the size of
- * output[] buffer. On function return, it stores the number of updated output bytes.
- * return Status of the hash finish operation
+ * @param[in,out] ctx Hash context.
+ * @param[out] output Output hash data.
+ * @param[in,out] outputSize Optional size of output, see HASHCRYPT_SHA_Finish().
+ * @return kStatus_Success.
  */
-status_t HASHCRYPT_SHA_Finish(HASHCRYPT_Type *base, hashcrypt_hash_ctx_t *ctx, uint8_t *output, size_t *outputSize)
+static status_t hashcrypt_sha_soft_finish(hashcrypt_hash_ctx_t *ctx, uint8_t *output, size_t *outputSize)
 {
-    size_t algOutSize = 0;
-    status_t status;
-    hashcrypt_sha_ctx_internal_t *ctxInternal;
-#ifdef HASHCRYPT_SHA_DO_CHECK_CONTEXT
-    uint32_t *ctxW;
-    uint32_t i;
-#endif /* HASHCRYPT_SHA_DO_CHECK_CONTEXT */
+    hashcrypt_sha_ctx_internal_t *ctxInternal = (hashcrypt_sha_ctx_internal_t *)ctx;
+    uint8_t digest[SHA_SOFT_SHA512_SIZE];
+    size_t digestSize =
+        (ctxInternal->soft.algo == kSHA_SOFT_Sha512) ? SHA_SOFT_SHA512_SIZE : SHA_SOFT_SHA256_SIZE;
+
+    SHA_SOFT_Finish(&ctxInternal->soft, digest);
+    if ((NULL != outputSize) && (*outputSize < digestSize))
+    {
+        digestSize = *outputSize;
+    }
+    hashcrypt_memcpy(output, digest, digestSize);
+    if (NULL != outputSize)
+    {
+        *outputSize = digestSize;
+    }
+    memset(digest, 0, sizeof(digest));
+
+#ifdef HASHCRYPT_SHA_DO_WIPE_CONTEXT
+    memset(ctx, 0, sizeof(*ctx));
+#endif /* HASHCRYPT_SHA_DO_WIPE_CONTEXT */
+    return kStatus_Success;
+}
+
+/*!
+ * brief Runs a hash context in software.
+ *
+ * param base HASHCRYPT peripheral base address.
+ * param[in,out] ctx Hash context, kHASHCRYPT_Sha256 or kHASHCRYPT_Sha512.
+ * param impl Software implementation, see SHA_SOFT_Init().
+ * return kStatus_Success or kStatus_InvalidArgument.
+ */
+status_t HASHCRYPT_SHA_SetSoftware(HASHCRYPT_Type *base, hashcrypt_hash_ctx_t *ctx, sha_soft_impl_t impl)
+{
+    hashcrypt_sha_ctx_internal_t *ctxInternal = (hashcrypt_sha_ctx_internal_t *)ctx;
+    sha_soft_algo_t algo;
+
+    if ((NULL == ctxInternal) || (ctxInternal->state != kHASHCRYPT_HashInit) ||
+        (ctxInternal->fullMessageSize != 0u) || ctxInternal->busy)
+    {
+        return kStatus_InvalidArgument;
+    }
+
+    switch (ctxInternal->algo)
+    {
+        case kHASHCRYPT_Sha256:
+            algo = kSHA_SOFT_Sha256;
+            break;
+        case kHASHCRYPT_Sha512:
+            algo = kSHA_SOFT_Sha512;
+            break;
+        default:
+            return kStatus_InvalidArgument;
+    }
+
+    if (!SHA_SOFT_Init(&ctxInternal->soft, algo, impl))
+    {
+        return kStatus_InvalidArgument;
+    }
+    ctxInternal->software = true;
+
+    return kStatus_Success;
+}
+#endif /* HASHCRYPT_SHA_SOFTWARE */
+
+/*!
+ * brief Finalize hashing
+ *
+ * Outputs the final hash (computed by HASHCRYPT_HASH_Update()) and erases the context.
+ *
+ * param base HASHCRYPT peripheral base address
+ * param[in,out] ctx Input hash context
+ * param[out] output Output hash data
+ * param[in,out] outputSize Optional parameter (can be passed as NULL). On function entry, it specifies the size of
+ * output[] buffer. On function return, it stores the number of updated output bytes.
+ * return Status of the hash finish operation
+ */
+status_t HASHCRYPT_SHA_Finish(HASHCRYPT_Type *base, hashcrypt_hash_ctx_t *ctx, uint8_t *output, size_t *outputSize)
+{
+    size_t algOutSize = 0;
+    status_t status;
+    hashcrypt_sha_ctx_internal_t *ctxInternal;
+#ifdef HASHCRYPT_SHA_DO_CHECK_CONTEXT
+    uint32_t *ctxW;
+    uint32_t i;
+#endif /* HASHCRYPT_SHA_DO_CHECK_CONTEXT */
 
     if (output == NULL)
     {
@@ -702,9 +1449,26 @@ status_t HASHCRYPT_SHA_Finish(HASHCRYPT_Type *base, hashcrypt_hash_ctx_t *ctx, u
     }
 #endif /* HASHCRYPT_SHA_DO_CHECK_CONTEXT */
 
-    if (ctxInternal->state == kHASHCRYPT_HashInit)
+    /* non-blocking update of this context still in progress */
+    if (ctxInternal->busy)
+    {
+        return kStatus_HASHCRYPT_Again;
+    }
+
+#if HASHCRYPT_SHA_SOFTWARE
+    if (ctxInternal->software)
+    {
+        return hashcrypt_sha_soft_finish(ctx, output, outputSize);
+    }
+#endif /* HASHCRYPT_SHA_SOFTWARE */
+
+    /* start NEW hash or continue the running hash, non-blocking hashes wait meanwhile */
+    hashcrypt_sha_hold(base);
+    status = hashcrypt_sha_take(base, ctxInternal);
+    if (kStatus_Success != status)
     {
-        hashcrypt_engine_init(base, ctxInternal->algo);
+        hashcrypt_sha_release(base);
+        return status;
     }
 
     size_t outSize = 0u;
@@ -739,6 +1503,8 @@ status_t HASHCRYPT_SHA_Finish(HASHCRYPT_Type *base, hashcrypt_hash_ctx_t *ctx, u
     }
 
     hashcrypt_get_data(base, (uint32_t *)output, algOutSize);
+    hashcrypt_sha_forget(base, ctxInternal);
+    hashcrypt_sha_release(base);
 
 #ifdef HASHCRYPT_SHA_DO_WIPE_CONTEXT
     ctxW = (uint32_t *)ctx;
@@ -750,6 +1516,277 @@ status_t HASHCRYPT_SHA_Finish(HASHCRYPT_Type *base, hashcrypt_hash_ctx_t *ctx, u
     return status;
 }
 
+/*!
+ * brief Abandons an unfinished hash.
+ *
+ * Releases HASHCRYPT if the context holds it and removes the context from the queue of non-blocking hashes. Its
+ * callback is not invoked. Hashes waiting for HASHCRYPT are started. The context shall be initialized by
+ * HASHCRYPT_SHA_Init() before it is used again.
+ *
+ * param base HASHCRYPT peripheral base address.
+ * param ctx Hash context.
+ * return kStatus_Success, kStatus_InvalidArgument, or kStatus_HASHCRYPT_Again if an AHB master run of the context
+ * is in progress, then the context can be aborted once its callback is invoked.
+ */
+status_t HASHCRYPT_SHA_Abort(HASHCRYPT_Type *base, hashcrypt_hash_ctx_t *ctx)
+{
+    hashcrypt_sha_ctx_internal_t *ctxInternal = (hashcrypt_sha_ctx_internal_t *)ctx;
+    hashcrypt_sha_ctx_internal_t **link;
+
+    if (NULL == ctxInternal)
+    {
+        return kStatus_InvalidArgument;
+    }
+
+    uint32_t regPrimask = DisableGlobalIRQ();
+    if (s_shaActive == ctxInternal)
+    {
+        EnableGlobalIRQ(regPrimask);
+        return kStatus_HASHCRYPT_Again;
+    }
+
+    for (link = &s_shaQueue; NULL != *link; link = &(*link)->next)
+    {
+        if (*link == ctxInternal)
+        {
+            *link = ctxInternal->next;
+            break;
+        }
+    }
+    ctxInternal->next = NULL;
+    ctxInternal->busy = false;
+    if (s_shaOwner == ctxInternal)
+    {
+        s_shaOwner = NULL;
+    }
+    EnableGlobalIRQ(regPrimask);
+
+    /* hashes that waited for the released HASHCRYPT */
+    hashcrypt_sha_schedule(base);
+
+    return kStatus_Success;
+}
+
+/*!
+ * brief Returns the counters of a hash context.
+ *
+ * param base HASHCRYPT peripheral base address.
+ * param ctx Hash context.
+ * param[out] stats Counters since HASHCRYPT_SHA_Init().
+ */
+void HASHCRYPT_SHA_GetStats(HASHCRYPT_Type *base, const hashcrypt_hash_ctx_t *ctx, hashcrypt_sha_stats_t *stats)
+{
+    const hashcrypt_sha_ctx_internal_t *ctxInternal = (const hashcrypt_sha_ctx_internal_t *)ctx;
+
+    uint32_t regPrimask = DisableGlobalIRQ();
+    *stats = ctxInternal->stats;
+    EnableGlobalIRQ(regPrimask);
+}
+
+/*!
+ * brief Sets the progress callback of a hash context.
+ *
+ * param base HASHCRYPT peripheral base address.
+ * param[in,out] ctx Hash context.
+ * param progress Progress callback, NULL to disable.
+ * param userData User data passed to the callback.
+ */
+void HASHCRYPT_SHA_SetProgress(HASHCRYPT_Type *base,
+                               hashcrypt_hash_ctx_t *ctx,
+                               hashcrypt_sha_progress_t progress,
+                               void *userData)
+{
+    hashcrypt_sha_ctx_internal_t *ctxInternal = (hashcrypt_sha_ctx_internal_t *)ctx;
+
+    ctxInternal->progress = progress;
+    ctxInternal->progressData = userData;
+}
+
+/*!
+ * brief Sets the hook invoked between chunks of all blocking hash updates.
+ *
+ * param base HASHCRYPT peripheral base address.
+ * param hook Yield hook, NULL to disable.
+ * param userData User data passed to the hook.
+ */
+void HASHCRYPT_SHA_SetYieldHook(HASHCRYPT_Type *base, hashcrypt_yield_hook_t hook, void *userData)
+{
+    uint32_t regPrimask = DisableGlobalIRQ();
+    s_shaYield = hook;
+    s_shaYieldData = userData;
+    EnableGlobalIRQ(regPrimask);
+}
+
+/*!
+ * brief Sets an HMAC-SHA256 key.
+ *
+ * param base HASHCRYPT peripheral base address.
+ * param[out] key HMAC key.
+ * param keyData Key bytes.
+ * param keySize Size of keyData in bytes.
+ * return kStatus_Success, kStatus_InvalidArgument or status of the hash of a long key.
+ */
+status_t HASHCRYPT_HMAC_SetKey(HASHCRYPT_Type *base, hashcrypt_hmac_key_t *key, const uint8_t *keyData, size_t keySize)
+{
+    uint8_t k0[SHA_BLOCK_SIZE] = {0};
+    status_t status = kStatus_Success;
+
+    if ((NULL == key) || ((NULL == keyData) && (keySize > 0u)))
+    {
+        return kStatus_InvalidArgument;
+    }
+
+    /* K0 is the key padded with zeros, or its digest for keys longer than the block */
+    if (keySize > SHA_BLOCK_SIZE)
+    {
+        status = HASHCRYPT_SHA(base, kHASHCRYPT_Sha256, keyData, keySize, k0, NULL);
+    }
+    else
+    {
+        hashcrypt_memcpy(k0, keyData, keySize);
+    }
+
+    if (kStatus_Success == status)
+    {
+        hashcrypt_memcpy(key->k0, k0, sizeof(k0));
+    }
+    memset(k0, 0, sizeof(k0));
+
+    return status;
+}
+
+/*!
+ * @brief Starts a hash whose first block is the padded key XOR ipad or opad.
+ *
+ * The padded key block fills the context block and is hashed as a normal first block.
+ *
+ * @param base Hashcrypt peripheral base address.
+ * @param[out] ctx Hash context.
+ * @param key HMAC key.
+ * @param pad HMAC_IPAD for the inner hash, HMAC_OPAD for the outer hash.
+ */
+static void hashcrypt_hmac_start(HASHCRYPT_Type *base,
+                                 hashcrypt_hash_ctx_t *ctx,
+                                 const hashcrypt_hmac_key_t *key,
+                                 uint8_t pad)
+{
+    hashcrypt_sha_ctx_internal_t *ctxInternal = (hashcrypt_sha_ctx_internal_t *)ctx;
+
+    (void)HASHCRYPT_SHA_Init(base, ctx, kHASHCRYPT_Sha256);
+    for (uint32_t i = 0; i < SHA_BLOCK_SIZE; i++)
+    {
+        ctxInternal->blk.b[i] = key->k0[i] ^ pad;
+    }
+    ctxInternal->blksz = SHA_BLOCK_SIZE;
+    ctxInternal->fullMessageSize = SHA_BLOCK_SIZE;
+}
+
+/*!
+ * brief Starts an HMAC-SHA256 computation.
+ *
+ * param base HASHCRYPT peripheral base address.
+ * param[out] ctx HMAC context.
+ * param key HMAC key set by HASHCRYPT_HMAC_SetKey(). Shall stay valid until HASHCRYPT_HMAC_Finish().
+ * return kStatus_Success or kStatus_InvalidArgument.
+ */
+status_t HASHCRYPT_HMAC_Init(HASHCRYPT_Type *base, hashcrypt_hmac_ctx_t *ctx, const hashcrypt_hmac_key_t *key)
+{
+    if ((NULL == ctx) || (NULL == key))
+    {
+        return kStatus_InvalidArgument;
+    }
+
+    hashcrypt_hmac_start(base, &ctx->hash, key, HMAC_IPAD);
+    ctx->key = key;
+
+    return kStatus_Success;
+}
+
+/*!
+ * brief Adds data to an HMAC-SHA256 computation.
+ *
+ * param base HASHCRYPT peripheral base address.
+ * param[in,out] ctx HMAC context.
+ * param input Input data.
+ * param inputSize Size of input data in bytes.
+ * return Status of the inner hash update, see HASHCRYPT_SHA_Update().
+ */
+status_t HASHCRYPT_HMAC_Update(HASHCRYPT_Type *base, hashcrypt_hmac_ctx_t *ctx, const uint8_t *input, size_t inputSize)
+{
+    return HASHCRYPT_SHA_Update(base, &ctx->hash, input, inputSize);
+}
+
+/*!
+ * brief Finishes an HMAC-SHA256 computation.
+ *
+ * param base HASHCRYPT peripheral base address.
+ * param[in,out] ctx HMAC context.
+ * param[out] mac Output MAC.
+ * param macSize Size of mac in bytes, up to HASHCRYPT_HMAC_SIZE. Shorter MACs are truncated.
+ * return kStatus_Success, kStatus_InvalidArgument or status of the hash functions.
+ */
+status_t HASHCRYPT_HMAC_Finish(HASHCRYPT_Type *base, hashcrypt_hmac_ctx_t *ctx, uint8_t *mac, size_t macSize)
+{
+    uint8_t inner[HASHCRYPT_HMAC_SIZE];
+    size_t outSize = macSize;
+    status_t status;
+
+    if ((NULL == mac) || (macSize == 0u) || (macSize > HASHCRYPT_HMAC_SIZE) || (NULL == ctx->key))
+    {
+        return kStatus_InvalidArgument;
+    }
+
+    status = HASHCRYPT_SHA_Finish(base, &ctx->hash, inner, NULL);
+    if (kStatus_Success == status)
+    {
+        /* outer hash of the inner digest fits one block after the opad block */
+        hashcrypt_hmac_start(base, &ctx->hash, ctx->key, HMAC_OPAD);
+        status = HASHCRYPT_SHA_Update(base, &ctx->hash, inner, sizeof(inner));
+    }
+    if (kStatus_Success == status)
+    {
+        status = HASHCRYPT_SHA_Finish(base, &ctx->hash, mac, &outSize);
+    }
+    memset(inner, 0, sizeof(inner));
+    ctx->key = NULL;
+
+    return status;
+}
+
+/*!
+ * brief Computes HMAC-SHA256 of a message in one call.
+ *
+ * param base HASHCRYPT peripheral base address.
+ * param key HMAC key set by HASHCRYPT_HMAC_SetKey().
+ * param input Input data.
+ * param inputSize Size of input data in bytes.
+ * param[out] mac Output MAC.
+ * param macSize Size of mac in bytes, up to HASHCRYPT_HMAC_SIZE. Shorter MACs are truncated.
+ * return kStatus_Success, kStatus_InvalidArgument or status of the hash functions.
+ */
+status_t HASHCRYPT_HMAC(HASHCRYPT_Type *base,
+                        const hashcrypt_hmac_key_t *key,
+                        const uint8_t *input,
+                        size_t inputSize,
+                        uint8_t *mac,
+                        size_t macSize)
+{
+    hashcrypt_hmac_ctx_t ctx;
+    status_t status;
+
+    status = HASHCRYPT_HMAC_Init(base, &ctx, key);
+    if (kStatus_Success == status)
+    {
+        status = HASHCRYPT_HMAC_Update(base, &ctx, input, inputSize);
+    }
+    if (kStatus_Success == status)
+    {
+        status = HASHCRYPT_HMAC_Finish(base, &ctx, mac, macSize);
+    }
+
+    return status;
+}
+
 /*!
  * brief Initializes the HASHCRYPT handle for background hashing.
  *
@@ -773,7 +1810,6 @@ void HASHCRYPT_SHA_SetCallback(HASHCRYPT_Type *base,
 {
     hashcrypt_sha_ctx_internal_t *ctxInternal;
 
-    s_ctx = ctx;
     ctxInternal = (hashcrypt_sha_ctx_internal_t *)ctx;
     ctxInternal->hashCallback = callback;
     ctxInternal->userData = userData;
@@ -784,19 +1820,25 @@ void HASHCRYPT_SHA_SetCallback(HASHCRYPT_Type *base,
 /*!
 * brief Create running hash on given data.
 *
-* Configures the HASHCRYPT to compute new running hash as AHB master
-* and returns immediately. HASHCRYPT AHB Master mode supports only aligned \p input
-* address and can be called only once per continuous block of data. Every call to this function
-* must be preceded with HASHCRYPT_SHA_Init() and finished with HASHCRYPT_SHA_Finish().
-* Once callback function is invoked by HASHCRYPT isr, it should set a flag
-* for the main application to finalize the hashing (padding) and to read out the final digest
-* by calling HASHCRYPT_SHA_Finish().
+* Configures the HASHCRYPT to add one segment of the message to the running hash as AHB master
+* and returns immediately. The message can be passed as a chain of segments of any size and alignment,
+* started with HASHCRYPT_SHA_Init() and finished with HASHCRYPT_SHA_Finish(). Bytes that do not fill
+* a block are kept in the context and merged with the next segment. Word aligned input is read in AHB master
+* bursts, unaligned input is copied to the context one block at a time.
+* The callback is invoked by HASHCRYPT isr once the segment is hashed, or directly if it only fills
+* the context block. The next segment, or HASHCRYPT_SHA_Finish(), can be passed after that.
+*
+* Several contexts can be started at once. If HASHCRYPT is busy with another hash or with a non-blocking AES
+* operation, the context is queued and started by HASHCRYPT isr in order. HASHCRYPT cannot save a running hash and
+* load it back, so a hash keeps HASHCRYPT from its first segment until HASHCRYPT_SHA_Finish() or
+* HASHCRYPT_SHA_Abort(). Queued hashes of other contexts wait for that, and blocking hash and AES functions return
+* kStatus_HASHCRYPT_Again meanwhile.
 *
 * param base HASHCRYPT peripheral base address
-* param ctx Specifies callback. Last incomplete 512-bit block of the input is copied into clear buffer for padding.
-* param input 32-bit word aligned pointer to Input data.
-* param inputSize Size of input data in bytes (must be word aligned)
-* return Status of the hash update operation.
+* param ctx Hash context with the callback.
+* param input Input data, shall stay valid until the callback is invoked.
+* param inputSize Size of input data in bytes.
+* return kStatus_Success, or kStatus_HASHCRYPT_Again if the previous segment is still in progress.
 */
 status_t HASHCRYPT_SHA_UpdateNonBlocking(HASHCRYPT_Type *base,
                                          hashcrypt_hash_ctx_t *ctx,
@@ -804,19 +1846,14 @@ status_t HASHCRYPT_SHA_UpdateNonBlocking(HASHCRYPT_Type *base,
                                          size_t inputSize)
 {
     hashcrypt_sha_ctx_internal_t *ctxInternal;
-    uint32_t numBlocks;
     status_t status;
+    size_t toCopy;
 
     if (inputSize == 0)
     {
         return kStatus_Success;
     }
 
-    if ((uintptr_t)input & 0x3U)
-    {
-        return kStatus_Fail;
-    }
-
     ctxInternal = (hashcrypt_sha_ctx_internal_t *)ctx;
     status = hashcrypt_sha_check_context(base, ctxInternal);
     if (kStatus_Success != status)
@@ -824,44 +1861,53 @@ status_t HASHCRYPT_SHA_UpdateNonBlocking(HASHCRYPT_Type *base,
         return status;
     }
 
-    ctxInternal->fullMessageSize = inputSize;
-    ctxInternal->remainingBlcks = inputSize / SHA_BLOCK_SIZE;
-    ctxInternal->blksz = inputSize % SHA_BLOCK_SIZE;
-
-    /* copy last incomplete block to context */
-    if ((ctxInternal->blksz > 0) && (ctxInternal->blksz <= SHA_BLOCK_SIZE))
+    /* previous segment still in progress */
+    if (ctxInternal->busy)
     {
-        hashcrypt_memcpy((&ctxInternal->blk.b[0]), input + SHA_BLOCK_SIZE * ctxInternal->remainingBlcks,
-                         ctxInternal->blksz);
+        return kStatus_HASHCRYPT_Again;
     }
 
-    if (ctxInternal->remainingBlcks >= SHA_MASTER_MAX_BLOCKS)
+    ctxInternal->fullMessageSize += inputSize;
+    ctxInternal->stats.bytes += inputSize;
+
+#if HASHCRYPT_SHA_SOFTWARE
+    if (ctxInternal->software)
     {
-        numBlocks = SHA_MASTER_MAX_BLOCKS - 1;
+        SHA_SOFT_Update(&ctxInternal->soft, input, inputSize);
+        if (NULL != ctxInternal->hashCallback)
+        {
+            ctxInternal->hashCallback(HASHCRYPT, ctx, status, ctxInternal->userData);
+        }
+        return status;
     }
-    else
+#endif /* HASHCRYPT_SHA_SOFTWARE */
+
+    /* segment fits into the context block, no full block to hash yet, invoke callback directly */
+    if ((ctxInternal->blksz + inputSize) <= SHA_BLOCK_SIZE)
     {
-        numBlocks = ctxInternal->remainingBlcks;
+        hashcrypt_memcpy(&ctxInternal->blk.b[ctxInternal->blksz], input, inputSize);
+        ctxInternal->blksz += inputSize;
+        if (NULL != ctxInternal->hashCallback)
+        {
+            ctxInternal->hashCallback(HASHCRYPT, ctx, status, ctxInternal->userData);
+        }
+        return status;
     }
-    /* update remainingBlks so that ISR can run another hash if necessary */
-    ctxInternal->remainingBlcks -= numBlocks;
 
-    /* compute hash using AHB Master mode for full blocks */
-    if (numBlocks > 0)
-    {
-        ctxInternal->state = kHASHCRYPT_HashUpdate;
-        hashcrypt_engine_init(base, ctxInternal->algo);
+    /* complete the context block, full blocks of the rest are read from input and the tail copied at the end */
+    toCopy = SHA_BLOCK_SIZE - ctxInternal->blksz;
+    hashcrypt_memcpy(&ctxInternal->blk.b[ctxInternal->blksz], input, toCopy);
+    ctxInternal->blksz = SHA_BLOCK_SIZE;
+    ctxInternal->input = input + toCopy;
+    ctxInternal->remainingBlcks = (inputSize - toCopy) / SHA_BLOCK_SIZE;
+    ctxInternal->tailSize = (inputSize - toCopy) % SHA_BLOCK_SIZE;
+    ctxInternal->busy = true;
 
-        /* Enable digest and error interrupts and start hash */
-        base->INTENSET = HASHCRYPT_INTENCLR_DIGEST_MASK | HASHCRYPT_INTENCLR_ERROR_MASK;
-        base->MEMADDR = FSL_FEATURE_HASHCRYPT_ALIAS_OFFSET | HASHCRYPT_MEMADDR_BASE(input);
-        base->MEMCTRL = HASHCRYPT_MEMCTRL_MASTER(1) | HASHCRYPT_MEMCTRL_COUNT(numBlocks);
-    }
-    /* no full blocks, invoke callback directly */
-    else
-    {
-        ctxInternal->hashCallback(HASHCRYPT, ctx, status, ctxInternal->userData);
-    }
+    /* compute hash using AHB Master mode, now or once HASHCRYPT gets free */
+    uint32_t regPrimask = DisableGlobalIRQ();
+    hashcrypt_sha_enqueue(ctxInternal);
+    EnableGlobalIRQ(regPrimask);
+    hashcrypt_sha_schedule(base);
 
     return status;
 }
@@ -871,6 +1917,7 @@ status_t HASHCRYPT_SHA_UpdateNonBlocking(HASHCRYPT_Type *base,
  *
  * Sets the AES key for encryption/decryption with the hashcrypt_handle_t structure.
  * The hashcrypt_handle_t input argument specifies key source.
+ * The background AES callback of the handle is cleared.
  *
  * param   base HASHCRYPT peripheral base address.
  * param   handle Handle used for the request.
@@ -901,6 +1948,21 @@ status_t HASHCRYPT_AES_SetKey(HASHCRYPT_Type *base, hashcrypt_handle_t *handle,
         return kStatus_InvalidArgument;
     }
 
+    /* no background callback until HASHCRYPT_AES_SetCallback() is called */
+    handle->aesCallback = NULL;
+    handle->userData = NULL;
+    handle->aesProgress = NULL;
+    handle->progressUserData = NULL;
+
+    /* CMAC subkeys are derived on first use */
+    handle->cmacSubkeys = false;
+
+    /* software context holds the previous key */
+    handle->soft = NULL;
+
+    /* key may have changed, streaming CTR context has to reload it */
+    s_ctrOwner = NULL;
+
     if (handle->keyType == kHASHCRYPT_SecretKey)
     {
         /* for kHASHCRYPT_SecretKey just return Success */
@@ -913,390 +1975,1794 @@ status_t HASHCRYPT_AES_SetKey(HASHCRYPT_Type *base, hashcrypt_handle_t *handle,
         {
             return kStatus_InvalidArgument;
         }
-
-        /* move the key by 32-bit words */
-        int i = 0;
-        while (aesKeySize)
+
+        /* move the key by 32-bit words */
+        int i = 0;
+        while (aesKeySize)
+        {
+            aesKeySize -= sizeof(uint32_t);
+            handle->keyWord[i] = ((uint32_t *)(uintptr_t)key)[i];
+            i++;
+        }
+
+#if HASHCRYPT_AES_SOFTWARE
+        return HASHCRYPT_AES_SetSoftware(base, handle, &handle->softCtx, kAES_SOFT_Auto);
+#endif
+    }
+    else
+    {
+        return kStatus_InvalidArgument;
+    }
+
+    return kStatus_Success;
+}
+
+/*!
+ * brief Selects software AES for the blocking ECB, CBC and CTR APIs of a handle.
+ *
+ * param base HASHCRYPT peripheral base address.
+ * param[in,out] handle Handle with a user key, set by HASHCRYPT_AES_SetKey().
+ * param[out] ctx Software AES context to expand the key into, NULL to use HASHCRYPT again.
+ * param impl Software implementation, see aes_soft_impl_t.
+ * return kStatus_Success, or kStatus_InvalidArgument for secret (PUF) keys, which software cannot read.
+ */
+status_t HASHCRYPT_AES_SetSoftware(HASHCRYPT_Type *base,
+                                   hashcrypt_handle_t *handle,
+                                   aes_soft_ctx_t *ctx,
+                                   aes_soft_impl_t impl)
+{
+    handle->soft = NULL;
+
+    if (ctx == NULL)
+    {
+        return kStatus_Success;
+    }
+
+    if ((handle->keyType != kHASHCRYPT_UserKey) || (handle->keySize == kHASHCRYPT_InvalidKey))
+    {
+        return kStatus_InvalidArgument;
+    }
+
+    /* keyWord holds the key bytes in memory order */
+    if (!AES_SOFT_SetKey(ctx, (const uint8_t *)handle->keyWord, 16u + 8u * (size_t)handle->keySize, impl))
+    {
+        return kStatus_InvalidArgument;
+    }
+    handle->soft = ctx;
+
+    return kStatus_Success;
+}
+
+/*!
+ * brief Installs the progress callback for blocking AES operations.
+ *
+ * param base HASHCRYPT peripheral base address.
+ * param[in,out] handle Handle used for the request. Shall be configured with HASHCRYPT_AES_SetKey() first.
+ * param callback Progress callback function, NULL to disable progress reporting.
+ * param userData User data passed as an argument to callback function.
+ */
+void HASHCRYPT_AES_SetProgressCallback(HASHCRYPT_Type *base,
+                                       hashcrypt_handle_t *handle,
+                                       hashcrypt_aes_progress_t callback,
+                                       void *userData)
+{
+    handle->aesProgress = callback;
+    handle->progressUserData = userData;
+}
+
+/*!
+ * brief Encrypts AES on one or multiple 128-bit block(s).
+ *
+ * Encrypts AES.
+ * The source plaintext and destination ciphertext can overlap in system memory.
+ *
+ * param base HASHCRYPT peripheral base address
+ * param handle Handle used for this request.
+ * param plaintext Input plain text to encrypt
+ * param[out] ciphertext Output cipher text
+ * param size Size of input and output data in bytes. Must be multiple of 16 bytes.
+ * return Status from encrypt operation
+ */
+status_t HASHCRYPT_AES_EncryptEcb(
+    HASHCRYPT_Type *base, hashcrypt_handle_t *handle, const uint8_t *plaintext, uint8_t *ciphertext, size_t size)
+{
+    status_t status = kStatus_Fail;
+
+    if ((size % 16u) || (handle->keySize == kHASHCRYPT_InvalidKey))
+    {
+        return kStatus_InvalidArgument;
+    }
+
+    if (handle->soft)
+    {
+        AES_SOFT_EncryptEcb(handle->soft, plaintext, ciphertext, size);
+        return kStatus_Success;
+    }
+
+    status = hashcrypt_aes_engine_init(base, handle, kHASHCRYPT_AesEcb, AES_ENCRYPT);
+    if (status != kStatus_Success)
+    {
+        return status;
+    }
+
+    /* load message and get result */
+    status = hashcrypt_aes_one_block(base, handle, plaintext, ciphertext, size);
+
+    return status;
+}
+
+/*!
+ * brief Decrypts AES on one or multiple 128-bit block(s).
+ *
+ * Decrypts AES.
+ * The source ciphertext and destination plaintext can overlap in system memory.
+ *
+ * param base HASHCRYPT peripheral base address
+ * param handle Handle used for this request.
+ * param ciphertext Input plain text to encrypt
+ * param[out] plaintext Output cipher text
+ * param size Size of input and output data in bytes. Must be multiple of 16 bytes.
+ * return Status from decrypt operation
+ */
+status_t HASHCRYPT_AES_DecryptEcb(
+    HASHCRYPT_Type *base, hashcrypt_handle_t *handle, const uint8_t *ciphertext, uint8_t *plaintext, size_t size)
+{
+    status_t status = kStatus_Fail;
+
+    if ((size % 16u) || (handle->keySize == kHASHCRYPT_InvalidKey))
+    {
+        return kStatus_InvalidArgument;
+    }
+
+    if (handle->soft)
+    {
+        AES_SOFT_DecryptEcb(handle->soft, ciphertext, plaintext, size);
+        return kStatus_Success;
+    }
+
+    status = hashcrypt_aes_engine_init(base, handle, kHASHCRYPT_AesEcb, AES_DECRYPT);
+    if (status != kStatus_Success)
+    {
+        return status;
+    }
+
+    /* load message and get result */
+    status = hashcrypt_aes_one_block(base, handle, ciphertext, plaintext, size);
+
+    return status;
+}
+
+/*!
+ * brief Encrypts AES using CBC block mode.
+ *
+ * param base HASHCRYPT peripheral base address
+ * param handle Handle used for this request.
+ * param plaintext Input plain text to encrypt
+ * param[out] ciphertext Output cipher text
+ * param size Size of input and output data in bytes. Must be multiple of 16 bytes.
+ * param iv Input initial vector to combine with the first input block.
+ * return Status from encrypt operation
+ */
+status_t HASHCRYPT_AES_EncryptCbc(HASHCRYPT_Type *base,
+                                  hashcrypt_handle_t *handle,
+                                  const uint8_t *plaintext,
+                                  uint8_t *ciphertext,
+                                  size_t size,
+                                  const uint8_t iv[16])
+{
+    status_t status = kStatus_Fail;
+
+    if ((size % 16u) || (handle->keySize == kHASHCRYPT_InvalidKey))
+    {
+        return kStatus_InvalidArgument;
+    }
+
+    if (handle->soft)
+    {
+        AES_SOFT_EncryptCbc(handle->soft, plaintext, ciphertext, size, iv);
+        return kStatus_Success;
+    }
+
+    status = hashcrypt_aes_engine_init(base, handle, kHASHCRYPT_AesCbc, AES_ENCRYPT);
+    if (status != kStatus_Success)
+    {
+        return status;
+    }
+
+    /* load 16b iv */
+    hashcrypt_load_data(base, (uint32_t *)iv, 16);
+
+    /* load message and get result */
+    status = hashcrypt_aes_one_block(base, handle, plaintext, ciphertext, size);
+
+    return status;
+}
+
+/*!
+ * brief Decrypts AES using CBC block mode.
+ *
+ * param base HASHCRYPT peripheral base address
+ * param handle Handle used for this request.
+ * param ciphertext Input cipher text to decrypt
+ * param[out] plaintext Output plain text
+ * param size Size of input and output data in bytes. Must be multiple of 16 bytes.
+ * param iv Input initial vector to combine with the first input block.
+ * return Status from decrypt operation
+ */
+status_t HASHCRYPT_AES_DecryptCbc(HASHCRYPT_Type *base,
+                                  hashcrypt_handle_t *handle,
+                                  const uint8_t *ciphertext,
+                                  uint8_t *plaintext,
+                                  size_t size,
+                                  const uint8_t iv[16])
+{
+    status_t status = kStatus_Fail;
+
+    if ((size % 16u) || (handle->keySize == kHASHCRYPT_InvalidKey))
+    {
+        return kStatus_InvalidArgument;
+    }
+
+    if (handle->soft)
+    {
+        AES_SOFT_DecryptCbc(handle->soft, ciphertext, plaintext, size, iv);
+        return kStatus_Success;
+    }
+
+    status = hashcrypt_aes_engine_init(base, handle, kHASHCRYPT_AesCbc, AES_DECRYPT);
+    if (status != kStatus_Success)
+    {
+        return status;
+    }
+
+    /* load iv */
+    hashcrypt_load_data(base, (uint32_t *)iv, 16);
+
+    /* load message and get result */
+    status = hashcrypt_aes_one_block(base, handle, ciphertext, plaintext, size);
+
+    return status;
+}
+
+/*!
+ * brief Encrypts or decrypts AES using CTR block mode.
+ *
+ * Encrypts or decrypts AES using CTR block mode.
+ * AES CTR mode uses only forward AES cipher and same algorithm for encryption and decryption.
+ * The only difference between encryption and decryption is that, for encryption, the input argument
+ * is plain text and the output argument is cipher text. For decryption, the input argument is cipher text
+ * and the output argument is plain text.
+ *
+ * param base HASHCRYPT peripheral base address
+ * param handle Handle used for this request.
+ * param input Input data for CTR block mode
+ * param[out] output Output data for CTR block mode
+ * param size Size of input and output data in bytes
+ * param[in,out] counter Input counter (updates on return)
+ * param[out] counterlast Output cipher of last counter, for chained CTR calls (statefull encryption). NULL can be
+ * passed if chained calls are
+ * not used.
+ * param[out] szLeft Output number of bytes in left unused in counterlast block. NULL can be passed if chained calls
+ * are not used.
+ * return Status from encrypt operation
+ */
+status_t HASHCRYPT_AES_CryptCtr(HASHCRYPT_Type *base,
+                                hashcrypt_handle_t *handle,
+                                const uint8_t *input,
+                                uint8_t *output,
+                                size_t size,
+                                uint8_t counter[HASHCRYPT_AES_BLOCK_SIZE],
+                                uint8_t counterlast[HASHCRYPT_AES_BLOCK_SIZE],
+                                size_t *szLeft)
+{
+    uint32_t lastSize;
+    uint8_t lastBlock[HASHCRYPT_AES_BLOCK_SIZE] = {0};
+    uint8_t *lastEncryptedCounter;
+    status_t status = kStatus_Fail;
+
+    if (handle->keySize == kHASHCRYPT_InvalidKey)
+    {
+        return kStatus_InvalidArgument;
+    }
+
+    if (handle->soft)
+    {
+        AES_SOFT_CryptCtr(handle->soft, input, output, size, counter, counterlast, szLeft);
+        return kStatus_Success;
+    }
+
+    status = hashcrypt_aes_engine_init(base, handle, kHASHCRYPT_AesCtr, AES_ENCRYPT);
+    if (status != kStatus_Success)
+    {
+        return status;
+    }
+
+    /* load nonce */
+    hashcrypt_load_data(base, (uint32_t *)counter, 16);
+
+    lastSize = size % HASHCRYPT_AES_BLOCK_SIZE;
+    size -= lastSize;
+
+    /* encrypt full 16byte blocks */
+    status = hashcrypt_aes_one_block(base, handle, input, output, size);
+    if (status != kStatus_Success)
+    {
+        return status;
+    }
+
+    ctrAdd(counter, size / HASHCRYPT_AES_BLOCK_SIZE);
+    input += size;
+    output += size;
+
+    if (lastSize)
+    {
+        if (counterlast)
+        {
+            lastEncryptedCounter = counterlast;
+        }
+        else
+        {
+            lastEncryptedCounter = lastBlock;
+        }
+
+        /* Perform encryption with all zeros to get last counter. XOR with zeros doesn't change. */
+        status = hashcrypt_aes_one_block(base, NULL, lastBlock, lastEncryptedCounter, HASHCRYPT_AES_BLOCK_SIZE);
+        if (status != kStatus_Success)
+        {
+            return status;
+        }
+        /* remain output = input XOR counterlast */
+        for (uint32_t i = 0; i < lastSize; i++)
+        {
+            output[i] = input[i] ^ lastEncryptedCounter[i];
+        }
+        /* Increment counter parameter */
+        ctrIncrement(counter);
+    }
+    else
+    {
+        lastSize = HASHCRYPT_AES_BLOCK_SIZE;
+        /* no remaining bytes in couterlast so clearing it */
+        if (counterlast)
+        {
+            memset(counterlast, 0, HASHCRYPT_AES_BLOCK_SIZE);
+        }
+    }
+
+    if (szLeft)
+    {
+        *szLeft = HASHCRYPT_AES_BLOCK_SIZE - lastSize;
+    }
+
+    return kStatus_Success;
+}
+
+/*!
+ * @brief Doubles a 16 byte value in GF(2^128) (CMAC subkey generation).
+ *
+ * @param[in,out] blk 16 byte big endian value.
+ */
+static void hashcrypt_cmac_dbl(uint8_t *blk)
+{
+    uint8_t msb = blk[0] & 0x80u;
+
+    for (int i = 0; i < HASHCRYPT_AES_BLOCK_SIZE - 1; i++)
+    {
+        blk[i] = (uint8_t)((blk[i] << 1) | (blk[i + 1] >> 7));
+    }
+    blk[HASHCRYPT_AES_BLOCK_SIZE - 1] = (uint8_t)(blk[HASHCRYPT_AES_BLOCK_SIZE - 1] << 1);
+    if (msb)
+    {
+        blk[HASHCRYPT_AES_BLOCK_SIZE - 1] ^= 0x87u;
+    }
+}
+
+/*!
+ * @brief Runs CBC encryption and keeps only the last cipher block.
+ *
+ * HASHCRYPT is configured for CBC encryption with iv equal to the MAC so far, the whole input is fed in
+ * AHB master mode and all output blocks but the last one are discarded.
+ *
+ * @param base HASHCRYPT peripheral base address
+ * @param handle Handle with the key.
+ * @param blk Optional word aligned block processed before input, NULL if not used.
+ * @param input Input data
+ * @param size Size of input data in bytes (must be 16bytes multiple).
+ * @param[in,out] mac Word aligned chaining value, updated to the last cipher block.
+ */
+static status_t hashcrypt_aes_mac_run(HASHCRYPT_Type *base,
+                                      hashcrypt_handle_t *handle,
+                                      const uint32_t *blk,
+                                      const uint8_t *input,
+                                      size_t size,
+                                      uint32_t mac[HASHCRYPT_AES_BLOCK_SIZE / sizeof(uint32_t)])
+{
+    status_t status = kStatus_Success;
+
+    status = hashcrypt_aes_engine_init(base, handle, kHASHCRYPT_AesCbc, AES_ENCRYPT);
+    if (status != kStatus_Success)
+    {
+        return status;
+    }
+    hashcrypt_load_data(base, mac, HASHCRYPT_AES_BLOCK_SIZE);
+
+    if (blk)
+    {
+        status = hashcrypt_aes_one_block(base, NULL, (const uint8_t *)blk, (uint8_t *)mac, HASHCRYPT_AES_BLOCK_SIZE);
+    }
+    if ((status == kStatus_Success) && (size > HASHCRYPT_AES_BLOCK_SIZE))
+    {
+        status = hashcrypt_aes_one_block(base, handle, input, NULL, size - HASHCRYPT_AES_BLOCK_SIZE);
+        input += size - HASHCRYPT_AES_BLOCK_SIZE;
+        size = HASHCRYPT_AES_BLOCK_SIZE;
+    }
+    if ((status == kStatus_Success) && size)
+    {
+        status = hashcrypt_aes_one_block(base, NULL, input, (uint8_t *)mac, HASHCRYPT_AES_BLOCK_SIZE);
+    }
+
+    return status;
+}
+
+/*!
+ * brief Computes AES CBC-MAC.
+ *
+ * param base HASHCRYPT peripheral base address
+ * param handle Handle used for this request.
+ * param input Input data
+ * param size Size of input data in bytes. Must be multiple of 16 bytes.
+ * param iv Input initial vector, zeros for plain CBC-MAC.
+ * param[out] mac Output last cipher block.
+ * return Status from MAC operation
+ */
+status_t HASHCRYPT_AES_CbcMac(HASHCRYPT_Type *base,
+                              hashcrypt_handle_t *handle,
+                              const uint8_t *input,
+                              size_t size,
+                              const uint8_t iv[HASHCRYPT_AES_BLOCK_SIZE],
+                              uint8_t mac[HASHCRYPT_AES_BLOCK_SIZE])
+{
+    uint32_t chain[HASHCRYPT_AES_BLOCK_SIZE / sizeof(uint32_t)];
+    status_t status;
+
+    if ((size % 16u) || (handle->keySize == kHASHCRYPT_InvalidKey))
+    {
+        return kStatus_InvalidArgument;
+    }
+
+    hashcrypt_memcpy(chain, iv, HASHCRYPT_AES_BLOCK_SIZE);
+    status = hashcrypt_aes_mac_run(base, handle, NULL, input, size, chain);
+    hashcrypt_memcpy(mac, chain, HASHCRYPT_AES_BLOCK_SIZE);
+
+    return status;
+}
+
+/*!
+ * brief Initializes AES-CMAC context.
+ *
+ * param base HASHCRYPT peripheral base address
+ * param[out] ctx CMAC context.
+ * param handle Handle with the key, set by HASHCRYPT_AES_SetKey(). Must stay valid until HASHCRYPT_AES_CmacFinish().
+ * return Status of the subkey derivation.
+ */
+status_t HASHCRYPT_AES_CmacInit(HASHCRYPT_Type *base, hashcrypt_cmac_ctx_t *ctx, hashcrypt_handle_t *handle)
+{
+    status_t status;
+
+    if (handle->keySize == kHASHCRYPT_InvalidKey)
+    {
+        return kStatus_InvalidArgument;
+    }
+
+    /* K1 and K2 are derived once per key and cached in the handle */
+    if (!handle->cmacSubkeys)
+    {
+        memset(handle->cmacK1, 0, sizeof(handle->cmacK1));
+        status = HASHCRYPT_AES_EncryptEcb(base, handle, (uint8_t *)handle->cmacK1, (uint8_t *)handle->cmacK1,
+                                          HASHCRYPT_AES_BLOCK_SIZE);
+        if (status != kStatus_Success)
+        {
+            return status;
+        }
+        hashcrypt_cmac_dbl((uint8_t *)handle->cmacK1);
+        hashcrypt_memcpy(handle->cmacK2, handle->cmacK1, HASHCRYPT_AES_BLOCK_SIZE);
+        hashcrypt_cmac_dbl((uint8_t *)handle->cmacK2);
+        handle->cmacSubkeys = true;
+    }
+
+    ctx->handle = handle;
+    memset(ctx->mac, 0, sizeof(ctx->mac));
+    memset(ctx->blk, 0, sizeof(ctx->blk));
+    ctx->blksz = 0;
+
+    return kStatus_Success;
+}
+
+/*!
+ * brief Adds data to AES-CMAC.
+ *
+ * param base HASHCRYPT peripheral base address
+ * param[in,out] ctx CMAC context.
+ * param input Input data
+ * param size Size of input data in bytes. Any size.
+ * return Status from MAC operation
+ */
+status_t HASHCRYPT_AES_CmacUpdate(HASHCRYPT_Type *base, hashcrypt_cmac_ctx_t *ctx, const uint8_t *input, size_t size)
+{
+    uint8_t *blk = (uint8_t *)ctx->blk;
+    size_t n;
+    status_t status;
+
+    /* the last block is always kept in the context, it is processed with a subkey by Finish */
+    if (ctx->blksz + size <= HASHCRYPT_AES_BLOCK_SIZE)
+    {
+        hashcrypt_memcpy(blk + ctx->blksz, input, size);
+        ctx->blksz += size;
+        return kStatus_Success;
+    }
+
+    /* complete the buffered block, more data follows so it is not the last one */
+    n = HASHCRYPT_AES_BLOCK_SIZE - ctx->blksz;
+    hashcrypt_memcpy(blk + ctx->blksz, input, n);
+    input += n;
+    size -= n;
+
+    /* buffered block and all full blocks but the last one in one engine pass */
+    n = ((size - 1u) / HASHCRYPT_AES_BLOCK_SIZE) * HASHCRYPT_AES_BLOCK_SIZE;
+    status = hashcrypt_aes_mac_run(base, ctx->handle, ctx->blk, input, n, ctx->mac);
+    input += n;
+    size -= n;
+
+    hashcrypt_memcpy(blk, input, size);
+    ctx->blksz = size;
+
+    return status;
+}
+
+/*!
+ * brief Finalizes AES-CMAC.
+ *
+ * param base HASHCRYPT peripheral base address
+ * param[in,out] ctx CMAC context, cleared on return.
+ * param[out] mac Output MAC.
+ * param macSize Size of output MAC in bytes, 1 to 16.
+ * return Status from MAC operation
+ */
+status_t HASHCRYPT_AES_CmacFinish(HASHCRYPT_Type *base, hashcrypt_cmac_ctx_t *ctx, uint8_t *mac, size_t macSize)
+{
+    uint8_t *blk = (uint8_t *)ctx->blk;
+    const uint32_t *subkey;
+    status_t status;
+
+    if ((macSize == 0) || (macSize > HASHCRYPT_AES_BLOCK_SIZE))
+    {
+        return kStatus_InvalidArgument;
+    }
+
+    if (ctx->blksz == HASHCRYPT_AES_BLOCK_SIZE)
+    {
+        subkey = ctx->handle->cmacK1;
+    }
+    else
+    {
+        /* pad incomplete block with 10..0 */
+        blk[ctx->blksz] = 0x80u;
+        memset(blk + ctx->blksz + 1, 0, HASHCRYPT_AES_BLOCK_SIZE - ctx->blksz - 1);
+        subkey = ctx->handle->cmacK2;
+    }
+    for (int i = 0; i < HASHCRYPT_AES_BLOCK_SIZE / sizeof(uint32_t); i++)
+    {
+        ctx->blk[i] ^= subkey[i];
+    }
+
+    status = hashcrypt_aes_mac_run(base, ctx->handle, ctx->blk, NULL, 0, ctx->mac);
+    hashcrypt_memcpy(mac, ctx->mac, macSize);
+
+    memset(ctx, 0, sizeof(*ctx));
+
+    return status;
+}
+
+/*!
+ * brief Computes AES-CMAC of a message.
+ *
+ * param base HASHCRYPT peripheral base address
+ * param handle Handle used for this request.
+ * param input Input data
+ * param size Size of input data in bytes. Any size.
+ * param[out] mac Output MAC, 16 bytes.
+ * return Status from MAC operation
+ */
+status_t HASHCRYPT_AES_Cmac(HASHCRYPT_Type *base,
+                            hashcrypt_handle_t *handle,
+                            const uint8_t *input,
+                            size_t size,
+                            uint8_t mac[HASHCRYPT_AES_BLOCK_SIZE])
+{
+    hashcrypt_cmac_ctx_t ctx;
+    status_t status;
+
+    status = HASHCRYPT_AES_CmacInit(base, &ctx, handle);
+    if (status == kStatus_Success)
+    {
+        status = HASHCRYPT_AES_CmacUpdate(base, &ctx, input, size);
+    }
+    if (status == kStatus_Success)
+    {
+        status = HASHCRYPT_AES_CmacFinish(base, &ctx, mac, HASHCRYPT_AES_BLOCK_SIZE);
+    }
+
+    return status;
+}
+
+/*!
+ * @brief Runs HASHCRYPT in CTR mode for a streaming CTR context.
+ *
+ * This function configures HASHCRYPT and loads key and counter only if the engine has been used for something else
+ * since the previous run of the same context. Otherwise the engine continues with its own copy of the counter.
+ *
+ * @param base HASHCRYPT peripheral base address
+ * @param ctx Streaming CTR context.
+ * @param input Input data
+ * @param[out] output Output data
+ * @param size Size of input and output data in bytes (must be 16bytes multiple).
+ */
+static status_t hashcrypt_ctr_stream_run(
+    HASHCRYPT_Type *base, hashcrypt_ctr_stream_t *ctx, const uint8_t *input, uint8_t *output, size_t size)
+{
+    status_t status;
+
+    if (s_ctrOwner != ctx)
+    {
+        status = hashcrypt_aes_engine_init(base, ctx->handle, kHASHCRYPT_AesCtr, AES_ENCRYPT);
+        if (status != kStatus_Success)
+        {
+            return status;
+        }
+        hashcrypt_load_data(base, ctx->counter, HASHCRYPT_AES_BLOCK_SIZE);
+    }
+
+    status = hashcrypt_aes_one_block(base, NULL, input, output, size);
+    if (status == kStatus_Success)
+    {
+        ctrAdd((uint8_t *)ctx->counter, size / HASHCRYPT_AES_BLOCK_SIZE);
+        s_ctrOwner = ctx;
+    }
+    else
+    {
+        s_ctrOwner = NULL;
+    }
+
+    return status;
+}
+
+/*!
+ * brief Initializes streaming AES-CTR context.
+ *
+ * param base HASHCRYPT peripheral base address
+ * param[out] ctx Streaming CTR context.
+ * param handle Handle with the key, set by HASHCRYPT_AES_SetKey(). Must stay valid until
+ * HASHCRYPT_AES_CtrStreamFinal().
+ * param counter Initial counter block.
+ * return kStatus_Success or kStatus_InvalidArgument.
+ */
+status_t HASHCRYPT_AES_CtrStreamInit(HASHCRYPT_Type *base,
+                                     hashcrypt_ctr_stream_t *ctx,
+                                     hashcrypt_handle_t *handle,
+                                     const uint8_t counter[HASHCRYPT_AES_BLOCK_SIZE])
+{
+    if ((ctx == NULL) || (handle == NULL) || (handle->keySize == kHASHCRYPT_InvalidKey))
+    {
+        return kStatus_InvalidArgument;
+    }
+
+    /* context may be reused, engine state of its previous stream is not valid */
+    if (s_ctrOwner == ctx)
+    {
+        s_ctrOwner = NULL;
+    }
+
+    ctx->handle = handle;
+    hashcrypt_memcpy(ctx->counter, counter, HASHCRYPT_AES_BLOCK_SIZE);
+    memset(ctx->keyStream, 0, sizeof(ctx->keyStream));
+    ctx->szLeft = 0;
+
+    return kStatus_Success;
+}
+
+/*!
+ * brief Encrypts or decrypts next part of AES-CTR stream.
+ *
+ * param base HASHCRYPT peripheral base address
+ * param[in,out] ctx Streaming CTR context.
+ * param input Input data
+ * param[out] output Output data
+ * param size Size of input and output data in bytes. Any size.
+ * return Status from encrypt operation
+ */
+status_t HASHCRYPT_AES_CtrStreamUpdate(
+    HASHCRYPT_Type *base, hashcrypt_ctr_stream_t *ctx, const uint8_t *input, uint8_t *output, size_t size)
+{
+    uint8_t *keyStream = (uint8_t *)ctx->keyStream;
+    status_t status = kStatus_Success;
+    size_t n;
+
+    if (ctx->handle == NULL)
+    {
+        return kStatus_InvalidArgument;
+    }
+
+    /* use key stream left over from the previous call */
+    n = (size < ctx->szLeft) ? size : ctx->szLeft;
+    for (size_t i = 0; i < n; i++)
+    {
+        output[i] = input[i] ^ keyStream[HASHCRYPT_AES_BLOCK_SIZE - ctx->szLeft + i];
+    }
+    ctx->szLeft -= n;
+    input += n;
+    output += n;
+    size -= n;
+
+    /* full blocks go through HASHCRYPT directly */
+    n = size - (size % HASHCRYPT_AES_BLOCK_SIZE);
+    if (n)
+    {
+        status = hashcrypt_ctr_stream_run(base, ctx, input, output, n);
+        if (status != kStatus_Success)
+        {
+            return status;
+        }
+        input += n;
+        output += n;
+        size -= n;
+    }
+
+    /* encrypt zeros to get key stream of the last incomplete block, the rest is kept for the next call */
+    if (size)
+    {
+        memset(ctx->keyStream, 0, sizeof(ctx->keyStream));
+        status = hashcrypt_ctr_stream_run(base, ctx, keyStream, keyStream, HASHCRYPT_AES_BLOCK_SIZE);
+        if (status != kStatus_Success)
+        {
+            return status;
+        }
+        for (size_t i = 0; i < size; i++)
+        {
+            output[i] = input[i] ^ keyStream[i];
+        }
+        ctx->szLeft = HASHCRYPT_AES_BLOCK_SIZE - size;
+    }
+
+    return status;
+}
+
+/*!
+ * brief Finalizes streaming AES-CTR context.
+ *
+ * Unused key stream is discarded and the context is cleared.
+ *
+ * param base HASHCRYPT peripheral base address
+ * param[in,out] ctx Streaming CTR context.
+ * param[out] counter Counter of the next unused block. NULL can be passed if not needed.
+ * return kStatus_Success
+ */
+status_t HASHCRYPT_AES_CtrStreamFinal(HASHCRYPT_Type *base,
+                                      hashcrypt_ctr_stream_t *ctx,
+                                      uint8_t counter[HASHCRYPT_AES_BLOCK_SIZE])
+{
+    if (counter)
+    {
+        hashcrypt_memcpy(counter, ctx->counter, HASHCRYPT_AES_BLOCK_SIZE);
+    }
+
+    if (s_ctrOwner == ctx)
+    {
+        s_ctrOwner = NULL;
+    }
+
+    memset(ctx, 0, sizeof(*ctx));
+
+    return kStatus_Success;
+}
+
+/*!
+ * brief Creates a prepared AES handle for one key, mode and direction.
+ *
+ * param base HASHCRYPT peripheral base address
+ * param[out] prepared Prepared handle.
+ * param handle Handle with the key, set by HASHCRYPT_AES_SetKey().
+ * param mode kHASHCRYPT_AesEcb or kHASHCRYPT_AesCbc.
+ * param direction AES_ENCRYPT or AES_DECRYPT.
+ * return kStatus_Success or kStatus_InvalidArgument.
+ */
+status_t HASHCRYPT_AES_Prepare(HASHCRYPT_Type *base,
+                               hashcrypt_aes_prepared_t *prepared,
+                               const hashcrypt_handle_t *handle,
+                               hashcrypt_aes_mode_t mode,
+                               uint32_t direction)
+{
+    uint32_t keyType;
+
+    /* contents change, the engine may hold the previous key */
+    if (s_aesPrepared == prepared)
+    {
+        s_aesPrepared = NULL;
+    }
+
+    if ((handle->keySize == kHASHCRYPT_InvalidKey) || ((mode != kHASHCRYPT_AesEcb) && (mode != kHASHCRYPT_AesCbc)) ||
+        ((direction != AES_ENCRYPT) && (direction != AES_DECRYPT)))
+    {
+        return kStatus_InvalidArgument;
+    }
+
+    keyType = (handle->keyType == kHASHCRYPT_UserKey) ? 0 : 1u;
+    prepared->cryptCfg = HASHCRYPT_CRYPTCFG_AESMODE(mode) | HASHCRYPT_CRYPTCFG_AESDECRYPT(direction) |
+                         HASHCRYPT_CRYPTCFG_AESSECRET(keyType) | HASHCRYPT_CRYPTCFG_AESKEYSZ(handle->keySize) |
+                         HASHCRYPT_CRYPTCFG_MSW1ST_OUT(1) | HASHCRYPT_CRYPTCFG_SWAPKEY(1) |
+                         HASHCRYPT_CRYPTCFG_SWAPDAT(1) | HASHCRYPT_CRYPTCFG_MSW1ST(1);
+    prepared->mode = mode;
+
+    /* key words are loaded as stored, SWAPKEY makes HASHCRYPT swap the bytes */
+    prepared->keyWords = 0;
+    if (handle->keyType == kHASHCRYPT_UserKey)
+    {
+        prepared->keyWords = 4u + 2u * (uint32_t)handle->keySize;
+        for (uint32_t i = 0; i < prepared->keyWords; i++)
+        {
+            prepared->keyWord[i] = handle->keyWord[i];
+        }
+    }
+
+    return kStatus_Success;
+}
+
+/*!
+ * brief Encrypts or decrypts AES using a prepared handle.
+ *
+ * param base HASHCRYPT peripheral base address
+ * param prepared Prepared handle.
+ * param input Input data
+ * param[out] output Output data
+ * param size Size of input and output data in bytes. Must be multiple of 16 bytes.
+ * param iv CBC: input initial vector. ECB: not used, can be NULL.
+ * return kStatus_Success, kStatus_InvalidArgument or kStatus_Fail if HASHCRYPT reports an error.
+ */
+status_t HASHCRYPT_AES_CryptPrepared(HASHCRYPT_Type *base,
+                                     const hashcrypt_aes_prepared_t *prepared,
+                                     const uint8_t *input,
+                                     uint8_t *output,
+                                     size_t size,
+                                     const uint8_t *iv)
+{
+    uint32_t blk[HASHCRYPT_AES_BLOCK_SIZE / sizeof(uint32_t)];
+    status_t status;
+
+    if ((size % 16u) || ((prepared->mode == kHASHCRYPT_AesCbc) && (iv == NULL)))
+    {
+        return kStatus_InvalidArgument;
+    }
+
+    /* ECB has no chaining state, the engine configured by the previous call takes the next block as is */
+    if (s_aesPrepared != prepared)
+    {
+        if (hashcrypt_aes_engine_busy())
+        {
+            return kStatus_HASHCRYPT_Again;
+        }
+        base->CRYPTCFG = prepared->cryptCfg;
+        hashcrypt_engine_init(base, kHASHCRYPT_Aes);
+        hashcrypt_load_data(base, prepared->keyWord, prepared->keyWords * sizeof(uint32_t));
+
+        if (prepared->mode == kHASHCRYPT_AesCbc)
+        {
+            hashcrypt_memcpy(blk, iv, HASHCRYPT_AES_BLOCK_SIZE);
+            hashcrypt_load_data(base, blk, HASHCRYPT_AES_BLOCK_SIZE);
+        }
+        else if (prepared->keyWords)
+        {
+            s_aesPrepared = prepared;
+        }
+    }
+
+    /* one block is written by the CPU, AHB master setup costs more than it saves */
+    if (size == HASHCRYPT_AES_BLOCK_SIZE)
+    {
+        hashcrypt_memcpy(blk, input, HASHCRYPT_AES_BLOCK_SIZE);
+        hashcrypt_load_data(base, blk, HASHCRYPT_AES_BLOCK_SIZE);
+        hashcrypt_aes_get_block(base, output);
+        status = (base->STATUS & HASHCRYPT_STATUS_ERROR_MASK) ? kStatus_Fail : kStatus_Success;
+    }
+    else
+    {
+        status = hashcrypt_aes_one_block(base, NULL, input, output, size);
+    }
+
+    /* configure the engine from scratch after an error */
+    if (status != kStatus_Success)
+    {
+        s_aesPrepared = NULL;
+    }
+
+    return status;
+}
+
+/*!
+ * @brief Checks if two handles use the same AES key.
+ *
+ * @param a First handle.
+ * @param b Second handle.
+ * @return true if HASHCRYPT can process both handles without reloading the key.
+ */
+static bool hashcrypt_aes_same_key(const hashcrypt_handle_t *a, const hashcrypt_handle_t *b)
+{
+    size_t keyWords;
+
+    if (a == b)
+    {
+        return true;
+    }
+
+    if ((a->keyType != b->keyType) || (a->keySize != b->keySize))
+    {
+        return false;
+    }
+
+    /* secret key comes from the dedicated hw bus, there is only one */
+    if (a->keyType == kHASHCRYPT_SecretKey)
+    {
+        return true;
+    }
+
+    /* 4, 6 or 8 words for AES-128, AES-192 or AES-256 */
+    keyWords = 4u + 2u * (size_t)a->keySize;
+    return (0 == memcmp(a->keyWord, b->keyWord, keyWords * sizeof(uint32_t)));
+}
+
+/*!
+ * @brief Gets HASHCRYPT configuration of batch job.
+ *
+ * CTR jobs are processed by HASHCRYPT in ECB encrypt mode, the key stream is XORed by CPU.
+ *
+ * @param job Batch job.
+ * @param[out] mode HASHCRYPT AES mode.
+ * @param[out] direction HASHCRYPT AES direction.
+ */
+static void hashcrypt_aes_job_config(const hashcrypt_aes_job_t *job, hashcrypt_aes_mode_t *mode, uint32_t *direction)
+{
+    if (job->mode == kHASHCRYPT_AesCtr)
+    {
+        *mode = kHASHCRYPT_AesEcb;
+        *direction = AES_ENCRYPT;
+    }
+    else
+    {
+        *mode = job->mode;
+        *direction = job->direction;
+    }
+}
+
+/*!
+ * @brief Check validity of batch job.
+ *
+ * @param job Batch job.
+ * @return kStatus_Success if valid, kStatus_InvalidArgument otherwise.
+ */
+static status_t hashcrypt_aes_check_job(const hashcrypt_aes_job_t *job)
+{
+    if ((NULL == job->handle) || (job->handle->keySize == kHASHCRYPT_InvalidKey))
+    {
+        return kStatus_InvalidArgument;
+    }
+
+    if (job->mode == kHASHCRYPT_AesCtr)
+    {
+        return (NULL == job->iv) ? kStatus_InvalidArgument : kStatus_Success;
+    }
+
+    if (((job->mode != kHASHCRYPT_AesEcb) && (job->mode != kHASHCRYPT_AesCbc)) ||
+        ((job->direction != AES_ENCRYPT) && (job->direction != AES_DECRYPT)) || (job->size % 16u))
+    {
+        return kStatus_InvalidArgument;
+    }
+
+    if ((job->mode == kHASHCRYPT_AesCbc) && (NULL == job->iv))
+    {
+        return kStatus_InvalidArgument;
+    }
+
+    return kStatus_Success;
+}
+
+/*!
+ * @brief Processes CBC batch job.
+ *
+ * HASHCRYPT continues the CBC chain of the previous job of the group, so the first block of the job
+ * is corrected for the job iv: plaintext is XORed with iv and chain before encryption,
+ * plaintext is XORed with chain and iv after decryption.
+ *
+ * @param base Hashcrypt peripheral base address.
+ * @param job Batch job.
+ * @param[in,out] chain Last cipher text block of the previous job (iv of the group for the first job).
+ * @return kStatus_Success or kStatus_Fail.
+ */
+static status_t hashcrypt_aes_batch_cbc(HASHCRYPT_Type *base, hashcrypt_aes_job_t *job, uint8_t *chain)
+{
+    uint32_t firstBlock[HASHCRYPT_AES_BLOCK_SIZE / sizeof(uint32_t)];
+    uint8_t lastCipher[HASHCRYPT_AES_BLOCK_SIZE];
+    uint8_t *first = (uint8_t *)firstBlock;
+    status_t status;
+
+    if (job->size == 0)
+    {
+        return kStatus_Success;
+    }
+
+    if (job->direction == AES_ENCRYPT)
+    {
+        for (int i = 0; i < HASHCRYPT_AES_BLOCK_SIZE; i++)
+        {
+            first[i] = job->input[i] ^ job->iv[i] ^ chain[i];
+        }
+        status = hashcrypt_aes_one_block(base, NULL, first, job->output, HASHCRYPT_AES_BLOCK_SIZE);
+    }
+    else
+    {
+        /* save the chain for the next job before in-place decryption overwrites it */
+        hashcrypt_memcpy(lastCipher, job->input + job->size - HASHCRYPT_AES_BLOCK_SIZE, HASHCRYPT_AES_BLOCK_SIZE);
+        hashcrypt_memcpy(first, job->input, HASHCRYPT_AES_BLOCK_SIZE);
+        status = hashcrypt_aes_one_block(base, NULL, first, job->output, HASHCRYPT_AES_BLOCK_SIZE);
+        for (int i = 0; i < HASHCRYPT_AES_BLOCK_SIZE; i++)
+        {
+            job->output[i] ^= chain[i] ^ job->iv[i];
+        }
+    }
+
+    if ((status == kStatus_Success) && (job->size > HASHCRYPT_AES_BLOCK_SIZE))
+    {
+        status = hashcrypt_aes_one_block(base, NULL, job->input + HASHCRYPT_AES_BLOCK_SIZE,
+                                         job->output + HASHCRYPT_AES_BLOCK_SIZE,
+                                         job->size - HASHCRYPT_AES_BLOCK_SIZE);
+    }
+
+    if (job->direction == AES_ENCRYPT)
+    {
+        hashcrypt_memcpy(chain, job->output + job->size - HASHCRYPT_AES_BLOCK_SIZE, HASHCRYPT_AES_BLOCK_SIZE);
+    }
+    else
+    {
+        hashcrypt_memcpy(chain, lastCipher, HASHCRYPT_AES_BLOCK_SIZE);
+    }
+
+    return status;
+}
+
+/*!
+ * @brief Processes CTR batch job.
+ *
+ * HASHCRYPT is configured for ECB encryption. Counter blocks are encrypted
+ * AES_BATCH_CTR_BLOCKS at a time and XORed with the input by CPU.
+ *
+ * @param base Hashcrypt peripheral base address.
+ * @param job Batch job. Counter (job iv) is updated.
+ * @return kStatus_Success or kStatus_Fail.
+ */
+static status_t hashcrypt_aes_batch_ctr(HASHCRYPT_Type *base, hashcrypt_aes_job_t *job)
+{
+    uint32_t keyStream[AES_BATCH_CTR_BLOCKS * HASHCRYPT_AES_BLOCK_SIZE / sizeof(uint32_t)];
+    const uint8_t *input = job->input;
+    uint8_t *output = job->output;
+    size_t size = job->size;
+    status_t status = kStatus_Success;
+
+    while (size)
+    {
+        size_t blocks = (size + HASHCRYPT_AES_BLOCK_SIZE - 1) / HASHCRYPT_AES_BLOCK_SIZE;
+        size_t actSz;
+
+        if (blocks > AES_BATCH_CTR_BLOCKS)
+        {
+            blocks = AES_BATCH_CTR_BLOCKS;
+        }
+
+        for (size_t i = 0; i < blocks; i++)
+        {
+            hashcrypt_memcpy(&keyStream[i * 4], job->iv, HASHCRYPT_AES_BLOCK_SIZE);
+            ctrIncrement(job->iv);
+        }
+
+        status = hashcrypt_aes_one_block(base, NULL, (uint8_t *)keyStream, (uint8_t *)keyStream,
+                                         blocks * HASHCRYPT_AES_BLOCK_SIZE);
+        if (status != kStatus_Success)
+        {
+            break;
+        }
+
+        actSz = (size < blocks * HASHCRYPT_AES_BLOCK_SIZE) ? size : blocks * HASHCRYPT_AES_BLOCK_SIZE;
+        for (size_t i = 0; i < actSz; i++)
+        {
+            output[i] = input[i] ^ ((uint8_t *)keyStream)[i];
+        }
+        input += actSz;
+        output += actSz;
+        size -= actSz;
+    }
+
+    memset(keyStream, 0, sizeof(keyStream));
+
+    return status;
+}
+
+/*!
+ * brief Processes a batch of AES jobs.
+ *
+ * Processes many (typically short) messages with as few HASHCRYPT reconfigurations as possible.
+ * Jobs are grouped by key and engine configuration: HASHCRYPT is configured and the key is loaded once
+ * per group and all jobs of the group are then fed back to back. CBC jobs of a group continue the CBC chain
+ * of the engine and the first block of each job is corrected by the CPU for its own iv. CTR jobs share
+ * the ECB encrypt configuration, the key stream is computed from the job counter.
+ * Jobs with the same key and configuration are processed in array order. Jobs use the same key if they
+ * refer to the same handle or to handles with the same key type, size and user key.
+ *
+ * param base HASHCRYPT peripheral base address
+ * param[in,out] jobs Array of jobs. Status of each job is stored to its status member.
+ * param jobCount Number of jobs in the array.
+ * return kStatus_Success if all jobs succeeded, kStatus_Fail otherwise.
+ */
+status_t HASHCRYPT_AES_ProcessBatch(HASHCRYPT_Type *base, hashcrypt_aes_job_t *jobs, size_t jobCount)
+{
+    uint8_t chain[HASHCRYPT_AES_BLOCK_SIZE];
+    hashcrypt_aes_mode_t mode, jobMode;
+    uint32_t direction, jobDirection;
+    status_t status = kStatus_Success;
+
+    /* validate all jobs first, kStatus_HASHCRYPT_Again marks the jobs still to be processed */
+    for (size_t i = 0; i < jobCount; i++)
+    {
+        jobs[i].status = hashcrypt_aes_check_job(&jobs[i]);
+        if (jobs[i].status == kStatus_Success)
+        {
+            jobs[i].status = kStatus_HASHCRYPT_Again;
+        }
+        else
+        {
+            status = kStatus_Fail;
+        }
+    }
+
+    /* HASHCRYPT is busy or held by an unfinished hash, the valid jobs are left to be processed */
+    if (hashcrypt_aes_engine_busy())
+    {
+        return kStatus_HASHCRYPT_Again;
+    }
+
+    for (size_t i = 0; i < jobCount; i++)
+    {
+        if (jobs[i].status != kStatus_HASHCRYPT_Again)
+        {
+            continue;
+        }
+
+        /* first job of a new group, configure HASHCRYPT and load the key once for the whole group */
+        hashcrypt_aes_job_config(&jobs[i], &mode, &direction);
+        hashcrypt_aes_engine_config(base, jobs[i].handle, mode, direction);
+        if (mode == kHASHCRYPT_AesCbc)
+        {
+            hashcrypt_load_data(base, (uint32_t *)jobs[i].iv, 16);
+            hashcrypt_memcpy(chain, jobs[i].iv, HASHCRYPT_AES_BLOCK_SIZE);
+        }
+
+        for (size_t j = i; j < jobCount; j++)
+        {
+            hashcrypt_aes_job_t *job = &jobs[j];
+
+            if (job->status != kStatus_HASHCRYPT_Again)
+            {
+                continue;
+            }
+            hashcrypt_aes_job_config(job, &jobMode, &jobDirection);
+            if ((jobMode != mode) || (jobDirection != direction) ||
+                (!hashcrypt_aes_same_key(jobs[i].handle, job->handle)))
+            {
+                continue;
+            }
+
+            switch (job->mode)
+            {
+                case kHASHCRYPT_AesCbc:
+                    job->status = hashcrypt_aes_batch_cbc(base, job, chain);
+                    break;
+                case kHASHCRYPT_AesCtr:
+                    job->status = hashcrypt_aes_batch_ctr(base, job);
+                    break;
+                default:
+                    job->status = hashcrypt_aes_one_block(base, NULL, job->input, job->output, job->size);
+                    break;
+            }
+
+            if (job->status != kStatus_Success)
+            {
+                status = kStatus_Fail;
+            }
+        }
+    }
+
+    return status;
+}
+
+/*!
+ * @brief Starts next AHB master run of a non-blocking AES operation.
+ *
+ * This function feeds up to AES_MASTER_MAX_BLOCKS - 1 full blocks from the handle input to HASHCRYPT.
+ *
+ * @param base Hashcrypt peripheral base address.
+ * @param handle Handle of the non-blocking operation.
+ */
+static void hashcrypt_aes_start_run(HASHCRYPT_Type *base, hashcrypt_handle_t *handle)
+{
+    uint32_t numBlocks;
+
+    if (handle->remainingBlcks >= AES_MASTER_MAX_BLOCKS)
+    {
+        numBlocks = AES_MASTER_MAX_BLOCKS - 1;
+    }
+    else
+    {
+        numBlocks = handle->remainingBlcks;
+    }
+    handle->remainingBlcks -= numBlocks;
+    handle->runBlcks = numBlocks;
+
+    base->MEMADDR = FSL_FEATURE_HASHCRYPT_ALIAS_OFFSET | HASHCRYPT_MEMADDR_BASE(handle->input);
+    base->MEMCTRL = HASHCRYPT_MEMCTRL_MASTER(1) | HASHCRYPT_MEMCTRL_COUNT(numBlocks);
+    handle->input += numBlocks * HASHCRYPT_AES_BLOCK_SIZE;
+}
+
+/*!
+ * @brief Starts a non-blocking AES operation.
+ *
+ * HASHCRYPT is expected to be configured (CRYPTCFG, key and iv/nonce loaded) by the caller.
+ * This function enables HASHCRYPT interrupts and starts the first AHB master run.
+ *
+ * @param base Hashcrypt peripheral base address.
+ * @param handle Handle of the non-blocking operation.
+ * @param input 32-bit word aligned input data.
+ * @param output Output data.
+ * @param size Size of input data in bytes. Full blocks are processed, remaining bytes are handled in CTR mode only.
+ */
+static void hashcrypt_aes_start_nonblocking(HASHCRYPT_Type *base,
+                                            hashcrypt_handle_t *handle,
+                                            const uint8_t *input,
+                                            uint8_t *output,
+                                            size_t size)
+{
+    handle->input = input;
+    handle->output = output;
+    handle->remainingBlcks = size / HASHCRYPT_AES_BLOCK_SIZE;
+    handle->runBlcks = 0;
+    handle->lastBlockRun = false;
+
+    if (handle->remainingBlcks > 0)
+    {
+        /* Enable digest and error interrupts and start AES */
+        base->INTENSET = HASHCRYPT_INTENCLR_DIGEST_MASK | HASHCRYPT_INTENCLR_ERROR_MASK;
+        hashcrypt_aes_start_run(base, handle);
+    }
+    else if (handle->lastSize > 0)
+    {
+        /* only the last incomplete CTR block, encrypt zeros to get the last counter */
+        handle->lastBlockRun = true;
+        handle->runBlcks = 1;
+        base->INTENSET = HASHCRYPT_INTENCLR_DIGEST_MASK | HASHCRYPT_INTENCLR_ERROR_MASK;
+        base->MEMADDR = FSL_FEATURE_HASHCRYPT_ALIAS_OFFSET | HASHCRYPT_MEMADDR_BASE(&handle->zeroBlock[0]);
+        base->MEMCTRL = HASHCRYPT_MEMCTRL_MASTER(1) | HASHCRYPT_MEMCTRL_COUNT(1);
+    }
+    /* nothing to process, invoke callback directly */
+    else
+    {
+        s_aesHandle = NULL;
+        if (NULL != handle->aesCallback)
+        {
+            handle->aesCallback(base, handle, kStatus_Success, handle->userData);
+        }
+        hashcrypt_sha_schedule(base);
+    }
+}
+
+/*!
+ * @brief Checks input arguments of non-blocking AES operation and takes the HASHCRYPT.
+ *
+ * @param handle Handle used for this request.
+ * @param input Input data.
+ * @param size Size of input data in bytes.
+ * @param blockSizeOnly True if size must be multiple of 16 bytes.
+ * @return kStatus_Success, kStatus_InvalidArgument or kStatus_HASHCRYPT_Again.
+ */
+static status_t hashcrypt_aes_check_nonblocking(hashcrypt_handle_t *handle,
+                                                const uint8_t *input,
+                                                size_t size,
+                                                bool blockSizeOnly)
+{
+    status_t status = kStatus_HASHCRYPT_Again;
+
+    /* AHB Master mode supports only aligned input */
+    if ((blockSizeOnly && (size % 16u)) || (handle->keySize == kHASHCRYPT_InvalidKey) || ((uintptr_t)input & 0x3U))
+    {
+        return kStatus_InvalidArgument;
+    }
+
+    /* only one non-blocking AES operation can be in progress, and not during a non-blocking hash run or while
+     * HASHCRYPT is held by an unfinished hash */
+    uint32_t regPrimask = DisableGlobalIRQ();
+    if (!hashcrypt_aes_engine_busy())
+    {
+        s_aesHandle = handle;
+        status = kStatus_Success;
+    }
+    EnableGlobalIRQ(regPrimask);
+
+    return status;
+}
+
+/*!
+ * @brief Stops the non-blocking AES operation in progress.
+ *
+ * Called by HASHCRYPT_Init() and HASHCRYPT_Deinit() before HASHCRYPT is reset. The callback of the stopped operation
+ * is invoked with kStatus_Fail once the reset is done.
+ *
+ * @param base Hashcrypt peripheral base address.
+ * @return Handle of the stopped operation, NULL if none.
+ */
+static hashcrypt_handle_t *hashcrypt_aes_drop(HASHCRYPT_Type *base)
+{
+    hashcrypt_handle_t *handle;
+    uint32_t regPrimask = DisableGlobalIRQ();
+
+    handle = s_aesHandle;
+    if (NULL != handle)
+    {
+        /* HASHCRYPT is clocked while the operation runs, disable interrupts and AHB master mode */
+        base->INTENCLR = HASHCRYPT_INTENCLR_DIGEST_MASK | HASHCRYPT_INTENCLR_ERROR_MASK;
+        base->MEMCTRL = HASHCRYPT_MEMCTRL_MASTER(0);
+        s_aesHandle = NULL;
+    }
+    EnableGlobalIRQ(regPrimask);
+
+    return handle;
+}
+
+/*!
+ * @brief Handles HASHCRYPT interrupt of a non-blocking AES operation.
+ *
+ * This function reads out one output block, starts next AHB master run if the current one has been processed
+ * and invokes the handle callback once all blocks have been processed.
+ *
+ * @param base Hashcrypt peripheral base address.
+ * @param handle Handle of the non-blocking operation.
+ */
+static void hashcrypt_aes_irq(HASHCRYPT_Type *base, hashcrypt_handle_t *handle)
+{
+    uint32_t outBlk[HASHCRYPT_AES_BLOCK_SIZE / sizeof(uint32_t)];
+    uint8_t *lastEncryptedCounter;
+    status_t status;
+
+    if (0 == (base->STATUS & HASHCRYPT_STATUS_ERROR_MASK))
+    {
+        for (int i = 0; i < 4; i++)
+        {
+            outBlk[i] = swap_bytes(base->OUTDATA0[i]);
+        }
+        handle->runBlcks--;
+
+        if (!handle->lastBlockRun)
+        {
+            /* output can be unaligned */
+            hashcrypt_memcpy(handle->output, outBlk, HASHCRYPT_AES_BLOCK_SIZE);
+            handle->output += HASHCRYPT_AES_BLOCK_SIZE;
+
+            if (handle->runBlcks > 0)
+            {
+                /* wait for next block of the current run */
+                return;
+            }
+            if (handle->remainingBlcks > 0)
+            {
+                /* some blocks still remaining, start another run */
+                hashcrypt_aes_start_run(base, handle);
+                return;
+            }
+            if (handle->lastSize > 0)
+            {
+                /* Perform encryption with all zeros to get last counter. XOR with zeros doesn't change. */
+                handle->lastBlockRun = true;
+                handle->runBlcks = 1;
+                base->MEMADDR = FSL_FEATURE_HASHCRYPT_ALIAS_OFFSET | HASHCRYPT_MEMADDR_BASE(&handle->zeroBlock[0]);
+                base->MEMCTRL = HASHCRYPT_MEMCTRL_MASTER(1) | HASHCRYPT_MEMCTRL_COUNT(1);
+                return;
+            }
+        }
+        else
         {
-            aesKeySize -= sizeof(uint32_t);
-            handle->keyWord[i] = ((uint32_t *)(uintptr_t)key)[i];
-            i++;
+            lastEncryptedCounter =
+                (handle->counterlast != NULL) ? handle->counterlast : (uint8_t *)&handle->zeroBlock[0];
+            hashcrypt_memcpy(lastEncryptedCounter, outBlk, HASHCRYPT_AES_BLOCK_SIZE);
+            /* remain output = input XOR counterlast */
+            for (uint32_t i = 0; i < handle->lastSize; i++)
+            {
+                handle->output[i] = handle->input[i] ^ lastEncryptedCounter[i];
+            }
+            if (handle->szLeft)
+            {
+                *handle->szLeft = HASHCRYPT_AES_BLOCK_SIZE - handle->lastSize;
+            }
         }
+        status = kStatus_Success;
     }
     else
     {
-        return kStatus_InvalidArgument;
+        status = kStatus_Fail;
     }
 
-    return kStatus_Success;
+    /* all blocks processed, disable interrupts and AHB master mode */
+    base->INTENCLR = HASHCRYPT_INTENCLR_DIGEST_MASK | HASHCRYPT_INTENCLR_ERROR_MASK;
+    base->MEMCTRL = HASHCRYPT_MEMCTRL_MASTER(0);
+    s_aesHandle = NULL;
+
+    /* Invoke callback if there is one */
+    if (NULL != handle->aesCallback)
+    {
+        handle->aesCallback(base, handle, status, handle->userData);
+    }
+
+    /* hashes queued meanwhile */
+    hashcrypt_sha_schedule(base);
 }
 
 /*!
- * brief Encrypts AES on one or multiple 128-bit block(s).
+ * brief Installs the callback for background AES operations.
  *
- * Encrypts AES.
- * The source plaintext and destination ciphertext can overlap in system memory.
+ * This function stores the callback in the AES handle and enables HASHCRYPT interrupt.
+ * The callback is invoked from HASHCRYPT isr, once a non-blocking AES operation
+ * started with this handle completes.
+ *
+ * param base HASHCRYPT peripheral base address.
+ * param[in,out] handle Handle used for the request. Shall be configured with HASHCRYPT_AES_SetKey() first.
+ * param callback Callback function.
+ * param userData User data (to be passed as an argument to callback function, once callback is invoked from isr).
+ */
+void HASHCRYPT_AES_SetCallback(HASHCRYPT_Type *base,
+                               hashcrypt_handle_t *handle,
+                               hashcrypt_aes_callback_t callback,
+                               void *userData)
+{
+    handle->aesCallback = callback;
+    handle->userData = userData;
+
+    EnableIRQ(HASHCRYPT_IRQn);
+}
+
+/*!
+ * brief Encrypts AES on one or multiple 128-bit block(s) in background.
+ *
+ * Configures the HASHCRYPT to read \p plaintext as AHB master and returns immediately.
+ * Output blocks are read out by HASHCRYPT isr, which invokes the handle callback when all
+ * blocks have been processed. Neither \p plaintext nor \p ciphertext can be released
+ * before the callback is invoked.
  *
  * param base HASHCRYPT peripheral base address
  * param handle Handle used for this request.
- * param plaintext Input plain text to encrypt
+ * param plaintext 32-bit word aligned pointer to input plain text to encrypt
  * param[out] ciphertext Output cipher text
  * param size Size of input and output data in bytes. Must be multiple of 16 bytes.
- * return Status from encrypt operation
+ * return kStatus_Success if the operation has been started.
+ * return kStatus_HASHCRYPT_Again if HASHCRYPT is busy with another non-blocking AES operation.
  */
-status_t HASHCRYPT_AES_EncryptEcb(
+status_t HASHCRYPT_AES_EncryptEcbNonBlocking(
     HASHCRYPT_Type *base, hashcrypt_handle_t *handle, const uint8_t *plaintext, uint8_t *ciphertext, size_t size)
 {
-    status_t status = kStatus_Fail;
+    status_t status;
 
-    if ((size % 16u) || (handle->keySize == kHASHCRYPT_InvalidKey))
+    status = hashcrypt_aes_check_nonblocking(handle, plaintext, size, true);
+    if (status != kStatus_Success)
     {
-        return kStatus_InvalidArgument;
+        return status;
     }
 
-    uint32_t keyType = (handle->keyType == kHASHCRYPT_UserKey) ? 0 : 1u;
-    base->CRYPTCFG = HASHCRYPT_CRYPTCFG_AESMODE(kHASHCRYPT_AesEcb) | HASHCRYPT_CRYPTCFG_AESDECRYPT(AES_ENCRYPT) |
-                     HASHCRYPT_CRYPTCFG_AESSECRET(keyType) | HASHCRYPT_CRYPTCFG_AESKEYSZ(handle->keySize) |
-                     HASHCRYPT_CRYPTCFG_MSW1ST_OUT(1) | HASHCRYPT_CRYPTCFG_SWAPKEY(1) | HASHCRYPT_CRYPTCFG_SWAPDAT(1) |
-                     HASHCRYPT_CRYPTCFG_MSW1ST(1);
-
-    hashcrypt_engine_init(base, kHASHCRYPT_Aes);
-
-    /* load key if kHASHCRYPT_UserKey is selected */
-    if (handle->keyType == kHASHCRYPT_UserKey)
-    {
-        hashcrypt_aes_load_userKey(base, handle);
-    }
+    hashcrypt_aes_engine_config(base, handle, kHASHCRYPT_AesEcb, AES_ENCRYPT);
 
-    /* load message and get result */
-    status = hashcrypt_aes_one_block(base, plaintext, ciphertext, size);
+    handle->lastSize = 0;
+    hashcrypt_aes_start_nonblocking(base, handle, plaintext, ciphertext, size);
 
-    return status;
+    return kStatus_Success;
 }
 
 /*!
- * brief Decrypts AES on one or multiple 128-bit block(s).
+ * brief Decrypts AES on one or multiple 128-bit block(s) in background.
  *
- * Decrypts AES.
- * The source ciphertext and destination plaintext can overlap in system memory.
+ * Same as HASHCRYPT_AES_EncryptEcbNonBlocking(), but decrypts.
  *
  * param base HASHCRYPT peripheral base address
  * param handle Handle used for this request.
- * param ciphertext Input plain text to encrypt
- * param[out] plaintext Output cipher text
+ * param ciphertext 32-bit word aligned pointer to input cipher text to decrypt
+ * param[out] plaintext Output plain text
  * param size Size of input and output data in bytes. Must be multiple of 16 bytes.
- * return Status from decrypt operation
+ * return kStatus_Success if the operation has been started.
+ * return kStatus_HASHCRYPT_Again if HASHCRYPT is busy with another non-blocking AES operation.
  */
-status_t HASHCRYPT_AES_DecryptEcb(
+status_t HASHCRYPT_AES_DecryptEcbNonBlocking(
     HASHCRYPT_Type *base, hashcrypt_handle_t *handle, const uint8_t *ciphertext, uint8_t *plaintext, size_t size)
 {
-    status_t status = kStatus_Fail;
+    status_t status;
 
-    if ((size % 16u) || (handle->keySize == kHASHCRYPT_InvalidKey))
+    status = hashcrypt_aes_check_nonblocking(handle, ciphertext, size, true);
+    if (status != kStatus_Success)
     {
-        return kStatus_InvalidArgument;
+        return status;
     }
 
-    uint32_t keyType = (handle->keyType == kHASHCRYPT_UserKey) ? 0 : 1u;
-    base->CRYPTCFG = HASHCRYPT_CRYPTCFG_AESMODE(kHASHCRYPT_AesEcb) | HASHCRYPT_CRYPTCFG_AESDECRYPT(AES_DECRYPT) |
-                     HASHCRYPT_CRYPTCFG_AESSECRET(keyType) | HASHCRYPT_CRYPTCFG_AESKEYSZ(handle->keySize) |
-                     HASHCRYPT_CRYPTCFG_MSW1ST_OUT(1) | HASHCRYPT_CRYPTCFG_SWAPKEY(1) | HASHCRYPT_CRYPTCFG_SWAPDAT(1) |
-                     HASHCRYPT_CRYPTCFG_MSW1ST(1);
-
-    hashcrypt_engine_init(base, kHASHCRYPT_Aes);
-
-    /* load key if kHASHCRYPT_UserKey is selected */
-    if (handle->keyType == kHASHCRYPT_UserKey)
-    {
-        hashcrypt_aes_load_userKey(base, handle);
-    }
+    hashcrypt_aes_engine_config(base, handle, kHASHCRYPT_AesEcb, AES_DECRYPT);
 
-    /* load message and get result */
-    status = hashcrypt_aes_one_block(base, ciphertext, plaintext, size);
+    handle->lastSize = 0;
+    hashcrypt_aes_start_nonblocking(base, handle, ciphertext, plaintext, size);
 
-    return status;
+    return kStatus_Success;
 }
 
 /*!
- * brief Encrypts AES using CBC block mode.
+ * brief Encrypts AES using CBC block mode in background.
  *
  * param base HASHCRYPT peripheral base address
  * param handle Handle used for this request.
- * param plaintext Input plain text to encrypt
+ * param plaintext 32-bit word aligned pointer to input plain text to encrypt
  * param[out] ciphertext Output cipher text
  * param size Size of input and output data in bytes. Must be multiple of 16 bytes.
  * param iv Input initial vector to combine with the first input block.
- * return Status from encrypt operation
+ * return kStatus_Success if the operation has been started.
+ * return kStatus_HASHCRYPT_Again if HASHCRYPT is busy with another non-blocking AES operation.
  */
-status_t HASHCRYPT_AES_EncryptCbc(HASHCRYPT_Type *base,
-                                  hashcrypt_handle_t *handle,
-                                  const uint8_t *plaintext,
-                                  uint8_t *ciphertext,
-                                  size_t size,
-                                  const uint8_t iv[16])
+status_t HASHCRYPT_AES_EncryptCbcNonBlocking(HASHCRYPT_Type *base,
+                                             hashcrypt_handle_t *handle,
+                                             const uint8_t *plaintext,
+                                             uint8_t *ciphertext,
+                                             size_t size,
+                                             const uint8_t iv[16])
 {
-    status_t status = kStatus_Fail;
+    status_t status;
 
-    if ((size % 16u) || (handle->keySize == kHASHCRYPT_InvalidKey))
+    status = hashcrypt_aes_check_nonblocking(handle, plaintext, size, true);
+    if (status != kStatus_Success)
     {
-        return kStatus_InvalidArgument;
+        return status;
     }
 
-    uint32_t keyType = (handle->keyType == kHASHCRYPT_UserKey) ? 0 : 1u;
-    base->CRYPTCFG = HASHCRYPT_CRYPTCFG_AESMODE(kHASHCRYPT_AesCbc) | HASHCRYPT_CRYPTCFG_AESDECRYPT(AES_ENCRYPT) |
-                     HASHCRYPT_CRYPTCFG_AESSECRET(keyType) | HASHCRYPT_CRYPTCFG_AESKEYSZ(handle->keySize) |
-                     HASHCRYPT_CRYPTCFG_MSW1ST_OUT(1) | HASHCRYPT_CRYPTCFG_SWAPKEY(1) | HASHCRYPT_CRYPTCFG_SWAPDAT(1) |
-                     HASHCRYPT_CRYPTCFG_MSW1ST(1);
-
-    hashcrypt_engine_init(base, kHASHCRYPT_Aes);
-
-    /* load key if kHASHCRYPT_UserKey is selected */
-    if (handle->keyType == kHASHCRYPT_UserKey)
-    {
-        hashcrypt_aes_load_userKey(base, handle);
-    }
+    hashcrypt_aes_engine_config(base, handle, kHASHCRYPT_AesCbc, AES_ENCRYPT);
 
     /* load 16b iv */
     hashcrypt_load_data(base, (uint32_t *)iv, 16);
 
-    /* load message and get result */
-    status = hashcrypt_aes_one_block(base, plaintext, ciphertext, size);
+    handle->lastSize = 0;
+    hashcrypt_aes_start_nonblocking(base, handle, plaintext, ciphertext, size);
 
-    return status;
+    return kStatus_Success;
 }
 
 /*!
- * brief Decrypts AES using CBC block mode.
+ * brief Decrypts AES using CBC block mode in background.
  *
  * param base HASHCRYPT peripheral base address
  * param handle Handle used for this request.
- * param ciphertext Input cipher text to decrypt
+ * param ciphertext 32-bit word aligned pointer to input cipher text to decrypt
  * param[out] plaintext Output plain text
  * param size Size of input and output data in bytes. Must be multiple of 16 bytes.
  * param iv Input initial vector to combine with the first input block.
- * return Status from decrypt operation
+ * return kStatus_Success if the operation has been started.
+ * return kStatus_HASHCRYPT_Again if HASHCRYPT is busy with another non-blocking AES operation.
  */
-status_t HASHCRYPT_AES_DecryptCbc(HASHCRYPT_Type *base,
-                                  hashcrypt_handle_t *handle,
-                                  const uint8_t *ciphertext,
-                                  uint8_t *plaintext,
-                                  size_t size,
-                                  const uint8_t iv[16])
+status_t HASHCRYPT_AES_DecryptCbcNonBlocking(HASHCRYPT_Type *base,
+                                             hashcrypt_handle_t *handle,
+                                             const uint8_t *ciphertext,
+                                             uint8_t *plaintext,
+                                             size_t size,
+                                             const uint8_t iv[16])
 {
-    status_t status = kStatus_Fail;
+    status_t status;
 
-    if ((size % 16u) || (handle->keySize == kHASHCRYPT_InvalidKey))
+    status = hashcrypt_aes_check_nonblocking(handle, ciphertext, size, true);
+    if (status != kStatus_Success)
     {
-        return kStatus_InvalidArgument;
+        return status;
     }
 
-    uint32_t keyType = (handle->keyType == kHASHCRYPT_UserKey) ? 0 : 1u;
-    base->CRYPTCFG = HASHCRYPT_CRYPTCFG_AESMODE(kHASHCRYPT_AesCbc) | HASHCRYPT_CRYPTCFG_AESDECRYPT(AES_DECRYPT) |
-                     HASHCRYPT_CRYPTCFG_AESSECRET(keyType) | HASHCRYPT_CRYPTCFG_AESKEYSZ(handle->keySize) |
-                     HASHCRYPT_CRYPTCFG_MSW1ST_OUT(1) | HASHCRYPT_CRYPTCFG_SWAPKEY(1) | HASHCRYPT_CRYPTCFG_SWAPDAT(1) |
-                     HASHCRYPT_CRYPTCFG_MSW1ST(1);
-
-    hashcrypt_engine_init(base, kHASHCRYPT_Aes);
-
-    /* load key if kHASHCRYPT_UserKey is selected */
-    if (handle->keyType == kHASHCRYPT_UserKey)
-    {
-        hashcrypt_aes_load_userKey(base, handle);
-    }
+    hashcrypt_aes_engine_config(base, handle, kHASHCRYPT_AesCbc, AES_DECRYPT);
 
     /* load iv */
     hashcrypt_load_data(base, (uint32_t *)iv, 16);
 
-    /* load message and get result */
-    status = hashcrypt_aes_one_block(base, ciphertext, plaintext, size);
+    handle->lastSize = 0;
+    hashcrypt_aes_start_nonblocking(base, handle, ciphertext, plaintext, size);
 
-    return status;
+    return kStatus_Success;
 }
 
 /*!
- * brief Encrypts or decrypts AES using CTR block mode.
+ * brief Encrypts or decrypts AES using CTR block mode in background.
  *
- * Encrypts or decrypts AES using CTR block mode.
- * AES CTR mode uses only forward AES cipher and same algorithm for encryption and decryption.
- * The only difference between encryption and decryption is that, for encryption, the input argument
- * is plain text and the output argument is cipher text. For decryption, the input argument is cipher text
- * and the output argument is plain text.
+ * Background version of HASHCRYPT_AES_CryptCtr(). The \p counter is updated before this function returns.
+ * The \p counterlast and \p szLeft outputs are updated by HASHCRYPT isr before the handle callback is invoked,
+ * so both shall stay valid until then.
  *
  * param base HASHCRYPT peripheral base address
  * param handle Handle used for this request.
- * param input Input data for CTR block mode
+ * param input 32-bit word aligned pointer to input data for CTR block mode
  * param[out] output Output data for CTR block mode
  * param size Size of input and output data in bytes
  * param[in,out] counter Input counter (updates on return)
  * param[out] counterlast Output cipher of last counter, for chained CTR calls (statefull encryption). NULL can be
- * passed if chained calls are
- * not used.
+ * passed if chained calls are not used.
  * param[out] szLeft Output number of bytes in left unused in counterlast block. NULL can be passed if chained calls
  * are not used.
- * return Status from encrypt operation
+ * return kStatus_Success if the operation has been started.
+ * return kStatus_HASHCRYPT_Again if HASHCRYPT is busy with another non-blocking AES operation.
  */
-status_t HASHCRYPT_AES_CryptCtr(HASHCRYPT_Type *base,
-                                hashcrypt_handle_t *handle,
-                                const uint8_t *input,
-                                uint8_t *output,
-                                size_t size,
-                                uint8_t counter[HASHCRYPT_AES_BLOCK_SIZE],
-                                uint8_t counterlast[HASHCRYPT_AES_BLOCK_SIZE],
-                                size_t *szLeft)
+status_t HASHCRYPT_AES_CryptCtrNonBlocking(HASHCRYPT_Type *base,
+                                           hashcrypt_handle_t *handle,
+                                           const uint8_t *input,
+                                           uint8_t *output,
+                                           size_t size,
+                                           uint8_t counter[HASHCRYPT_AES_BLOCK_SIZE],
+                                           uint8_t counterlast[HASHCRYPT_AES_BLOCK_SIZE],
+                                           size_t *szLeft)
 {
-    uint32_t lastSize;
-    uint8_t lastBlock[HASHCRYPT_AES_BLOCK_SIZE] = {0};
-    uint8_t *lastEncryptedCounter;
-    status_t status = kStatus_Fail;
+    status_t status;
+    size_t blocks;
 
-    if (handle->keySize == kHASHCRYPT_InvalidKey)
+    status = hashcrypt_aes_check_nonblocking(handle, input, size, false);
+    if (status != kStatus_Success)
     {
-        return kStatus_InvalidArgument;
+        return status;
     }
 
-    uint32_t keyType = (handle->keyType == kHASHCRYPT_UserKey) ? 0 : 1u;
-    base->CRYPTCFG = HASHCRYPT_CRYPTCFG_AESMODE(kHASHCRYPT_AesCtr) | HASHCRYPT_CRYPTCFG_AESDECRYPT(AES_ENCRYPT) |
-                     HASHCRYPT_CRYPTCFG_AESSECRET(keyType) | HASHCRYPT_CRYPTCFG_AESKEYSZ(handle->keySize) |
-                     HASHCRYPT_CRYPTCFG_MSW1ST_OUT(1) | HASHCRYPT_CRYPTCFG_SWAPKEY(1) | HASHCRYPT_CRYPTCFG_SWAPDAT(1) |
-                     HASHCRYPT_CRYPTCFG_MSW1ST(1);
-
-    hashcrypt_engine_init(base, kHASHCRYPT_Aes);
-
-    /* load key if kHASHCRYPT_UserKey is selected */
-    if (handle->keyType == kHASHCRYPT_UserKey)
-    {
-        hashcrypt_aes_load_userKey(base, handle);
-    }
+    hashcrypt_aes_engine_config(base, handle, kHASHCRYPT_AesCtr, AES_ENCRYPT);
 
     /* load nonce */
     hashcrypt_load_data(base, (uint32_t *)counter, 16);
 
-    lastSize = size % HASHCRYPT_AES_BLOCK_SIZE;
-    size -= lastSize;
-
-    /* encrypt full 16byte blocks */
-    hashcrypt_aes_one_block(base, input, output, size);
-
-    while (size)
-    {
-        ctrIncrement(counter);
-        size -= 16u;
-        input += 16;
-        output += 16;
-    }
+    handle->lastSize = size % HASHCRYPT_AES_BLOCK_SIZE;
+    handle->counterlast = counterlast;
+    handle->szLeft = szLeft;
+    memset(handle->zeroBlock, 0, sizeof(handle->zeroBlock));
 
-    if (lastSize)
-    {
-        if (counterlast)
-        {
-            lastEncryptedCounter = counterlast;
-        }
-        else
-        {
-            lastEncryptedCounter = lastBlock;
-        }
+    /* HASHCRYPT holds its own copy of the counter, so the caller's counter can be updated right away */
+    blocks = (size + HASHCRYPT_AES_BLOCK_SIZE - 1) / HASHCRYPT_AES_BLOCK_SIZE;
+    ctrAdd(counter, blocks);
 
-        /* Perform encryption with all zeros to get last counter. XOR with zeros doesn't change. */
-        status = hashcrypt_aes_one_block(base, lastBlock, lastEncryptedCounter, HASHCRYPT_AES_BLOCK_SIZE);
-        if (status != kStatus_Success)
-        {
-            return status;
-        }
-        /* remain output = input XOR counterlast */
-        for (uint32_t i = 0; i < lastSize; i++)
-        {
-            output[i] = input[i] ^ lastEncryptedCounter[i];
-        }
-        /* Increment counter parameter */
-        ctrIncrement(counter);
-    }
-    else
+    if (handle->lastSize == 0)
     {
-        lastSize = HASHCRYPT_AES_BLOCK_SIZE;
         /* no remaining bytes in couterlast so clearing it */
         if (counterlast)
         {
             memset(counterlast, 0, HASHCRYPT_AES_BLOCK_SIZE);
         }
+        if (szLeft)
+        {
+            *szLeft = 0;
+        }
     }
 
-    if (szLeft)
-    {
-        *szLeft = HASHCRYPT_AES_BLOCK_SIZE - lastSize;
-    }
+    hashcrypt_aes_start_nonblocking(base, handle, input, output, size);
 
     return kStatus_Success;
 }
 
-void HASH_IRQHandler(void)
+void HASHCRYPT_DriverIRQHandler(void)
 {
     hashcrypt_sha_ctx_internal_t *ctxInternal;
     HASHCRYPT_Type *base = HASHCRYPT;
-    uint32_t numBlocks;
     status_t status;
 
-    ctxInternal = (hashcrypt_sha_ctx_internal_t *)s_ctx;
+    /* non-blocking AES operation in progress */
+    if (NULL != s_aesHandle)
+    {
+        hashcrypt_aes_irq(base, s_aesHandle);
+        return;
+    }
+
+    ctxInternal = s_shaActive;
+    if (NULL == ctxInternal)
+    {
+        return;
+    }
 
     if (0 == (base->STATUS & HASHCRYPT_STATUS_ERROR_MASK))
     {
-        if (ctxInternal->remainingBlcks > 0)
+        if (hashcrypt_sha_has_blocks(ctxInternal))
         {
-            if (ctxInternal->remainingBlcks >= SHA_MASTER_MAX_BLOCKS)
-            {
-                numBlocks = SHA_MASTER_MAX_BLOCKS - 1;
-            }
-            else
-            {
-                numBlocks = ctxInternal->remainingBlcks;
-            }
-            /* some blocks still remaining, update remainingBlcks for next ISR and start another hash */
-            ctxInternal->remainingBlcks -= numBlocks;
-            base->MEMCTRL = HASHCRYPT_MEMCTRL_MASTER(1) | HASHCRYPT_MEMCTRL_COUNT(numBlocks);
+            /* some blocks still remaining, start another run */
+            hashcrypt_sha_start_run(base, ctxInternal);
             return;
         }
-        /* no full blocks left, disable interrupts and AHB master mode */
-        base->INTENCLR = HASHCRYPT_INTENCLR_DIGEST_MASK | HASHCRYPT_INTENCLR_ERROR_MASK;
-        base->MEMCTRL = HASHCRYPT_MEMCTRL_MASTER(0);
+        /* keep the tail of the segment for the next update or for padding */
+        hashcrypt_memcpy(&ctxInternal->blk.b[0], ctxInternal->input, ctxInternal->tailSize);
+        ctxInternal->blksz = ctxInternal->tailSize;
         status = kStatus_Success;
     }
     else
     {
+        /* running hash is lost */
+        s_shaOwner = NULL;
         status = kStatus_Fail;
     }
 
+    /* segment done, disable interrupts and AHB master mode */
+    base->INTENCLR = HASHCRYPT_INTENCLR_DIGEST_MASK | HASHCRYPT_INTENCLR_ERROR_MASK;
+    base->MEMCTRL = HASHCRYPT_MEMCTRL_MASTER(0);
+    s_shaActive = NULL;
+    ctxInternal->busy = false;
+
     /* Invoke callback if there is one */
     if (NULL != ctxInternal->hashCallback)
     {
-        ctxInternal->hashCallback(HASHCRYPT, s_ctx, status, ctxInternal->userData);
+        ctxInternal->hashCallback(HASHCRYPT, (hashcrypt_hash_ctx_t *)ctxInternal, status, ctxInternal->userData);
     }
+
+    /* next queued hash */
+    hashcrypt_sha_schedule(base);
 }
 
 /*!
  * brief Enables clock and disables reset for HASHCRYPT peripheral.
  *
  * Enable clock and disable reset for HASHCRYPT.
+ * The non-blocking AES operation in progress is stopped, non-blocking hashes in progress or queued are released,
+ * their callbacks are invoked with kStatus_Fail.
  *
  * param base HASHCRYPT base address
  */
 void HASHCRYPT_Init(HASHCRYPT_Type *base)
 {
+    hashcrypt_sha_ctx_internal_t *dropped;
+    hashcrypt_handle_t *aesHandle;
+
+    s_ctrOwner = NULL;
+    s_aesPrepared = NULL;
+    aesHandle = hashcrypt_aes_drop(base);
+    dropped = hashcrypt_sha_drop_all();
     RESET_PeripheralReset(kHASHCRYPT_RST_SHIFT_RSTn);
 #if !(defined(FSL_SDK_DISABLE_DRIVER_CLOCK_CONTROL) && FSL_SDK_DISABLE_DRIVER_CLOCK_CONTROL)
     CLOCK_EnableClock(kCLOCK_HashCrypt);
 #endif /* FSL_SDK_DISABLE_DRIVER_CLOCK_CONTROL */
+    /* non-blocking AES operation and hashes in progress cannot complete after the reset */
+    if ((NULL != aesHandle) && (NULL != aesHandle->aesCallback))
+    {
+        aesHandle->aesCallback(base, aesHandle, kStatus_Fail, aesHandle->userData);
+    }
+    hashcrypt_sha_fail_dropped(dropped);
 }
 
 /*!
  * brief Disables clock for HASHCRYPT peripheral.
  *
  * Disable clock and enable reset.
+ * The non-blocking AES operation in progress is stopped, non-blocking hashes in progress or queued are released,
+ * their callbacks are invoked with kStatus_Fail.
  *
  * param base HASHCRYPT base address
  */
 void HASHCRYPT_Deinit(HASHCRYPT_Type *base)
 {
+    hashcrypt_sha_ctx_internal_t *dropped;
+    hashcrypt_handle_t *aesHandle;
+
+    s_ctrOwner = NULL;
+    s_aesPrepared = NULL;
+    aesHandle = hashcrypt_aes_drop(base);
+    dropped = hashcrypt_sha_drop_all();
     RESET_SetPeripheralReset(kHASHCRYPT_RST_SHIFT_RSTn);
 #if !(defined(FSL_SDK_DISABLE_DRIVER_CLOCK_CONTROL) && FSL_SDK_DISABLE_DRIVER_CLOCK_CONTROL)
     CLOCK_DisableClock(kCLOCK_HashCrypt);
 #endif /* FSL_SDK_DISABLE_DRIVER_CLOCK_CONTROL */
+    if ((NULL != aesHandle) && (NULL != aesHandle->aesCallback))
+    {
+        aesHandle->aesCallback(base, aesHandle, kStatus_Fail, aesHandle->userData);
+    }
+    hashcrypt_sha_fail_dropped(dropped);
 }
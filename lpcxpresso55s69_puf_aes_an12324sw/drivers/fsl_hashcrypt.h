@@ -9,6 +9,8 @@
 #define _FSL_HASHCRYPT_H_
 
 #include "fsl_common.h"
+#include "fsl_aes_soft.h"
+#include "fsl_sha_soft.h"
 
 /*! @brief HASHCRYPT status return codes. */
 enum _hashcrypt_status
@@ -27,17 +29,77 @@ enum _hashcrypt_status
  */
 /*! @name Driver version */
 /*@{*/
-/*! @brief HASHCRYPT driver version. Version 2.0.0.
+/*! @brief HASHCRYPT driver version. Version 2.14.0.
  *
- * Current version: 2.0.0
+ * Current version: 2.14.0
  *
  * Change log:
+ * - Version 2.14.0
+ *   - Blocking hash updates realign unaligned input through two staging windows of HASHCRYPT_SHA_STAGING_BLOCKS
+ *     blocks and hash them by AHB master runs, instead of feeding one block at a time.
+ * - Version 2.13.0
+ *   - Blocking hash updates run in chunks of HASHCRYPT_SHA_CHUNK_BLOCKS blocks, within the AHB master count limit.
+ *     Added HASHCRYPT_SHA_SetProgress() and HASHCRYPT_SHA_SetYieldHook().
+ * - Version 2.12.0
+ *   - Added software SHA-256 and SHA-512 behind the HASHCRYPT_SHA APIs, HASHCRYPT_SHA_SOFTWARE build option and
+ *     HASHCRYPT_SHA_SetSoftware().
+ * - Version 2.11.0
+ *   - Added HMAC-SHA256, HASHCRYPT_HMAC_SetKey(), HASHCRYPT_HMAC_Init(), HASHCRYPT_HMAC_Update(),
+ *     HASHCRYPT_HMAC_Finish() and HASHCRYPT_HMAC(). The padded key is computed once by HASHCRYPT_HMAC_SetKey(),
+ *     the padded key blocks are hashed for each MAC.
+ * - Version 2.10.0
+ *   - HASHCRYPT_SHA_UpdateNonBlocking() can be chained and accepts input of any size and alignment.
+ * - Version 2.9.0
+ *   - Non-blocking hashes of several contexts can be started at once, they are queued and each runs to completion.
+ *     HASHCRYPT of LPC55S69 cannot save a running hash and load it back, so a hash holds HASHCRYPT until
+ *     HASHCRYPT_SHA_Finish() and other hashes, blocking AES and prepared AES return kStatus_HASHCRYPT_Again
+ *     meanwhile. Added HASHCRYPT_SHA_Abort() and HASHCRYPT_SHA_GetStats().
+ * - Version 2.8.0
+ *   - Added software AES backend for blocking ECB, CBC and CTR APIs, HASHCRYPT_AES_SetSoftware() and
+ *     HASHCRYPT_AES_SOFTWARE build option.
+ * - Version 2.7.0
+ *   - Added prepared AES handle, HASHCRYPT_AES_Prepare() and HASHCRYPT_AES_CryptPrepared().
+ * - Version 2.6.0
+ *   - Added AES-CMAC (HASHCRYPT_AES_Cmac(), CmacInit(), CmacUpdate(), CmacFinish()) and HASHCRYPT_AES_CbcMac().
+ * - Version 2.5.0
+ *   - Blocking AES APIs split large buffers into AHB master runs within the MEMCTRL COUNT limit.
+ *   - Added HASHCRYPT_AES_SetProgressCallback().
+ * - Version 2.4.0
+ *   - Added streaming AES-CTR context, HASHCRYPT_AES_CtrStreamInit(), Update() and Final().
+ *   - CTR counter is advanced in constant time instead of once per block.
+ * - Version 2.3.0
+ *   - Unaligned AES input is staged through an aligned double buffer, copy of the next chunk overlaps engine run.
+ *   - Unaligned AES output is written directly from OUTDATA registers without staging.
+ * - Version 2.2.0
+ *   - Added HASHCRYPT_AES_ProcessBatch() to process many AES messages with one key load per key and mode.
+ * - Version 2.1.0
+ *   - Added non-blocking (interrupt driven) AES ECB, CBC and CTR APIs. Blocking AES APIs return
+ *     kStatus_HASHCRYPT_Again while a non-blocking AES operation or hash run is in progress.
+ *   - HASHCRYPT_Init() and HASHCRYPT_Deinit() stop a non-blocking AES operation in progress and invoke its callback
+ *     with kStatus_Fail.
+ *   - Renamed HASH_IRQHandler() to HASHCRYPT_DriverIRQHandler() so that it overrides the weak startup symbol.
  * - Version 2.0.0
  *   - Initial version
  */
-#define FSL_HASHCRYPT_DRIVER_VERSION (MAKE_VERSION(2, 0, 0))
+#define FSL_HASHCRYPT_DRIVER_VERSION (MAKE_VERSION(2, 14, 0))
 /*@}*/
 
+/*! @brief Run blocking AES ECB, CBC and CTR APIs in software for all user keys.
+ *
+ * When set to 1, each handle embeds a software AES context and HASHCRYPT_AES_SetKey() expands user keys into it.
+ */
+#ifndef HASHCRYPT_AES_SOFTWARE
+#define HASHCRYPT_AES_SOFTWARE 0
+#endif
+
+/*! @brief Hash SHA-512 in software where HASHCRYPT lacks it, and allow SHA-256 contexts to run in software.
+ *
+ * When set to 1, each hash context embeds a software hash context, see HASHCRYPT_SHA_SetSoftware().
+ */
+#ifndef HASHCRYPT_SHA_SOFTWARE
+#define HASHCRYPT_SHA_SOFTWARE 0
+#endif
+
 /*! @brief Algorithm used for Hashcrypt operation */
 typedef enum _hashcrypt_algo_t
 {
@@ -64,6 +126,15 @@ typedef enum _hashcrypt_algo_t
 #define AES_ENCRYPT 0
 #define AES_DECRYPT 1
 
+/*! @brief Size in bytes of each of the two staging buffers used for unaligned AES input.
+ *
+ * Must be a multiple of 16 and at most 2047 AES blocks (MEMCTRL COUNT limit). The driver allocates two buffers
+ * of this size in RAM.
+ */
+#ifndef HASHCRYPT_AES_STAGING_SIZE
+#define HASHCRYPT_AES_STAGING_SIZE 256
+#endif
+
 /*! @brief AES mode */
 typedef enum _hashcrypt_aes_mode_t
 {
@@ -90,13 +161,89 @@ typedef enum _hashcrypt_key
     kHASHCRYPT_SecretKey = 0x3c3cU, /*!< HASHCRYPT secret key (dedicated hw bus from PUF) */
 } hashcrypt_key_t;
 
+/*! @brief Forward declaration of the HASHCRYPT AES handle. */
+typedef struct _hashcrypt_handle hashcrypt_handle_t;
+
+/*! @brief HASHCRYPT background AES callback function. */
+typedef void (*hashcrypt_aes_callback_t)(HASHCRYPT_Type *base,
+                                         hashcrypt_handle_t *handle,
+                                         status_t status,
+                                         void *userData);
+
+/*! @brief HASHCRYPT blocking AES progress callback function. */
+typedef void (*hashcrypt_aes_progress_t)(
+    HASHCRYPT_Type *base, hashcrypt_handle_t *handle, size_t done, size_t total, void *userData);
+
 /*! @brief Specify HASHCRYPT's key resource. */
-typedef struct _hashcrypt_handle
+struct _hashcrypt_handle
 {
     uint32_t keyWord[8]; /*!< Copy of user key (set by HASHCRYPT_AES_SetKey(). */
     hashcrypt_aes_keysize_t keySize;
     hashcrypt_key_t keyType; /*!< For operations with key (such as AES encryption/decryption), specify key type. */
-} hashcrypt_handle_t;
+    hashcrypt_aes_progress_t aesProgress; /*!< Progress callback of blocking AES APIs, NULL if not used */
+    void *progressUserData;               /*!< User data passed as an argument to progress callback */
+    uint32_t cmacK1[HASHCRYPT_AES_BLOCK_SIZE / sizeof(uint32_t)]; /*!< CMAC subkey K1 */
+    uint32_t cmacK2[HASHCRYPT_AES_BLOCK_SIZE / sizeof(uint32_t)]; /*!< CMAC subkey K2 */
+    bool cmacSubkeys; /*!< True if cmacK1 and cmacK2 have been derived from the current key */
+    aes_soft_ctx_t *soft; /*!< Software backend of blocking ECB, CBC and CTR APIs, NULL for HASHCRYPT */
+#if HASHCRYPT_AES_SOFTWARE
+    aes_soft_ctx_t softCtx; /*!< Software AES context used when HASHCRYPT_AES_SOFTWARE is enabled */
+#endif
+
+    /* Members below are used only by the non-blocking AES APIs. */
+    hashcrypt_aes_callback_t aesCallback; /*!< Pointer to AES callback function */
+    void *userData;            /*!< User data passed as an argument to callback function, once invoked from isr */
+    const uint8_t *input;      /*!< Next input block to be fed to HASHCRYPT in AHB master mode */
+    uint8_t *output;           /*!< Next output block to be read out from HASHCRYPT */
+    uint32_t remainingBlcks;   /*!< Number of full blocks not yet started in AHB master mode */
+    uint32_t runBlcks;         /*!< Number of output blocks still expected from the current AHB master run */
+    size_t lastSize;           /*!< CTR mode only. Number of bytes of the last incomplete block. */
+    bool lastBlockRun;         /*!< CTR mode only. True while HASHCRYPT encrypts the counter of the last block. */
+    uint8_t *counterlast;      /*!< CTR mode only. Optional output of the last encrypted counter. */
+    size_t *szLeft;            /*!< CTR mode only. Optional output of unused bytes in counterlast. */
+    uint32_t zeroBlock[HASHCRYPT_AES_BLOCK_SIZE / sizeof(uint32_t)]; /*!< Word aligned AHB master input of the
+                                                                          last CTR block */
+};
+
+/*! @brief AES job processed by HASHCRYPT_AES_ProcessBatch(). */
+typedef struct _hashcrypt_aes_job
+{
+    hashcrypt_aes_mode_t mode;  /*!< AES mode (ECB, CBC or CTR) */
+    uint32_t direction;         /*!< AES_ENCRYPT or AES_DECRYPT. Ignored in CTR mode. */
+    hashcrypt_handle_t *handle; /*!< Handle with the key, set by HASHCRYPT_AES_SetKey() */
+    uint8_t *iv; /*!< CBC: initial vector. CTR: counter, updated on return. ECB: not used, can be NULL. */
+    const uint8_t *input; /*!< Input data */
+    uint8_t *output;      /*!< Output data */
+    size_t size;          /*!< Size of input and output data in bytes. ECB and CBC: multiple of 16 bytes. */
+    status_t status;      /*!< Output status of this job */
+} hashcrypt_aes_job_t;
+
+/*! @brief AES-CMAC context used by HASHCRYPT_AES_CmacInit(), Update() and Finish(). */
+typedef struct _hashcrypt_cmac_ctx
+{
+    hashcrypt_handle_t *handle; /*!< Handle with the key */
+    uint32_t mac[HASHCRYPT_AES_BLOCK_SIZE / sizeof(uint32_t)]; /*!< CBC chaining value */
+    uint32_t blk[HASHCRYPT_AES_BLOCK_SIZE / sizeof(uint32_t)]; /*!< Last (possibly incomplete) block */
+    size_t blksz;                                              /*!< Number of valid bytes in blk */
+} hashcrypt_cmac_ctx_t;
+
+/*! @brief Streaming AES-CTR context used by HASHCRYPT_AES_CtrStreamInit(), Update() and Final(). */
+typedef struct _hashcrypt_ctr_stream
+{
+    hashcrypt_handle_t *handle; /*!< Handle with the key */
+    uint32_t counter[HASHCRYPT_AES_BLOCK_SIZE / sizeof(uint32_t)];   /*!< Counter of the next block */
+    uint32_t keyStream[HASHCRYPT_AES_BLOCK_SIZE / sizeof(uint32_t)]; /*!< Key stream of the last block */
+    size_t szLeft; /*!< Number of unused bytes at the end of keyStream */
+} hashcrypt_ctr_stream_t;
+
+/*! @brief Prepared AES handle, created by HASHCRYPT_AES_Prepare() and used by HASHCRYPT_AES_CryptPrepared(). */
+typedef struct _hashcrypt_aes_prepared
+{
+    uint32_t cryptCfg;          /*!< Final CRYPTCFG value (mode, direction, key source and size, byte order) */
+    uint32_t keyWord[8];        /*!< User key words in INDATA/ALIAS load order */
+    uint32_t keyWords;          /*!< Number of key words to load, 0 for secret (PUF) key */
+    hashcrypt_aes_mode_t mode;  /*!< AES mode, ECB or CBC */
+} hashcrypt_aes_prepared_t;
 
 /*!
  *@}
@@ -111,7 +258,27 @@ typedef struct _hashcrypt_handle
  */
 
 /*! @brief HASHCRYPT HASH Context size. */
-#define HASHCRYPT_HASH_CTX_SIZE 22
+#if HASHCRYPT_SHA_SOFTWARE
+#define HASHCRYPT_HASH_CTX_SIZE (40 + 1 + (sizeof(sha_soft_ctx_t) + 3) / 4)
+#else
+#define HASHCRYPT_HASH_CTX_SIZE 40
+#endif
+
+/*! @brief Number of 64-byte blocks hashed by one AHB master run of the blocking hash updates, at most 2047.
+ *
+ * The progress callback and the yield hook are invoked after each chunk.
+ */
+#ifndef HASHCRYPT_SHA_CHUNK_BLOCKS
+#define HASHCRYPT_SHA_CHUNK_BLOCKS 256
+#endif
+
+/*! @brief Number of 64-byte blocks of each of the two staging windows used for unaligned hash input.
+ *
+ * The driver allocates two windows of this size in RAM.
+ */
+#ifndef HASHCRYPT_SHA_STAGING_BLOCKS
+#define HASHCRYPT_SHA_STAGING_BLOCKS 4
+#endif
 
 /*! @brief Storage type used to save hash context. */
 typedef struct _hashcrypt_hash_ctx_t
@@ -119,9 +286,43 @@ typedef struct _hashcrypt_hash_ctx_t
     uint32_t x[HASHCRYPT_HASH_CTX_SIZE]; /*!< storage */
 } hashcrypt_hash_ctx_t;
 
+/*! @brief Counters of one hash context, cleared by HASHCRYPT_SHA_Init(). */
+typedef struct _hashcrypt_sha_stats
+{
+    uint32_t bytes; /*!< Message bytes passed to the update functions */
+    uint32_t runs;  /*!< Non-blocking AHB master runs */
+} hashcrypt_sha_stats_t;
+
+/*! @brief HMAC-SHA256 output size in bytes. */
+#define HASHCRYPT_HMAC_SIZE 32u
+
+/*!
+ * @brief HMAC-SHA256 key.
+ *
+ * The key padded to the block size (K0), as secret as the key itself.
+ */
+typedef struct _hashcrypt_hmac_key
+{
+    uint8_t k0[64]; /*!< Key padded with zeros, or its digest padded with zeros for keys longer than 64 bytes */
+} hashcrypt_hmac_key_t;
+
+/*! @brief HMAC-SHA256 context of the incremental API. */
+typedef struct _hashcrypt_hmac_ctx
+{
+    hashcrypt_hash_ctx_t hash;       /*!< Inner hash */
+    const hashcrypt_hmac_key_t *key; /*!< Key set by HASHCRYPT_HMAC_Init() */
+} hashcrypt_hmac_ctx_t;
+
 /*! @brief HASHCRYPT background hash callback function. */
 typedef void (*hashcrypt_callback_t)(HASHCRYPT_Type *base, hashcrypt_hash_ctx_t *ctx, status_t status, void *userData);
 
+/*! @brief Progress of a blocking hash update, \p done of \p total bytes of the update call are hashed. */
+typedef void (*hashcrypt_sha_progress_t)(
+    HASHCRYPT_Type *base, hashcrypt_hash_ctx_t *ctx, size_t done, size_t total, void *userData);
+
+/*! @brief Hook invoked between chunks of blocking hash updates, for example to service a watchdog or a console. */
+typedef void (*hashcrypt_yield_hook_t)(void *userData);
+
 /*!
  *@}
  */ /* end of hashcrypt_driver_hash */
@@ -142,6 +343,8 @@ extern "C" {
  * @brief Enables clock and disables reset for HASHCRYPT peripheral.
  *
  * Enable clock and disable reset for HASHCRYPT.
+ * The non-blocking AES operation in progress is stopped, non-blocking hashes in progress or queued are released,
+ * their callbacks are invoked with kStatus_Fail.
  *
  * @param base HASHCRYPT base address
  */
@@ -151,6 +354,8 @@ void HASHCRYPT_Init(HASHCRYPT_Type *base);
  * @brief Disables clock for HASHCRYPT peripheral.
  *
  * Disable clock and enable reset.
+ * The non-blocking AES operation in progress is stopped, non-blocking hashes in progress or queued are released,
+ * their callbacks are invoked with kStatus_Fail.
  *
  * @param base HASHCRYPT base address
  */
@@ -174,6 +379,8 @@ void HASHCRYPT_Deinit(HASHCRYPT_Type *base);
  *
  * Sets the AES key for encryption/decryption with the hashcrypt_handle_t structure.
  * The hashcrypt_handle_t input argument specifies key source.
+ * The background AES callback and the progress callback of the handle are cleared, cached CMAC subkeys
+ * are invalidated.
  *
  * @param   base HASHCRYPT peripheral base address.
  * @param   handle Handle used for the request.
@@ -183,18 +390,58 @@ void HASHCRYPT_Deinit(HASHCRYPT_Type *base);
  */
 status_t HASHCRYPT_AES_SetKey(HASHCRYPT_Type *base, hashcrypt_handle_t *handle, const uint8_t *key, size_t keySize);
 
+/*!
+ * @brief Selects software AES for the blocking ECB, CBC and CTR APIs of a handle.
+ *
+ * HASHCRYPT_AES_EncryptEcb(), DecryptEcb(), EncryptCbc(), DecryptCbc() and CryptCtr() called with this handle
+ * are computed by the CPU, with bit-identical results, so they work while HASHCRYPT is busy or clock gated.
+ * Other APIs always use HASHCRYPT. HASHCRYPT_AES_SetKey() switches the handle back to HASHCRYPT unless
+ * HASHCRYPT_AES_SOFTWARE is enabled.
+ *
+ * @param base HASHCRYPT peripheral base address.
+ * @param[in,out] handle Handle with a user key, set by HASHCRYPT_AES_SetKey().
+ * @param[out] ctx Software AES context to expand the key into, NULL to use HASHCRYPT again.
+ * @param impl Software implementation, see aes_soft_impl_t.
+ * @return kStatus_Success, or kStatus_InvalidArgument for secret (PUF) keys, which software cannot read.
+ */
+status_t HASHCRYPT_AES_SetSoftware(HASHCRYPT_Type *base,
+                                   hashcrypt_handle_t *handle,
+                                   aes_soft_ctx_t *ctx,
+                                   aes_soft_impl_t impl);
+
+/*!
+ * @brief Installs the progress callback for blocking AES operations.
+ *
+ * Blocking ECB, CBC and CTR APIs process any amount of data in AHB master runs of at most 2047 blocks
+ * (MEMCTRL COUNT limit), unaligned input in runs of HASHCRYPT_AES_STAGING_SIZE bytes. The progress callback
+ * is invoked after each run with the number of bytes processed so far by the current call.
+ *
+ * @param base HASHCRYPT peripheral base address.
+ * @param[in,out] handle Handle used for the request. Shall be configured with HASHCRYPT_AES_SetKey() first.
+ * @param callback Progress callback function, NULL to disable progress reporting.
+ * @param userData User data passed as an argument to callback function.
+ */
+void HASHCRYPT_AES_SetProgressCallback(HASHCRYPT_Type *base,
+                                       hashcrypt_handle_t *handle,
+                                       hashcrypt_aes_progress_t callback,
+                                       void *userData);
+
 /*!
  * @brief Encrypts AES on one or multiple 128-bit block(s).
  *
  * Encrypts AES.
  * The source plaintext and destination ciphertext can overlap in system memory.
  *
+ * Blocking AES functions do not wait for HASHCRYPT. They return kStatus_HASHCRYPT_Again without touching the engine
+ * while a non-blocking AES operation or a non-blocking hash run is in progress, or while HASHCRYPT is held by an
+ * unfinished hash of another context (see HASHCRYPT_SHA_Abort()).
+ *
  * @param base HASHCRYPT peripheral base address
  * @param handle Handle used for this request.
  * @param plaintext Input plain text to encrypt
  * @param[out] ciphertext Output cipher text
  * @param size Size of input and output data in bytes. Must be multiple of 16 bytes.
- * @return Status from encrypt operation
+ * @return Status from encrypt operation, kStatus_HASHCRYPT_Again if HASHCRYPT is busy.
  */
 status_t HASHCRYPT_AES_EncryptEcb(
     HASHCRYPT_Type *base, hashcrypt_handle_t *handle, const uint8_t *plaintext, uint8_t *ciphertext, size_t size);
@@ -210,7 +457,7 @@ status_t HASHCRYPT_AES_EncryptEcb(
  * @param ciphertext Input plain text to encrypt
  * @param[out] plaintext Output cipher text
  * @param size Size of input and output data in bytes. Must be multiple of 16 bytes.
- * @return Status from decrypt operation
+ * @return Status from decrypt operation, kStatus_HASHCRYPT_Again if HASHCRYPT is busy, see HASHCRYPT_AES_EncryptEcb().
  */
 status_t HASHCRYPT_AES_DecryptEcb(
     HASHCRYPT_Type *base, hashcrypt_handle_t *handle, const uint8_t *ciphertext, uint8_t *plaintext, size_t size);
@@ -224,7 +471,7 @@ status_t HASHCRYPT_AES_DecryptEcb(
  * @param[out] ciphertext Output cipher text
  * @param size Size of input and output data in bytes. Must be multiple of 16 bytes.
  * @param iv Input initial vector to combine with the first input block.
- * @return Status from encrypt operation
+ * @return Status from encrypt operation, kStatus_HASHCRYPT_Again if HASHCRYPT is busy, see HASHCRYPT_AES_EncryptEcb().
  */
 status_t HASHCRYPT_AES_EncryptCbc(HASHCRYPT_Type *base,
                                   hashcrypt_handle_t *handle,
@@ -242,7 +489,7 @@ status_t HASHCRYPT_AES_EncryptCbc(HASHCRYPT_Type *base,
  * @param[out] plaintext Output plain text
  * @param size Size of input and output data in bytes. Must be multiple of 16 bytes.
  * @param iv Input initial vector to combine with the first input block.
- * @return Status from decrypt operation
+ * @return Status from decrypt operation, kStatus_HASHCRYPT_Again if HASHCRYPT is busy, see HASHCRYPT_AES_EncryptEcb().
  */
 status_t HASHCRYPT_AES_DecryptCbc(HASHCRYPT_Type *base,
                                   hashcrypt_handle_t *handle,
@@ -271,7 +518,7 @@ status_t HASHCRYPT_AES_DecryptCbc(HASHCRYPT_Type *base,
  * not used.
  * @param[out] szLeft Output number of bytes in left unused in counterlast block. NULL can be passed if chained calls
  * are not used.
- * @return Status from encrypt operation
+ * @return Status from encrypt operation, kStatus_HASHCRYPT_Again if HASHCRYPT is busy, see HASHCRYPT_AES_EncryptEcb().
  */
 status_t HASHCRYPT_AES_CryptCtr(HASHCRYPT_Type *base,
                                 hashcrypt_handle_t *handle,
@@ -282,10 +529,319 @@ status_t HASHCRYPT_AES_CryptCtr(HASHCRYPT_Type *base,
                                 uint8_t counterlast[HASHCRYPT_AES_BLOCK_SIZE],
                                 size_t *szLeft);
 
+/*!
+ * @brief Processes a batch of AES jobs.
+ *
+ * Processes many (typically short) messages with as few HASHCRYPT reconfigurations as possible.
+ * Jobs are grouped by key and engine configuration: HASHCRYPT is configured and the key is loaded once
+ * per group and all jobs of the group are then fed back to back. CBC jobs of a group continue the CBC chain
+ * of the engine and the first block of each job is corrected by the CPU for its own iv. CTR jobs share
+ * the ECB encrypt configuration, the key stream is computed from the job counter.
+ * Jobs with the same key and configuration are processed in array order. Jobs use the same key if they
+ * refer to the same handle or to handles with the same key type, size and user key.
+ *
+ * @param base HASHCRYPT peripheral base address
+ * @param[in,out] jobs Array of jobs. Status of each job is stored to its status member.
+ * @param jobCount Number of jobs in the array.
+ * @return kStatus_Success if all jobs succeeded, kStatus_Fail otherwise. kStatus_HASHCRYPT_Again if HASHCRYPT is
+ * busy (see HASHCRYPT_AES_EncryptEcb()), valid jobs are then left with the same status.
+ */
+status_t HASHCRYPT_AES_ProcessBatch(HASHCRYPT_Type *base, hashcrypt_aes_job_t *jobs, size_t jobCount);
+
+/*!
+ * @brief Computes AES CBC-MAC.
+ *
+ * Runs HASHCRYPT in CBC mode over the whole message in AHB master mode, only the last cipher block is kept.
+ * The message is not padded, so plain CBC-MAC is secure only for messages of a fixed length.
+ *
+ * @param base HASHCRYPT peripheral base address
+ * @param handle Handle used for this request.
+ * @param input Input data
+ * @param size Size of input data in bytes. Must be multiple of 16 bytes.
+ * @param iv Input initial vector, zeros for plain CBC-MAC.
+ * @param[out] mac Output last cipher block.
+ * @return Status from MAC operation
+ */
+status_t HASHCRYPT_AES_CbcMac(HASHCRYPT_Type *base,
+                              hashcrypt_handle_t *handle,
+                              const uint8_t *input,
+                              size_t size,
+                              const uint8_t iv[HASHCRYPT_AES_BLOCK_SIZE],
+                              uint8_t mac[HASHCRYPT_AES_BLOCK_SIZE]);
+
+/*!
+ * @brief Initializes AES-CMAC context.
+ *
+ * Subkeys K1 and K2 (NIST SP 800-38B) are derived on first use of the handle and cached in it until
+ * the next HASHCRYPT_AES_SetKey().
+ *
+ * @param base HASHCRYPT peripheral base address
+ * @param[out] ctx CMAC context.
+ * @param handle Handle with the key, set by HASHCRYPT_AES_SetKey(). Must stay valid until HASHCRYPT_AES_CmacFinish().
+ * @return Status of the subkey derivation.
+ */
+status_t HASHCRYPT_AES_CmacInit(HASHCRYPT_Type *base, hashcrypt_cmac_ctx_t *ctx, hashcrypt_handle_t *handle);
+
+/*!
+ * @brief Adds data to AES-CMAC.
+ *
+ * All complete blocks of the call except the last one of the message so far are processed in one CBC pass.
+ *
+ * @param base HASHCRYPT peripheral base address
+ * @param[in,out] ctx CMAC context.
+ * @param input Input data
+ * @param size Size of input data in bytes. Any size.
+ * @return Status from MAC operation
+ */
+status_t HASHCRYPT_AES_CmacUpdate(HASHCRYPT_Type *base, hashcrypt_cmac_ctx_t *ctx, const uint8_t *input, size_t size);
+
+/*!
+ * @brief Finalizes AES-CMAC.
+ *
+ * @param base HASHCRYPT peripheral base address
+ * @param[in,out] ctx CMAC context, cleared on return.
+ * @param[out] mac Output MAC.
+ * @param macSize Size of output MAC in bytes, 1 to 16.
+ * @return Status from MAC operation
+ */
+status_t HASHCRYPT_AES_CmacFinish(HASHCRYPT_Type *base, hashcrypt_cmac_ctx_t *ctx, uint8_t *mac, size_t macSize);
+
+/*!
+ * @brief Computes AES-CMAC of a message.
+ *
+ * @param base HASHCRYPT peripheral base address
+ * @param handle Handle used for this request.
+ * @param input Input data
+ * @param size Size of input data in bytes. Any size.
+ * @param[out] mac Output MAC, 16 bytes.
+ * @return Status from MAC operation
+ */
+status_t HASHCRYPT_AES_Cmac(HASHCRYPT_Type *base,
+                            hashcrypt_handle_t *handle,
+                            const uint8_t *input,
+                            size_t size,
+                            uint8_t mac[HASHCRYPT_AES_BLOCK_SIZE]);
+
+/*!
+ * @brief Initializes streaming AES-CTR context.
+ *
+ * Streaming context is meant for data that arrives in small pieces of any size. Key stream left over from one
+ * call is used by the next call and HASHCRYPT is configured and the key and counter are loaded only when
+ * the engine has been used for anything else since the previous call on the same context.
+ *
+ * @param base HASHCRYPT peripheral base address
+ * @param[out] ctx Streaming CTR context.
+ * @param handle Handle with the key, set by HASHCRYPT_AES_SetKey(). Must stay valid until
+ * HASHCRYPT_AES_CtrStreamFinal().
+ * @param counter Initial counter block.
+ * @return kStatus_Success or kStatus_InvalidArgument.
+ */
+status_t HASHCRYPT_AES_CtrStreamInit(HASHCRYPT_Type *base,
+                                     hashcrypt_ctr_stream_t *ctx,
+                                     hashcrypt_handle_t *handle,
+                                     const uint8_t counter[HASHCRYPT_AES_BLOCK_SIZE]);
+
+/*!
+ * @brief Encrypts or decrypts next part of AES-CTR stream.
+ *
+ * @param base HASHCRYPT peripheral base address
+ * @param[in,out] ctx Streaming CTR context.
+ * @param input Input data
+ * @param[out] output Output data
+ * @param size Size of input and output data in bytes. Any size.
+ * @return Status from encrypt operation
+ */
+status_t HASHCRYPT_AES_CtrStreamUpdate(
+    HASHCRYPT_Type *base, hashcrypt_ctr_stream_t *ctx, const uint8_t *input, uint8_t *output, size_t size);
+
+/*!
+ * @brief Finalizes streaming AES-CTR context.
+ *
+ * Unused key stream is discarded and the context is cleared.
+ *
+ * @param base HASHCRYPT peripheral base address
+ * @param[in,out] ctx Streaming CTR context.
+ * @param[out] counter Counter of the next unused block. NULL can be passed if not needed.
+ * @return kStatus_Success
+ */
+status_t HASHCRYPT_AES_CtrStreamFinal(HASHCRYPT_Type *base,
+                                      hashcrypt_ctr_stream_t *ctx,
+                                      uint8_t counter[HASHCRYPT_AES_BLOCK_SIZE]);
+
+/*!
+ * @brief Creates a prepared AES handle for one key, mode and direction.
+ *
+ * The CRYPTCFG word and the key words are computed once here, so HASHCRYPT_AES_CryptPrepared() only writes
+ * the registers. The key is copied, the prepared handle stays valid if the source handle changes.
+ *
+ * @param base HASHCRYPT peripheral base address
+ * @param[out] prepared Prepared handle.
+ * @param handle Handle with the key, set by HASHCRYPT_AES_SetKey().
+ * @param mode kHASHCRYPT_AesEcb or kHASHCRYPT_AesCbc.
+ * @param direction AES_ENCRYPT or AES_DECRYPT.
+ * @return kStatus_Success or kStatus_InvalidArgument.
+ */
+status_t HASHCRYPT_AES_Prepare(HASHCRYPT_Type *base,
+                               hashcrypt_aes_prepared_t *prepared,
+                               const hashcrypt_handle_t *handle,
+                               hashcrypt_aes_mode_t mode,
+                               uint32_t direction);
+
+/*!
+ * @brief Encrypts or decrypts AES using a prepared handle.
+ *
+ * Single block input is written to INDATA by the CPU, larger input is read by AHB master.
+ * If HASHCRYPT has not been used since the previous ECB call with the same prepared user key handle, the engine
+ * is still configured and only the data is written.
+ *
+ * @param base HASHCRYPT peripheral base address
+ * @param prepared Prepared handle.
+ * @param input Input data
+ * @param[out] output Output data
+ * @param size Size of input and output data in bytes. Must be multiple of 16 bytes.
+ * @param iv CBC: input initial vector. ECB: not used, can be NULL.
+ * @return kStatus_Success, kStatus_InvalidArgument, kStatus_Fail if HASHCRYPT reports an error, or
+ * kStatus_HASHCRYPT_Again if HASHCRYPT is busy, see HASHCRYPT_AES_EncryptEcb().
+ */
+status_t HASHCRYPT_AES_CryptPrepared(HASHCRYPT_Type *base,
+                                     const hashcrypt_aes_prepared_t *prepared,
+                                     const uint8_t *input,
+                                     uint8_t *output,
+                                     size_t size,
+                                     const uint8_t *iv);
+
 /*!
  *@}
  */ /* end of hashcrypt_driver_aes */
 
+/*!
+ * @addtogroup hashcrypt_background_driver_aes
+ * @{
+ */
+
+/*!
+ * @brief Installs the callback for background AES operations.
+ *
+ * This function stores the callback in the AES handle and enables HASHCRYPT interrupt.
+ * The callback is invoked from HASHCRYPT isr, once a non-blocking AES operation
+ * started with this handle completes.
+ *
+ * @param base HASHCRYPT peripheral base address.
+ * @param[in,out] handle Handle used for the request. Shall be configured with HASHCRYPT_AES_SetKey() first.
+ * @param callback Callback function.
+ * @param userData User data (to be passed as an argument to callback function, once callback is invoked from isr).
+ */
+void HASHCRYPT_AES_SetCallback(HASHCRYPT_Type *base,
+                               hashcrypt_handle_t *handle,
+                               hashcrypt_aes_callback_t callback,
+                               void *userData);
+
+/*!
+ * @brief Encrypts AES on one or multiple 128-bit block(s) in background.
+ *
+ * Configures the HASHCRYPT to read \p plaintext as AHB master and returns immediately.
+ * Output blocks are read out by HASHCRYPT isr, which invokes the handle callback when all
+ * blocks have been processed. Neither \p plaintext nor \p ciphertext can be released
+ * before the callback is invoked.
+ *
+ * @param base HASHCRYPT peripheral base address
+ * @param handle Handle used for this request.
+ * @param plaintext 32-bit word aligned pointer to input plain text to encrypt
+ * @param[out] ciphertext Output cipher text
+ * @param size Size of input and output data in bytes. Must be multiple of 16 bytes.
+ * @return kStatus_Success if the operation has been started.
+ * @return kStatus_HASHCRYPT_Again if HASHCRYPT is busy with another non-blocking AES operation.
+ */
+status_t HASHCRYPT_AES_EncryptEcbNonBlocking(
+    HASHCRYPT_Type *base, hashcrypt_handle_t *handle, const uint8_t *plaintext, uint8_t *ciphertext, size_t size);
+
+/*!
+ * @brief Decrypts AES on one or multiple 128-bit block(s) in background.
+ *
+ * Same as HASHCRYPT_AES_EncryptEcbNonBlocking(), but decrypts.
+ *
+ * @param base HASHCRYPT peripheral base address
+ * @param handle Handle used for this request.
+ * @param ciphertext 32-bit word aligned pointer to input cipher text to decrypt
+ * @param[out] plaintext Output plain text
+ * @param size Size of input and output data in bytes. Must be multiple of 16 bytes.
+ * @return kStatus_Success if the operation has been started.
+ * @return kStatus_HASHCRYPT_Again if HASHCRYPT is busy with another non-blocking AES operation.
+ */
+status_t HASHCRYPT_AES_DecryptEcbNonBlocking(
+    HASHCRYPT_Type *base, hashcrypt_handle_t *handle, const uint8_t *ciphertext, uint8_t *plaintext, size_t size);
+
+/*!
+ * @brief Encrypts AES using CBC block mode in background.
+ *
+ * @param base HASHCRYPT peripheral base address
+ * @param handle Handle used for this request.
+ * @param plaintext 32-bit word aligned pointer to input plain text to encrypt
+ * @param[out] ciphertext Output cipher text
+ * @param size Size of input and output data in bytes. Must be multiple of 16 bytes.
+ * @param iv Input initial vector to combine with the first input block.
+ * @return kStatus_Success if the operation has been started.
+ * @return kStatus_HASHCRYPT_Again if HASHCRYPT is busy with another non-blocking AES operation.
+ */
+status_t HASHCRYPT_AES_EncryptCbcNonBlocking(HASHCRYPT_Type *base,
+                                             hashcrypt_handle_t *handle,
+                                             const uint8_t *plaintext,
+                                             uint8_t *ciphertext,
+                                             size_t size,
+                                             const uint8_t iv[16]);
+
+/*!
+ * @brief Decrypts AES using CBC block mode in background.
+ *
+ * @param base HASHCRYPT peripheral base address
+ * @param handle Handle used for this request.
+ * @param ciphertext 32-bit word aligned pointer to input cipher text to decrypt
+ * @param[out] plaintext Output plain text
+ * @param size Size of input and output data in bytes. Must be multiple of 16 bytes.
+ * @param iv Input initial vector to combine with the first input block.
+ * @return kStatus_Success if the operation has been started.
+ * @return kStatus_HASHCRYPT_Again if HASHCRYPT is busy with another non-blocking AES operation.
+ */
+status_t HASHCRYPT_AES_DecryptCbcNonBlocking(HASHCRYPT_Type *base,
+                                             hashcrypt_handle_t *handle,
+                                             const uint8_t *ciphertext,
+                                             uint8_t *plaintext,
+                                             size_t size,
+                                             const uint8_t iv[16]);
+
+/*!
+ * @brief Encrypts or decrypts AES using CTR block mode in background.
+ *
+ * Background version of HASHCRYPT_AES_CryptCtr(). The \p counter is updated before this function returns.
+ * The \p counterlast and \p szLeft outputs are updated by HASHCRYPT isr before the handle callback is invoked,
+ * so both shall stay valid until then.
+ *
+ * @param base HASHCRYPT peripheral base address
+ * @param handle Handle used for this request.
+ * @param input 32-bit word aligned pointer to input data for CTR block mode
+ * @param[out] output Output data for CTR block mode
+ * @param size Size of input and output data in bytes
+ * @param[in,out] counter Input counter (updates on return)
+ * @param[out] counterlast Output cipher of last counter, for chained CTR calls (statefull encryption). NULL can be
+ * passed if chained calls are not used.
+ * @param[out] szLeft Output number of bytes in left unused in counterlast block. NULL can be passed if chained calls
+ * are not used.
+ * @return kStatus_Success if the operation has been started.
+ * @return kStatus_HASHCRYPT_Again if HASHCRYPT is busy with another non-blocking AES operation.
+ */
+status_t HASHCRYPT_AES_CryptCtrNonBlocking(HASHCRYPT_Type *base,
+                                           hashcrypt_handle_t *handle,
+                                           const uint8_t *input,
+                                           uint8_t *output,
+                                           size_t size,
+                                           uint8_t counter[HASHCRYPT_AES_BLOCK_SIZE],
+                                           uint8_t counterlast[HASHCRYPT_AES_BLOCK_SIZE],
+                                           size_t *szLeft);
+
+/*!
+ *@}
+ */ /* end of hashcrypt_background_driver_aes */
+
 /*******************************************************************************
  * HASH API
  ******************************************************************************/
@@ -358,6 +914,139 @@ status_t HASHCRYPT_SHA_Update(HASHCRYPT_Type *base, hashcrypt_hash_ctx_t *ctx, c
  */
 status_t HASHCRYPT_SHA_Finish(HASHCRYPT_Type *base, hashcrypt_hash_ctx_t *ctx, uint8_t *output, size_t *outputSize);
 
+/*!
+ * @brief Abandons an unfinished hash.
+ *
+ * Releases HASHCRYPT if the context holds it and removes the context from the queue of non-blocking hashes. Its
+ * callback is not invoked. Hashes waiting for HASHCRYPT are started. The context shall be initialized by
+ * HASHCRYPT_SHA_Init() before it is used again.
+ *
+ * @param base HASHCRYPT peripheral base address.
+ * @param ctx Hash context.
+ * @return kStatus_Success, kStatus_InvalidArgument, or kStatus_HASHCRYPT_Again if an AHB master run of the context
+ * is in progress, then the context can be aborted once its callback is invoked.
+ */
+status_t HASHCRYPT_SHA_Abort(HASHCRYPT_Type *base, hashcrypt_hash_ctx_t *ctx);
+
+/*!
+ * @brief Returns the counters of a hash context.
+ *
+ * @param base HASHCRYPT peripheral base address.
+ * @param ctx Hash context.
+ * @param[out] stats Counters since HASHCRYPT_SHA_Init().
+ */
+void HASHCRYPT_SHA_GetStats(HASHCRYPT_Type *base, const hashcrypt_hash_ctx_t *ctx, hashcrypt_sha_stats_t *stats);
+
+/*!
+ * @brief Sets the progress callback of a hash context.
+ *
+ * HASHCRYPT_SHA_Update() invokes the callback after each chunk of HASHCRYPT_SHA_CHUNK_BLOCKS blocks. The callback
+ * is cleared by HASHCRYPT_SHA_Init() and shall not use HASHCRYPT.
+ *
+ * @param base HASHCRYPT peripheral base address.
+ * @param[in,out] ctx Hash context.
+ * @param progress Progress callback, NULL to disable.
+ * @param userData User data passed to the callback.
+ */
+void HASHCRYPT_SHA_SetProgress(HASHCRYPT_Type *base,
+                               hashcrypt_hash_ctx_t *ctx,
+                               hashcrypt_sha_progress_t progress,
+                               void *userData);
+
+/*!
+ * @brief Sets the hook invoked between chunks of all blocking hash updates.
+ *
+ * HASHCRYPT stays reserved to the blocking update while the hook runs, the hook shall not use HASHCRYPT.
+ *
+ * @param base HASHCRYPT peripheral base address.
+ * @param hook Yield hook, NULL to disable.
+ * @param userData User data passed to the hook.
+ */
+void HASHCRYPT_SHA_SetYieldHook(HASHCRYPT_Type *base, hashcrypt_yield_hook_t hook, void *userData);
+
+#if HASHCRYPT_SHA_SOFTWARE
+/*!
+ * @brief Runs a hash context in software.
+ *
+ * Shall be called after HASHCRYPT_SHA_Init() and before any data is added. SHA-512 contexts run in software
+ * anyway when HASHCRYPT does not support SHA-512. Blocking and non-blocking updates of a software context
+ * complete in the calling thread, the callback is invoked before HASHCRYPT_SHA_UpdateNonBlocking() returns.
+ *
+ * @param base HASHCRYPT peripheral base address.
+ * @param[in,out] ctx Hash context, kHASHCRYPT_Sha256 or kHASHCRYPT_Sha512.
+ * @param impl Software implementation, see SHA_SOFT_Init().
+ * @return kStatus_Success or kStatus_InvalidArgument.
+ */
+status_t HASHCRYPT_SHA_SetSoftware(HASHCRYPT_Type *base, hashcrypt_hash_ctx_t *ctx, sha_soft_impl_t impl);
+#endif /* HASHCRYPT_SHA_SOFTWARE */
+
+/*!
+ * @brief Sets an HMAC-SHA256 key.
+ *
+ * Computes the padded key K0 once, keys longer than 64 bytes are hashed first. HASHCRYPT cannot load a running hash,
+ * so each MAC still hashes the key XOR ipad and the key XOR opad blocks as the first block of the inner and of the
+ * outer hash. The cost per MAC is the one of plain HMAC-SHA256, only the key preparation is saved.
+ *
+ * @param base HASHCRYPT peripheral base address.
+ * @param[out] key HMAC key.
+ * @param keyData Key bytes.
+ * @param keySize Size of keyData in bytes.
+ * @return kStatus_Success or kStatus_InvalidArgument.
+ */
+status_t HASHCRYPT_HMAC_SetKey(HASHCRYPT_Type *base, hashcrypt_hmac_key_t *key, const uint8_t *keyData, size_t keySize);
+
+/*!
+ * @brief Starts an HMAC-SHA256 computation.
+ *
+ * @param base HASHCRYPT peripheral base address.
+ * @param[out] ctx HMAC context.
+ * @param key HMAC key set by HASHCRYPT_HMAC_SetKey(). Shall stay valid until HASHCRYPT_HMAC_Finish().
+ * @return kStatus_Success or kStatus_InvalidArgument.
+ */
+status_t HASHCRYPT_HMAC_Init(HASHCRYPT_Type *base, hashcrypt_hmac_ctx_t *ctx, const hashcrypt_hmac_key_t *key);
+
+/*!
+ * @brief Adds data to an HMAC-SHA256 computation.
+ *
+ * @param base HASHCRYPT peripheral base address.
+ * @param[in,out] ctx HMAC context.
+ * @param input Input data.
+ * @param inputSize Size of input data in bytes.
+ * @return Status of the inner hash update, see HASHCRYPT_SHA_Update().
+ */
+status_t HASHCRYPT_HMAC_Update(HASHCRYPT_Type *base, hashcrypt_hmac_ctx_t *ctx, const uint8_t *input, size_t inputSize);
+
+/*!
+ * @brief Finishes an HMAC-SHA256 computation.
+ *
+ * The inner hash is finished and the outer hash is computed over the key XOR opad block and the inner digest.
+ *
+ * @param base HASHCRYPT peripheral base address.
+ * @param[in,out] ctx HMAC context.
+ * @param[out] mac Output MAC.
+ * @param macSize Size of mac in bytes, up to HASHCRYPT_HMAC_SIZE. Shorter MACs are truncated.
+ * @return kStatus_Success, kStatus_InvalidArgument or status of the hash functions.
+ */
+status_t HASHCRYPT_HMAC_Finish(HASHCRYPT_Type *base, hashcrypt_hmac_ctx_t *ctx, uint8_t *mac, size_t macSize);
+
+/*!
+ * @brief Computes HMAC-SHA256 of a message in one call.
+ *
+ * @param base HASHCRYPT peripheral base address.
+ * @param key HMAC key set by HASHCRYPT_HMAC_SetKey().
+ * @param input Input data.
+ * @param inputSize Size of input data in bytes.
+ * @param[out] mac Output MAC.
+ * @param macSize Size of mac in bytes, up to HASHCRYPT_HMAC_SIZE. Shorter MACs are truncated.
+ * @return kStatus_Success, kStatus_InvalidArgument or status of the hash functions.
+ */
+status_t HASHCRYPT_HMAC(HASHCRYPT_Type *base,
+                        const hashcrypt_hmac_key_t *key,
+                        const uint8_t *input,
+                        size_t inputSize,
+                        uint8_t *mac,
+                        size_t macSize);
+
 /*!
  *@}
  */ /* end of hashcrypt_driver_hash */
@@ -391,19 +1080,25 @@ void HASHCRYPT_SHA_SetCallback(HASHCRYPT_Type *base,
 /*!
 * @brief Create running hash on given data.
 *
-* Configures the HASHCRYPT to compute new running hash as AHB master
-* and returns immediately. HASHCRYPT AHB Master mode supports only aligned \p input
-* address and can be called only once per continuous block of data. Every call to this function
-* must be preceded with HASHCRYPT_SHA_Init() and finished with HASHCRYPT_SHA_Finish().
-* Once callback function is invoked by HASHCRYPT isr, it should set a flag
-* for the main application to finalize the hashing (padding) and to read out the final digest
-* by calling HASHCRYPT_SHA_Finish().
+* Configures the HASHCRYPT to add one segment of the message to the running hash as AHB master
+* and returns immediately. The message can be passed as a chain of segments of any size and alignment,
+* started with HASHCRYPT_SHA_Init() and finished with HASHCRYPT_SHA_Finish(). Bytes that do not fill
+* a block are kept in the context and merged with the next segment. Word aligned input is read in AHB master
+* bursts, unaligned input is copied to the context one block at a time.
+* The callback is invoked by HASHCRYPT isr once the segment is hashed, or directly if it only fills
+* the context block. The next segment, or HASHCRYPT_SHA_Finish(), can be passed after that.
+*
+* Several contexts can be started at once. If HASHCRYPT is busy with another hash or with a non-blocking AES
+* operation, the context is queued and started by HASHCRYPT isr in order. HASHCRYPT cannot save a running hash and
+* load it back, so a hash keeps HASHCRYPT from its first segment until HASHCRYPT_SHA_Finish() or
+* HASHCRYPT_SHA_Abort(). Queued hashes of other contexts wait for that, and blocking hash and AES functions return
+* kStatus_HASHCRYPT_Again meanwhile.
 *
 * @param base HASHCRYPT peripheral base address
-* @param ctx Specifies callback. Last incomplete 512-bit block of the input is copied into clear buffer for padding.
-* @param input 32-bit word aligned pointer to Input data.
-* @param inputSize Size of input data in bytes (must be word aligned)
-* @return Status of the hash update operation.
+* @param ctx Hash context with the callback.
+* @param input Input data, shall stay valid until the callback is invoked.
+* @param inputSize Size of input data in bytes.
+* @return kStatus_Success, or kStatus_HASHCRYPT_Again if the previous segment is still in progress.
 */
 status_t HASHCRYPT_SHA_UpdateNonBlocking(HASHCRYPT_Type *base,
                                          hashcrypt_hash_ctx_t *ctx,
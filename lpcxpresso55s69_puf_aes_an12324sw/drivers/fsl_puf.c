@@ -11,6 +11,37 @@
 #include "fsl_reset.h"
 #include "fsl_common.h"
 
+/*! Requests of the PUF to exchange one word of code or key */
+#define PUF_STAT_REQUEST_MASK \
+    (PUF_STAT_CODEINREQ_MASK | PUF_STAT_CODEOUTAVAIL_MASK | PUF_STAT_KEYINREQ_MASK | PUF_STAT_KEYOUTAVAIL_MASK)
+
+/*! Interrupts used by the non-blocking commands */
+#define PUF_INTEN_COMMAND_MASK                                                                                \
+    (PUF_INTEN_SUCCESEN_MASK | PUF_INTEN_ERROREN_MASK | PUF_INTEN_KEYINREQEN_MASK | PUF_INTEN_KEYOUTAVAILEN_MASK | \
+     PUF_INTEN_CODEINREQEN_MASK | PUF_INTEN_CODEOUTAVAILEN_MASK)
+
+#if defined(FSL_FEATURE_PUF_HAS_KEYSLOTS) && (FSL_FEATURE_PUF_HAS_KEYSLOTS > 0)
+#define PUF_KEYSLOT_COUNT FSL_FEATURE_PUF_HAS_KEYSLOTS
+#else
+#define PUF_KEYSLOT_COUNT 1
+#endif /* FSL_FEATURE_PUF_HAS_KEYSLOTS */
+
+/*! Key code loaded to a key slot of the hardware bus */
+typedef struct _puf_resident_key
+{
+    size_t keyCodeSize; /*!< Size of keyCode in bytes, 0 if the slot content is unknown */
+    uint32_t keyCode[PUF_RESIDENT_KEY_CODE_SIZE / sizeof(uint32_t)]; /*!< Copy of the key code */
+} puf_resident_key_t;
+
+/*! key codes loaded to the key slots, cleared on reset with the rest of RAM */
+static puf_resident_key_t s_pufResident[PUF_KEYSLOT_COUNT];
+
+/*! handle of the running non-blocking command, NULL if none runs */
+static puf_handle_t *volatile s_pufActive;
+
+/*! handle of the command started when the running one completes, NULL if none is queued */
+static puf_handle_t *volatile s_pufQueued;
+
 static void puf_wait_usec(uint32_t usec, uint32_t coreClockFrequencyMHz)
 {
     while (usec > 0)
@@ -65,22 +96,31 @@ static void puf_powerOn(PUF_Type *base)
 #endif /* FSL_FEATURE_PUF_PWR_HAS_MANUAL_SLEEP_CONTROL */
 }
 
-static status_t puf_powerCycle(PUF_Type *base, uint32_t dischargeTimeMsec, uint32_t coreClockFrequencyHz)
+/* powers PUF SRAM down, it discharges until puf_dischargeEnd() */
+static void puf_dischargeStart(PUF_Type *base)
 {
 #if defined(FSL_FEATURE_PUF_PWR_HAS_MANUAL_SLEEP_CONTROL) && (FSL_FEATURE_PUF_PWR_HAS_MANUAL_SLEEP_CONTROL > 0)
     /* RT6xxs */
-    uint32_t coreClockFrequencyMHz = coreClockFrequencyHz / 1000000u;
-
     base->PWRCTRL = 0xDu; /* disable RAM CK */
 
     /* enter ASPS mode */
     base->PWRCTRL = 0xCu;  /* SLEEP = 1 */
     base->PWRCTRL = 0x8u;  /* enable RAM CK */
     base->PWRCTRL = 0xF8u; /* SLEEP=1, PSW*=1 */
+#else
+    /* Niobe4 & Aruba FL */
+    base->PWRCTRL = 0x0u;
+    while (PUF_PWRCTRL_RAMSTAT_MASK & base->PWRCTRL)
+    {
+    }
+#endif
+}
 
-    /* Wait enough time to discharge fully */
-    puf_wait_usec(dischargeTimeMsec * 1000u, coreClockFrequencyHz / 1000000u);
-
+/* powers PUF SRAM up again once it is discharged */
+static void puf_dischargeEnd(PUF_Type *base, uint32_t coreClockFrequencyMHz)
+{
+#if defined(FSL_FEATURE_PUF_PWR_HAS_MANUAL_SLEEP_CONTROL) && (FSL_FEATURE_PUF_PWR_HAS_MANUAL_SLEEP_CONTROL > 0)
+    /* RT6xxs */
     /* write PWRCTRL=0x38. wait time > 1 us */
     base->PWRCTRL = 0x38u; /* SLEEP=1. PSWSMALL*=0. PSWLARGE*=1. */
     puf_wait_usec(1, coreClockFrequencyMHz);
@@ -97,24 +137,173 @@ static status_t puf_powerCycle(PUF_Type *base, uint32_t dischargeTimeMsec, uint3
     base->PWRCTRL = 0xDu;
     base->PWRCTRL = 0x5u;
     base->PWRCTRL = 0x1u;
-#else
-    /* Niobe4 & Aruba FL */
-    base->PWRCTRL = 0x0u;
-    while (PUF_PWRCTRL_RAMSTAT_MASK & base->PWRCTRL)
-    {
-    }
-
-    /* Wait enough time to discharge fully */
-    puf_wait_usec(dischargeTimeMsec * 1000u, coreClockFrequencyHz / 1000000u);
 #endif
 
     /* Reset PUF and reenable power to PUF SRAM */
     RESET_PeripheralReset(kPUF_RST_SHIFT_RSTn);
     puf_powerOn(base);
+}
+
+static status_t puf_powerCycle(PUF_Type *base, uint32_t dischargeTimeMsec, uint32_t coreClockFrequencyHz)
+{
+    puf_dischargeStart(base);
+
+    /* Wait enough time to discharge fully */
+    puf_wait_usec(dischargeTimeMsec * 1000u, coreClockFrequencyHz / 1000000u);
+
+    puf_dischargeEnd(base, coreClockFrequencyHz / 1000000u);
+
+    return kStatus_Success;
+}
+
+static status_t puf_checkActivationCode(const uint8_t *activationCode, size_t activationCodeSize)
+{
+    /* check that activation code buffer size is at least 1192 bytes */
+    if (activationCodeSize < PUF_ACTIVATION_CODE_SIZE)
+    {
+        return kStatus_InvalidArgument;
+    }
+
+    /* only work with aligned activationCode */
+    if (0x3u & (uintptr_t)activationCode)
+    {
+        return kStatus_InvalidArgument;
+    }
+
+    return kStatus_Success;
+}
+
+static status_t puf_checkSetKey(puf_key_index_register_t keyIndex,
+                                size_t keySize,
+                                const uint8_t *keyCode,
+                                size_t keyCodeSize)
+{
+    /* only work with aligned keyCode */
+    if (0x3u & (uintptr_t)keyCode)
+    {
+        return kStatus_InvalidArgument;
+    }
+
+    /* Check that keySize is in the correct range and that it is multiple of 8 */
+    if ((keySize < kPUF_KeySizeMin) || (keySize > kPUF_KeySizeMax) || (keySize & 0x7))
+    {
+        return kStatus_InvalidArgument;
+    }
+
+    /* check that keyCodeSize is correct for given keySize */
+    if (keyCodeSize < PUF_GET_KEY_CODE_SIZE_FOR_KEY_SIZE(keySize))
+    {
+        return kStatus_InvalidArgument;
+    }
+
+    if ((uint32_t)keyIndex > kPUF_KeyIndexMax)
+    {
+        return kStatus_InvalidArgument;
+    }
+
+    return kStatus_Success;
+}
+
+/* key index 0 goes to AES or PRINCE, which expect the user key reversed with swapped bytes, in place */
+static void puf_swapUserKey(const uint8_t *userKey, size_t userKeySize)
+{
+    uint32_t *pa = (uint32_t *)(uintptr_t)userKey;
+    uint32_t *pd = &pa[(userKeySize >> 2) - 1u];
+    uint32_t temp32;
+    uint32_t i;
+
+    for (i = 0; i < (userKeySize >> 3); i++)
+    {
+        temp32 = *pa;
+        *pa++ = swap_bytes(*pd);
+        *pd-- = swap_bytes(temp32);
+    }
+}
+
+static status_t puf_checkGetKey(const uint8_t *keyCode, size_t keyCodeSize, size_t minKeyCodeSize, bool hwKey)
+{
+    uint32_t keyIndex;
+
+    /* only work with aligned keyCode */
+    if (0x3u & (uintptr_t)keyCode)
+    {
+        return kStatus_Fail;
+    }
+
+    if (keyCodeSize < minKeyCodeSize)
+    {
+        return kStatus_InvalidArgument;
+    }
+
+    /* check the Key Code header byte 1. index must be zero for the hw key, non-zero for the register key. */
+    keyIndex = 0x0Fu & keyCode[1];
+    if ((kPUF_KeyIndex_00 == (puf_key_index_register_t)keyIndex) != hwKey)
+    {
+        return kStatus_Fail;
+    }
 
     return kStatus_Success;
 }
 
+static void puf_setKeySlot(PUF_Type *base, puf_key_slot_t keySlot, uint32_t keyMask)
+{
+#if defined(FSL_FEATURE_PUF_HAS_KEYSLOTS) && (FSL_FEATURE_PUF_HAS_KEYSLOTS > 0)
+#define PUF_KEYSLOT_EN 2
+    uint32_t regVal = (PUF_KEYSLOT_EN << (2 * keySlot));
+
+    base->KEYRESET = regVal;
+    base->KEYENABLE = regVal;
+    base->KEYMASK[keySlot] = keyMask;
+#endif /* FSL_FEATURE_PUF_HAS_KEYSLOTS */
+}
+
+/* keyCodeSize64 is byte 3 of the key code header, the key size in 64-bit words */
+static status_t puf_checkShiftStatus(PUF_Type *base, uint32_t keyCodeSize64, puf_key_slot_t keySlot)
+{
+    status_t status = kStatus_Success;
+
+#if defined(FSL_FEATURE_PUF_HAS_SHIFT_STATUS) && (FSL_FEATURE_PUF_HAS_SHIFT_STATUS > 0)
+    size_t keyWords = 0;
+
+    /* if the corresponding shift count does not match, return fail anyway */
+    keyWords = ((((size_t)keyCodeSize64) * 2) - 1u) << (keySlot << 2);
+    if (keyWords != ((0x0Fu << (keySlot << 2)) & base->SHIFT_STATUS))
+    {
+        status = kStatus_Fail;
+    }
+#endif /* FSL_FEATURE_PUF_HAS_SHIFT_STATUS */
+
+    return status;
+}
+
+/* significant bytes of a key code, as given by the key size in its header */
+static size_t puf_keyCodeLength(const uint8_t *keyCode, size_t keyCodeSize)
+{
+    return MIN(keyCodeSize, PUF_GET_KEY_CODE_SIZE_FOR_KEY_SIZE((size_t)keyCode[3] << 3));
+}
+
+static void puf_forgetHwKeys(void)
+{
+    memset(s_pufResident, 0, sizeof(s_pufResident));
+}
+
+static void puf_recordHwKey(const uint8_t *keyCode, size_t keyCodeSize, puf_key_slot_t keySlot, status_t status)
+{
+    size_t length = puf_keyCodeLength(keyCode, keyCodeSize);
+
+    if ((uint32_t)keySlot >= PUF_KEYSLOT_COUNT)
+    {
+        return;
+    }
+
+    memset(&s_pufResident[keySlot], 0, sizeof(s_pufResident[keySlot]));
+    if ((kStatus_Success == status) && (length <= PUF_RESIDENT_KEY_CODE_SIZE))
+    {
+        memcpy(s_pufResident[keySlot].keyCode, keyCode, length);
+        s_pufResident[keySlot].keyCodeSize = length;
+    }
+}
+
 /*!
  * brief Initialize PUF
  *
@@ -134,6 +323,7 @@ status_t PUF_Init(PUF_Type *base, uint32_t dischargeTimeMsec, uint32_t coreClock
 #endif
     /* Reset PUF */
     RESET_PeripheralReset(kPUF_RST_SHIFT_RSTn);
+    puf_forgetHwKeys();
 
     /* Enable power to PUF SRAM */
     puf_powerOn(base);
@@ -161,6 +351,12 @@ status_t PUF_Init(PUF_Type *base, uint32_t dischargeTimeMsec, uint32_t coreClock
  */
 void PUF_Deinit(PUF_Type *base, uint32_t dischargeTimeMsec, uint32_t coreClockFrequencyHz)
 {
+    /* drop the non-blocking commands, their callbacks are not invoked */
+    base->INTEN = 0;
+    s_pufActive = NULL;
+    s_pufQueued = NULL;
+    puf_forgetHwKeys();
+
 #if defined(FSL_FEATURE_PUF_PWR_HAS_MANUAL_SLEEP_CONTROL) && (FSL_FEATURE_PUF_PWR_HAS_MANUAL_SLEEP_CONTROL > 0)
     /* RT6xxs */
     base->PWRCTRL = 0xDu; /* disable RAM CK */
@@ -177,6 +373,82 @@ void PUF_Deinit(PUF_Type *base, uint32_t dischargeTimeMsec, uint32_t coreClockFr
     /* Wait enough time to discharge fully */
     puf_wait_usec(dischargeTimeMsec * 1000u, coreClockFrequencyHz / 1000000u);
 
+    PUF_DischargeDeinit(base);
+}
+
+/*!
+ * brief Starts discharging PUF SRAM
+ *
+ * First half of the power cycle done by PUF_Init() and PUF_Deinit(), without the wait. PUF SRAM is powered down
+ * and left to discharge while the CPU sleeps or does other work, the discharge time being measured by the caller,
+ * typically with a hardware timer. PUF_DischargeEnd(), or PUF_DischargePowerUp() from the timer isr, shall be
+ * called once the discharge time has elapsed, or PUF_DischargeDeinit() to leave the PUF deinitialized.
+ * Non-blocking commands are dropped and the key slot records cleared.
+ *
+ * param base PUF peripheral base address
+ */
+void PUF_DischargeStart(PUF_Type *base)
+{
+#if !(defined(FSL_SDK_DISABLE_DRIVER_CLOCK_CONTROL) && FSL_SDK_DISABLE_DRIVER_CLOCK_CONTROL)
+    CLOCK_EnableClock(kCLOCK_Puf);
+#endif
+
+    base->INTEN = 0;
+    s_pufActive = NULL;
+    s_pufQueued = NULL;
+    puf_forgetHwKeys();
+
+    puf_dischargeStart(base);
+}
+
+/*!
+ * brief Powers PUF SRAM up after discharging it
+ *
+ * Resets the PUF and powers PUF SRAM up, without waiting until the block initializes, so that it can be called
+ * from the isr of the timer that measures the discharge time. PUF_DischargeWaitForInit() shall be called next.
+ *
+ * param base PUF peripheral base address
+ * param coreClockFrequencyHz core clock frequency in Hz
+ */
+void PUF_DischargePowerUp(PUF_Type *base, uint32_t coreClockFrequencyHz)
+{
+    puf_dischargeEnd(base, coreClockFrequencyHz / 1000000u);
+}
+
+/*!
+ * brief Waits until the PUF initializes after PUF_DischargePowerUp()
+ *
+ * The PUF is then in the same state as after PUF_Init().
+ *
+ * param base PUF peripheral base address
+ * return kStatus_Success, kStatus_Fail if the PUF did not initialize or does not allow Enroll and Start, which
+ * means that the discharge time was too short.
+ */
+status_t PUF_DischargeWaitForInit(PUF_Type *base)
+{
+    status_t status;
+
+    status = puf_waitForInit(base);
+
+    if ((PUF_ALLOW_ALLOWENROLL_MASK | PUF_ALLOW_ALLOWSTART_MASK) !=
+        (base->ALLOW & (PUF_ALLOW_ALLOWENROLL_MASK | PUF_ALLOW_ALLOWSTART_MASK)))
+    {
+        status = kStatus_Fail;
+    }
+
+    return status;
+}
+
+/*!
+ * brief Leaves PUF SRAM powered down after discharging it
+ *
+ * Holds the PUF in reset and disables its clock instead of powering PUF SRAM up, the PUF is then in the same state
+ * as after PUF_Deinit(). Short enough to be called from the isr of the timer that measures the discharge time.
+ *
+ * param base PUF peripheral base address
+ */
+void PUF_DischargeDeinit(PUF_Type *base)
+{
     RESET_SetPeripheralReset(kPUF_RST_SHIFT_RSTn);
 
 #if !(defined(FSL_SDK_DISABLE_DRIVER_CLOCK_CONTROL) && FSL_SDK_DISABLE_DRIVER_CLOCK_CONTROL)
@@ -184,6 +456,24 @@ void PUF_Deinit(PUF_Type *base, uint32_t dischargeTimeMsec, uint32_t coreClockFr
 #endif
 }
 
+/*!
+ * brief Ends discharging PUF SRAM
+ *
+ * Second half of the power cycle: PUF_DischargePowerUp() followed by PUF_DischargeWaitForInit().
+ * The PUF is then in the same state as after PUF_Init().
+ *
+ * param base PUF peripheral base address
+ * param coreClockFrequencyHz core clock frequency in Hz
+ * return kStatus_Success, kStatus_Fail if the PUF did not initialize or does not allow Enroll and Start, which
+ * means that the discharge time was too short.
+ */
+status_t PUF_DischargeEnd(PUF_Type *base, uint32_t coreClockFrequencyHz)
+{
+    PUF_DischargePowerUp(base, coreClockFrequencyHz);
+
+    return PUF_DischargeWaitForInit(base);
+}
+
 /*!
  * brief Enroll PUF
  *
@@ -195,6 +485,7 @@ void PUF_Deinit(PUF_Type *base, uint32_t dischargeTimeMsec, uint32_t coreClockFr
  * param[out] activationCode Word aligned address of the resulting activation code.
  * param activationCodeSize Size of the activationCode buffer in bytes. Shall be 1192 bytes.
  * return Status of enroll operation.
+ * return kStatus_PUF_Again if a non-blocking command runs.
  */
 status_t PUF_Enroll(PUF_Type *base, uint8_t *activationCode, size_t activationCodeSize)
 {
@@ -202,17 +493,18 @@ status_t PUF_Enroll(PUF_Type *base, uint8_t *activationCode, size_t activationCo
     uint32_t *activationCodeAligned = NULL;
     register uint32_t temp32 = 0;
 
-    /* check that activation code buffer size is at least 1192 bytes */
-    if (activationCodeSize < PUF_ACTIVATION_CODE_SIZE)
+    /* a non-blocking command runs, see PUF_IsBusy() */
+    if (NULL != s_pufActive)
     {
-        return kStatus_InvalidArgument;
+        return kStatus_PUF_Again;
     }
 
-    /* only work with aligned activationCode */
-    if (0x3u & (uintptr_t)activationCode)
+    status = puf_checkActivationCode(activationCode, activationCodeSize);
+    if (status != kStatus_Success)
     {
-        return kStatus_InvalidArgument;
+        return status;
     }
+    status = kStatus_Fail;
 
     activationCodeAligned = (uint32_t *)(uintptr_t)activationCode;
 
@@ -264,6 +556,7 @@ status_t PUF_Enroll(PUF_Type *base, uint8_t *activationCode, size_t activationCo
  * param activationCode Word aligned address of the input activation code.
  * param activationCodeSize Size of the activationCode buffer in bytes. Shall be 1192 bytes.
  * return Status of start operation.
+ * return kStatus_PUF_Again if a non-blocking command runs.
  */
 status_t PUF_Start(PUF_Type *base, const uint8_t *activationCode, size_t activationCodeSize)
 {
@@ -271,17 +564,18 @@ status_t PUF_Start(PUF_Type *base, const uint8_t *activationCode, size_t activat
     const uint32_t *activationCodeAligned = NULL;
     register uint32_t temp32 = 0;
 
-    /* check that activation code size is at least 1192 bytes */
-    if (activationCodeSize < 1192)
+    /* a non-blocking command runs, see PUF_IsBusy() */
+    if (NULL != s_pufActive)
     {
-        return kStatus_InvalidArgument;
+        return kStatus_PUF_Again;
     }
 
-    /* only work with aligned activationCode */
-    if (0x3u & (uintptr_t)activationCode)
+    status = puf_checkActivationCode(activationCode, activationCodeSize);
+    if (status != kStatus_Success)
     {
-        return kStatus_InvalidArgument;
+        return status;
     }
+    status = kStatus_Fail;
 
     activationCodeAligned = (const uint32_t *)(uintptr_t)activationCode;
 
@@ -323,92 +617,148 @@ status_t PUF_Start(PUF_Type *base, const uint8_t *activationCode, size_t activat
     return status;
 }
 
-/*!
- * brief Set intrinsic key
- *
- * The digital fingerprint generated during the Enroll/Start
- * operations is used to generate a Key Code (KC) that defines a unique intrinsic
- * key. This KC is returned to be stored in an NVM or a file. This operation
- * needs to be done only once for each intrinsic key.
- * Each time a Set Intrinsic Key operation is executed a new unique key is
- * generated.
- *
- * param base PUF peripheral base address
- * param keyIndex PUF key index register
- * param keySize Size of the intrinsic key to generate in bytes.
- * param[out] keyCode Word aligned address of the resulting key code.
- * param keyCodeSize Size of the keyCode buffer in bytes. Shall be PUF_GET_KEY_CODE_SIZE_FOR_KEY_SIZE(keySize).
- * return Status of set intrinsic key operation.
- */
-status_t PUF_SetIntrinsicKey(
+static status_t puf_setIntrinsicKey(
     PUF_Type *base, puf_key_index_register_t keyIndex, size_t keySize, uint8_t *keyCode, size_t keyCodeSize)
 {
     status_t status = kStatus_Fail;
     uint32_t *keyCodeAligned = NULL;
     register uint32_t temp32 = 0;
 
-    /* check if SET KEY is allowed */
-    if (0x0u == (base->ALLOW & PUF_ALLOW_ALLOWSETKEY_MASK))
-    {
-        return kStatus_Fail;
-    }
+    keyCodeAligned = (uint32_t *)(uintptr_t)keyCode;
 
-    /* only work with aligned keyCode */
-    if (0x3u & (uintptr_t)keyCode)
+    /* program the key size and index */
+    base->KEYSIZE = keySize >> 3;
+    base->KEYINDEX = (uint32_t)keyIndex;
+
+    /* start generate key command  */
+    base->CTRL = PUF_CTRL_GENERATEKEY_MASK;
+
+    /* wait till command is accepted */
+    while (0 == (base->STAT & (PUF_STAT_BUSY_MASK | PUF_STAT_ERROR_MASK)))
     {
-        return kStatus_InvalidArgument;
     }
 
-    /* Check that keySize is in the correct range and that it is multiple of 8 */
-    if ((keySize < kPUF_KeySizeMin) || (keySize > kPUF_KeySizeMax) || (keySize & 0x7))
-    {
-        return kStatus_InvalidArgument;
+    /* while busy read KC */
+    while (0 != (base->STAT & PUF_STAT_BUSY_MASK))
+    {
+        if (0 != (PUF_STAT_CODEOUTAVAIL_MASK & base->STAT))
+        {
+            temp32 = base->CODEOUTPUT;
+            if (keyCodeSize >= sizeof(uint32_t))
+            {
+                *keyCodeAligned = temp32;
+                keyCodeAligned++;
+                keyCodeSize -= sizeof(uint32_t);
+            }
+        }
     }
 
-    /* check that keyCodeSize is correct for given keySize */
-    if (keyCodeSize < PUF_GET_KEY_CODE_SIZE_FOR_KEY_SIZE(keySize))
+    /* get status */
+    if (0 != (base->STAT & PUF_STAT_SUCCESS_MASK))
     {
-        return kStatus_InvalidArgument;
+        status = kStatus_Success;
     }
 
-    if ((uint32_t)keyIndex > kPUF_KeyIndexMax)
+    return status;
+}
+
+/*!
+ * brief Set intrinsic key
+ *
+ * The digital fingerprint generated during the Enroll/Start
+ * operations is used to generate a Key Code (KC) that defines a unique intrinsic
+ * key. This KC is returned to be stored in an NVM or a file. This operation
+ * needs to be done only once for each intrinsic key.
+ * Each time a Set Intrinsic Key operation is executed a new unique key is
+ * generated.
+ *
+ * param base PUF peripheral base address
+ * param keyIndex PUF key index register
+ * param keySize Size of the intrinsic key to generate in bytes.
+ * param[out] keyCode Word aligned address of the resulting key code.
+ * param keyCodeSize Size of the keyCode buffer in bytes. Shall be PUF_GET_KEY_CODE_SIZE_FOR_KEY_SIZE(keySize).
+ * return Status of set intrinsic key operation.
+ * return kStatus_PUF_Again if a non-blocking command runs.
+ */
+status_t PUF_SetIntrinsicKey(
+    PUF_Type *base, puf_key_index_register_t keyIndex, size_t keySize, uint8_t *keyCode, size_t keyCodeSize)
+{
+    status_t status = kStatus_Fail;
+
+    /* a non-blocking command runs, see PUF_IsBusy() */
+    if (NULL != s_pufActive)
     {
-        return kStatus_InvalidArgument;
+        return kStatus_PUF_Again;
     }
 
-    keyCodeAligned = (uint32_t *)(uintptr_t)keyCode;
+    /* check if SET KEY is allowed */
+    if (0x0u == (base->ALLOW & PUF_ALLOW_ALLOWSETKEY_MASK))
+    {
+        return kStatus_Fail;
+    }
 
-    /* program the key size and index */
-    base->KEYSIZE = keySize >> 3;
-    base->KEYINDEX = (uint32_t)keyIndex;
+    status = puf_checkSetKey(keyIndex, keySize, keyCode, keyCodeSize);
+    if (status != kStatus_Success)
+    {
+        return status;
+    }
 
-    /* start generate key command  */
-    base->CTRL = PUF_CTRL_GENERATEKEY_MASK;
+    return puf_setIntrinsicKey(base, keyIndex, keySize, keyCode, keyCodeSize);
+}
 
-    /* wait till command is accepted */
-    while (0 == (base->STAT & (PUF_STAT_BUSY_MASK | PUF_STAT_ERROR_MASK)))
+/*!
+ * brief Set several intrinsic keys
+ *
+ * Same as calling PUF_SetIntrinsicKey() for each job. ALLOW is checked once and all jobs are validated before
+ * the first key is generated, then the Set Intrinsic Key commands are issued back to back.
+ *
+ * param base PUF peripheral base address
+ * param[in,out] jobs Array of jobs. Status of each job is stored to its status member.
+ * param jobCount Number of jobs in the array.
+ * return kStatus_Success if all jobs succeeded, kStatus_Fail otherwise.
+ * return kStatus_PUF_Again if a non-blocking command runs.
+ */
+status_t PUF_SetIntrinsicKeys(PUF_Type *base, puf_set_key_job_t *jobs, size_t jobCount)
+{
+    status_t status = kStatus_Success;
+    size_t i;
+
+    /* a non-blocking command runs, see PUF_IsBusy() */
+    if (NULL != s_pufActive)
+    {
+        for (i = 0; i < jobCount; i++)
+        {
+            jobs[i].status = kStatus_PUF_Again;
+        }
+        return kStatus_PUF_Again;
+    }
+
+    /* check if SET KEY is allowed */
+    if (0x0u == (base->ALLOW & PUF_ALLOW_ALLOWSETKEY_MASK))
     {
+        status = kStatus_Fail;
     }
 
-    /* while busy read KC */
-    while (0 != (base->STAT & PUF_STAT_BUSY_MASK))
+    for (i = 0; i < jobCount; i++)
     {
-        if (0 != (PUF_STAT_CODEOUTAVAIL_MASK & base->STAT))
+        jobs[i].status = kStatus_Fail;
+        if (kStatus_Success == status)
         {
-            temp32 = base->CODEOUTPUT;
-            if (keyCodeSize >= sizeof(uint32_t))
-            {
-                *keyCodeAligned = temp32;
-                keyCodeAligned++;
-                keyCodeSize -= sizeof(uint32_t);
-            }
+            jobs[i].status = puf_checkSetKey(jobs[i].keyIndex, jobs[i].keySize, jobs[i].keyCode, jobs[i].keyCodeSize);
         }
     }
 
-    /* get status */
-    if (0 != (base->STAT & PUF_STAT_SUCCESS_MASK))
+    for (i = 0; i < jobCount; i++)
     {
-        status = kStatus_Success;
+        if (kStatus_Success == jobs[i].status)
+        {
+            jobs[i].status =
+                puf_setIntrinsicKey(base, jobs[i].keyIndex, jobs[i].keySize, jobs[i].keyCode, jobs[i].keyCodeSize);
+        }
+        if (kStatus_Success != jobs[i].status)
+        {
+            status = kStatus_Fail;
+        }
     }
 
     return status;
@@ -429,6 +779,7 @@ status_t PUF_SetIntrinsicKey(
  * param[out] keyCode Word aligned address of the resulting key code.
  * param keyCodeSize Size of the keyCode buffer in bytes. Shall be PUF_GET_KEY_CODE_SIZE_FOR_KEY_SIZE(userKeySize).
  * return Status of set user key operation.
+ * return kStatus_PUF_Again if a non-blocking command runs.
  */
 status_t PUF_SetUserKey(PUF_Type *base,
                         puf_key_index_register_t keyIndex,
@@ -442,34 +793,24 @@ status_t PUF_SetUserKey(PUF_Type *base,
     const uint32_t *userKeyAligned = NULL;  // RK why const?
     register uint32_t temp32 = 0;
 
-    /* check if SET KEY is allowed */
-    if (0x0u == (base->ALLOW & PUF_ALLOW_ALLOWSETKEY_MASK))
-    {
-        return kStatus_Fail;
-    }
-
-    /* only work with aligned keyCode */
-    if (0x3u & (uintptr_t)keyCode)
-    {
-        return kStatus_InvalidArgument;
-    }
-
-    /* Check that userKeySize is in the correct range and that it is multiple of 8 */
-    if ((userKeySize < kPUF_KeySizeMin) || (userKeySize > kPUF_KeySizeMax) || (userKeySize & 0x7))
+    /* a non-blocking command runs, see PUF_IsBusy() */
+    if (NULL != s_pufActive)
     {
-        return kStatus_InvalidArgument;
+        return kStatus_PUF_Again;
     }
 
-    /* check that keyCodeSize is correct for given userKeySize */
-    if (keyCodeSize < PUF_GET_KEY_CODE_SIZE_FOR_KEY_SIZE(userKeySize))
+    /* check if SET KEY is allowed */
+    if (0x0u == (base->ALLOW & PUF_ALLOW_ALLOWSETKEY_MASK))
     {
-        return kStatus_InvalidArgument;
+        return kStatus_Fail;
     }
 
-    if ((uint32_t)keyIndex > kPUF_KeyIndexMax)
+    status = puf_checkSetKey(keyIndex, userKeySize, keyCode, keyCodeSize);
+    if (status != kStatus_Success)
     {
-        return kStatus_InvalidArgument;
+        return status;
     }
+    status = kStatus_Fail;
 
     keyCodeAligned = (uint32_t *)(uintptr_t)keyCode;
     userKeyAligned = (const uint32_t *)(uintptr_t)userKey;
@@ -481,16 +822,7 @@ status_t PUF_SetUserKey(PUF_Type *base,
     /*if key index 0 - to be sent to AES, PRINCE, change endianess and */
     if (keyIndex == 0)
     {
-        uint32_t * pa = (uint32_t *)userKeyAligned;
-        uint32_t * pd = (uint32_t *)(&userKeyAligned[userKeySize >> 2]-1);
-        uint32_t i;
-    for(i = 0; i < (userKeySize >> 3); i++)
-    {
-        temp32 = *pa;
-        *pa++ = swap_bytes(*pd);
-        *pd-- = swap_bytes(temp32);
-    }
-      
+        puf_swapUserKey(userKey, userKeySize);
     }
     /* begin */
     base->CTRL = PUF_CTRL_SETKEY_MASK;
@@ -591,151 +923,151 @@ static status_t puf_getHwKey(PUF_Type *base, const uint8_t *keyCode, size_t keyC
  * param keyMask key masking value. Shall be random for each POR/reset. Value does not have to be cryptographicaly
  * secure.
  * return Status of get key operation.
+ * return kStatus_PUF_Again if a non-blocking command runs.
  */
 status_t PUF_GetHwKey(
     PUF_Type *base, const uint8_t *keyCode, size_t keyCodeSize, puf_key_slot_t keySlot, uint32_t keyMask)
 {
     status_t status = kStatus_Fail;
-    uint32_t keyIndex;
 
-    /* check if GET KEY is allowed */
-    if (0x0u == (base->ALLOW & PUF_ALLOW_ALLOWGETKEY_MASK))
+    /* a non-blocking command runs, see PUF_IsBusy() */
+    if (NULL != s_pufActive)
     {
-        return kStatus_Fail;
+        return kStatus_PUF_Again;
     }
 
-    /* only work with aligned keyCode */
-    if (0x3u & (uintptr_t)keyCode)
+    /* check if GET KEY is allowed */
+    if (0x0u == (base->ALLOW & PUF_ALLOW_ALLOWGETKEY_MASK))
     {
         return kStatus_Fail;
     }
 
     /* check that keyCodeSize is at least PUF_MIN_KEY_CODE_SIZE */
-    if (keyCodeSize < PUF_MIN_KEY_CODE_SIZE)
-    {
-        return kStatus_InvalidArgument;
-    }
-
-    keyIndex = 0x0Fu & keyCode[1];
-
-    /* check the Key Code header byte 1. index must be zero for the hw key. */
-    if (kPUF_KeyIndex_00 != (puf_key_index_register_t)keyIndex)
+    status = puf_checkGetKey(keyCode, keyCodeSize, PUF_MIN_KEY_CODE_SIZE, true);
+    if (status != kStatus_Success)
     {
-        return kStatus_Fail;
+        return status;
     }
 
 #if defined(FSL_FEATURE_PUF_HAS_KEYSLOTS) && (FSL_FEATURE_PUF_HAS_KEYSLOTS > 0)
-    //volatile uint32_t *keyMask_reg = NULL;
-#define PUF_KEYSLOT_EN 2
-    uint32_t regVal = (PUF_KEYSLOT_EN << (2 * keySlot));
-
-     if (keySlot >= FSL_FEATURE_PUF_HAS_KEYSLOTS)
+    if (keySlot >= FSL_FEATURE_PUF_HAS_KEYSLOTS)
     {
         return kStatus_InvalidArgument;
     }
-
-#endif /* FSL_FEATURE_PUF_HAS_KEYSLOTS */
-
-
-#if defined(FSL_FEATURE_PUF_HAS_KEYSLOTS) && (FSL_FEATURE_PUF_HAS_KEYSLOTS > 0)
-        base->KEYRESET = regVal;
-        base->KEYENABLE = regVal;
-        base->KEYMASK[keySlot] = keyMask;
 #endif /* FSL_FEATURE_PUF_HAS_KEYSLOTS */
 
-        status = puf_getHwKey(base, keyCode, keyCodeSize);
-
-#if defined(FSL_FEATURE_PUF_HAS_SHIFT_STATUS) && (FSL_FEATURE_PUF_HAS_SHIFT_STATUS > 0)
-        size_t keyWords = 0;
+    puf_setKeySlot(base, keySlot, keyMask);
 
-        if (status == kStatus_Success)
-        {
-            /* if the corresponding shift count does not match, return fail anyway */
-            keyWords = ((((size_t)keyCode[3]) * 2) - 1u) << (keySlot << 2);
-            if (keyWords != ((0x0Fu << (keySlot << 2)) & base->SHIFT_STATUS))
-            {
-                status = kStatus_Fail;
-            }
-        }
-#endif /* FSL_FEATURE_PUF_HAS_SHIFT_STATUS */
+    status = puf_getHwKey(base, keyCode, keyCodeSize);
 
+    if (status == kStatus_Success)
+    {
+        status = puf_checkShiftStatus(base, keyCode[3], keySlot);
+    }
+    puf_recordHwKey(keyCode, keyCodeSize, keySlot, status);
 
     return status;
 }
 
 /*!
- * brief Checks if Get Key operation is allowed.
+ * brief Checks if a key code is loaded to a key slot.
  *
- * This function returns true if get key operation is allowed.
+ * The driver records the key code of each successful PUF_GetHwKey() or PUF_GetHwKeyCached(). The records are
+ * cleared by PUF_Init(), PUF_Deinit(), PUF_Zeroize() and on reset. A failed or non-blocking get key to the slot
+ * clears its record.
  *
  * param base PUF peripheral base address
- * return true if get key operation is allowed
+ * param keyCode Key code.
+ * param keyCodeSize Size of the keyCode buffer in bytes.
+ * param keySlot key slot of the hw bus.
+ * return true if the key of keyCode is known to be loaded in keySlot
  */
-bool PUF_IsGetKeyAllowed(PUF_Type *base)
+bool PUF_IsHwKeyResident(PUF_Type *base, const uint8_t *keyCode, size_t keyCodeSize, puf_key_slot_t keySlot)
 {
-    /* check if GET KEY is allowed */
-    if (0x0u == (base->ALLOW & PUF_ALLOW_ALLOWGETKEY_MASK))
+    size_t length;
+
+    if ((NULL == keyCode) || (keyCodeSize < PUF_MIN_KEY_CODE_SIZE) || ((uint32_t)keySlot >= PUF_KEYSLOT_COUNT))
     {
         return false;
     }
 
-    return true;
+    length = puf_keyCodeLength(keyCode, keyCodeSize);
+
+    return ((s_pufResident[keySlot].keyCodeSize != 0u) && (s_pufResident[keySlot].keyCodeSize == length) &&
+            !memcmp(s_pufResident[keySlot].keyCode, keyCode, length));
 }
 
 /*!
- * brief Reconstruct key from a key code
+ * brief Reconstruct hw bus key from a key code unless it is already loaded
  *
- * The digital fingerprint generated during the Start operation and the KC
- * generated during a Set Key operation (Set intrinsic key or Set user key) are used to retrieve a stored key. This
- * operation needs to be done every time a key is needed.
- * This function accepts only Key Codes created for PUF index registers kPUF_KeyIndex_01 to kPUF_KeyIndex_15.
+ * Same as PUF_GetHwKey(), except that nothing is done when PUF_IsHwKeyResident() finds the key code in the key slot.
+ * The key mask of a key already loaded is not changed.
  *
  * param base PUF peripheral base address
  * param keyCode Word aligned address of the input key code.
  * param keyCodeSize Size of the keyCode buffer in bytes. Shall be PUF_GET_KEY_CODE_SIZE_FOR_KEY_SIZE(keySize).
- * param[out] key Word aligned address of output key.
- * param keySize Size of the output key in bytes.
+ * param keySlot key slot to output on hw bus. Parameter is ignored on devices with less than two key slots.
+ * param keyMask key masking value. Shall be random for each POR/reset. Value does not have to be cryptographicaly
+ * secure.
  * return Status of get key operation.
+ * return kStatus_PUF_Again if a non-blocking command runs.
  */
-status_t PUF_GetKey(PUF_Type *base, const uint8_t *keyCode, size_t keyCodeSize, uint8_t *key, size_t keySize)
+status_t PUF_GetHwKeyCached(
+    PUF_Type *base, const uint8_t *keyCode, size_t keyCodeSize, puf_key_slot_t keySlot, uint32_t keyMask)
 {
-    status_t status = kStatus_Fail;
-    uint32_t *keyCodeAligned = NULL;
-    uint32_t *keyAligned = NULL;
-    uint32_t keyIndex;
-    register uint32_t temp32 = 0;
-
-    /* check if GET KEY is allowed */
-    if (0x0u == (base->ALLOW & PUF_ALLOW_ALLOWGETKEY_MASK))
+    if (PUF_IsHwKeyResident(base, keyCode, keyCodeSize, keySlot))
     {
-        return kStatus_Fail;
+        return kStatus_Success;
     }
 
-    /* only work with aligned keyCode */
-    if (0x3u & (uintptr_t)keyCode)
-    {
-        return kStatus_Fail;
-    }
+    return PUF_GetHwKey(base, keyCode, keyCodeSize, keySlot, keyMask);
+}
 
-    /* only work with aligned key */
-    if (0x3u & (uintptr_t)key)
+/*!
+ * brief Forgets the key code loaded to a key slot.
+ *
+ * To be called when the key slot is reloaded or reset by other means than this driver, so that the next
+ * PUF_GetHwKeyCached() reconstructs the key again.
+ *
+ * param base PUF peripheral base address
+ * param keySlot key slot of the hw bus.
+ */
+void PUF_InvalidateHwKey(PUF_Type *base, puf_key_slot_t keySlot)
+{
+    if ((uint32_t)keySlot < PUF_KEYSLOT_COUNT)
     {
-        return kStatus_Fail;
+        memset(&s_pufResident[keySlot], 0, sizeof(s_pufResident[keySlot]));
     }
+}
 
-    /* check that keyCodeSize is correct for given keySize */
-    if (keyCodeSize < PUF_GET_KEY_CODE_SIZE_FOR_KEY_SIZE(keySize))
+/*!
+ * brief Checks if Get Key operation is allowed.
+ *
+ * This function returns true if get key operation is allowed.
+ *
+ * param base PUF peripheral base address
+ * return true if get key operation is allowed
+ */
+bool PUF_IsGetKeyAllowed(PUF_Type *base)
+{
+    /* check if GET KEY is allowed */
+    if (0x0u == (base->ALLOW & PUF_ALLOW_ALLOWGETKEY_MASK))
     {
-        return kStatus_InvalidArgument;
+        return false;
     }
 
-    keyIndex = 0x0Fu & keyCode[1];
+    return true;
+}
 
-    /* check the Key Code header byte 1. index must be non-zero for the register key. */
-    if (kPUF_KeyIndex_00 == (puf_key_index_register_t)keyIndex)
-    {
-        return kStatus_Fail;
-    }
+static status_t puf_getKey(PUF_Type *base, const uint8_t *keyCode, size_t keyCodeSize, uint8_t *key, size_t keySize)
+{
+    status_t status = kStatus_Fail;
+    uint32_t *keyCodeAligned = NULL;
+    uint32_t *keyAligned = NULL;
+    uint32_t keyIndex;
+    register uint32_t temp32 = 0;
+
+    keyIndex = 0x0Fu & keyCode[1];
 
     keyCodeAligned = (uint32_t *)(uintptr_t)keyCode;
     keyAligned = (uint32_t *)(uintptr_t)key;
@@ -786,25 +1118,680 @@ status_t PUF_GetKey(PUF_Type *base, const uint8_t *keyCode, size_t keyCodeSize,
 }
 
 /*!
- * brief Zeroize PUF
+ * brief Reconstruct key from a key code
  *
- * This function clears all PUF internal logic and puts the PUF to error state.
+ * The digital fingerprint generated during the Start operation and the KC
+ * generated during a Set Key operation (Set intrinsic key or Set user key) are used to retrieve a stored key. This
+ * operation needs to be done every time a key is needed.
+ * This function accepts only Key Codes created for PUF index registers kPUF_KeyIndex_01 to kPUF_KeyIndex_15.
  *
  * param base PUF peripheral base address
- * return Status of the zeroize operation.
+ * param keyCode Word aligned address of the input key code.
+ * param keyCodeSize Size of the keyCode buffer in bytes. Shall be PUF_GET_KEY_CODE_SIZE_FOR_KEY_SIZE(keySize).
+ * param[out] key Word aligned address of output key.
+ * param keySize Size of the output key in bytes.
+ * return Status of get key operation.
+ * return kStatus_PUF_Again if a non-blocking command runs.
  */
-status_t PUF_Zeroize(PUF_Type *base)
+status_t PUF_GetKey(PUF_Type *base, const uint8_t *keyCode, size_t keyCodeSize, uint8_t *key, size_t keySize)
 {
     status_t status = kStatus_Fail;
 
-    /* zeroize command is always allowed */
-    base->CTRL = PUF_CTRL_ZEROIZE_MASK;
+    /* a non-blocking command runs, see PUF_IsBusy() */
+    if (NULL != s_pufActive)
+    {
+        return kStatus_PUF_Again;
+    }
 
-    /* check that command is accepted */
-    if ((0 != (base->STAT & PUF_STAT_ERROR_MASK)) && (0 == base->ALLOW))
+    /* check if GET KEY is allowed */
+    if (0x0u == (base->ALLOW & PUF_ALLOW_ALLOWGETKEY_MASK))
     {
-        status = kStatus_Success;
+        return kStatus_Fail;
     }
 
-    return status;
+    /* only work with aligned key */
+    if (0x3u & (uintptr_t)key)
+    {
+        return kStatus_Fail;
+    }
+
+    /* check that keyCodeSize is correct for given keySize */
+    status = puf_checkGetKey(keyCode, keyCodeSize, PUF_GET_KEY_CODE_SIZE_FOR_KEY_SIZE(keySize), false);
+    if (status != kStatus_Success)
+    {
+        return status;
+    }
+
+    return puf_getKey(base, keyCode, keyCodeSize, key, keySize);
+}
+
+/*!
+ * brief Reconstruct several keys from their key codes
+ *
+ * Same as calling PUF_GetKey() for each job. ALLOW is checked once and all key code headers are validated before
+ * the first key is reconstructed, then the Get Key commands are issued back to back.
+ *
+ * param base PUF peripheral base address
+ * param[in,out] jobs Array of jobs. Status of each job is stored to its status member.
+ * param jobCount Number of jobs in the array.
+ * return kStatus_Success if all jobs succeeded, kStatus_Fail otherwise.
+ * return kStatus_PUF_Again if a non-blocking command runs.
+ */
+status_t PUF_GetKeys(PUF_Type *base, puf_get_key_job_t *jobs, size_t jobCount)
+{
+    status_t status = kStatus_Success;
+    size_t i;
+
+    /* a non-blocking command runs, see PUF_IsBusy() */
+    if (NULL != s_pufActive)
+    {
+        for (i = 0; i < jobCount; i++)
+        {
+            jobs[i].status = kStatus_PUF_Again;
+        }
+        return kStatus_PUF_Again;
+    }
+
+    /* check if GET KEY is allowed */
+    if (0x0u == (base->ALLOW & PUF_ALLOW_ALLOWGETKEY_MASK))
+    {
+        status = kStatus_Fail;
+    }
+
+    for (i = 0; i < jobCount; i++)
+    {
+        jobs[i].status = kStatus_Fail;
+        if ((kStatus_Success == status) && (0 == (0x3u & (uintptr_t)jobs[i].key)))
+        {
+            jobs[i].status = puf_checkGetKey(jobs[i].keyCode, jobs[i].keyCodeSize,
+                                             PUF_GET_KEY_CODE_SIZE_FOR_KEY_SIZE(jobs[i].keySize), false);
+        }
+    }
+
+    for (i = 0; i < jobCount; i++)
+    {
+        if (kStatus_Success == jobs[i].status)
+        {
+            jobs[i].status = puf_getKey(base, jobs[i].keyCode, jobs[i].keyCodeSize, jobs[i].key, jobs[i].keySize);
+        }
+        if (kStatus_Success != jobs[i].status)
+        {
+            status = kStatus_Fail;
+        }
+    }
+
+    return status;
+}
+
+/*!
+ * brief Zeroize PUF
+ *
+ * This function clears all PUF internal logic and puts the PUF to error state.
+ *
+ * param base PUF peripheral base address
+ * return Status of the zeroize operation.
+ */
+status_t PUF_Zeroize(PUF_Type *base)
+{
+    status_t status = kStatus_Fail;
+
+    /* zeroize command is always allowed */
+    base->CTRL = PUF_CTRL_ZEROIZE_MASK;
+    puf_forgetHwKeys();
+
+    /* check that command is accepted */
+    if ((0 != (base->STAT & PUF_STAT_ERROR_MASK)) && (0 == base->ALLOW))
+    {
+        status = kStatus_Success;
+    }
+
+    return status;
+}
+
+/* returns the next word to send, zero once the buffer is exhausted */
+static uint32_t puf_nextWord(const uint32_t **buffer, size_t *size)
+{
+    uint32_t temp32 = 0;
+
+    if (*size >= sizeof(uint32_t))
+    {
+        temp32 = **buffer;
+        (*buffer)++;
+        *size -= sizeof(uint32_t);
+    }
+
+    return temp32;
+}
+
+/* stores a received word, drops it once the buffer is full */
+static void puf_storeWord(uint32_t **buffer, size_t *size, uint32_t temp32)
+{
+    if (*size >= sizeof(uint32_t))
+    {
+        **buffer = temp32;
+        (*buffer)++;
+        *size -= sizeof(uint32_t);
+    }
+}
+
+/* starts the command of the handle, must be called with the PUF interrupt masked */
+static status_t puf_startCommand(PUF_Type *base, puf_handle_t *handle)
+{
+    uint32_t allow;
+    uint32_t ctrl;
+
+    switch (handle->command)
+    {
+        case kPUF_CommandEnroll:
+            allow = PUF_ALLOW_ALLOWENROLL_MASK;
+            ctrl = PUF_CTRL_ENROLL_MASK;
+            break;
+        case kPUF_CommandStart:
+            allow = PUF_ALLOW_ALLOWSTART_MASK;
+            ctrl = PUF_CTRL_START_MASK;
+            break;
+        case kPUF_CommandSetIntrinsicKey:
+            allow = PUF_ALLOW_ALLOWSETKEY_MASK;
+            ctrl = PUF_CTRL_GENERATEKEY_MASK;
+            break;
+        case kPUF_CommandSetUserKey:
+            allow = PUF_ALLOW_ALLOWSETKEY_MASK;
+            ctrl = PUF_CTRL_SETKEY_MASK;
+            break;
+        default:
+            allow = PUF_ALLOW_ALLOWGETKEY_MASK;
+            ctrl = PUF_CTRL_GETKEY_MASK;
+            break;
+    }
+
+    /* ALLOW is checked here, as the command that runs before a queued one may change it */
+    if (0x0u == (base->ALLOW & allow))
+    {
+        return kStatus_Fail;
+    }
+
+    if ((kPUF_CommandSetIntrinsicKey == handle->command) || (kPUF_CommandSetUserKey == handle->command))
+    {
+        /* program the key size and index */
+        base->KEYSIZE = handle->keySize >> 3;
+        base->KEYINDEX = handle->keyIndex;
+    }
+    else if (kPUF_CommandGetHwKey == handle->command)
+    {
+        puf_setKeySlot(base, handle->keySlot, handle->keyMask);
+        PUF_InvalidateHwKey(base, handle->keySlot);
+    }
+    else
+    {
+    }
+
+    /* clear events of the previous command before the first request of this one can be raised */
+    base->INTSTAT = base->INTSTAT;
+
+    s_pufActive = handle;
+    base->CTRL = ctrl;
+
+    /* wait till command is accepted */
+    while (0 == (base->STAT & (PUF_STAT_BUSY_MASK | PUF_STAT_ERROR_MASK)))
+    {
+    }
+
+    /* let PUF isr serve the word requests */
+    base->INTEN = PUF_INTEN_COMMAND_MASK;
+
+    return kStatus_Success;
+}
+
+/* starts the command of the handle, or queues it if a command runs */
+static status_t puf_submit(PUF_Type *base, puf_handle_t *handle)
+{
+    status_t status = kStatus_Success;
+    uint32_t regPrimask;
+
+    regPrimask = DisableGlobalIRQ();
+    if (NULL == s_pufActive)
+    {
+        status = puf_startCommand(base, handle);
+    }
+    else if (NULL == s_pufQueued)
+    {
+        s_pufQueued = handle;
+    }
+    else
+    {
+        status = kStatus_PUF_Again;
+    }
+    EnableGlobalIRQ(regPrimask);
+
+    return status;
+}
+
+/* status of a completed command, evaluated as the blocking functions do */
+static status_t puf_commandStatus(PUF_Type *base, puf_handle_t *handle, uint32_t stat)
+{
+    status_t status = kStatus_Fail;
+
+    if (0 != (stat & PUF_STAT_SUCCESS_MASK))
+    {
+        status = kStatus_Success;
+    }
+
+    if (kStatus_Success == status)
+    {
+        switch (handle->command)
+        {
+            case kPUF_CommandEnroll:
+                if (handle->codeOutSize != 0)
+                {
+                    status = kStatus_Fail;
+                }
+                break;
+            case kPUF_CommandGetKey:
+                if (0 == handle->keyIndex)
+                {
+                    status = kStatus_Fail;
+                }
+                break;
+            case kPUF_CommandGetHwKey:
+                status = puf_checkShiftStatus(base, handle->keySize >> 3, handle->keySlot);
+                break;
+            default:
+                break;
+        }
+    }
+
+    return status;
+}
+
+/*!
+ * brief Installs the callback of a non-blocking PUF command handle.
+ *
+ * This function stores the callback in the handle and enables PUF interrupt.
+ *
+ * param base PUF peripheral base address
+ * param handle Handle of the non-blocking commands
+ * param callback Callback function, invoked from PUF isr when a command of the handle completes
+ * param userData User data passed as an argument to callback function
+ */
+void PUF_SetCallback(PUF_Type *base, puf_handle_t *handle, puf_callback_t callback, void *userData)
+{
+    memset(handle, 0, sizeof(*handle));
+    handle->callback = callback;
+    handle->userData = userData;
+
+    EnableIRQ(PUF_IRQn);
+}
+
+/*!
+ * brief Enroll PUF in background
+ *
+ * Same as PUF_Enroll(). The activation code is read out word by word by PUF isr, the CPU is free in between.
+ * Non-blocking commands run one at a time. One more command can be queued while a command runs, it is started
+ * by PUF isr as soon as the running command completes, before the callback of the completed one is invoked.
+ *
+ * param base PUF peripheral base address
+ * param handle Handle with the callback set by PUF_SetCallback(). Shall not be in use.
+ * param[out] activationCode Word aligned address of the resulting activation code.
+ * param activationCodeSize Size of the activationCode buffer in bytes. Shall be 1192 bytes.
+ * return kStatus_Success if the command has been started or queued.
+ * return kStatus_PUF_Again if a command runs and another one is already queued.
+ * return kStatus_Fail or kStatus_InvalidArgument, as PUF_Enroll().
+ */
+status_t PUF_EnrollNonBlocking(PUF_Type *base,
+                               puf_handle_t *handle,
+                               uint8_t *activationCode,
+                               size_t activationCodeSize)
+{
+    status_t status;
+
+    status = puf_checkActivationCode(activationCode, activationCodeSize);
+    if (status != kStatus_Success)
+    {
+        return status;
+    }
+
+    handle->command = kPUF_CommandEnroll;
+    handle->codeIn = NULL;
+    handle->codeInSize = 0;
+    handle->codeOut = (uint32_t *)(uintptr_t)activationCode;
+    handle->codeOutSize = activationCodeSize;
+    handle->keyIn = NULL;
+    handle->keyInSize = 0;
+    handle->keyOut = NULL;
+    handle->keyOutSize = 0;
+
+    return puf_submit(base, handle);
+}
+
+/*!
+ * brief Start PUF in background
+ *
+ * Same as PUF_Start(), the activation code is sent by PUF isr. See PUF_EnrollNonBlocking() for queuing.
+ *
+ * param base PUF peripheral base address
+ * param handle Handle with the callback set by PUF_SetCallback(). Shall not be in use.
+ * param activationCode Word aligned address of the input activation code. Shall stay valid until the callback.
+ * param activationCodeSize Size of the activationCode buffer in bytes. Shall be 1192 bytes.
+ * return kStatus_Success if the command has been started or queued.
+ * return kStatus_PUF_Again if a command runs and another one is already queued.
+ * return kStatus_Fail or kStatus_InvalidArgument, as PUF_Start().
+ */
+status_t PUF_StartNonBlocking(PUF_Type *base,
+                              puf_handle_t *handle,
+                              const uint8_t *activationCode,
+                              size_t activationCodeSize)
+{
+    status_t status;
+
+    status = puf_checkActivationCode(activationCode, activationCodeSize);
+    if (status != kStatus_Success)
+    {
+        return status;
+    }
+
+    handle->command = kPUF_CommandStart;
+    handle->codeIn = (const uint32_t *)(uintptr_t)activationCode;
+    handle->codeInSize = activationCodeSize;
+    handle->codeOut = NULL;
+    handle->codeOutSize = 0;
+    handle->keyIn = NULL;
+    handle->keyInSize = 0;
+    handle->keyOut = NULL;
+    handle->keyOutSize = 0;
+
+    return puf_submit(base, handle);
+}
+
+/*!
+ * brief Set intrinsic key in background
+ *
+ * Same as PUF_SetIntrinsicKey(), the key code is read out by PUF isr. See PUF_EnrollNonBlocking() for queuing.
+ *
+ * param base PUF peripheral base address
+ * param handle Handle with the callback set by PUF_SetCallback(). Shall not be in use.
+ * param keyIndex PUF key index register
+ * param keySize Size of the intrinsic key to generate in bytes.
+ * param[out] keyCode Word aligned address of the resulting key code.
+ * param keyCodeSize Size of the keyCode buffer in bytes. Shall be PUF_GET_KEY_CODE_SIZE_FOR_KEY_SIZE(keySize).
+ * return kStatus_Success if the command has been started or queued.
+ * return kStatus_PUF_Again if a command runs and another one is already queued.
+ * return kStatus_Fail or kStatus_InvalidArgument, as PUF_SetIntrinsicKey().
+ */
+status_t PUF_SetIntrinsicKeyNonBlocking(PUF_Type *base,
+                                        puf_handle_t *handle,
+                                        puf_key_index_register_t keyIndex,
+                                        size_t keySize,
+                                        uint8_t *keyCode,
+                                        size_t keyCodeSize)
+{
+    status_t status;
+
+    status = puf_checkSetKey(keyIndex, keySize, keyCode, keyCodeSize);
+    if (status != kStatus_Success)
+    {
+        return status;
+    }
+
+    handle->command = kPUF_CommandSetIntrinsicKey;
+    handle->codeIn = NULL;
+    handle->codeInSize = 0;
+    handle->codeOut = (uint32_t *)(uintptr_t)keyCode;
+    handle->codeOutSize = keyCodeSize;
+    handle->keyIn = NULL;
+    handle->keyInSize = 0;
+    handle->keyOut = NULL;
+    handle->keyOutSize = 0;
+    handle->keyIndex = (uint32_t)keyIndex;
+    handle->keySize = keySize;
+
+    return puf_submit(base, handle);
+}
+
+/*!
+ * brief Set user key in background
+ *
+ * Same as PUF_SetUserKey(), the user key is sent and the key code read out by PUF isr. See PUF_EnrollNonBlocking()
+ * for queuing.
+ *
+ * param base PUF peripheral base address
+ * param handle Handle with the callback set by PUF_SetCallback(). Shall not be in use.
+ * param keyIndex PUF key index register
+ * param userKey Word aligned address of input user key. Shall stay valid until the callback.
+ * param userKeySize Size of the input user key in bytes.
+ * param[out] keyCode Word aligned address of the resulting key code.
+ * param keyCodeSize Size of the keyCode buffer in bytes. Shall be PUF_GET_KEY_CODE_SIZE_FOR_KEY_SIZE(userKeySize).
+ * return kStatus_Success if the command has been started or queued.
+ * return kStatus_PUF_Again if a command runs and another one is already queued.
+ * return kStatus_Fail or kStatus_InvalidArgument, as PUF_SetUserKey().
+ */
+status_t PUF_SetUserKeyNonBlocking(PUF_Type *base,
+                                   puf_handle_t *handle,
+                                   puf_key_index_register_t keyIndex,
+                                   const uint8_t *userKey,
+                                   size_t userKeySize,
+                                   uint8_t *keyCode,
+                                   size_t keyCodeSize)
+{
+    status_t status;
+
+    status = puf_checkSetKey(keyIndex, userKeySize, keyCode, keyCodeSize);
+    if (status != kStatus_Success)
+    {
+        return status;
+    }
+
+    /* only work with aligned userKey */
+    if (0x3u & (uintptr_t)userKey)
+    {
+        return kStatus_InvalidArgument;
+    }
+
+    handle->command = kPUF_CommandSetUserKey;
+    handle->codeIn = NULL;
+    handle->codeInSize = 0;
+    handle->codeOut = (uint32_t *)(uintptr_t)keyCode;
+    handle->codeOutSize = keyCodeSize;
+    handle->keyIn = (const uint32_t *)(uintptr_t)userKey;
+    handle->keyInSize = userKeySize;
+    handle->keyOut = NULL;
+    handle->keyOutSize = 0;
+    handle->keyIndex = (uint32_t)keyIndex;
+    handle->keySize = userKeySize;
+
+    /* as PUF_SetUserKey(), the key of index 0 is sent reversed, it has to be swapped before PUF isr may read it */
+    if (keyIndex == 0)
+    {
+        puf_swapUserKey(userKey, userKeySize);
+    }
+
+    status = puf_submit(base, handle);
+
+    /* not started nor queued, the caller gets its key back as it was */
+    if ((kStatus_Success != status) && (keyIndex == 0))
+    {
+        puf_swapUserKey(userKey, userKeySize);
+    }
+
+    return status;
+}
+
+/*!
+ * brief Reconstruct key from a key code in background
+ *
+ * Same as PUF_GetKey(), the key code is sent and the key read out by PUF isr. See PUF_EnrollNonBlocking()
+ * for queuing.
+ *
+ * param base PUF peripheral base address
+ * param handle Handle with the callback set by PUF_SetCallback(). Shall not be in use.
+ * param keyCode Word aligned address of the input key code. Shall stay valid until the callback.
+ * param keyCodeSize Size of the keyCode buffer in bytes. Shall be PUF_GET_KEY_CODE_SIZE_FOR_KEY_SIZE(keySize).
+ * param[out] key Word aligned address of output key.
+ * param keySize Size of the output key in bytes.
+ * return kStatus_Success if the command has been started or queued.
+ * return kStatus_PUF_Again if a command runs and another one is already queued.
+ * return kStatus_Fail or kStatus_InvalidArgument, as PUF_GetKey().
+ */
+status_t PUF_GetKeyNonBlocking(
+    PUF_Type *base, puf_handle_t *handle, const uint8_t *keyCode, size_t keyCodeSize, uint8_t *key, size_t keySize)
+{
+    status_t status;
+
+    /* only work with aligned key */
+    if (0x3u & (uintptr_t)key)
+    {
+        return kStatus_Fail;
+    }
+
+    status = puf_checkGetKey(keyCode, keyCodeSize, PUF_GET_KEY_CODE_SIZE_FOR_KEY_SIZE(keySize), false);
+    if (status != kStatus_Success)
+    {
+        return status;
+    }
+
+    handle->command = kPUF_CommandGetKey;
+    handle->codeIn = (const uint32_t *)(uintptr_t)keyCode;
+    handle->codeInSize = keyCodeSize;
+    handle->codeOut = NULL;
+    handle->codeOutSize = 0;
+    handle->keyIn = NULL;
+    handle->keyInSize = 0;
+    handle->keyOut = (uint32_t *)(uintptr_t)key;
+    handle->keyOutSize = keySize;
+    handle->keyIndex = 0x0Fu & keyCode[1];
+
+    return puf_submit(base, handle);
+}
+
+/*!
+ * brief Reconstruct hw bus key from a key code in background
+ *
+ * Same as PUF_GetHwKey(), the key code is sent by PUF isr. See PUF_EnrollNonBlocking() for queuing. The key slot
+ * is configured when the command starts.
+ *
+ * param base PUF peripheral base address
+ * param handle Handle with the callback set by PUF_SetCallback(). Shall not be in use.
+ * param keyCode Word aligned address of the input key code. Shall stay valid until the callback.
+ * param keyCodeSize Size of the keyCode buffer in bytes. Shall be PUF_GET_KEY_CODE_SIZE_FOR_KEY_SIZE(keySize).
+ * param keySlot key slot to output on hw bus. Parameter is ignored on devices with less than two key slots.
+ * param keyMask key masking value. Shall be random for each POR/reset.
+ * return kStatus_Success if the command has been started or queued.
+ * return kStatus_PUF_Again if a command runs and another one is already queued.
+ * return kStatus_Fail or kStatus_InvalidArgument, as PUF_GetHwKey().
+ */
+status_t PUF_GetHwKeyNonBlocking(PUF_Type *base,
+                                 puf_handle_t *handle,
+                                 const uint8_t *keyCode,
+                                 size_t keyCodeSize,
+                                 puf_key_slot_t keySlot,
+                                 uint32_t keyMask)
+{
+    status_t status;
+
+    status = puf_checkGetKey(keyCode, keyCodeSize, PUF_MIN_KEY_CODE_SIZE, true);
+    if (status != kStatus_Success)
+    {
+        return status;
+    }
+
+#if defined(FSL_FEATURE_PUF_HAS_KEYSLOTS) && (FSL_FEATURE_PUF_HAS_KEYSLOTS > 0)
+    if (keySlot >= FSL_FEATURE_PUF_HAS_KEYSLOTS)
+    {
+        return kStatus_InvalidArgument;
+    }
+#endif /* FSL_FEATURE_PUF_HAS_KEYSLOTS */
+
+    handle->command = kPUF_CommandGetHwKey;
+    handle->codeIn = (const uint32_t *)(uintptr_t)keyCode;
+    handle->codeInSize = keyCodeSize;
+    handle->codeOut = NULL;
+    handle->codeOutSize = 0;
+    handle->keyIn = NULL;
+    handle->keyInSize = 0;
+    handle->keyOut = NULL;
+    handle->keyOutSize = 0;
+    handle->keySlot = keySlot;
+    handle->keyMask = keyMask;
+    handle->keySize = (uint32_t)keyCode[3] << 3;
+
+    return puf_submit(base, handle);
+}
+
+/*!
+ * brief Checks if a non-blocking PUF command runs.
+ *
+ * param base PUF peripheral base address
+ * return true if a non-blocking command runs or is queued
+ */
+bool PUF_IsBusy(PUF_Type *base)
+{
+    return (NULL != s_pufActive);
+}
+
+void PUF_DriverIRQHandler(void)
+{
+    PUF_Type *base = PUF;
+    puf_handle_t *handle = s_pufActive;
+    puf_handle_t *next;
+    status_t status;
+    uint32_t stat = 0;
+
+    /* clear the events first, any request raised after the last read of STAT below enters the isr again */
+    base->INTSTAT = base->INTSTAT;
+
+    if (NULL != handle)
+    {
+        /* serve the word requests, the PUF raises the next one within a few cycles */
+        stat = base->STAT;
+        while ((0 != (stat & PUF_STAT_BUSY_MASK)) && (0 != (stat & PUF_STAT_REQUEST_MASK)))
+        {
+            if (0 != (PUF_STAT_CODEINREQ_MASK & stat))
+            {
+                base->CODEINPUT = puf_nextWord(&handle->codeIn, &handle->codeInSize);
+            }
+            if (0 != (PUF_STAT_KEYINREQ_MASK & stat))
+            {
+                base->KEYINPUT = puf_nextWord(&handle->keyIn, &handle->keyInSize);
+            }
+            if (0 != (PUF_STAT_CODEOUTAVAIL_MASK & stat))
+            {
+                puf_storeWord(&handle->codeOut, &handle->codeOutSize, base->CODEOUTPUT);
+            }
+            if (0 != (PUF_STAT_KEYOUTAVAIL_MASK & stat))
+            {
+                handle->keyIndex = base->KEYOUTINDEX;
+                puf_storeWord(&handle->keyOut, &handle->keyOutSize, base->KEYOUTPUT);
+            }
+            stat = base->STAT;
+        }
+    }
+
+    if ((NULL == handle) || (0 == (stat & PUF_STAT_BUSY_MASK)))
+    {
+        base->INTEN = 0;
+    }
+
+    if ((NULL != handle) && (0 == (stat & PUF_STAT_BUSY_MASK)))
+    {
+        status = puf_commandStatus(base, handle, stat);
+
+        /* start the queued command before the callback, so that the PUF does not idle during it */
+        s_pufActive = NULL;
+        next = s_pufQueued;
+        s_pufQueued = NULL;
+        if ((NULL != next) && (kStatus_Success != puf_startCommand(base, next)) && (NULL != next->callback))
+        {
+            /* not allowed, the queued command completes right away */
+            next->callback(base, next, kStatus_Fail, next->userData);
+        }
+
+        if (NULL != handle->callback)
+        {
+            handle->callback(base, handle, status, handle->userData);
+        }
+    }
+/* Add for ARM errata 838869, affects Cortex-M4, Cortex-M4F Store immediate overlapping
+  exception return operation might vector to incorrect interrupt */
+#if defined __CORTEX_M && (__CORTEX_M == 4U)
+    __DSB();
+#endif
 }
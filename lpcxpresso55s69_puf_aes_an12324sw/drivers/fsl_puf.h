@@ -16,6 +16,13 @@
 
 #define swap_bytes(in) __REV(in)
 
+/*! @brief PUF status return codes. */
+enum _puf_status
+{
+    kStatus_PUF_Again = MAKE_STATUS(kStatusGroup_PUF, 0), /*!< A non-blocking command is running, and another one is
+                                                              queued or a blocking function was called. */
+};
+
 typedef enum _puf_key_index_register
 {
     kPUF_KeyIndex_00 = 0x00U,
@@ -57,6 +64,69 @@ typedef enum _puf_key_slot
 #define PUF_GET_KEY_CODE_SIZE_FOR_KEY_SIZE(x) ((160u + ((((x << 3) + 255u) >> 8) << 8)) >> 3)
 #define PUF_MIN_KEY_CODE_SIZE PUF_GET_KEY_CODE_SIZE_FOR_KEY_SIZE(8)
 #define PUF_ACTIVATION_CODE_SIZE 1192
+
+/*! @brief Largest key code whose residency in a key slot is tracked, that of a 256-bit AES key. */
+#define PUF_RESIDENT_KEY_CODE_SIZE PUF_GET_KEY_CODE_SIZE_FOR_KEY_SIZE(32u)
+
+/*! @brief Key generated by PUF_SetIntrinsicKeys(). */
+typedef struct _puf_set_key_job
+{
+    puf_key_index_register_t keyIndex; /*!< PUF key index register */
+    size_t keySize;                    /*!< Size of the intrinsic key to generate in bytes */
+    uint8_t *keyCode;                  /*!< Word aligned address of the resulting key code */
+    size_t keyCodeSize;                /*!< Size of the keyCode buffer in bytes */
+    status_t status;                   /*!< Output status of this job */
+} puf_set_key_job_t;
+
+/*! @brief Key reconstructed by PUF_GetKeys(). */
+typedef struct _puf_get_key_job
+{
+    const uint8_t *keyCode; /*!< Word aligned address of the input key code, key index 1 to 15 */
+    size_t keyCodeSize;     /*!< Size of the keyCode buffer in bytes */
+    uint8_t *key;           /*!< Word aligned address of output key */
+    size_t keySize;         /*!< Size of the output key in bytes */
+    status_t status;        /*!< Output status of this job */
+} puf_get_key_job_t;
+
+/*! @brief PUF command run by the non-blocking APIs. */
+typedef enum _puf_command
+{
+    kPUF_CommandEnroll = 0U,          /*!< Enroll, activation code out */
+    kPUF_CommandStart = 1U,           /*!< Start, activation code in */
+    kPUF_CommandSetIntrinsicKey = 2U, /*!< Set intrinsic key, key code out */
+    kPUF_CommandSetUserKey = 3U,      /*!< Set user key, user key in and key code out */
+    kPUF_CommandGetKey = 4U,          /*!< Get key, key code in and key out */
+    kPUF_CommandGetHwKey = 5U,        /*!< Get key to the hardware bus, key code in */
+} puf_command_t;
+
+typedef struct _puf_handle puf_handle_t;
+
+/*! @brief PUF non-blocking command callback, invoked from PUF isr. */
+typedef void (*puf_callback_t)(PUF_Type *base, puf_handle_t *handle, status_t status, void *userData);
+
+/*!
+ * @brief PUF non-blocking command handle.
+ *
+ * The handle is owned by the driver from the non-blocking call until its callback is invoked.
+ */
+struct _puf_handle
+{
+    puf_command_t command;   /*!< Command */
+    const uint32_t *codeIn;  /*!< Activation code or key code to send, NULL if the command has none */
+    size_t codeInSize;       /*!< Remaining bytes of codeIn */
+    uint32_t *codeOut;       /*!< Activation code or key code to receive, NULL if the command has none */
+    size_t codeOutSize;      /*!< Remaining bytes of codeOut */
+    const uint32_t *keyIn;   /*!< User key to send, NULL if the command has none */
+    size_t keyInSize;        /*!< Remaining bytes of keyIn */
+    uint32_t *keyOut;        /*!< Key to receive, NULL if the command has none */
+    size_t keyOutSize;       /*!< Remaining bytes of keyOut */
+    uint32_t keyIndex;       /*!< Key index of a set key command, last KEYOUTINDEX of a get key command */
+    uint32_t keySize;        /*!< Key size of a set key or get key to the hardware bus command in bytes */
+    puf_key_slot_t keySlot;  /*!< Key slot of a get key to the hardware bus command */
+    uint32_t keyMask;        /*!< Key mask of a get key to the hardware bus command */
+    puf_callback_t callback; /*!< Callback invoked from PUF isr when the command completes */
+    void *userData;          /*!< User data passed as an argument to callback function */
+};
 /*******************************************************************************
  * API
  *******************************************************************************/
@@ -88,6 +158,64 @@ status_t PUF_Init(PUF_Type *base, uint32_t dischargeTimeMsec, uint32_t coreClock
  */
 void PUF_Deinit(PUF_Type *base, uint32_t dischargeTimeMsec, uint32_t coreClockFrequencyHz);
 
+/*!
+ * @brief Starts discharging PUF SRAM
+ *
+ * First half of the power cycle done by PUF_Init() and PUF_Deinit(), without the wait. PUF SRAM is powered down
+ * and left to discharge while the CPU sleeps or does other work, the discharge time being measured by the caller,
+ * typically with a hardware timer. PUF_DischargeEnd(), or PUF_DischargePowerUp() from the timer isr, shall be
+ * called once the discharge time has elapsed, or PUF_DischargeDeinit() to leave the PUF deinitialized.
+ * Non-blocking commands are dropped and the key slot records cleared.
+ *
+ * @param base PUF peripheral base address
+ */
+void PUF_DischargeStart(PUF_Type *base);
+
+/*!
+ * @brief Powers PUF SRAM up after discharging it
+ *
+ * Resets the PUF and powers PUF SRAM up, without waiting until the block initializes, so that it can be called
+ * from the isr of the timer that measures the discharge time. PUF_DischargeWaitForInit() shall be called next.
+ *
+ * @param base PUF peripheral base address
+ * @param coreClockFrequencyHz core clock frequency in Hz
+ */
+void PUF_DischargePowerUp(PUF_Type *base, uint32_t coreClockFrequencyHz);
+
+/*!
+ * @brief Waits until the PUF initializes after PUF_DischargePowerUp()
+ *
+ * The PUF is then in the same state as after PUF_Init().
+ *
+ * @param base PUF peripheral base address
+ * @return kStatus_Success, kStatus_Fail if the PUF did not initialize or does not allow Enroll and Start, which
+ * means that the discharge time was too short.
+ */
+status_t PUF_DischargeWaitForInit(PUF_Type *base);
+
+/*!
+ * @brief Leaves PUF SRAM powered down after discharging it
+ *
+ * Holds the PUF in reset and disables its clock instead of powering PUF SRAM up, the PUF is then in the same state
+ * as after PUF_Deinit(). Short enough to be called from the isr of the timer that measures the discharge time.
+ *
+ * @param base PUF peripheral base address
+ */
+void PUF_DischargeDeinit(PUF_Type *base);
+
+/*!
+ * @brief Ends discharging PUF SRAM
+ *
+ * Second half of the power cycle: PUF_DischargePowerUp() followed by PUF_DischargeWaitForInit().
+ * The PUF is then in the same state as after PUF_Init().
+ *
+ * @param base PUF peripheral base address
+ * @param coreClockFrequencyHz core clock frequency in Hz
+ * @return kStatus_Success, kStatus_Fail if the PUF did not initialize or does not allow Enroll and Start, which
+ * means that the discharge time was too short.
+ */
+status_t PUF_DischargeEnd(PUF_Type *base, uint32_t coreClockFrequencyHz);
+
 /*!
  * @brief Enroll PUF
  *
@@ -99,6 +227,7 @@ void PUF_Deinit(PUF_Type *base, uint32_t dischargeTimeMsec, uint32_t coreClockFr
  * @param[out] activationCode Word aligned address of the resulting activation code.
  * @param activationCodeSize Size of the activationCode buffer in bytes. Shall be 1192 bytes.
  * @return Status of enroll operation.
+ * @return kStatus_PUF_Again if a non-blocking command runs.
  */
 status_t PUF_Enroll(PUF_Type *base, uint8_t *activationCode, size_t activationCodeSize);
 
@@ -113,6 +242,7 @@ status_t PUF_Enroll(PUF_Type *base, uint8_t *activationCode, size_t activationCo
  * @param activationCode Word aligned address of the input activation code.
  * @param activationCodeSize Size of the activationCode buffer in bytes. Shall be 1192 bytes.
  * @return Status of start operation.
+ * @return kStatus_PUF_Again if a non-blocking command runs.
  */
 status_t PUF_Start(PUF_Type *base, const uint8_t *activationCode, size_t activationCodeSize);
 
@@ -132,10 +262,25 @@ status_t PUF_Start(PUF_Type *base, const uint8_t *activationCode, size_t activat
  * @param[out] keyCode Word aligned address of the resulting key code.
  * @param keyCodeSize Size of the keyCode buffer in bytes. Shall be PUF_GET_KEY_CODE_SIZE_FOR_KEY_SIZE(keySize).
  * @return Status of set intrinsic key operation.
+ * @return kStatus_PUF_Again if a non-blocking command runs.
  */
 status_t PUF_SetIntrinsicKey(
     PUF_Type *base, puf_key_index_register_t keyIndex, size_t keySize, uint8_t *keyCode, size_t keyCodeSize);
 
+/*!
+ * @brief Set several intrinsic keys
+ *
+ * Same as calling PUF_SetIntrinsicKey() for each job. ALLOW is checked once and all jobs are validated before
+ * the first key is generated, then the Set Intrinsic Key commands are issued back to back.
+ *
+ * @param base PUF peripheral base address
+ * @param[in,out] jobs Array of jobs. Status of each job is stored to its status member.
+ * @param jobCount Number of jobs in the array.
+ * @return kStatus_Success if all jobs succeeded, kStatus_Fail otherwise.
+ * @return kStatus_PUF_Again if a non-blocking command runs.
+ */
+status_t PUF_SetIntrinsicKeys(PUF_Type *base, puf_set_key_job_t *jobs, size_t jobCount);
+
 /*!
  * @brief Set user key
  *
@@ -151,6 +296,7 @@ status_t PUF_SetIntrinsicKey(
  * @param[out] keyCode Word aligned address of the resulting key code.
  * @param keyCodeSize Size of the keyCode buffer in bytes. Shall be PUF_GET_KEY_CODE_SIZE_FOR_KEY_SIZE(userKeySize).
  * @return Status of set user key operation.
+ * @return kStatus_PUF_Again if a non-blocking command runs.
  */
 status_t PUF_SetUserKey(PUF_Type *base,
                         puf_key_index_register_t keyIndex,
@@ -173,9 +319,24 @@ status_t PUF_SetUserKey(PUF_Type *base,
  * @param[out] key Word aligned address of output key.
  * @param keySize Size of the output key in bytes.
  * @return Status of get key operation.
+ * @return kStatus_PUF_Again if a non-blocking command runs.
  */
 status_t PUF_GetKey(PUF_Type *base, const uint8_t *keyCode, size_t keyCodeSize, uint8_t *key, size_t keySize);
 
+/*!
+ * @brief Reconstruct several keys from their key codes
+ *
+ * Same as calling PUF_GetKey() for each job. ALLOW is checked once and all key code headers are validated before
+ * the first key is reconstructed, then the Get Key commands are issued back to back.
+ *
+ * @param base PUF peripheral base address
+ * @param[in,out] jobs Array of jobs. Status of each job is stored to its status member.
+ * @param jobCount Number of jobs in the array.
+ * @return kStatus_Success if all jobs succeeded, kStatus_Fail otherwise.
+ * @return kStatus_PUF_Again if a non-blocking command runs.
+ */
+status_t PUF_GetKeys(PUF_Type *base, puf_get_key_job_t *jobs, size_t jobCount);
+
 /*!
  * @brief Reconstruct hw bus key from a key code
  *
@@ -192,10 +353,55 @@ status_t PUF_GetKey(PUF_Type *base, const uint8_t *keyCode, size_t keyCodeSize,
  * @param keyMask key masking value. Shall be random for each POR/reset. Value does not have to be cryptographicaly
  * secure.
  * @return Status of get key operation.
+ * @return kStatus_PUF_Again if a non-blocking command runs.
  */
 status_t PUF_GetHwKey(
     PUF_Type *base, const uint8_t *keyCode, size_t keyCodeSize, puf_key_slot_t keySlot, uint32_t keyMask);
 
+/*!
+ * @brief Checks if a key code is loaded to a key slot.
+ *
+ * The driver records the key code of each successful PUF_GetHwKey() or PUF_GetHwKeyCached(). The records are
+ * cleared by PUF_Init(), PUF_Deinit(), PUF_Zeroize() and on reset. A failed or non-blocking get key to the slot
+ * clears its record.
+ *
+ * @param base PUF peripheral base address
+ * @param keyCode Key code.
+ * @param keyCodeSize Size of the keyCode buffer in bytes.
+ * @param keySlot key slot of the hw bus.
+ * @return true if the key of keyCode is known to be loaded in keySlot
+ */
+bool PUF_IsHwKeyResident(PUF_Type *base, const uint8_t *keyCode, size_t keyCodeSize, puf_key_slot_t keySlot);
+
+/*!
+ * @brief Reconstruct hw bus key from a key code unless it is already loaded
+ *
+ * Same as PUF_GetHwKey(), except that nothing is done when PUF_IsHwKeyResident() finds the key code in the key slot.
+ * The key mask of a key already loaded is not changed.
+ *
+ * @param base PUF peripheral base address
+ * @param keyCode Word aligned address of the input key code.
+ * @param keyCodeSize Size of the keyCode buffer in bytes. Shall be PUF_GET_KEY_CODE_SIZE_FOR_KEY_SIZE(keySize).
+ * @param keySlot key slot to output on hw bus. Parameter is ignored on devices with less than two key slots.
+ * @param keyMask key masking value. Shall be random for each POR/reset. Value does not have to be cryptographicaly
+ * secure.
+ * @return Status of get key operation.
+ * @return kStatus_PUF_Again if a non-blocking command runs.
+ */
+status_t PUF_GetHwKeyCached(
+    PUF_Type *base, const uint8_t *keyCode, size_t keyCodeSize, puf_key_slot_t keySlot, uint32_t keyMask);
+
+/*!
+ * @brief Forgets the key code loaded to a key slot.
+ *
+ * To be called when the key slot is reloaded or reset by other means than this driver, so that the next
+ * PUF_GetHwKeyCached() reconstructs the key again.
+ *
+ * @param base PUF peripheral base address
+ * @param keySlot key slot of the hw bus.
+ */
+void PUF_InvalidateHwKey(PUF_Type *base, puf_key_slot_t keySlot);
+
 /*!
  * @brief Zeroize PUF
  *
@@ -216,6 +422,153 @@ status_t PUF_Zeroize(PUF_Type *base);
  */
 bool PUF_IsGetKeyAllowed(PUF_Type *base);
 
+/*!
+ * @brief Installs the callback of a non-blocking PUF command handle.
+ *
+ * This function stores the callback in the handle and enables PUF interrupt.
+ *
+ * @param base PUF peripheral base address
+ * @param handle Handle of the non-blocking commands
+ * @param callback Callback function, invoked from PUF isr when a command of the handle completes
+ * @param userData User data passed as an argument to callback function
+ */
+void PUF_SetCallback(PUF_Type *base, puf_handle_t *handle, puf_callback_t callback, void *userData);
+
+/*!
+ * @brief Enroll PUF in background
+ *
+ * Same as PUF_Enroll(). The activation code is read out word by word by PUF isr, the CPU is free in between.
+ * Non-blocking commands run one at a time. One more command can be queued while a command runs, it is started
+ * by PUF isr as soon as the running command completes, before the callback of the completed one is invoked.
+ *
+ * @param base PUF peripheral base address
+ * @param handle Handle with the callback set by PUF_SetCallback(). Shall not be in use.
+ * @param[out] activationCode Word aligned address of the resulting activation code.
+ * @param activationCodeSize Size of the activationCode buffer in bytes. Shall be 1192 bytes.
+ * @return kStatus_Success if the command has been started or queued.
+ * @return kStatus_PUF_Again if a command runs and another one is already queued.
+ * @return kStatus_Fail or kStatus_InvalidArgument, as PUF_Enroll().
+ */
+status_t PUF_EnrollNonBlocking(PUF_Type *base,
+                               puf_handle_t *handle,
+                               uint8_t *activationCode,
+                               size_t activationCodeSize);
+
+/*!
+ * @brief Start PUF in background
+ *
+ * Same as PUF_Start(), the activation code is sent by PUF isr. See PUF_EnrollNonBlocking() for queuing.
+ *
+ * @param base PUF peripheral base address
+ * @param handle Handle with the callback set by PUF_SetCallback(). Shall not be in use.
+ * @param activationCode Word aligned address of the input activation code. Shall stay valid until the callback.
+ * @param activationCodeSize Size of the activationCode buffer in bytes. Shall be 1192 bytes.
+ * @return kStatus_Success if the command has been started or queued.
+ * @return kStatus_PUF_Again if a command runs and another one is already queued.
+ * @return kStatus_Fail or kStatus_InvalidArgument, as PUF_Start().
+ */
+status_t PUF_StartNonBlocking(PUF_Type *base,
+                              puf_handle_t *handle,
+                              const uint8_t *activationCode,
+                              size_t activationCodeSize);
+
+/*!
+ * @brief Set intrinsic key in background
+ *
+ * Same as PUF_SetIntrinsicKey(), the key code is read out by PUF isr. See PUF_EnrollNonBlocking() for queuing.
+ *
+ * @param base PUF peripheral base address
+ * @param handle Handle with the callback set by PUF_SetCallback(). Shall not be in use.
+ * @param keyIndex PUF key index register
+ * @param keySize Size of the intrinsic key to generate in bytes.
+ * @param[out] keyCode Word aligned address of the resulting key code.
+ * @param keyCodeSize Size of the keyCode buffer in bytes. Shall be PUF_GET_KEY_CODE_SIZE_FOR_KEY_SIZE(keySize).
+ * @return kStatus_Success if the command has been started or queued.
+ * @return kStatus_PUF_Again if a command runs and another one is already queued.
+ * @return kStatus_Fail or kStatus_InvalidArgument, as PUF_SetIntrinsicKey().
+ */
+status_t PUF_SetIntrinsicKeyNonBlocking(PUF_Type *base,
+                                        puf_handle_t *handle,
+                                        puf_key_index_register_t keyIndex,
+                                        size_t keySize,
+                                        uint8_t *keyCode,
+                                        size_t keyCodeSize);
+
+/*!
+ * @brief Set user key in background
+ *
+ * Same as PUF_SetUserKey(), the user key is sent and the key code read out by PUF isr. See PUF_EnrollNonBlocking()
+ * for queuing.
+ *
+ * @param base PUF peripheral base address
+ * @param handle Handle with the callback set by PUF_SetCallback(). Shall not be in use.
+ * @param keyIndex PUF key index register
+ * @param userKey Word aligned address of input user key. Shall stay valid until the callback.
+ * @param userKeySize Size of the input user key in bytes.
+ * @param[out] keyCode Word aligned address of the resulting key code.
+ * @param keyCodeSize Size of the keyCode buffer in bytes. Shall be PUF_GET_KEY_CODE_SIZE_FOR_KEY_SIZE(userKeySize).
+ * @return kStatus_Success if the command has been started or queued.
+ * @return kStatus_PUF_Again if a command runs and another one is already queued.
+ * @return kStatus_Fail or kStatus_InvalidArgument, as PUF_SetUserKey().
+ */
+status_t PUF_SetUserKeyNonBlocking(PUF_Type *base,
+                                   puf_handle_t *handle,
+                                   puf_key_index_register_t keyIndex,
+                                   const uint8_t *userKey,
+                                   size_t userKeySize,
+                                   uint8_t *keyCode,
+                                   size_t keyCodeSize);
+
+/*!
+ * @brief Reconstruct key from a key code in background
+ *
+ * Same as PUF_GetKey(), the key code is sent and the key read out by PUF isr. See PUF_EnrollNonBlocking()
+ * for queuing.
+ *
+ * @param base PUF peripheral base address
+ * @param handle Handle with the callback set by PUF_SetCallback(). Shall not be in use.
+ * @param keyCode Word aligned address of the input key code. Shall stay valid until the callback.
+ * @param keyCodeSize Size of the keyCode buffer in bytes. Shall be PUF_GET_KEY_CODE_SIZE_FOR_KEY_SIZE(keySize).
+ * @param[out] key Word aligned address of output key.
+ * @param keySize Size of the output key in bytes.
+ * @return kStatus_Success if the command has been started or queued.
+ * @return kStatus_PUF_Again if a command runs and another one is already queued.
+ * @return kStatus_Fail or kStatus_InvalidArgument, as PUF_GetKey().
+ */
+status_t PUF_GetKeyNonBlocking(
+    PUF_Type *base, puf_handle_t *handle, const uint8_t *keyCode, size_t keyCodeSize, uint8_t *key, size_t keySize);
+
+/*!
+ * @brief Reconstruct hw bus key from a key code in background
+ *
+ * Same as PUF_GetHwKey(), the key code is sent by PUF isr. See PUF_EnrollNonBlocking() for queuing. The key slot
+ * is configured when the command starts.
+ *
+ * @param base PUF peripheral base address
+ * @param handle Handle with the callback set by PUF_SetCallback(). Shall not be in use.
+ * @param keyCode Word aligned address of the input key code. Shall stay valid until the callback.
+ * @param keyCodeSize Size of the keyCode buffer in bytes. Shall be PUF_GET_KEY_CODE_SIZE_FOR_KEY_SIZE(keySize).
+ * @param keySlot key slot to output on hw bus. Parameter is ignored on devices with less than two key slots.
+ * @param keyMask key masking value. Shall be random for each POR/reset.
+ * @return kStatus_Success if the command has been started or queued.
+ * @return kStatus_PUF_Again if a command runs and another one is already queued.
+ * @return kStatus_Fail or kStatus_InvalidArgument, as PUF_GetHwKey().
+ */
+status_t PUF_GetHwKeyNonBlocking(PUF_Type *base,
+                                 puf_handle_t *handle,
+                                 const uint8_t *keyCode,
+                                 size_t keyCodeSize,
+                                 puf_key_slot_t keySlot,
+                                 uint32_t keyMask);
+
+/*!
+ * @brief Checks if a non-blocking PUF command runs.
+ *
+ * @param base PUF peripheral base address
+ * @return true if a non-blocking command runs or is queued
+ */
+bool PUF_IsBusy(PUF_Type *base);
+
 static inline void PUF_BlockSetKey(PUF_Type *base)
 {
     base->CFG |= PUF_CFG_BLOCKKEYOUTPUT_MASK; /* block set key */
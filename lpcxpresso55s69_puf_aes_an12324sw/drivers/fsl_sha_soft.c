@@ -0,0 +1,761 @@
+/*
+ * Copyright 2026 asvin.io
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <string.h>
+#include "fsl_sha_soft.h"
+
+#if SHA_SOFT_HAS_X86
+#include <immintrin.h>
+#endif
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+
+#define SHA_SOFT_MIN(a, b) (((a) < (b)) ? (a) : (b))
+#define SHA_SOFT_ROR32(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+#define SHA_SOFT_ROR64(x, n) (((x) >> (n)) | ((x) << (64 - (n))))
+#define SHA_SOFT_CH(x, y, z) ((z) ^ ((x) & ((y) ^ (z))))
+#define SHA_SOFT_MAJ(x, y, z) (((x) & (y)) | ((z) & ((x) | (y))))
+#define SHA_SOFT_GET32(p) \
+    (((uint32_t)(p)[0] << 24) | ((uint32_t)(p)[1] << 16) | ((uint32_t)(p)[2] << 8) | (uint32_t)(p)[3])
+#define SHA_SOFT_GET64(p) (((uint64_t)SHA_SOFT_GET32(p) << 32) | SHA_SOFT_GET32((p) + 4))
+#define SHA_SOFT_PUT32(p, v)           \
+    do                                 \
+    {                                  \
+        (p)[0] = (uint8_t)((v) >> 24); \
+        (p)[1] = (uint8_t)((v) >> 16); \
+        (p)[2] = (uint8_t)((v) >> 8);  \
+        (p)[3] = (uint8_t)(v);         \
+    } while (0)
+
+#define SHA256_S0(x) (SHA_SOFT_ROR32(x, 2) ^ SHA_SOFT_ROR32(x, 13) ^ SHA_SOFT_ROR32(x, 22))
+#define SHA256_S1(x) (SHA_SOFT_ROR32(x, 6) ^ SHA_SOFT_ROR32(x, 11) ^ SHA_SOFT_ROR32(x, 25))
+#define SHA256_s0(x) (SHA_SOFT_ROR32(x, 7) ^ SHA_SOFT_ROR32(x, 18) ^ ((x) >> 3))
+#define SHA256_s1(x) (SHA_SOFT_ROR32(x, 17) ^ SHA_SOFT_ROR32(x, 19) ^ ((x) >> 10))
+#define SHA512_S0(x) (SHA_SOFT_ROR64(x, 28) ^ SHA_SOFT_ROR64(x, 34) ^ SHA_SOFT_ROR64(x, 39))
+#define SHA512_S1(x) (SHA_SOFT_ROR64(x, 14) ^ SHA_SOFT_ROR64(x, 18) ^ SHA_SOFT_ROR64(x, 41))
+#define SHA512_s0(x) (SHA_SOFT_ROR64(x, 1) ^ SHA_SOFT_ROR64(x, 8) ^ ((x) >> 7))
+#define SHA512_s1(x) (SHA_SOFT_ROR64(x, 19) ^ SHA_SOFT_ROR64(x, 61) ^ ((x) >> 6))
+
+/* message word of rounds 0-15, and of rounds 16 and up computed in place in the 16-word window */
+#define SHA_SOFT_W0(i) (w[(i)])
+#define SHA256_W(i) (w[(i)&15] += SHA256_s1(w[((i)-2) & 15]) + w[((i)-7) & 15] + SHA256_s0(w[((i)-15) & 15]))
+#define SHA512_W(i) (w[(i)&15] += SHA512_s1(w[((i)-2) & 15]) + w[((i)-7) & 15] + SHA512_s0(w[((i)-15) & 15]))
+
+#define SHA256_ROUND(a, b, c, d, e, f, g, h, i, W)                                        \
+    do                                                                                    \
+    {                                                                                     \
+        uint32_t t1 = (h) + SHA256_S1(e) + SHA_SOFT_CH(e, f, g) + s_sha256K[(i)] + W(i); \
+        (d) += t1;                                                                        \
+        (h) = t1 + SHA256_S0(a) + SHA_SOFT_MAJ(a, b, c);                                  \
+    } while (0)
+
+#define SHA512_ROUND(a, b, c, d, e, f, g, h, i, W)                                        \
+    do                                                                                    \
+    {                                                                                     \
+        uint64_t t1 = (h) + SHA512_S1(e) + SHA_SOFT_CH(e, f, g) + s_sha512K[(i)] + W(i); \
+        (d) += t1;                                                                        \
+        (h) = t1 + SHA512_S0(a) + SHA_SOFT_MAJ(a, b, c);                                  \
+    } while (0)
+
+/* eight rounds with the working variables renamed instead of moved, so they can stay in registers */
+#define SHA_SOFT_8ROUNDS(ROUND, i, W)              \
+    do                                             \
+    {                                              \
+        ROUND(a, b, c, d, e, f, g, h, (i) + 0, W); \
+        ROUND(h, a, b, c, d, e, f, g, (i) + 1, W); \
+        ROUND(g, h, a, b, c, d, e, f, (i) + 2, W); \
+        ROUND(f, g, h, a, b, c, d, e, (i) + 3, W); \
+        ROUND(e, f, g, h, a, b, c, d, (i) + 4, W); \
+        ROUND(d, e, f, g, h, a, b, c, (i) + 5, W); \
+        ROUND(c, d, e, f, g, h, a, b, (i) + 6, W); \
+        ROUND(b, c, d, e, f, g, h, a, (i) + 7, W); \
+    } while (0)
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+
+static const uint32_t s_sha256K[64] = {
+    0x428a2f98u, 0x71374491u, 0xb5c0fbcfu, 0xe9b5dba5u, 0x3956c25bu, 0x59f111f1u, 0x923f82a4u, 0xab1c5ed5u,
+    0xd807aa98u, 0x12835b01u, 0x243185beu, 0x550c7dc3u, 0x72be5d74u, 0x80deb1feu, 0x9bdc06a7u, 0xc19bf174u,
+    0xe49b69c1u, 0xefbe4786u, 0x0fc19dc6u, 0x240ca1ccu, 0x2de92c6fu, 0x4a7484aau, 0x5cb0a9dcu, 0x76f988dau,
+    0x983e5152u, 0xa831c66du, 0xb00327c8u, 0xbf597fc7u, 0xc6e00bf3u, 0xd5a79147u, 0x06ca6351u, 0x14292967u,
+    0x27b70a85u, 0x2e1b2138u, 0x4d2c6dfcu, 0x53380d13u, 0x650a7354u, 0x766a0abbu, 0x81c2c92eu, 0x92722c85u,
+    0xa2bfe8a1u, 0xa81a664bu, 0xc24b8b70u, 0xc76c51a3u, 0xd192e819u, 0xd6990624u, 0xf40e3585u, 0x106aa070u,
+    0x19a4c116u, 0x1e376c08u, 0x2748774cu, 0x34b0bcb5u, 0x391c0cb3u, 0x4ed8aa4au, 0x5b9cca4fu, 0x682e6ff3u,
+    0x748f82eeu, 0x78a5636fu, 0x84c87814u, 0x8cc70208u, 0x90befffau, 0xa4506cebu, 0xbef9a3f7u, 0xc67178f2u,
+};
+
+static const uint64_t s_sha512K[80] = {
+    0x428a2f98d728ae22ull, 0x7137449123ef65cdull, 0xb5c0fbcfec4d3b2full, 0xe9b5dba58189dbbcull,
+    0x3956c25bf348b538ull, 0x59f111f1b605d019ull, 0x923f82a4af194f9bull, 0xab1c5ed5da6d8118ull,
+    0xd807aa98a3030242ull, 0x12835b0145706fbeull, 0x243185be4ee4b28cull, 0x550c7dc3d5ffb4e2ull,
+    0x72be5d74f27b896full, 0x80deb1fe3b1696b1ull, 0x9bdc06a725c71235ull, 0xc19bf174cf692694ull,
+    0xe49b69c19ef14ad2ull, 0xefbe4786384f25e3ull, 0x0fc19dc68b8cd5b5ull, 0x240ca1cc77ac9c65ull,
+    0x2de92c6f592b0275ull, 0x4a7484aa6ea6e483ull, 0x5cb0a9dcbd41fbd4ull, 0x76f988da831153b5ull,
+    0x983e5152ee66dfabull, 0xa831c66d2db43210ull, 0xb00327c898fb213full, 0xbf597fc7beef0ee4ull,
+    0xc6e00bf33da88fc2ull, 0xd5a79147930aa725ull, 0x06ca6351e003826full, 0x142929670a0e6e70ull,
+    0x27b70a8546d22ffcull, 0x2e1b21385c26c926ull, 0x4d2c6dfc5ac42aedull, 0x53380d139d95b3dfull,
+    0x650a73548baf63deull, 0x766a0abb3c77b2a8ull, 0x81c2c92e47edaee6ull, 0x92722c851482353bull,
+    0xa2bfe8a14cf10364ull, 0xa81a664bbc423001ull, 0xc24b8b70d0f89791ull, 0xc76c51a30654be30ull,
+    0xd192e819d6ef5218ull, 0xd69906245565a910ull, 0xf40e35855771202aull, 0x106aa07032bbd1b8ull,
+    0x19a4c116b8d2d0c8ull, 0x1e376c085141ab53ull, 0x2748774cdf8eeb99ull, 0x34b0bcb5e19b48a8ull,
+    0x391c0cb3c5c95a63ull, 0x4ed8aa4ae3418acbull, 0x5b9cca4f7763e373ull, 0x682e6ff3d6b2b8a3ull,
+    0x748f82ee5defb2fcull, 0x78a5636f43172f60ull, 0x84c87814a1f0ab72ull, 0x8cc702081a6439ecull,
+    0x90befffa23631e28ull, 0xa4506cebde82bde9ull, 0xbef9a3f7b2c67915ull, 0xc67178f2e372532bull,
+    0xca273eceea26619cull, 0xd186b8c721c0c207ull, 0xeada7dd6cde0eb1eull, 0xf57d4f7fee6ed178ull,
+    0x06f067aa72176fbaull, 0x0a637dc5a2c898a6ull, 0x113f9804bef90daeull, 0x1b710b35131c471bull,
+    0x28db77f523047d84ull, 0x32caab7b40c72493ull, 0x3c9ebe0a15c9bebcull, 0x431d67c49c100d4cull,
+    0x4cc5d4becb3e42b6ull, 0x597f299cfc657e2aull, 0x5fcb6fab3ad6faecull, 0x6c44198c4a475817ull,
+};
+
+static const uint32_t s_sha256Iv[8] = {
+    0x6a09e667u, 0xbb67ae85u, 0x3c6ef372u, 0xa54ff53au, 0x510e527fu, 0x9b05688cu, 0x1f83d9abu, 0x5be0cd19u,
+};
+
+static const uint64_t s_sha512Iv[8] = {
+    0x6a09e667f3bcc908ull, 0xbb67ae8584caa73bull, 0x3c6ef372fe94f82bull, 0xa54ff53a5f1d36f1ull,
+    0x510e527fade682d1ull, 0x9b05688c2b3e6c1full, 0x1f83d9abfb41bd6bull, 0x5be0cd19137e2179ull,
+};
+
+/*******************************************************************************
+ * Portable implementation
+ ******************************************************************************/
+
+static void sha_soft_sha256_blocks(uint32_t state[8], const uint8_t *data, size_t blocks)
+{
+    uint32_t a, b, c, d, e, f, g, h;
+    uint32_t w[16];
+    uint32_t i;
+
+    while (blocks--)
+    {
+        for (i = 0; i < 16u; i++)
+        {
+            w[i] = SHA_SOFT_GET32(data + 4u * i);
+        }
+        a = state[0];
+        b = state[1];
+        c = state[2];
+        d = state[3];
+        e = state[4];
+        f = state[5];
+        g = state[6];
+        h = state[7];
+
+        SHA_SOFT_8ROUNDS(SHA256_ROUND, 0, SHA_SOFT_W0);
+        SHA_SOFT_8ROUNDS(SHA256_ROUND, 8, SHA_SOFT_W0);
+        for (i = 16; i < 64u; i += 8u)
+        {
+            SHA_SOFT_8ROUNDS(SHA256_ROUND, i, SHA256_W);
+        }
+
+        state[0] += a;
+        state[1] += b;
+        state[2] += c;
+        state[3] += d;
+        state[4] += e;
+        state[5] += f;
+        state[6] += g;
+        state[7] += h;
+        data += 64;
+    }
+}
+
+/*!
+ * @brief SHA-512 compression, the state is kept as pairs of 32-bit words in the context.
+ */
+static void sha_soft_sha512_blocks(uint32_t state[16], const uint8_t *data, size_t blocks)
+{
+    uint64_t s[8];
+    uint64_t a, b, c, d, e, f, g, h;
+    uint64_t w[16];
+    uint32_t i;
+
+    for (i = 0; i < 8u; i++)
+    {
+        s[i] = ((uint64_t)state[2u * i] << 32) | state[2u * i + 1u];
+    }
+
+    while (blocks--)
+    {
+        for (i = 0; i < 16u; i++)
+        {
+            w[i] = SHA_SOFT_GET64(data + 8u * i);
+        }
+        a = s[0];
+        b = s[1];
+        c = s[2];
+        d = s[3];
+        e = s[4];
+        f = s[5];
+        g = s[6];
+        h = s[7];
+
+        SHA_SOFT_8ROUNDS(SHA512_ROUND, 0, SHA_SOFT_W0);
+        SHA_SOFT_8ROUNDS(SHA512_ROUND, 8, SHA_SOFT_W0);
+        for (i = 16; i < 80u; i += 8u)
+        {
+            SHA_SOFT_8ROUNDS(SHA512_ROUND, i, SHA512_W);
+        }
+
+        s[0] += a;
+        s[1] += b;
+        s[2] += c;
+        s[3] += d;
+        s[4] += e;
+        s[5] += f;
+        s[6] += g;
+        s[7] += h;
+        data += 128;
+    }
+
+    for (i = 0; i < 8u; i++)
+    {
+        state[2u * i] = (uint32_t)(s[i] >> 32);
+        state[2u * i + 1u] = (uint32_t)s[i];
+    }
+}
+
+/*******************************************************************************
+ * SHA-NI and AVX2 implementations
+ ******************************************************************************/
+#if SHA_SOFT_HAS_X86
+
+static bool sha_soft_has_shani(void)
+{
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sha") != 0;
+}
+
+static bool sha_soft_has_avx2(void)
+{
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") != 0;
+}
+
+__attribute__((target("sha,sse4.1"))) static void sha_soft_ni_sha256_blocks(uint32_t state[8],
+                                                                           const uint8_t *data,
+                                                                           size_t blocks)
+{
+    const __m128i mask = _mm_set_epi64x(0x0c0d0e0f08090a0bll, 0x0405060700010203ll);
+    __m128i state0, state1, msg[4], tmp, next, abefSave, cdghSave;
+    uint32_t i;
+
+    /* a..h to the ABEF and CDGH layout of the SHA instructions */
+    tmp = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)&state[0]), 0xB1);
+    state1 = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)&state[4]), 0x1B);
+    state0 = _mm_alignr_epi8(tmp, state1, 8);
+    state1 = _mm_blend_epi16(state1, tmp, 0xF0);
+
+    while (blocks--)
+    {
+        abefSave = state0;
+        cdghSave = state1;
+        for (i = 0; i < 4u; i++)
+        {
+            msg[i] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(data + 16u * i)), mask);
+        }
+
+        /* four rounds per step, msg[i & 3] holds W[4i..4i+3] and is replaced by W[4i+16..4i+19] */
+        for (i = 0; i < 16u; i++)
+        {
+            tmp = _mm_add_epi32(msg[i & 3u], _mm_loadu_si128((const __m128i *)&s_sha256K[4u * i]));
+            state1 = _mm_sha256rnds2_epu32(state1, state0, tmp);
+            state0 = _mm_sha256rnds2_epu32(state0, state1, _mm_shuffle_epi32(tmp, 0x0E));
+            if (i < 12u)
+            {
+                next = _mm_sha256msg1_epu32(msg[i & 3u], msg[(i + 1u) & 3u]);
+                next = _mm_add_epi32(next, _mm_alignr_epi8(msg[(i + 3u) & 3u], msg[(i + 2u) & 3u], 4));
+                msg[i & 3u] = _mm_sha256msg2_epu32(next, msg[(i + 3u) & 3u]);
+            }
+        }
+
+        state0 = _mm_add_epi32(state0, abefSave);
+        state1 = _mm_add_epi32(state1, cdghSave);
+        data += 64;
+    }
+
+    tmp = _mm_shuffle_epi32(state0, 0x1B);
+    state1 = _mm_shuffle_epi32(state1, 0xB1);
+    _mm_storeu_si128((__m128i *)&state[0], _mm_blend_epi16(tmp, state1, 0xF0));
+    _mm_storeu_si128((__m128i *)&state[4], _mm_alignr_epi8(state1, tmp, 8));
+}
+
+#define SHA_SOFT_LANES32 8
+#define SHA_SOFT_LANES64 4
+
+#define SHA_SOFT_V32ROR(x, n) _mm256_or_si256(_mm256_srli_epi32(x, n), _mm256_slli_epi32(x, 32 - (n)))
+#define SHA_SOFT_V64ROR(x, n) _mm256_or_si256(_mm256_srli_epi64(x, n), _mm256_slli_epi64(x, 64 - (n)))
+#define SHA_SOFT_VXOR3(x, y, z) _mm256_xor_si256(_mm256_xor_si256(x, y), z)
+#define SHA_SOFT_VCH(x, y, z) _mm256_xor_si256(z, _mm256_and_si256(x, _mm256_xor_si256(y, z)))
+#define SHA_SOFT_VMAJ(x, y, z) _mm256_or_si256(_mm256_and_si256(x, y), _mm256_and_si256(z, _mm256_or_si256(x, y)))
+
+/*!
+ * @brief Compresses one block of each of 8 SHA-256 messages, lane l of word k of the state is state[k][l].
+ */
+__attribute__((target("avx2"))) static void sha_soft_avx2_sha256(uint32_t state[8][SHA_SOFT_LANES32],
+                                                                 const uint8_t *const block[SHA_SOFT_LANES32])
+{
+    __m256i w[16], s[8], v[8], t1, t2;
+    uint32_t lane[SHA_SOFT_LANES32];
+    uint32_t i, l;
+
+    for (i = 0; i < 16u; i++)
+    {
+        for (l = 0; l < SHA_SOFT_LANES32; l++)
+        {
+            lane[l] = SHA_SOFT_GET32(block[l] + 4u * i);
+        }
+        w[i] = _mm256_loadu_si256((const __m256i *)lane);
+    }
+    for (i = 0; i < 8u; i++)
+    {
+        s[i] = _mm256_loadu_si256((const __m256i *)state[i]);
+        v[i] = s[i];
+    }
+
+    for (i = 0; i < 64u; i++)
+    {
+        if (i >= 16u)
+        {
+            __m256i w2 = w[(i - 2u) & 15u];
+            __m256i w15 = w[(i - 15u) & 15u];
+            t1 = SHA_SOFT_VXOR3(SHA_SOFT_V32ROR(w2, 17), SHA_SOFT_V32ROR(w2, 19), _mm256_srli_epi32(w2, 10));
+            t2 = SHA_SOFT_VXOR3(SHA_SOFT_V32ROR(w15, 7), SHA_SOFT_V32ROR(w15, 18), _mm256_srli_epi32(w15, 3));
+            w[i & 15u] = _mm256_add_epi32(_mm256_add_epi32(w[i & 15u], t1), _mm256_add_epi32(w[(i - 7u) & 15u], t2));
+        }
+        t1 = _mm256_add_epi32(v[7], SHA_SOFT_VXOR3(SHA_SOFT_V32ROR(v[4], 6), SHA_SOFT_V32ROR(v[4], 11),
+                                                   SHA_SOFT_V32ROR(v[4], 25)));
+        t1 = _mm256_add_epi32(t1, SHA_SOFT_VCH(v[4], v[5], v[6]));
+        t1 = _mm256_add_epi32(t1, _mm256_add_epi32(_mm256_set1_epi32((int)s_sha256K[i]), w[i & 15u]));
+        t2 = _mm256_add_epi32(
+            SHA_SOFT_VXOR3(SHA_SOFT_V32ROR(v[0], 2), SHA_SOFT_V32ROR(v[0], 13), SHA_SOFT_V32ROR(v[0], 22)),
+            SHA_SOFT_VMAJ(v[0], v[1], v[2]));
+        v[7] = v[6];
+        v[6] = v[5];
+        v[5] = v[4];
+        v[4] = _mm256_add_epi32(v[3], t1);
+        v[3] = v[2];
+        v[2] = v[1];
+        v[1] = v[0];
+        v[0] = _mm256_add_epi32(t1, t2);
+    }
+
+    for (i = 0; i < 8u; i++)
+    {
+        _mm256_storeu_si256((__m256i *)state[i], _mm256_add_epi32(s[i], v[i]));
+    }
+}
+
+/*!
+ * @brief Compresses one block of each of 4 SHA-512 messages, lane l of word k of the state is state[k][l].
+ */
+__attribute__((target("avx2"))) static void sha_soft_avx2_sha512(uint64_t state[8][SHA_SOFT_LANES64],
+                                                                 const uint8_t *const block[SHA_SOFT_LANES64])
+{
+    __m256i w[16], s[8], v[8], t1, t2;
+    uint64_t lane[SHA_SOFT_LANES64];
+    uint32_t i, l;
+
+    for (i = 0; i < 16u; i++)
+    {
+        for (l = 0; l < SHA_SOFT_LANES64; l++)
+        {
+            lane[l] = SHA_SOFT_GET64(block[l] + 8u * i);
+        }
+        w[i] = _mm256_loadu_si256((const __m256i *)lane);
+    }
+    for (i = 0; i < 8u; i++)
+    {
+        s[i] = _mm256_loadu_si256((const __m256i *)state[i]);
+        v[i] = s[i];
+    }
+
+    for (i = 0; i < 80u; i++)
+    {
+        if (i >= 16u)
+        {
+            __m256i w2 = w[(i - 2u) & 15u];
+            __m256i w15 = w[(i - 15u) & 15u];
+            t1 = SHA_SOFT_VXOR3(SHA_SOFT_V64ROR(w2, 19), SHA_SOFT_V64ROR(w2, 61), _mm256_srli_epi64(w2, 6));
+            t2 = SHA_SOFT_VXOR3(SHA_SOFT_V64ROR(w15, 1), SHA_SOFT_V64ROR(w15, 8), _mm256_srli_epi64(w15, 7));
+            w[i & 15u] = _mm256_add_epi64(_mm256_add_epi64(w[i & 15u], t1), _mm256_add_epi64(w[(i - 7u) & 15u], t2));
+        }
+        t1 = _mm256_add_epi64(v[7], SHA_SOFT_VXOR3(SHA_SOFT_V64ROR(v[4], 14), SHA_SOFT_V64ROR(v[4], 18),
+                                                   SHA_SOFT_V64ROR(v[4], 41)));
+        t1 = _mm256_add_epi64(t1, SHA_SOFT_VCH(v[4], v[5], v[6]));
+        t1 = _mm256_add_epi64(t1, _mm256_add_epi64(_mm256_set1_epi64x((long long)s_sha512K[i]), w[i & 15u]));
+        t2 = _mm256_add_epi64(
+            SHA_SOFT_VXOR3(SHA_SOFT_V64ROR(v[0], 28), SHA_SOFT_V64ROR(v[0], 34), SHA_SOFT_V64ROR(v[0], 39)),
+            SHA_SOFT_VMAJ(v[0], v[1], v[2]));
+        v[7] = v[6];
+        v[6] = v[5];
+        v[5] = v[4];
+        v[4] = _mm256_add_epi64(v[3], t1);
+        v[3] = v[2];
+        v[2] = v[1];
+        v[1] = v[0];
+        v[0] = _mm256_add_epi64(t1, t2);
+    }
+
+    for (i = 0; i < 8u; i++)
+    {
+        _mm256_storeu_si256((__m256i *)state[i], _mm256_add_epi64(s[i], v[i]));
+    }
+}
+
+/*! @brief One message of SHA_SOFT_HashMulti() in a vector lane. */
+typedef struct _sha_soft_lane
+{
+    const uint8_t *next;                       /*!< Next full block of the message */
+    size_t blocks;                             /*!< Full blocks left */
+    uint8_t tail[2 * SHA_SOFT_MAX_BLOCK_SIZE]; /*!< Last incomplete block with padding and length */
+    size_t tailBlocks;                         /*!< Number of blocks in tail, 1 or 2 */
+    size_t tailIndex;                          /*!< Next block in tail */
+    size_t message;                            /*!< Index of the message, count if the lane is idle */
+} sha_soft_lane_t;
+
+static const uint8_t s_shaSoftIdle[SHA_SOFT_MAX_BLOCK_SIZE];
+
+/*!
+ * @brief Assigns a message to a lane and formats its padded tail.
+ */
+static void sha_soft_lane_start(
+    sha_soft_lane_t *lane, size_t blockSize, const uint8_t *input, size_t size, size_t message)
+{
+    size_t rem = size % blockSize;
+    size_t lenSize = blockSize / 8u;
+    uint64_t bits = (uint64_t)size << 3;
+
+    lane->next = input;
+    lane->blocks = size / blockSize;
+    lane->tailBlocks = (rem + 1u + lenSize > blockSize) ? 2u : 1u;
+    lane->tailIndex = 0;
+    lane->message = message;
+
+    memset(lane->tail, 0, sizeof(lane->tail));
+    memcpy(lane->tail, input + size - rem, rem);
+    lane->tail[rem] = 0x80u;
+    SHA_SOFT_PUT32(&lane->tail[lane->tailBlocks * blockSize - 8u], (uint32_t)(bits >> 32));
+    SHA_SOFT_PUT32(&lane->tail[lane->tailBlocks * blockSize - 4u], (uint32_t)bits);
+}
+
+/*!
+ * @brief Returns the next block of a lane, NULL once the message is done.
+ */
+static const uint8_t *sha_soft_lane_next(sha_soft_lane_t *lane, size_t blockSize)
+{
+    const uint8_t *block = NULL;
+
+    if (lane->blocks)
+    {
+        block = lane->next;
+        lane->next += blockSize;
+        lane->blocks--;
+    }
+    else if (lane->tailIndex < lane->tailBlocks)
+    {
+        block = &lane->tail[blockSize * lane->tailIndex++];
+    }
+
+    return block;
+}
+
+/*!
+ * @brief Hashes messages interleaved over the AVX2 lanes.
+ *
+ * Idle lanes hash a dummy block whose result is dropped.
+ */
+static void sha_soft_avx2_multi(
+    sha_soft_algo_t algo, const uint8_t *const input[], const size_t size[], uint8_t *output, size_t count)
+{
+    bool sha512 = (algo == kSHA_SOFT_Sha512);
+    size_t lanes = sha512 ? SHA_SOFT_LANES64 : SHA_SOFT_LANES32;
+    size_t blockSize = sha512 ? 128u : 64u;
+    size_t digestSize = sha512 ? SHA_SOFT_SHA512_SIZE : SHA_SOFT_SHA256_SIZE;
+    sha_soft_lane_t lane[SHA_SOFT_LANES32];
+    const uint8_t *block[SHA_SOFT_LANES32];
+    uint32_t state32[8][SHA_SOFT_LANES32];
+    uint64_t state64[8][SHA_SOFT_LANES64];
+    size_t started = 0;
+    size_t active = 0;
+    size_t l, k;
+
+    for (l = 0; l < lanes; l++)
+    {
+        lane[l].message = count;
+        block[l] = NULL;
+    }
+
+    for (;;)
+    {
+        for (l = 0; l < lanes; l++)
+        {
+            /* a lane whose message is done writes the digest and takes the next message */
+            if ((block[l] == NULL) && (lane[l].message < count))
+            {
+                for (k = 0; k < digestSize / 4u; k++)
+                {
+                    uint32_t word = sha512 ? (uint32_t)(state64[k / 2u][l] >> ((k & 1u) ? 0 : 32)) : state32[k][l];
+                    SHA_SOFT_PUT32(&output[lane[l].message * digestSize + 4u * k], word);
+                }
+                lane[l].message = count;
+                active--;
+            }
+            if ((block[l] == NULL) && (started < count))
+            {
+                sha_soft_lane_start(&lane[l], blockSize, input[started], size[started], started);
+                for (k = 0; k < 8u; k++)
+                {
+                    if (sha512)
+                    {
+                        state64[k][l] = s_sha512Iv[k];
+                    }
+                    else
+                    {
+                        state32[k][l] = s_sha256Iv[k];
+                    }
+                }
+                started++;
+                active++;
+                block[l] = sha_soft_lane_next(&lane[l], blockSize);
+            }
+        }
+
+        if (active == 0u)
+        {
+            break;
+        }
+
+        for (l = 0; l < lanes; l++)
+        {
+            if (block[l] == NULL)
+            {
+                block[l] = s_shaSoftIdle;
+            }
+        }
+        if (sha512)
+        {
+            sha_soft_avx2_sha512(state64, block);
+        }
+        else
+        {
+            sha_soft_avx2_sha256(state32, block);
+        }
+        for (l = 0; l < lanes; l++)
+        {
+            block[l] = (lane[l].message < count) ? sha_soft_lane_next(&lane[l], blockSize) : NULL;
+        }
+    }
+}
+
+#endif /* SHA_SOFT_HAS_X86 */
+
+/*******************************************************************************
+ * Common
+ ******************************************************************************/
+
+static size_t sha_soft_block_size(const sha_soft_ctx_t *ctx)
+{
+    return (ctx->algo == kSHA_SOFT_Sha512) ? 128u : 64u;
+}
+
+/*!
+ * @brief Compresses full blocks with the context implementation.
+ */
+static void sha_soft_blocks(sha_soft_ctx_t *ctx, const uint8_t *data, size_t blocks)
+{
+    if (ctx->algo == kSHA_SOFT_Sha512)
+    {
+        sha_soft_sha512_blocks(ctx->state, data, blocks);
+        return;
+    }
+#if SHA_SOFT_HAS_X86
+    if (ctx->impl == kSHA_SOFT_ShaNi)
+    {
+        sha_soft_ni_sha256_blocks(ctx->state, data, blocks);
+        return;
+    }
+#endif
+    sha_soft_sha256_blocks(ctx->state, data, blocks);
+}
+
+/*!
+ * brief Starts a hash.
+ *
+ * param[out] ctx Software hash context.
+ * param algo Algorithm.
+ * param impl Implementation, kSHA_SOFT_Auto selects the fastest one.
+ * return true on success, false if algo or impl is invalid.
+ */
+bool SHA_SOFT_Init(sha_soft_ctx_t *ctx, sha_soft_algo_t algo, sha_soft_impl_t impl)
+{
+    if ((algo > kSHA_SOFT_Sha512) || (impl > kSHA_SOFT_Avx2))
+    {
+        return false;
+    }
+
+    /* single messages have no AVX2 code, SHA-NI has no SHA-512 */
+    if ((impl == kSHA_SOFT_Auto) || (impl == kSHA_SOFT_Avx2))
+    {
+        impl = kSHA_SOFT_ShaNi;
+    }
+#if SHA_SOFT_HAS_X86
+    if ((impl == kSHA_SOFT_ShaNi) && ((algo != kSHA_SOFT_Sha256) || !sha_soft_has_shani()))
+    {
+        impl = kSHA_SOFT_Portable;
+    }
+#else
+    impl = kSHA_SOFT_Portable;
+#endif
+
+    memset(ctx, 0, sizeof(*ctx));
+    ctx->algo = algo;
+    ctx->impl = impl;
+    for (uint32_t i = 0; i < 8u; i++)
+    {
+        if (algo == kSHA_SOFT_Sha512)
+        {
+            ctx->state[2u * i] = (uint32_t)(s_sha512Iv[i] >> 32);
+            ctx->state[2u * i + 1u] = (uint32_t)s_sha512Iv[i];
+        }
+        else
+        {
+            ctx->state[i] = s_sha256Iv[i];
+        }
+    }
+
+    return true;
+}
+
+/*!
+ * brief Adds data to a hash.
+ *
+ * param[in,out] ctx Software hash context.
+ * param input Input data, any alignment.
+ * param size Size of input data in bytes.
+ */
+void SHA_SOFT_Update(sha_soft_ctx_t *ctx, const uint8_t *input, size_t size)
+{
+    size_t blockSize = sha_soft_block_size(ctx);
+    size_t n;
+
+    ctx->lengthLow += (uint32_t)size;
+    ctx->lengthHigh += (uint32_t)((uint64_t)size >> 32) + ((ctx->lengthLow < (uint32_t)size) ? 1u : 0u);
+
+    if (ctx->blksz)
+    {
+        n = SHA_SOFT_MIN(blockSize - ctx->blksz, size);
+        memcpy(&ctx->blk[ctx->blksz], input, n);
+        ctx->blksz += n;
+        input += n;
+        size -= n;
+        if (ctx->blksz < blockSize)
+        {
+            return;
+        }
+        sha_soft_blocks(ctx, ctx->blk, 1);
+        ctx->blksz = 0;
+    }
+
+    /* full blocks straight from the input, the implementations read any alignment */
+    n = size / blockSize;
+    if (n)
+    {
+        sha_soft_blocks(ctx, input, n);
+        input += n * blockSize;
+        size -= n * blockSize;
+    }
+
+    memcpy(ctx->blk, input, size);
+    ctx->blksz = size;
+}
+
+/*!
+ * brief Finishes a hash and clears the context.
+ *
+ * param[in,out] ctx Software hash context.
+ * param[out] output Digest, SHA_SOFT_SHA256_SIZE or SHA_SOFT_SHA512_SIZE bytes.
+ */
+void SHA_SOFT_Finish(sha_soft_ctx_t *ctx, uint8_t *output)
+{
+    size_t blockSize = sha_soft_block_size(ctx);
+    size_t words = (ctx->algo == kSHA_SOFT_Sha512) ? 16u : 8u;
+    uint32_t bitsHigh = (ctx->lengthHigh << 3) | (ctx->lengthLow >> 29);
+    uint32_t bitsLow = ctx->lengthLow << 3;
+
+    /* 0x80, zeros and the message size in bits, big endian in the last 8 bytes (upper SHA-512 bits are 0) */
+    ctx->blk[ctx->blksz++] = 0x80u;
+    if (ctx->blksz > blockSize - blockSize / 8u)
+    {
+        memset(&ctx->blk[ctx->blksz], 0, blockSize - ctx->blksz);
+        sha_soft_blocks(ctx, ctx->blk, 1);
+        ctx->blksz = 0;
+    }
+    memset(&ctx->blk[ctx->blksz], 0, blockSize - ctx->blksz);
+    SHA_SOFT_PUT32(&ctx->blk[blockSize - 8u], bitsHigh);
+    SHA_SOFT_PUT32(&ctx->blk[blockSize - 4u], bitsLow);
+    sha_soft_blocks(ctx, ctx->blk, 1);
+
+    for (uint32_t i = 0; i < words; i++)
+    {
+        SHA_SOFT_PUT32(&output[4u * i], ctx->state[i]);
+    }
+    memset(ctx, 0, sizeof(*ctx));
+}
+
+/*!
+ * brief Hashes many independent messages, for example to check digests reported by devices in bulk.
+ *
+ * param algo Algorithm.
+ * param impl Implementation, kSHA_SOFT_Auto selects SHA-NI for SHA-256 and AVX2 otherwise, if the host supports them.
+ * param input Array of count messages.
+ * param size Array of count message sizes in bytes.
+ * param[out] output count digests, stored one after the other.
+ * param count Number of messages.
+ * return true on success, false if algo or impl is invalid.
+ */
+bool SHA_SOFT_HashMulti(sha_soft_algo_t algo,
+                        sha_soft_impl_t impl,
+                        const uint8_t *const input[],
+                        const size_t size[],
+                        uint8_t *output,
+                        size_t count)
+{
+    size_t digestSize = (algo == kSHA_SOFT_Sha512) ? SHA_SOFT_SHA512_SIZE : SHA_SOFT_SHA256_SIZE;
+    sha_soft_ctx_t ctx;
+
+    if ((algo > kSHA_SOFT_Sha512) || (impl > kSHA_SOFT_Avx2))
+    {
+        return false;
+    }
+
+#if SHA_SOFT_HAS_X86
+    /* one SHA-NI stream outruns eight AVX2 lanes */
+    if ((impl == kSHA_SOFT_Auto) && (algo == kSHA_SOFT_Sha256) && sha_soft_has_shani())
+    {
+        impl = kSHA_SOFT_ShaNi;
+    }
+    if (((impl == kSHA_SOFT_Auto) || (impl == kSHA_SOFT_Avx2)) && sha_soft_has_avx2())
+    {
+        sha_soft_avx2_multi(algo, input, size, output, count);
+        return true;
+    }
+#endif
+
+    for (size_t m = 0; m < count; m++)
+    {
+        (void)SHA_SOFT_Init(&ctx, algo, impl);
+        SHA_SOFT_Update(&ctx, input[m], size[m]);
+        SHA_SOFT_Finish(&ctx, &output[m * digestSize]);
+    }
+
+    return true;
+}
@@ -0,0 +1,138 @@
+/*
+ * Copyright 2026 asvin.io
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _FSL_SHA_SOFT_H_
+#define _FSL_SHA_SOFT_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*!
+ * @addtogroup sha_soft
+ * @{
+ */
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+
+/*! @brief SHA-256 digest size in bytes. */
+#define SHA_SOFT_SHA256_SIZE 32
+/*! @brief SHA-512 digest size in bytes. */
+#define SHA_SOFT_SHA512_SIZE 64
+/*! @brief Largest block size in bytes, the SHA-512 one. */
+#define SHA_SOFT_MAX_BLOCK_SIZE 128
+
+/*! @brief Builds the SHA-NI and AVX2 implementations, enabled by default on x86 with GCC or Clang. */
+#ifndef SHA_SOFT_HAS_X86
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define SHA_SOFT_HAS_X86 1
+#else
+#define SHA_SOFT_HAS_X86 0
+#endif
+#endif
+
+/*! @brief Software hash algorithm. */
+typedef enum _sha_soft_algo
+{
+    kSHA_SOFT_Sha256 = 0U, /*!< SHA-256 */
+    kSHA_SOFT_Sha512 = 1U, /*!< SHA-512 */
+} sha_soft_algo_t;
+
+/*! @brief Software hash implementation. */
+typedef enum _sha_soft_impl
+{
+    kSHA_SOFT_Auto = 0U,     /*!< Fastest implementation supported by the host */
+    kSHA_SOFT_Portable = 1U, /*!< Portable C, rounds unrolled eight at a time */
+    kSHA_SOFT_ShaNi = 2U,    /*!< x86 SHA extensions, SHA-256 only */
+    kSHA_SOFT_Avx2 = 3U,     /*!< x86 AVX2, 8 SHA-256 or 4 SHA-512 messages in parallel, SHA_SOFT_HashMulti() only */
+} sha_soft_impl_t;
+
+/*!
+ * @brief Software hash context.
+ *
+ * Words only, so that the context can be embedded in word aligned storage such as hashcrypt_hash_ctx_t.
+ */
+typedef struct _sha_soft_ctx
+{
+    uint32_t state[16];                   /*!< Running hash, SHA-512 words stored high word first */
+    uint8_t blk[SHA_SOFT_MAX_BLOCK_SIZE]; /*!< Incomplete block */
+    uint32_t blksz;                       /*!< Number of valid bytes in blk */
+    uint32_t lengthLow;                   /*!< Message size in bytes, low word */
+    uint32_t lengthHigh;                  /*!< Message size in bytes, high word */
+    sha_soft_algo_t algo;                 /*!< Algorithm */
+    sha_soft_impl_t impl;                 /*!< Implementation selected by SHA_SOFT_Init() */
+} sha_soft_ctx_t;
+
+/*******************************************************************************
+ * API
+ ******************************************************************************/
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/*!
+ * @brief Starts a hash.
+ *
+ * Implementations not supported by the host or the algorithm fall back to kSHA_SOFT_Portable.
+ *
+ * @param[out] ctx Software hash context.
+ * @param algo Algorithm.
+ * @param impl Implementation, kSHA_SOFT_Auto selects the fastest one.
+ * @return true on success, false if algo or impl is invalid.
+ */
+bool SHA_SOFT_Init(sha_soft_ctx_t *ctx, sha_soft_algo_t algo, sha_soft_impl_t impl);
+
+/*!
+ * @brief Adds data to a hash.
+ *
+ * @param[in,out] ctx Software hash context.
+ * @param input Input data, any alignment.
+ * @param size Size of input data in bytes.
+ */
+void SHA_SOFT_Update(sha_soft_ctx_t *ctx, const uint8_t *input, size_t size);
+
+/*!
+ * @brief Finishes a hash and clears the context.
+ *
+ * @param[in,out] ctx Software hash context.
+ * @param[out] output Digest, SHA_SOFT_SHA256_SIZE or SHA_SOFT_SHA512_SIZE bytes.
+ */
+void SHA_SOFT_Finish(sha_soft_ctx_t *ctx, uint8_t *output);
+
+/*!
+ * @brief Hashes many independent messages, for example to check digests reported by devices in bulk.
+ *
+ * With kSHA_SOFT_Avx2 the messages are interleaved over the vector lanes. A lane that finishes its message
+ * takes the next one, so messages of different sizes keep all lanes busy.
+ *
+ * @param algo Algorithm.
+ * @param impl Implementation, kSHA_SOFT_Auto selects SHA-NI for SHA-256 and AVX2 otherwise, if the host supports them.
+ * @param input Array of count messages.
+ * @param size Array of count message sizes in bytes.
+ * @param[out] output count digests, stored one after the other.
+ * @param count Number of messages.
+ * @return true on success, false if algo or impl is invalid.
+ */
+bool SHA_SOFT_HashMulti(sha_soft_algo_t algo,
+                        sha_soft_impl_t impl,
+                        const uint8_t *const input[],
+                        const size_t size[],
+                        uint8_t *output,
+                        size_t count);
+
+#if defined(__cplusplus)
+}
+#endif
+
+/*!
+ * @}
+ */
+
+#endif /* _FSL_SHA_SOFT_H_ */
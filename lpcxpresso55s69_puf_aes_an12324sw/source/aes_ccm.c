@@ -0,0 +1,492 @@
+/*
+ * Copyright 2026 asvin.io
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <string.h>
+#include "aes_ccm.h"
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+#define AES_CCM_BLOCK_SIZE HASHCRYPT_AES_BLOCK_SIZE
+#define AES_CCM_BLOCK_WORDS (AES_CCM_BLOCK_SIZE / sizeof(uint32_t))
+#define AES_CCM_PAD(size) (((size) + AES_CCM_BLOCK_SIZE - 1u) & ~(AES_CCM_BLOCK_SIZE - 1u))
+
+#if (AES_CCM_SCRATCH_SIZE % AES_CCM_BLOCK_SIZE) || (AES_CCM_SCRATCH_SIZE < 2 * AES_CCM_BLOCK_SIZE)
+#error "AES_CCM_SCRATCH_SIZE shall be a multiple of 16 and at least 32"
+#endif
+
+#if (AES_CCM_BATCH_MAX == 0)
+#error "AES_CCM_BATCH_MAX shall not be zero"
+#endif
+
+/*! @brief Layout of one record in the working buffer. */
+typedef struct _aes_ccm_slot
+{
+    aes_ccm_record_t *record;                /*!< Record */
+    size_t offset;                           /*!< Offset of B0 in the working buffer */
+    size_t payload;                          /*!< Offset of the payload from B0 */
+    size_t size;                             /*!< Size of formatted data (B0, AAD and payload) */
+    uint32_t counter[AES_CCM_BLOCK_WORDS];   /*!< Counter block A0 */
+    uint32_t tag[AES_CCM_BLOCK_WORDS];       /*!< Tag, encrypted or decrypted */
+} aes_ccm_slot_t;
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+/*! Formatted records: B0, encoded AAD and payload, all padded to 16 bytes. */
+static uint32_t s_ccmScratch[AES_CCM_SCRATCH_SIZE / sizeof(uint32_t)];
+static const uint32_t s_ccmZeroIv[AES_CCM_BLOCK_WORDS] = {0};
+static aes_ccm_slot_t s_ccmSlots[AES_CCM_BATCH_MAX];
+static hashcrypt_aes_job_t s_ccmJobs[AES_CCM_BATCH_MAX];
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+/*!
+ * @brief Returns offset of the payload from B0, i.e. size of B0 and the encoded, padded AAD.
+ */
+static size_t aes_ccm_header_size(size_t aadSize)
+{
+    size_t lenSize = 0;
+
+    if (aadSize)
+    {
+        lenSize = (aadSize < 0xff00u) ? 2u : 6u;
+    }
+
+    return AES_CCM_BLOCK_SIZE + AES_CCM_PAD(lenSize + aadSize);
+}
+
+/*!
+ * @brief Checks CCM parameters and returns size of the formatted record in \p need.
+ */
+static status_t aes_ccm_check(
+    size_t nonceSize, size_t aadSize, size_t size, size_t tagSize, const uint8_t *tag, size_t *need)
+{
+    size_t lenSize = 15u - nonceSize;
+
+    if ((nonceSize < 7u) || (nonceSize > 13u) || (tagSize < 4u) || (tagSize > 16u) || (tagSize & 1u) ||
+        (tag == NULL))
+    {
+        return kStatus_InvalidArgument;
+    }
+
+    /* payload length shall fit into the L bytes of B0 */
+    if ((lenSize < sizeof(size_t)) && (size >> (8u * lenSize)))
+    {
+        return kStatus_InvalidArgument;
+    }
+
+    if ((aadSize > AES_CCM_SCRATCH_SIZE) || (size > AES_CCM_SCRATCH_SIZE))
+    {
+        return kStatus_InvalidArgument;
+    }
+
+    *need = aes_ccm_header_size(aadSize) + AES_CCM_PAD(size);
+    if (*need > AES_CCM_SCRATCH_SIZE)
+    {
+        return kStatus_InvalidArgument;
+    }
+
+    return kStatus_Success;
+}
+
+/*!
+ * @brief Writes B0 and the encoded AAD followed by zero padding.
+ *
+ * @param[out] buf Working buffer, at least aes_ccm_header_size(aadSize) bytes.
+ */
+static void aes_ccm_format(uint8_t *buf,
+                           const uint8_t *nonce,
+                           size_t nonceSize,
+                           const uint8_t *aad,
+                           size_t aadSize,
+                           size_t size,
+                           size_t tagSize)
+{
+    size_t lenSize = 15u - nonceSize;
+    size_t hdr = aes_ccm_header_size(aadSize);
+    uint8_t *p;
+
+    memset(buf, 0, hdr);
+
+    /* B0: flags | nonce | payload length */
+    buf[0] = (uint8_t)(((aadSize != 0u) ? 0x40u : 0u) | (((tagSize - 2u) / 2u) << 3) | (lenSize - 1u));
+    memcpy(&buf[1], nonce, nonceSize);
+    for (size_t i = 0; (i < lenSize) && (i < sizeof(size_t)); i++)
+    {
+        buf[15u - i] = (uint8_t)(size >> (8u * i));
+    }
+
+    if (aadSize == 0u)
+    {
+        return;
+    }
+
+    p = &buf[AES_CCM_BLOCK_SIZE];
+    if (aadSize < 0xff00u)
+    {
+        *p++ = (uint8_t)(aadSize >> 8);
+        *p++ = (uint8_t)aadSize;
+    }
+    else
+    {
+        *p++ = 0xffu;
+        *p++ = 0xfeu;
+        *p++ = (uint8_t)(aadSize >> 24);
+        *p++ = (uint8_t)(aadSize >> 16);
+        *p++ = (uint8_t)(aadSize >> 8);
+        *p++ = (uint8_t)aadSize;
+    }
+    memcpy(p, aad, aadSize);
+}
+
+/*!
+ * @brief Sets counter block A0: flags | nonce | zero counter.
+ */
+static void aes_ccm_counter(uint32_t counter[AES_CCM_BLOCK_WORDS], const uint8_t *nonce, size_t nonceSize)
+{
+    uint8_t *ctr = (uint8_t *)counter;
+
+    memset(ctr, 0, AES_CCM_BLOCK_SIZE);
+    ctr[0] = (uint8_t)(14u - nonceSize);
+    memcpy(&ctr[1], nonce, nonceSize);
+}
+
+/*!
+ * @brief Compares tags in constant time.
+ */
+static bool aes_ccm_tag_equal(const uint8_t *a, const uint8_t *b, size_t tagSize)
+{
+    uint8_t diff = 0;
+
+    for (size_t i = 0; i < tagSize; i++)
+    {
+        diff |= a[i] ^ b[i];
+    }
+
+    return (diff == 0u);
+}
+
+/*!
+ * @brief Packs records into the working buffer starting at \p first.
+ *
+ * Records with invalid parameters get kStatus_InvalidArgument and are skipped.
+ *
+ * @param[in,out] first Index of the first record to pack, updated to the first record not packed.
+ * @param[out] failed Set to true if some record was skipped.
+ * @return Number of slots used.
+ */
+static size_t aes_ccm_pack(aes_ccm_record_t *records, size_t count, size_t tagSize, size_t *first, bool *failed)
+{
+    size_t used = 0;
+    size_t n = 0;
+    size_t need;
+    aes_ccm_record_t *r;
+
+    while ((*first < count) && (n < AES_CCM_BATCH_MAX))
+    {
+        r = &records[*first];
+        r->status = aes_ccm_check(r->nonceSize, r->aadSize, r->size, tagSize, r->tag, &need);
+        if (r->status != kStatus_Success)
+        {
+            *failed = true;
+            (*first)++;
+            continue;
+        }
+        if (used + need > AES_CCM_SCRATCH_SIZE)
+        {
+            break;
+        }
+
+        s_ccmSlots[n].record = r;
+        s_ccmSlots[n].offset = used;
+        s_ccmSlots[n].payload = aes_ccm_header_size(r->aadSize);
+        s_ccmSlots[n].size = need;
+        aes_ccm_counter(s_ccmSlots[n].counter, r->nonce, r->nonceSize);
+        used += need;
+        n++;
+        (*first)++;
+    }
+
+    return n;
+}
+
+/*!
+ * @brief Fills a batch job working in place on the working buffer.
+ */
+static void aes_ccm_job(hashcrypt_aes_job_t *job,
+                        hashcrypt_handle_t *handle,
+                        hashcrypt_aes_mode_t mode,
+                        uint8_t *iv,
+                        uint8_t *data,
+                        size_t size)
+{
+    job->mode = mode;
+    job->direction = AES_ENCRYPT;
+    job->handle = handle;
+    job->iv = iv;
+    job->input = data;
+    job->output = data;
+    job->size = size;
+    job->status = kStatus_Success;
+}
+
+status_t AES_CCM_Encrypt(HASHCRYPT_Type *base,
+                         hashcrypt_handle_t *handle,
+                         const uint8_t *nonce,
+                         size_t nonceSize,
+                         const uint8_t *aad,
+                         size_t aadSize,
+                         const uint8_t *plaintext,
+                         uint8_t *ciphertext,
+                         size_t size,
+                         uint8_t *tag,
+                         size_t tagSize)
+{
+    status_t status;
+    size_t need;
+    size_t hdr;
+    uint8_t *buf = (uint8_t *)s_ccmScratch;
+    uint32_t counter[AES_CCM_BLOCK_WORDS];
+
+    status = aes_ccm_check(nonceSize, aadSize, size, tagSize, tag, &need);
+    if (status != kStatus_Success)
+    {
+        return status;
+    }
+
+    hdr = aes_ccm_header_size(aadSize);
+    aes_ccm_format(buf, nonce, nonceSize, aad, aadSize, size, tagSize);
+    memcpy(&buf[hdr], plaintext, size);
+    memset(&buf[hdr + size], 0, need - hdr - size);
+
+    /* T is placed right before the payload, so one CTR run returns the encrypted tag followed by the cipher text */
+    status = HASHCRYPT_AES_CbcMac(base, handle, buf, need, (const uint8_t *)s_ccmZeroIv, &buf[hdr - AES_CCM_BLOCK_SIZE]);
+    if (status == kStatus_Success)
+    {
+        aes_ccm_counter(counter, nonce, nonceSize);
+        status = HASHCRYPT_AES_CryptCtr(base, handle, &buf[hdr - AES_CCM_BLOCK_SIZE], &buf[hdr - AES_CCM_BLOCK_SIZE],
+                                        AES_CCM_BLOCK_SIZE + size, (uint8_t *)counter, NULL, NULL);
+    }
+    if (status == kStatus_Success)
+    {
+        memcpy(tag, &buf[hdr - AES_CCM_BLOCK_SIZE], tagSize);
+        memcpy(ciphertext, &buf[hdr], size);
+    }
+
+    memset(buf, 0, need);
+    return status;
+}
+
+status_t AES_CCM_Decrypt(HASHCRYPT_Type *base,
+                         hashcrypt_handle_t *handle,
+                         const uint8_t *nonce,
+                         size_t nonceSize,
+                         const uint8_t *aad,
+                         size_t aadSize,
+                         const uint8_t *ciphertext,
+                         uint8_t *plaintext,
+                         size_t size,
+                         const uint8_t *tag,
+                         size_t tagSize)
+{
+    status_t status;
+    size_t need;
+    size_t hdr;
+    uint8_t *buf = (uint8_t *)s_ccmScratch;
+    uint32_t counter[AES_CCM_BLOCK_WORDS];
+    uint32_t expected[AES_CCM_BLOCK_WORDS];
+    uint32_t mac[AES_CCM_BLOCK_WORDS];
+
+    status = aes_ccm_check(nonceSize, aadSize, size, tagSize, tag, &need);
+    if (status != kStatus_Success)
+    {
+        return status;
+    }
+
+    /* decrypt [U | C] first, then format the header over the block that held U */
+    hdr = aes_ccm_header_size(aadSize);
+    memset(&buf[hdr - AES_CCM_BLOCK_SIZE], 0, AES_CCM_BLOCK_SIZE);
+    memcpy(&buf[hdr - AES_CCM_BLOCK_SIZE], tag, tagSize);
+    memcpy(&buf[hdr], ciphertext, size);
+
+    aes_ccm_counter(counter, nonce, nonceSize);
+    status = HASHCRYPT_AES_CryptCtr(base, handle, &buf[hdr - AES_CCM_BLOCK_SIZE], &buf[hdr - AES_CCM_BLOCK_SIZE],
+                                    AES_CCM_BLOCK_SIZE + size, (uint8_t *)counter, NULL, NULL);
+    if (status == kStatus_Success)
+    {
+        memcpy(expected, &buf[hdr - AES_CCM_BLOCK_SIZE], AES_CCM_BLOCK_SIZE);
+        aes_ccm_format(buf, nonce, nonceSize, aad, aadSize, size, tagSize);
+        memset(&buf[hdr + size], 0, need - hdr - size);
+        status = HASHCRYPT_AES_CbcMac(base, handle, buf, need, (const uint8_t *)s_ccmZeroIv, (uint8_t *)mac);
+    }
+    if (status == kStatus_Success)
+    {
+        if (aes_ccm_tag_equal((const uint8_t *)mac, (const uint8_t *)expected, tagSize))
+        {
+            memcpy(plaintext, &buf[hdr], size);
+        }
+        else
+        {
+            memset(plaintext, 0, size);
+            status = kStatus_Fail;
+        }
+    }
+
+    memset(buf, 0, need);
+    return status;
+}
+
+status_t AES_CCM_EncryptBatch(
+    HASHCRYPT_Type *base, hashcrypt_handle_t *handle, aes_ccm_record_t *records, size_t count, size_t tagSize)
+{
+    uint8_t *buf = (uint8_t *)s_ccmScratch;
+    bool failed = false;
+    size_t first = 0;
+    size_t n;
+    aes_ccm_slot_t *s;
+    aes_ccm_record_t *r;
+    uint8_t *b0;
+
+    while (first < count)
+    {
+        n = aes_ccm_pack(records, count, tagSize, &first, &failed);
+
+        /* CBC-MAC of all records with one engine configuration */
+        for (size_t i = 0; i < n; i++)
+        {
+            s = &s_ccmSlots[i];
+            r = s->record;
+            b0 = &buf[s->offset];
+            aes_ccm_format(b0, r->nonce, r->nonceSize, r->aad, r->aadSize, r->size, tagSize);
+            memcpy(&b0[s->payload], r->input, r->size);
+            memset(&b0[s->payload + r->size], 0, s->size - s->payload - r->size);
+            aes_ccm_job(&s_ccmJobs[i], handle, kHASHCRYPT_AesCbc, (uint8_t *)s_ccmZeroIv, b0, s->size);
+        }
+        (void)HASHCRYPT_AES_ProcessBatch(base, s_ccmJobs, n);
+
+        /* CBC ran in place: keep T, restore the payload and encrypt [T | P] with one engine configuration */
+        for (size_t i = 0; i < n; i++)
+        {
+            s = &s_ccmSlots[i];
+            r = s->record;
+            b0 = &buf[s->offset];
+            r->status = s_ccmJobs[i].status;
+            memcpy(s->tag, &b0[s->size - AES_CCM_BLOCK_SIZE], AES_CCM_BLOCK_SIZE);
+            memcpy(&b0[s->payload - AES_CCM_BLOCK_SIZE], s->tag, AES_CCM_BLOCK_SIZE);
+            memcpy(&b0[s->payload], r->input, r->size);
+            aes_ccm_job(&s_ccmJobs[i], handle, kHASHCRYPT_AesCtr, (uint8_t *)s->counter,
+                        &b0[s->payload - AES_CCM_BLOCK_SIZE], (r->status == kStatus_Success) ?
+                                                                  AES_CCM_BLOCK_SIZE + r->size : 0u);
+        }
+        (void)HASHCRYPT_AES_ProcessBatch(base, s_ccmJobs, n);
+
+        for (size_t i = 0; i < n; i++)
+        {
+            s = &s_ccmSlots[i];
+            r = s->record;
+            b0 = &buf[s->offset];
+            if (r->status == kStatus_Success)
+            {
+                r->status = s_ccmJobs[i].status;
+            }
+            if (r->status == kStatus_Success)
+            {
+                memcpy(r->tag, &b0[s->payload - AES_CCM_BLOCK_SIZE], tagSize);
+                memcpy(r->output, &b0[s->payload], r->size);
+            }
+            else
+            {
+                failed = true;
+            }
+        }
+
+        if (n)
+        {
+            memset(buf, 0, s_ccmSlots[n - 1u].offset + s_ccmSlots[n - 1u].size);
+        }
+    }
+
+    memset(s_ccmSlots, 0, sizeof(s_ccmSlots));
+    return failed ? kStatus_Fail : kStatus_Success;
+}
+
+status_t AES_CCM_DecryptBatch(
+    HASHCRYPT_Type *base, hashcrypt_handle_t *handle, aes_ccm_record_t *records, size_t count, size_t tagSize)
+{
+    uint8_t *buf = (uint8_t *)s_ccmScratch;
+    bool failed = false;
+    size_t first = 0;
+    size_t n;
+    aes_ccm_slot_t *s;
+    aes_ccm_record_t *r;
+    uint8_t *b0;
+
+    while (first < count)
+    {
+        n = aes_ccm_pack(records, count, tagSize, &first, &failed);
+
+        /* decrypt [U | C] of all records with one engine configuration */
+        for (size_t i = 0; i < n; i++)
+        {
+            s = &s_ccmSlots[i];
+            r = s->record;
+            b0 = &buf[s->offset];
+            memset(&b0[s->payload - AES_CCM_BLOCK_SIZE], 0, AES_CCM_BLOCK_SIZE);
+            memcpy(&b0[s->payload - AES_CCM_BLOCK_SIZE], r->tag, tagSize);
+            memcpy(&b0[s->payload], r->input, r->size);
+            aes_ccm_job(&s_ccmJobs[i], handle, kHASHCRYPT_AesCtr, (uint8_t *)s->counter,
+                        &b0[s->payload - AES_CCM_BLOCK_SIZE], AES_CCM_BLOCK_SIZE + r->size);
+        }
+        (void)HASHCRYPT_AES_ProcessBatch(base, s_ccmJobs, n);
+
+        /* CBC-MAC of the recovered plain text, keep a copy of it as CBC runs in place */
+        for (size_t i = 0; i < n; i++)
+        {
+            s = &s_ccmSlots[i];
+            r = s->record;
+            b0 = &buf[s->offset];
+            r->status = s_ccmJobs[i].status;
+            memcpy(s->tag, &b0[s->payload - AES_CCM_BLOCK_SIZE], AES_CCM_BLOCK_SIZE);
+            memcpy(r->output, &b0[s->payload], r->size);
+            aes_ccm_format(b0, r->nonce, r->nonceSize, r->aad, r->aadSize, r->size, tagSize);
+            memset(&b0[s->payload + r->size], 0, s->size - s->payload - r->size);
+            aes_ccm_job(&s_ccmJobs[i], handle, kHASHCRYPT_AesCbc, (uint8_t *)s_ccmZeroIv, b0,
+                        (r->status == kStatus_Success) ? s->size : 0u);
+        }
+        (void)HASHCRYPT_AES_ProcessBatch(base, s_ccmJobs, n);
+
+        for (size_t i = 0; i < n; i++)
+        {
+            s = &s_ccmSlots[i];
+            r = s->record;
+            b0 = &buf[s->offset];
+            if (r->status == kStatus_Success)
+            {
+                r->status = s_ccmJobs[i].status;
+            }
+            if ((r->status == kStatus_Success) &&
+                (!aes_ccm_tag_equal(&b0[s->size - AES_CCM_BLOCK_SIZE], (const uint8_t *)s->tag, tagSize)))
+            {
+                r->status = kStatus_Fail;
+            }
+            if (r->status != kStatus_Success)
+            {
+                memset(r->output, 0, r->size);
+                failed = true;
+            }
+        }
+
+        if (n)
+        {
+            memset(buf, 0, s_ccmSlots[n - 1u].offset + s_ccmSlots[n - 1u].size);
+        }
+    }
+
+    memset(s_ccmSlots, 0, sizeof(s_ccmSlots));
+    return failed ? kStatus_Fail : kStatus_Success;
+}
@@ -0,0 +1,150 @@
+/*
+ * Copyright 2026 asvin.io
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _AES_CCM_H_
+#define _AES_CCM_H_
+
+#include "fsl_common.h"
+#include "fsl_hashcrypt.h"
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+
+/*! @brief Size of the word aligned working buffer in bytes.
+ *
+ * One record needs 16 bytes for B0, AAD with its length field and payload, both padded to 16 bytes.
+ * Larger records are rejected with kStatus_InvalidArgument.
+ */
+#ifndef AES_CCM_SCRATCH_SIZE
+#define AES_CCM_SCRATCH_SIZE 1024
+#endif
+
+/*! @brief Maximum number of records processed by one HASHCRYPT pass of the batch APIs. */
+#ifndef AES_CCM_BATCH_MAX
+#define AES_CCM_BATCH_MAX 8
+#endif
+
+/*! @brief One record of AES_CCM_EncryptBatch() or AES_CCM_DecryptBatch(). */
+typedef struct _aes_ccm_record
+{
+    const uint8_t *nonce; /*!< Nonce */
+    size_t nonceSize;     /*!< Size of nonce in bytes, 7 to 13 */
+    const uint8_t *aad;   /*!< Additional authenticated data, can be NULL if aadSize is 0 */
+    size_t aadSize;       /*!< Size of additional authenticated data in bytes */
+    const uint8_t *input; /*!< Input data, plain text for encryption, cipher text for decryption */
+    uint8_t *output;      /*!< Output data, cipher text for encryption, plain text for decryption */
+    size_t size;          /*!< Size of input and output data in bytes */
+    uint8_t *tag;         /*!< Output tag for encryption, expected tag for decryption */
+    status_t status;      /*!< Output status of this record */
+} aes_ccm_record_t;
+
+/*******************************************************************************
+ * API
+ ******************************************************************************/
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/*!
+ * @brief Encrypts and authenticates one record using AES-CCM.
+ *
+ * The record is formatted in the working buffer, the MAC is computed in one CBC pass and the tag and
+ * the cipher text are then produced by one CTR pass over the MAC block and the payload.
+ *
+ * @param base HASHCRYPT peripheral base address.
+ * @param handle Handle with the key, set by HASHCRYPT_AES_SetKey().
+ * @param nonce Nonce.
+ * @param nonceSize Size of nonce in bytes, 7 to 13.
+ * @param aad Additional authenticated data. Can be NULL if aadSize is 0.
+ * @param aadSize Size of additional authenticated data in bytes.
+ * @param plaintext Input plain text.
+ * @param[out] ciphertext Output cipher text.
+ * @param size Size of plain text and cipher text in bytes.
+ * @param[out] tag Output authentication tag.
+ * @param tagSize Size of tag in bytes, 4, 6, 8, 10, 12, 14 or 16.
+ * @return kStatus_Success, kStatus_InvalidArgument or status from HASHCRYPT.
+ */
+status_t AES_CCM_Encrypt(HASHCRYPT_Type *base,
+                         hashcrypt_handle_t *handle,
+                         const uint8_t *nonce,
+                         size_t nonceSize,
+                         const uint8_t *aad,
+                         size_t aadSize,
+                         const uint8_t *plaintext,
+                         uint8_t *ciphertext,
+                         size_t size,
+                         uint8_t *tag,
+                         size_t tagSize);
+
+/*!
+ * @brief Decrypts and verifies one record using AES-CCM.
+ *
+ * @param base HASHCRYPT peripheral base address.
+ * @param handle Handle with the key, set by HASHCRYPT_AES_SetKey().
+ * @param nonce Nonce.
+ * @param nonceSize Size of nonce in bytes, 7 to 13.
+ * @param aad Additional authenticated data. Can be NULL if aadSize is 0.
+ * @param aadSize Size of additional authenticated data in bytes.
+ * @param ciphertext Input cipher text.
+ * @param[out] plaintext Output plain text, cleared if the tag does not match.
+ * @param size Size of cipher text and plain text in bytes.
+ * @param tag Expected authentication tag.
+ * @param tagSize Size of tag in bytes, 4, 6, 8, 10, 12, 14 or 16.
+ * @return kStatus_Success, kStatus_Fail if the tag does not match, kStatus_InvalidArgument or status from HASHCRYPT.
+ */
+status_t AES_CCM_Decrypt(HASHCRYPT_Type *base,
+                         hashcrypt_handle_t *handle,
+                         const uint8_t *nonce,
+                         size_t nonceSize,
+                         const uint8_t *aad,
+                         size_t aadSize,
+                         const uint8_t *ciphertext,
+                         uint8_t *plaintext,
+                         size_t size,
+                         const uint8_t *tag,
+                         size_t tagSize);
+
+/*!
+ * @brief Encrypts and authenticates many records under one key.
+ *
+ * Records are packed into the working buffer, up to AES_CCM_BATCH_MAX at a time. The CBC-MAC of all packed
+ * records is computed with one HASHCRYPT configuration and the CTR pass of all of them with another one,
+ * see HASHCRYPT_AES_ProcessBatch().
+ *
+ * @param base HASHCRYPT peripheral base address.
+ * @param handle Handle with the key, set by HASHCRYPT_AES_SetKey().
+ * @param[in,out] records Array of records. Status of each record is stored to its status member.
+ * @param count Number of records.
+ * @param tagSize Size of tags in bytes, 4, 6, 8, 10, 12, 14 or 16.
+ * @return kStatus_Success if all records succeeded, kStatus_Fail otherwise.
+ */
+status_t AES_CCM_EncryptBatch(
+    HASHCRYPT_Type *base, hashcrypt_handle_t *handle, aes_ccm_record_t *records, size_t count, size_t tagSize);
+
+/*!
+ * @brief Decrypts and verifies many records under one key.
+ *
+ * Same scheduling as AES_CCM_EncryptBatch(), the CTR pass runs first. Plain text of a record whose tag does not
+ * match is cleared and its status is kStatus_Fail.
+ *
+ * @param base HASHCRYPT peripheral base address.
+ * @param handle Handle with the key, set by HASHCRYPT_AES_SetKey().
+ * @param[in,out] records Array of records. Status of each record is stored to its status member.
+ * @param count Number of records.
+ * @param tagSize Size of tags in bytes, 4, 6, 8, 10, 12, 14 or 16.
+ * @return kStatus_Success if all records succeeded, kStatus_Fail otherwise.
+ */
+status_t AES_CCM_DecryptBatch(
+    HASHCRYPT_Type *base, hashcrypt_handle_t *handle, aes_ccm_record_t *records, size_t count, size_t tagSize);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* _AES_CCM_H_ */
@@ -0,0 +1,197 @@
+/*
+ * Copyright 2026 asvin.io
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <string.h>
+#include "aes_etm.h"
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+static hashcrypt_hmac_ctx_t s_etmHmac;
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+/*!
+ * @brief Checks parameters common to encryption and decryption.
+ */
+static status_t aes_etm_check(hashcrypt_handle_t *handle,
+                              const hashcrypt_hmac_key_t *macKey,
+                              const uint8_t *iv,
+                              const uint8_t *aad,
+                              size_t aadSize,
+                              const uint8_t *input,
+                              const uint8_t *output,
+                              size_t size,
+                              const uint8_t *mac,
+                              size_t macSize)
+{
+    if ((handle == NULL) || (macKey == NULL) || (iv == NULL) || (mac == NULL) || (macSize < 16u) ||
+        (macSize > AES_ETM_MAC_SIZE) || ((aad == NULL) && aadSize) || (((input == NULL) || (output == NULL)) && size))
+    {
+        return kStatus_InvalidArgument;
+    }
+
+    return kStatus_Success;
+}
+
+/*!
+ * @brief Hashes the MAC prefix, aad || iv.
+ */
+static status_t aes_etm_start(
+    HASHCRYPT_Type *base, const hashcrypt_hmac_key_t *macKey, const uint8_t *iv, const uint8_t *aad, size_t aadSize)
+{
+    status_t status;
+
+    status = HASHCRYPT_HMAC_Init(base, &s_etmHmac, macKey);
+    if ((kStatus_Success == status) && aadSize)
+    {
+        status = HASHCRYPT_HMAC_Update(base, &s_etmHmac, aad, aadSize);
+    }
+    if (kStatus_Success == status)
+    {
+        status = HASHCRYPT_HMAC_Update(base, &s_etmHmac, iv, HASHCRYPT_AES_BLOCK_SIZE);
+    }
+
+    return status;
+}
+
+/*!
+ * @brief Hashes the MAC suffix, the bit lengths of aad and payload, and finishes the MAC.
+ */
+static status_t aes_etm_finish(HASHCRYPT_Type *base, size_t aadSize, size_t size, uint8_t *mac, size_t macSize)
+{
+    uint8_t lengths[16] = {0};
+    uint64_t bits;
+    uint32_t i;
+    status_t status;
+
+    for (i = 0; i < 8u; i++)
+    {
+        bits = (uint64_t)aadSize * 8u;
+        lengths[7u - i] = (uint8_t)(bits >> (8u * i));
+        bits = (uint64_t)size * 8u;
+        lengths[15u - i] = (uint8_t)(bits >> (8u * i));
+    }
+
+    status = HASHCRYPT_HMAC_Update(base, &s_etmHmac, lengths, sizeof(lengths));
+    if (kStatus_Success == status)
+    {
+        status = HASHCRYPT_HMAC_Finish(base, &s_etmHmac, mac, macSize);
+    }
+
+    return status;
+}
+
+status_t AES_ETM_Encrypt(HASHCRYPT_Type *base,
+                         hashcrypt_handle_t *handle,
+                         const hashcrypt_hmac_key_t *macKey,
+                         const uint8_t iv[HASHCRYPT_AES_BLOCK_SIZE],
+                         const uint8_t *aad,
+                         size_t aadSize,
+                         const uint8_t *plaintext,
+                         uint8_t *ciphertext,
+                         size_t size,
+                         uint8_t *mac,
+                         size_t macSize)
+{
+    uint8_t counter[HASHCRYPT_AES_BLOCK_SIZE];
+    status_t status;
+
+    status = aes_etm_check(handle, macKey, iv, aad, aadSize, plaintext, ciphertext, size, mac, macSize);
+    if (kStatus_Success != status)
+    {
+        return status;
+    }
+
+    memcpy(counter, iv, sizeof(counter));
+    /* the engine stays with a hash until it is finished, so the whole payload is encrypted before it is hashed */
+    if (size)
+    {
+        status = HASHCRYPT_AES_CryptCtr(base, handle, plaintext, ciphertext, size, counter, NULL, NULL);
+    }
+    if (kStatus_Success == status)
+    {
+        status = aes_etm_start(base, macKey, iv, aad, aadSize);
+    }
+    if ((kStatus_Success == status) && size)
+    {
+        status = HASHCRYPT_HMAC_Update(base, &s_etmHmac, ciphertext, size);
+    }
+    if (kStatus_Success == status)
+    {
+        status = aes_etm_finish(base, aadSize, size, mac, macSize);
+    }
+    if (kStatus_Success != status)
+    {
+        memset(ciphertext, 0, size);
+        memset(mac, 0, macSize);
+    }
+
+    return status;
+}
+
+status_t AES_ETM_Decrypt(HASHCRYPT_Type *base,
+                         hashcrypt_handle_t *handle,
+                         const hashcrypt_hmac_key_t *macKey,
+                         const uint8_t iv[HASHCRYPT_AES_BLOCK_SIZE],
+                         const uint8_t *aad,
+                         size_t aadSize,
+                         const uint8_t *ciphertext,
+                         uint8_t *plaintext,
+                         size_t size,
+                         const uint8_t *mac,
+                         size_t macSize)
+{
+    uint8_t counter[HASHCRYPT_AES_BLOCK_SIZE];
+    uint8_t expected[AES_ETM_MAC_SIZE];
+    uint8_t diff = 0;
+    status_t status;
+    uint32_t i;
+
+    status = aes_etm_check(handle, macKey, iv, aad, aadSize, ciphertext, plaintext, size, mac, macSize);
+    if (kStatus_Success != status)
+    {
+        return status;
+    }
+
+    memcpy(counter, iv, sizeof(counter));
+    status = aes_etm_start(base, macKey, iv, aad, aadSize);
+
+    if ((kStatus_Success == status) && size)
+    {
+        status = HASHCRYPT_HMAC_Update(base, &s_etmHmac, ciphertext, size);
+    }
+
+    if (kStatus_Success == status)
+    {
+        status = aes_etm_finish(base, aadSize, size, expected, macSize);
+    }
+    if (kStatus_Success == status)
+    {
+        for (i = 0; i < macSize; i++)
+        {
+            diff |= expected[i] ^ mac[i];
+        }
+        if (diff)
+        {
+            status = kStatus_Fail;
+        }
+    }
+    /* the hash is finished and the MAC verified, only authentic cipher text is decrypted */
+    if ((kStatus_Success == status) && size)
+    {
+        status = HASHCRYPT_AES_CryptCtr(base, handle, ciphertext, plaintext, size, counter, NULL, NULL);
+    }
+    memset(expected, 0, sizeof(expected));
+
+    if (kStatus_Success != status)
+    {
+        memset(plaintext, 0, size);
+    }
+
+    return status;
+}
@@ -0,0 +1,97 @@
+/*
+ * Copyright 2026 asvin.io
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _AES_ETM_H_
+#define _AES_ETM_H_
+
+#include "fsl_common.h"
+#include "fsl_hashcrypt.h"
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+
+/*! @brief Size of the full MAC in bytes. */
+#define AES_ETM_MAC_SIZE HASHCRYPT_HMAC_SIZE
+
+/*******************************************************************************
+ * API
+ ******************************************************************************/
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/*!
+ * @brief Encrypts with AES-CTR, then authenticates with HMAC-SHA256.
+ *
+ * The MAC covers aad || iv || ciphertext || [aadSize]64 || [size]64, lengths in bits, big endian.
+ *
+ * HASHCRYPT stays with a hash until it is finished, so the work is done in two passes: the whole payload is
+ * encrypted first, then the cipher text is hashed. The cipher text is therefore read back from memory once.
+ *
+ * @param base HASHCRYPT peripheral base address.
+ * @param handle Handle with the AES key, set by HASHCRYPT_AES_SetKey().
+ * @param macKey HMAC key, set by HASHCRYPT_HMAC_SetKey(). Shall differ from the AES key.
+ * @param iv Initial counter block.
+ * @param aad Additional authenticated data. Can be NULL if aadSize is 0.
+ * @param aadSize Size of additional authenticated data in bytes.
+ * @param plaintext Input plain text.
+ * @param[out] ciphertext Output cipher text. Can be the same as plaintext.
+ * @param size Size of plain text and cipher text in bytes.
+ * @param[out] mac Output MAC.
+ * @param macSize Size of mac in bytes, 16 to AES_ETM_MAC_SIZE, the MAC is truncated.
+ * @return kStatus_Success, kStatus_InvalidArgument or status from HASHCRYPT.
+ */
+status_t AES_ETM_Encrypt(HASHCRYPT_Type *base,
+                         hashcrypt_handle_t *handle,
+                         const hashcrypt_hmac_key_t *macKey,
+                         const uint8_t iv[HASHCRYPT_AES_BLOCK_SIZE],
+                         const uint8_t *aad,
+                         size_t aadSize,
+                         const uint8_t *plaintext,
+                         uint8_t *ciphertext,
+                         size_t size,
+                         uint8_t *mac,
+                         size_t macSize);
+
+/*!
+ * @brief Authenticates with HMAC-SHA256, then decrypts with AES-CTR.
+ *
+ * Two passes, as in AES_ETM_Encrypt(): the whole cipher text is hashed first, and it is decrypted only if the MAC
+ * matches.
+ *
+ * @param base HASHCRYPT peripheral base address.
+ * @param handle Handle with the AES key, set by HASHCRYPT_AES_SetKey().
+ * @param macKey HMAC key, set by HASHCRYPT_HMAC_SetKey().
+ * @param iv Initial counter block.
+ * @param aad Additional authenticated data. Can be NULL if aadSize is 0.
+ * @param aadSize Size of additional authenticated data in bytes.
+ * @param ciphertext Input cipher text.
+ * @param[out] plaintext Output plain text, cleared if the MAC does not match. Can be the same as ciphertext.
+ * @param size Size of cipher text and plain text in bytes.
+ * @param mac Expected MAC.
+ * @param macSize Size of mac in bytes, 16 to AES_ETM_MAC_SIZE.
+ * @return kStatus_Success, kStatus_Fail if the MAC does not match, kStatus_InvalidArgument or status from HASHCRYPT.
+ */
+status_t AES_ETM_Decrypt(HASHCRYPT_Type *base,
+                         hashcrypt_handle_t *handle,
+                         const hashcrypt_hmac_key_t *macKey,
+                         const uint8_t iv[HASHCRYPT_AES_BLOCK_SIZE],
+                         const uint8_t *aad,
+                         size_t aadSize,
+                         const uint8_t *ciphertext,
+                         uint8_t *plaintext,
+                         size_t size,
+                         const uint8_t *mac,
+                         size_t macSize);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* _AES_ETM_H_ */
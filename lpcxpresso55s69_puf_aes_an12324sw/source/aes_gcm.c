@@ -0,0 +1,503 @@
+/*
+ * Copyright 2026 asvin.io
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <string.h>
+#include "aes_gcm.h"
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+#define AES_GCM_BLOCK_SIZE HASHCRYPT_AES_BLOCK_SIZE
+#define AES_GCM_IV_SIZE 12
+
+#if (AES_GCM_TABLE_BITS != 4) && (AES_GCM_TABLE_BITS != 8)
+#error "AES_GCM_TABLE_BITS shall be 4 or 8"
+#endif
+
+#if (AES_GCM_CHUNK_SIZE % AES_GCM_BLOCK_SIZE) || (AES_GCM_CHUNK_SIZE == 0)
+#error "AES_GCM_CHUNK_SIZE shall be a non-zero multiple of 16"
+#endif
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+#if AES_GCM_TABLE_BITS == 8
+/*! reduction of the 8 bits shifted out of the GHASH state, in the top 16 bits */
+static const uint16_t s_gcmLast[256] = {
+    0x0000u, 0x01c2u, 0x0384u, 0x0246u, 0x0708u, 0x06cau, 0x048cu, 0x054eu,
+    0x0e10u, 0x0fd2u, 0x0d94u, 0x0c56u, 0x0918u, 0x08dau, 0x0a9cu, 0x0b5eu,
+    0x1c20u, 0x1de2u, 0x1fa4u, 0x1e66u, 0x1b28u, 0x1aeau, 0x18acu, 0x196eu,
+    0x1230u, 0x13f2u, 0x11b4u, 0x1076u, 0x1538u, 0x14fau, 0x16bcu, 0x177eu,
+    0x3840u, 0x3982u, 0x3bc4u, 0x3a06u, 0x3f48u, 0x3e8au, 0x3cccu, 0x3d0eu,
+    0x3650u, 0x3792u, 0x35d4u, 0x3416u, 0x3158u, 0x309au, 0x32dcu, 0x331eu,
+    0x2460u, 0x25a2u, 0x27e4u, 0x2626u, 0x2368u, 0x22aau, 0x20ecu, 0x212eu,
+    0x2a70u, 0x2bb2u, 0x29f4u, 0x2836u, 0x2d78u, 0x2cbau, 0x2efcu, 0x2f3eu,
+    0x7080u, 0x7142u, 0x7304u, 0x72c6u, 0x7788u, 0x764au, 0x740cu, 0x75ceu,
+    0x7e90u, 0x7f52u, 0x7d14u, 0x7cd6u, 0x7998u, 0x785au, 0x7a1cu, 0x7bdeu,
+    0x6ca0u, 0x6d62u, 0x6f24u, 0x6ee6u, 0x6ba8u, 0x6a6au, 0x682cu, 0x69eeu,
+    0x62b0u, 0x6372u, 0x6134u, 0x60f6u, 0x65b8u, 0x647au, 0x663cu, 0x67feu,
+    0x48c0u, 0x4902u, 0x4b44u, 0x4a86u, 0x4fc8u, 0x4e0au, 0x4c4cu, 0x4d8eu,
+    0x46d0u, 0x4712u, 0x4554u, 0x4496u, 0x41d8u, 0x401au, 0x425cu, 0x439eu,
+    0x54e0u, 0x5522u, 0x5764u, 0x56a6u, 0x53e8u, 0x522au, 0x506cu, 0x51aeu,
+    0x5af0u, 0x5b32u, 0x5974u, 0x58b6u, 0x5df8u, 0x5c3au, 0x5e7cu, 0x5fbeu,
+    0xe100u, 0xe0c2u, 0xe284u, 0xe346u, 0xe608u, 0xe7cau, 0xe58cu, 0xe44eu,
+    0xef10u, 0xeed2u, 0xec94u, 0xed56u, 0xe818u, 0xe9dau, 0xeb9cu, 0xea5eu,
+    0xfd20u, 0xfce2u, 0xfea4u, 0xff66u, 0xfa28u, 0xfbeau, 0xf9acu, 0xf86eu,
+    0xf330u, 0xf2f2u, 0xf0b4u, 0xf176u, 0xf438u, 0xf5fau, 0xf7bcu, 0xf67eu,
+    0xd940u, 0xd882u, 0xdac4u, 0xdb06u, 0xde48u, 0xdf8au, 0xddccu, 0xdc0eu,
+    0xd750u, 0xd692u, 0xd4d4u, 0xd516u, 0xd058u, 0xd19au, 0xd3dcu, 0xd21eu,
+    0xc560u, 0xc4a2u, 0xc6e4u, 0xc726u, 0xc268u, 0xc3aau, 0xc1ecu, 0xc02eu,
+    0xcb70u, 0xcab2u, 0xc8f4u, 0xc936u, 0xcc78u, 0xcdbau, 0xcffcu, 0xce3eu,
+    0x9180u, 0x9042u, 0x9204u, 0x93c6u, 0x9688u, 0x974au, 0x950cu, 0x94ceu,
+    0x9f90u, 0x9e52u, 0x9c14u, 0x9dd6u, 0x9898u, 0x995au, 0x9b1cu, 0x9adeu,
+    0x8da0u, 0x8c62u, 0x8e24u, 0x8fe6u, 0x8aa8u, 0x8b6au, 0x892cu, 0x88eeu,
+    0x83b0u, 0x8272u, 0x8034u, 0x81f6u, 0x84b8u, 0x857au, 0x873cu, 0x86feu,
+    0xa9c0u, 0xa802u, 0xaa44u, 0xab86u, 0xaec8u, 0xaf0au, 0xad4cu, 0xac8eu,
+    0xa7d0u, 0xa612u, 0xa454u, 0xa596u, 0xa0d8u, 0xa11au, 0xa35cu, 0xa29eu,
+    0xb5e0u, 0xb422u, 0xb664u, 0xb7a6u, 0xb2e8u, 0xb32au, 0xb16cu, 0xb0aeu,
+    0xbbf0u, 0xba32u, 0xb874u, 0xb9b6u, 0xbcf8u, 0xbd3au, 0xbf7cu, 0xbebeu,
+};
+#else
+/*! reduction of the 4 bits shifted out of the GHASH state, in the top 16 bits */
+static const uint16_t s_gcmLast[16] = {0x0000u, 0x1c20u, 0x3840u, 0x2460u, 0x7080u, 0x6ca0u, 0x48c0u, 0x54e0u,
+                                       0xe100u, 0xfd20u, 0xd940u, 0xc560u, 0x9180u, 0x8da0u, 0xa9c0u, 0xb5e0u};
+#endif
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+static uint64_t aes_gcm_get_be64(const uint8_t *b)
+{
+    return ((uint64_t)b[0] << 56) | ((uint64_t)b[1] << 48) | ((uint64_t)b[2] << 40) | ((uint64_t)b[3] << 32) |
+           ((uint64_t)b[4] << 24) | ((uint64_t)b[5] << 16) | ((uint64_t)b[6] << 8) | (uint64_t)b[7];
+}
+
+static void aes_gcm_put_be64(uint8_t *b, uint64_t v)
+{
+    for (int i = 7; i >= 0; i--)
+    {
+        b[i] = (uint8_t)v;
+        v >>= 8;
+    }
+}
+
+/*!
+ * @brief Computes GHASH tables from the hash subkey.
+ *
+ * Entry with only the top bit of the index set is H, entries with one bit set are H shifted (multiplied by x)
+ * in GF(2^128), other entries are sums of those.
+ *
+ * @param gcm AES-GCM handle.
+ * @param h Hash subkey, E(K, 0^128).
+ */
+static void aes_gcm_gen_table(aes_gcm_handle_t *gcm, const uint8_t h[16])
+{
+    uint64_t vh = aes_gcm_get_be64(h);
+    uint64_t vl = aes_gcm_get_be64(h + 8);
+    uint32_t t;
+    uint32_t i, j;
+
+    gcm->hh[0] = 0;
+    gcm->hl[0] = 0;
+    gcm->hh[AES_GCM_TABLE_SIZE / 2] = vh;
+    gcm->hl[AES_GCM_TABLE_SIZE / 2] = vl;
+
+    for (i = AES_GCM_TABLE_SIZE / 4; i > 0; i >>= 1)
+    {
+        t = (uint32_t)(vl & 1u) * 0xe1000000u;
+        vl = (vh << 63) | (vl >> 1);
+        vh = (vh >> 1) ^ ((uint64_t)t << 32);
+        gcm->hh[i] = vh;
+        gcm->hl[i] = vl;
+    }
+
+    for (i = 2; i < AES_GCM_TABLE_SIZE; i <<= 1)
+    {
+        for (j = 1; j < i; j++)
+        {
+            gcm->hh[i + j] = gcm->hh[i] ^ gcm->hh[j];
+            gcm->hl[i + j] = gcm->hl[i] ^ gcm->hl[j];
+        }
+    }
+}
+
+/*!
+ * @brief Multiplies x by H in GF(2^128) using the handle tables.
+ *
+ * @param gcm AES-GCM handle.
+ * @param[in,out] x 16 byte operand, replaced by the product.
+ */
+static void aes_gcm_mult(const aes_gcm_handle_t *gcm, uint8_t x[16])
+{
+    uint64_t zh, zl;
+    uint32_t rem;
+
+#if AES_GCM_TABLE_BITS == 8
+    zh = gcm->hh[x[15]];
+    zl = gcm->hl[x[15]];
+
+    for (int i = 14; i >= 0; i--)
+    {
+        rem = (uint32_t)zl & 0xffu;
+        zl = (zh << 56) | (zl >> 8);
+        zh = (zh >> 8) ^ ((uint64_t)s_gcmLast[rem] << 48);
+        zh ^= gcm->hh[x[i]];
+        zl ^= gcm->hl[x[i]];
+    }
+#else
+    uint32_t lo, hi;
+
+    lo = x[15] & 0xfu;
+    zh = gcm->hh[lo];
+    zl = gcm->hl[lo];
+
+    for (int i = 15; i >= 0; i--)
+    {
+        lo = x[i] & 0xfu;
+        hi = (x[i] >> 4) & 0xfu;
+
+        if (i != 15)
+        {
+            rem = (uint32_t)zl & 0xfu;
+            zl = (zh << 60) | (zl >> 4);
+            zh = (zh >> 4) ^ ((uint64_t)s_gcmLast[rem] << 48);
+            zh ^= gcm->hh[lo];
+            zl ^= gcm->hl[lo];
+        }
+
+        rem = (uint32_t)zl & 0xfu;
+        zl = (zh << 60) | (zl >> 4);
+        zh = (zh >> 4) ^ ((uint64_t)s_gcmLast[rem] << 48);
+        zh ^= gcm->hh[hi];
+        zl ^= gcm->hl[hi];
+    }
+#endif
+
+    aes_gcm_put_be64(x, zh);
+    aes_gcm_put_be64(x + 8, zl);
+}
+
+void AES_GCM_Ghash(const aes_gcm_handle_t *gcm, uint8_t y[16], const uint8_t *data, size_t size)
+{
+    size_t n;
+
+    while (size)
+    {
+        n = (size < AES_GCM_BLOCK_SIZE) ? size : AES_GCM_BLOCK_SIZE;
+        for (size_t i = 0; i < n; i++)
+        {
+            y[i] ^= data[i];
+        }
+        aes_gcm_mult(gcm, y);
+        data += n;
+        size -= n;
+    }
+}
+
+status_t AES_GCM_SetKey(HASHCRYPT_Type *base, aes_gcm_handle_t *gcm, const uint8_t *key, size_t keySize)
+{
+    uint32_t h[AES_GCM_BLOCK_SIZE / sizeof(uint32_t)] = {0};
+    status_t status;
+
+    status = HASHCRYPT_AES_SetKey(base, &gcm->aes, key, keySize);
+    if (status != kStatus_Success)
+    {
+        return status;
+    }
+
+    /* hash subkey H = E(K, 0^128) */
+    status = HASHCRYPT_AES_EncryptEcb(base, &gcm->aes, (uint8_t *)h, (uint8_t *)h, sizeof(h));
+    if (status == kStatus_Success)
+    {
+        aes_gcm_gen_table(gcm, (uint8_t *)h);
+    }
+    memset(h, 0, sizeof(h));
+
+    gcm->ctrBusy = false;
+    gcm->ctrStatus = kStatus_Success;
+
+    return status;
+}
+
+/*!
+ * @brief Computes the pre-counter block J0 from the iv.
+ */
+static void aes_gcm_j0(const aes_gcm_handle_t *gcm, const uint8_t *iv, size_t ivSize, uint8_t j0[16])
+{
+    uint8_t lenBlk[AES_GCM_BLOCK_SIZE] = {0};
+
+    if (ivSize == AES_GCM_IV_SIZE)
+    {
+        memcpy(j0, iv, AES_GCM_IV_SIZE);
+        j0[12] = 0;
+        j0[13] = 0;
+        j0[14] = 0;
+        j0[15] = 1;
+    }
+    else
+    {
+        memset(j0, 0, AES_GCM_BLOCK_SIZE);
+        AES_GCM_Ghash(gcm, j0, iv, ivSize);
+        aes_gcm_put_be64(lenBlk + 8, (uint64_t)ivSize * 8u);
+        AES_GCM_Ghash(gcm, j0, lenBlk, sizeof(lenBlk));
+    }
+}
+
+static void aes_gcm_ctr_callback(HASHCRYPT_Type *base, hashcrypt_handle_t *handle, status_t status, void *userData)
+{
+    aes_gcm_handle_t *gcm = (aes_gcm_handle_t *)userData;
+
+    gcm->ctrStatus = status;
+    gcm->ctrBusy = false;
+}
+
+/*!
+ * @brief Runs GCM counter mode and GHASH over the cipher text.
+ *
+ * Counter mode runs on HASHCRYPT. In background mode the CPU computes GHASH while HASHCRYPT works:
+ * for encryption GHASH of the previous chunk output, for decryption GHASH of the current chunk input
+ * (or before the chunk is started if input and output overlap).
+ *
+ * @param base HASHCRYPT peripheral base address.
+ * @param gcm AES-GCM handle.
+ * @param j0 Pre-counter block.
+ * @param input Input data.
+ * @param[out] output Output data.
+ * @param size Size of data in bytes.
+ * @param[in,out] y GHASH state.
+ * @param decrypt True for decryption (GHASH over input), false for encryption (GHASH over output).
+ */
+static status_t aes_gcm_crypt(HASHCRYPT_Type *base,
+                              aes_gcm_handle_t *gcm,
+                              const uint8_t j0[16],
+                              const uint8_t *input,
+                              uint8_t *output,
+                              size_t size,
+                              uint8_t y[16],
+                              bool decrypt)
+{
+    uint32_t ctrWords[AES_GCM_BLOCK_SIZE / sizeof(uint32_t)];
+    uint8_t *ctr = (uint8_t *)ctrWords;
+    const uint8_t *pending = NULL;
+    size_t pendingSz = 0;
+    uint32_t ctr32;
+    uint64_t segMax;
+    size_t n;
+    status_t status = kStatus_Success;
+    bool background = (((uintptr_t)input & 0x3u) == 0) && (size > AES_GCM_CHUNK_SIZE);
+    bool overlap = (output < input + size) && (input < output + size);
+
+    memcpy(ctr, j0, AES_GCM_BLOCK_SIZE);
+    /* inc32(J0) */
+    ctr32 = (((uint32_t)ctr[12] << 24) | ((uint32_t)ctr[13] << 16) | ((uint32_t)ctr[14] << 8) | ctr[15]) + 1u;
+
+    if (background)
+    {
+        HASHCRYPT_AES_SetCallback(base, &gcm->aes, aes_gcm_ctr_callback, gcm);
+    }
+
+    while (size)
+    {
+        ctr[12] = (uint8_t)(ctr32 >> 24);
+        ctr[13] = (uint8_t)(ctr32 >> 16);
+        ctr[14] = (uint8_t)(ctr32 >> 8);
+        ctr[15] = (uint8_t)ctr32;
+
+        /* HASHCRYPT increments whole 128-bit counter, GCM only its low 32 bits, so do not run across the wrap */
+        segMax = ((uint64_t)0x100000000u - ctr32) * AES_GCM_BLOCK_SIZE;
+        n = background ? AES_GCM_CHUNK_SIZE : size;
+        if (n > size)
+        {
+            n = size;
+        }
+        if (n > segMax)
+        {
+            n = (size_t)segMax;
+        }
+
+        if (decrypt && (!background || overlap))
+        {
+            AES_GCM_Ghash(gcm, y, input, n);
+        }
+
+        if (background)
+        {
+            gcm->ctrBusy = true;
+            status = HASHCRYPT_AES_CryptCtrNonBlocking(base, &gcm->aes, input, output, n, ctr, NULL, NULL);
+            if (status != kStatus_Success)
+            {
+                gcm->ctrBusy = false;
+                break;
+            }
+
+            /* GHASH overlapped with HASHCRYPT CTR run */
+            if (decrypt && !overlap)
+            {
+                AES_GCM_Ghash(gcm, y, input, n);
+            }
+            else if (pendingSz)
+            {
+                AES_GCM_Ghash(gcm, y, pending, pendingSz);
+            }
+
+            while (gcm->ctrBusy)
+            {
+            }
+            status = gcm->ctrStatus;
+        }
+        else
+        {
+            status = HASHCRYPT_AES_CryptCtr(base, &gcm->aes, input, output, n, ctr, NULL, NULL);
+        }
+        if (status != kStatus_Success)
+        {
+            break;
+        }
+
+        if (!decrypt)
+        {
+            if (background)
+            {
+                pending = output;
+                pendingSz = n;
+            }
+            else
+            {
+                AES_GCM_Ghash(gcm, y, output, n);
+            }
+        }
+
+        ctr32 += (uint32_t)(n / AES_GCM_BLOCK_SIZE);
+        input += n;
+        output += n;
+        size -= n;
+    }
+
+    if ((status == kStatus_Success) && pendingSz)
+    {
+        AES_GCM_Ghash(gcm, y, pending, pendingSz);
+    }
+
+    memset(ctrWords, 0, sizeof(ctrWords));
+
+    return status;
+}
+
+/*!
+ * @brief Computes the GCM tag from GHASH state, lengths and J0.
+ */
+static status_t aes_gcm_tag(HASHCRYPT_Type *base,
+                            aes_gcm_handle_t *gcm,
+                            const uint8_t j0[16],
+                            uint8_t y[16],
+                            size_t aadSize,
+                            size_t size,
+                            uint8_t tag[16])
+{
+    uint32_t ekj0[AES_GCM_BLOCK_SIZE / sizeof(uint32_t)];
+    uint8_t lenBlk[AES_GCM_BLOCK_SIZE];
+    status_t status;
+
+    aes_gcm_put_be64(lenBlk, (uint64_t)aadSize * 8u);
+    aes_gcm_put_be64(lenBlk + 8, (uint64_t)size * 8u);
+    AES_GCM_Ghash(gcm, y, lenBlk, sizeof(lenBlk));
+
+    memcpy(ekj0, j0, AES_GCM_BLOCK_SIZE);
+    status = HASHCRYPT_AES_EncryptEcb(base, &gcm->aes, (uint8_t *)ekj0, (uint8_t *)ekj0, AES_GCM_BLOCK_SIZE);
+    for (int i = 0; i < AES_GCM_BLOCK_SIZE; i++)
+    {
+        tag[i] = y[i] ^ ((uint8_t *)ekj0)[i];
+    }
+    memset(ekj0, 0, sizeof(ekj0));
+
+    return status;
+}
+
+status_t AES_GCM_Encrypt(HASHCRYPT_Type *base,
+                         aes_gcm_handle_t *gcm,
+                         const uint8_t *iv,
+                         size_t ivSize,
+                         const uint8_t *aad,
+                         size_t aadSize,
+                         const uint8_t *plaintext,
+                         uint8_t *ciphertext,
+                         size_t size,
+                         uint8_t *tag,
+                         size_t tagSize)
+{
+    uint8_t j0[AES_GCM_BLOCK_SIZE];
+    uint8_t y[AES_GCM_BLOCK_SIZE] = {0};
+    uint8_t fullTag[AES_GCM_TAG_SIZE];
+    status_t status;
+
+    if ((ivSize == 0) || (tagSize < 4) || (tagSize > AES_GCM_TAG_SIZE))
+    {
+        return kStatus_InvalidArgument;
+    }
+
+    aes_gcm_j0(gcm, iv, ivSize, j0);
+    AES_GCM_Ghash(gcm, y, aad, aadSize);
+
+    status = aes_gcm_crypt(base, gcm, j0, plaintext, ciphertext, size, y, false);
+    if (status == kStatus_Success)
+    {
+        status = aes_gcm_tag(base, gcm, j0, y, aadSize, size, fullTag);
+        memcpy(tag, fullTag, tagSize);
+    }
+
+    return status;
+}
+
+status_t AES_GCM_Decrypt(HASHCRYPT_Type *base,
+                         aes_gcm_handle_t *gcm,
+                         const uint8_t *iv,
+                         size_t ivSize,
+                         const uint8_t *aad,
+                         size_t aadSize,
+                         const uint8_t *ciphertext,
+                         uint8_t *plaintext,
+                         size_t size,
+                         const uint8_t *tag,
+                         size_t tagSize)
+{
+    uint8_t j0[AES_GCM_BLOCK_SIZE];
+    uint8_t y[AES_GCM_BLOCK_SIZE] = {0};
+    uint8_t fullTag[AES_GCM_TAG_SIZE];
+    uint8_t diff = 0;
+    status_t status;
+
+    if ((ivSize == 0) || (tagSize < 4) || (tagSize > AES_GCM_TAG_SIZE))
+    {
+        return kStatus_InvalidArgument;
+    }
+
+    aes_gcm_j0(gcm, iv, ivSize, j0);
+    AES_GCM_Ghash(gcm, y, aad, aadSize);
+
+    status = aes_gcm_crypt(base, gcm, j0, ciphertext, plaintext, size, y, true);
+    if (status == kStatus_Success)
+    {
+        status = aes_gcm_tag(base, gcm, j0, y, aadSize, size, fullTag);
+    }
+    if (status == kStatus_Success)
+    {
+        /* constant time compare */
+        for (size_t i = 0; i < tagSize; i++)
+        {
+            diff |= fullTag[i] ^ tag[i];
+        }
+        if (diff)
+        {
+            status = kStatus_Fail;
+        }
+    }
+    if (status != kStatus_Success)
+    {
+        memset(plaintext, 0, size);
+    }
+
+    return status;
+}
@@ -0,0 +1,138 @@
+/*
+ * Copyright 2026 asvin.io
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _AES_GCM_H_
+#define _AES_GCM_H_
+
+#include "fsl_common.h"
+#include "fsl_hashcrypt.h"
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+
+/*! @brief GHASH table width in bits, 4 (256 bytes per key) or 8 (4 KB per key). */
+#ifndef AES_GCM_TABLE_BITS
+#define AES_GCM_TABLE_BITS 4
+#endif
+
+/*! @brief Number of bytes processed by one HASHCRYPT CTR run while the CPU computes GHASH of the previous one. */
+#ifndef AES_GCM_CHUNK_SIZE
+#define AES_GCM_CHUNK_SIZE 256
+#endif
+
+#define AES_GCM_TABLE_SIZE (1u << AES_GCM_TABLE_BITS)
+#define AES_GCM_TAG_SIZE 16
+
+/*! @brief AES-GCM handle with the key and the precomputed GHASH tables. */
+typedef struct _aes_gcm_handle
+{
+    hashcrypt_handle_t aes;           /*!< HASHCRYPT key. keyType shall be set before AES_GCM_SetKey(). */
+    uint64_t hl[AES_GCM_TABLE_SIZE];  /*!< Low halves of multiples of the hash subkey H */
+    uint64_t hh[AES_GCM_TABLE_SIZE];  /*!< High halves of multiples of the hash subkey H */
+    volatile bool ctrBusy;            /*!< True while HASHCRYPT runs a background CTR chunk */
+    volatile status_t ctrStatus;      /*!< Status of the last background CTR chunk */
+} aes_gcm_handle_t;
+
+/*******************************************************************************
+ * API
+ ******************************************************************************/
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/*!
+ * @brief Sets AES-GCM key.
+ *
+ * Sets the key of the embedded HASHCRYPT handle, computes the hash subkey H and the GHASH tables.
+ * The key type (user or secret PUF key) is taken from gcm->aes.keyType.
+ *
+ * @param base HASHCRYPT peripheral base address.
+ * @param[in,out] gcm AES-GCM handle.
+ * @param key 0-mod-4 aligned pointer to AES key. Not used for kHASHCRYPT_SecretKey.
+ * @param keySize AES key size in bytes. Shall equal 16, 24 or 32.
+ * @return Status from set key operation.
+ */
+status_t AES_GCM_SetKey(HASHCRYPT_Type *base, aes_gcm_handle_t *gcm, const uint8_t *key, size_t keySize);
+
+/*!
+ * @brief Encrypts and authenticates data using AES-GCM.
+ *
+ * Key stream is computed by HASHCRYPT in CTR mode. For word aligned input longer than AES_GCM_CHUNK_SIZE,
+ * CTR runs in background chunk by chunk and GHASH of one chunk is computed while HASHCRYPT processes the next.
+ *
+ * @param base HASHCRYPT peripheral base address.
+ * @param gcm AES-GCM handle.
+ * @param iv Initialization vector.
+ * @param ivSize Size of iv in bytes. 12 is recommended.
+ * @param aad Additional authenticated data. Can be NULL if aadSize is 0.
+ * @param aadSize Size of additional authenticated data in bytes.
+ * @param plaintext Input plain text.
+ * @param[out] ciphertext Output cipher text. Can be the same as plaintext.
+ * @param size Size of plain text and cipher text in bytes.
+ * @param[out] tag Output authentication tag.
+ * @param tagSize Size of tag in bytes, 4 to 16.
+ * @return kStatus_Success, kStatus_InvalidArgument or status from HASHCRYPT.
+ */
+status_t AES_GCM_Encrypt(HASHCRYPT_Type *base,
+                         aes_gcm_handle_t *gcm,
+                         const uint8_t *iv,
+                         size_t ivSize,
+                         const uint8_t *aad,
+                         size_t aadSize,
+                         const uint8_t *plaintext,
+                         uint8_t *ciphertext,
+                         size_t size,
+                         uint8_t *tag,
+                         size_t tagSize);
+
+/*!
+ * @brief Decrypts and verifies data using AES-GCM.
+ *
+ * @param base HASHCRYPT peripheral base address.
+ * @param gcm AES-GCM handle.
+ * @param iv Initialization vector.
+ * @param ivSize Size of iv in bytes.
+ * @param aad Additional authenticated data. Can be NULL if aadSize is 0.
+ * @param aadSize Size of additional authenticated data in bytes.
+ * @param ciphertext Input cipher text.
+ * @param[out] plaintext Output plain text, cleared if the tag does not match. Can be the same as ciphertext.
+ * @param size Size of cipher text and plain text in bytes.
+ * @param tag Expected authentication tag.
+ * @param tagSize Size of tag in bytes, 4 to 16.
+ * @return kStatus_Success, kStatus_Fail if the tag does not match, kStatus_InvalidArgument or status from HASHCRYPT.
+ */
+status_t AES_GCM_Decrypt(HASHCRYPT_Type *base,
+                         aes_gcm_handle_t *gcm,
+                         const uint8_t *iv,
+                         size_t ivSize,
+                         const uint8_t *aad,
+                         size_t aadSize,
+                         const uint8_t *ciphertext,
+                         uint8_t *plaintext,
+                         size_t size,
+                         const uint8_t *tag,
+                         size_t tagSize);
+
+/*!
+ * @brief Updates GHASH state with data.
+ *
+ * Multiplies in GF(2^128) by H using the handle tables. Incomplete last block is padded with zeros.
+ *
+ * @param gcm AES-GCM handle.
+ * @param[in,out] y GHASH state.
+ * @param data Input data.
+ * @param size Size of input data in bytes.
+ */
+void AES_GCM_Ghash(const aes_gcm_handle_t *gcm, uint8_t y[16], const uint8_t *data, size_t size);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* _AES_GCM_H_ */
@@ -0,0 +1,1615 @@
+/*
+ * Copyright 2026 asvin.io
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <string.h>
+#include "fsl_device_registers.h"
+#include "fsl_debug_console.h"
+#include "fsl_clock.h"
+#include "fsl_hashcrypt.h"
+#include "fsl_puf.h"
+#include "aes_gcm.h"
+#include "aes_ccm.h"
+#include "aes_etm.h"
+#include "kdf.h"
+#include "flash_merkle.h"
+#include "drbg.h"
+#include "keystore.h"
+#include "crypto_bench.h"
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+#define BENCH_CORE_CLK_FREQ CLOCK_GetFreq(kCLOCK_CoreSysClk)
+
+/* number of records processed by one measurement */
+#define BENCH_RECORDS 64
+/* largest record size in bytes */
+#define BENCH_RECORD_MAX 64
+#define BENCH_BUF_SIZE (BENCH_RECORDS * BENCH_RECORD_MAX)
+/* message size used for throughput measurements */
+#define BENCH_BULK_SIZE 2048
+/* number of repetitions of one throughput measurement */
+#define BENCH_BULK_LOOPS 8
+/* records per AES-CCM measurement and their tag size */
+#define BENCH_CCM_RECORDS 16
+#define BENCH_CCM_TAG_SIZE 8
+/* message sizes of the concurrent hashes: firmware image, flash scrub and attestation transcript */
+#define BENCH_SHA_IMAGE_SIZE (16u * 1024u)
+#define BENCH_SHA_SCRUB_SIZE (8u * 1024u)
+#define BENCH_SHA_TRANSCRIPT_SIZE 1024u
+#define BENCH_SHA_STREAMS 3
+/* message hashed as a chain of segments */
+#define BENCH_SHA_CHAIN_SIZE 4000u
+/* HMAC-SHA256 messages, short as in authenticated command frames */
+#define BENCH_HMAC_MSG_SIZE 32u
+/* subkeys derived from one root key */
+#define BENCH_KDF_SUBKEYS 16
+/* pages of the firmware image covered by the Merkle tree bench */
+#define BENCH_MERKLE_PAGES FLASH_MERKLE_MAX_PAGES
+/* DRBG requests per measurement, sized so that masks and IVs together fit the pool */
+#define BENCH_DRBG_MASKS 16u
+#define BENCH_DRBG_IVS 8u
+/* key size of the keys generated by the PUF batch benchmark */
+#define BENCH_PUF_KEY_SIZE 16u
+/* AES operations with the secret key timed by the key slot benchmark */
+#define BENCH_HWKEY_OPS 8u
+/* number of labeled keys requested from the key store, more than it keeps in RAM */
+#define BENCH_KEYSTORE_KEYS 24u
+/* keys requested again after the first pass, they all fit the RAM table */
+#define BENCH_KEYSTORE_HOT (KEYSTORE_CACHE_ENTRIES / 2u)
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+static uint32_t s_benchIn[BENCH_BUF_SIZE / sizeof(uint32_t)];
+static uint32_t s_benchOut[BENCH_BUF_SIZE / sizeof(uint32_t)];
+static uint32_t s_benchRef[BENCH_BUF_SIZE / sizeof(uint32_t)];
+static hashcrypt_aes_job_t s_benchJobs[BENCH_RECORDS];
+
+static const uint32_t s_benchKey[4] = {0x16157e2bu, 0xa6d2ae28u, 0x8815f7abu, 0x3c4fcf09u};
+static uint8_t s_benchIv[HASHCRYPT_AES_BLOCK_SIZE] = {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+                                                      0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f};
+
+/* AES-GCM test vectors, test cases 2 to 4 of the GCM specification (NIST SP 800-38D validation set) */
+static const uint8_t s_gcmTc2Ct[16] = {0x03, 0x88, 0xda, 0xce, 0x60, 0xb6, 0xa3, 0x92,
+                                       0xf3, 0x28, 0xc2, 0xb9, 0x71, 0xb2, 0xfe, 0x78};
+static const uint8_t s_gcmTc2Tag[16] = {0xab, 0x6e, 0x47, 0xd4, 0x2c, 0xec, 0x13, 0xbd,
+                                        0xf5, 0x3a, 0x67, 0xb2, 0x12, 0x57, 0xbd, 0xdf};
+static const uint32_t s_gcmTc3Key[4] = {0x92e9fffeu, 0x1c736586u, 0x948f6a6du, 0x08833067u};
+static const uint8_t s_gcmTc3Iv[12] = {0xca, 0xfe, 0xba, 0xbe, 0xfa, 0xce, 0xdb, 0xad, 0xde, 0xca, 0xf8, 0x88};
+static const uint8_t s_gcmTc3Pt[64] = {
+    0xd9, 0x31, 0x32, 0x25, 0xf8, 0x84, 0x06, 0xe5, 0xa5, 0x59, 0x09, 0xc5,
+    0xaf, 0xf5, 0x26, 0x9a, 0x86, 0xa7, 0xa9, 0x53, 0x15, 0x34, 0xf7, 0xda,
+    0x2e, 0x4c, 0x30, 0x3d, 0x8a, 0x31, 0x8a, 0x72, 0x1c, 0x3c, 0x0c, 0x95,
+    0x95, 0x68, 0x09, 0x53, 0x2f, 0xcf, 0x0e, 0x24, 0x49, 0xa6, 0xb5, 0x25,
+    0xb1, 0x6a, 0xed, 0xf5, 0xaa, 0x0d, 0xe6, 0x57, 0xba, 0x63, 0x7b, 0x39,
+    0x1a, 0xaf, 0xd2, 0x55,
+};
+static const uint8_t s_gcmTc3Ct[64] = {
+    0x42, 0x83, 0x1e, 0xc2, 0x21, 0x77, 0x74, 0x24, 0x4b, 0x72, 0x21, 0xb7,
+    0x84, 0xd0, 0xd4, 0x9c, 0xe3, 0xaa, 0x21, 0x2f, 0x2c, 0x02, 0xa4, 0xe0,
+    0x35, 0xc1, 0x7e, 0x23, 0x29, 0xac, 0xa1, 0x2e, 0x21, 0xd5, 0x14, 0xb2,
+    0x54, 0x66, 0x93, 0x1c, 0x7d, 0x8f, 0x6a, 0x5a, 0xac, 0x84, 0xaa, 0x05,
+    0x1b, 0xa3, 0x0b, 0x39, 0x6a, 0x0a, 0xac, 0x97, 0x3d, 0x58, 0xe0, 0x91,
+    0x47, 0x3f, 0x59, 0x85,
+};
+static const uint8_t s_gcmTc3Tag[16] = {0x4d, 0x5c, 0x2a, 0xf3, 0x27, 0xcd, 0x64, 0xa6,
+                                        0x2c, 0xf3, 0x5a, 0xbd, 0x2b, 0xa6, 0xfa, 0xb4};
+static const uint8_t s_gcmTc4Aad[20] = {0xfe, 0xed, 0xfa, 0xce, 0xde, 0xad, 0xbe, 0xef, 0xfe, 0xed,
+                                        0xfa, 0xce, 0xde, 0xad, 0xbe, 0xef, 0xab, 0xad, 0xda, 0xd2};
+static const uint8_t s_gcmTc4Tag[16] = {0x5b, 0xc9, 0x4f, 0xbc, 0x32, 0x21, 0xa5, 0xdb,
+                                        0x94, 0xfa, 0xe9, 0x5a, 0xe7, 0x12, 0x1a, 0x47};
+/* AES-CMAC test vectors, RFC 4493 section 4, key is s_benchKey */
+static const uint8_t s_cmacMsg[64] = {
+    0x6b, 0xc1, 0xbe, 0xe2, 0x2e, 0x40, 0x9f, 0x96, 0xe9, 0x3d, 0x7e, 0x11,
+    0x73, 0x93, 0x17, 0x2a, 0xae, 0x2d, 0x8a, 0x57, 0x1e, 0x03, 0xac, 0x9c,
+    0x9e, 0xb7, 0x6f, 0xac, 0x45, 0xaf, 0x8e, 0x51, 0x30, 0xc8, 0x1c, 0x46,
+    0xa3, 0x5c, 0xe4, 0x11, 0xe5, 0xfb, 0xc1, 0x19, 0x1a, 0x0a, 0x52, 0xef,
+    0xf6, 0x9f, 0x24, 0x45, 0xdf, 0x4f, 0x9b, 0x17, 0xad, 0x2b, 0x41, 0x7b,
+    0xe6, 0x6c, 0x37, 0x10,
+};
+static const uint32_t s_cmacLen[4] = {0, 16, 40, 64};
+static const uint8_t s_cmacTag[4][16] = {
+    {0xbb, 0x1d, 0x69, 0x29, 0xe9, 0x59, 0x37, 0x28, 0x7f, 0xa3, 0x7d, 0x12, 0x9b, 0x75, 0x67, 0x46},
+    {0x07, 0x0a, 0x16, 0xb4, 0x6b, 0x4d, 0x41, 0x44, 0xf7, 0x9b, 0xdd, 0x9d, 0xd0, 0x4a, 0x28, 0x7c},
+    {0xdf, 0xa6, 0x67, 0x47, 0xde, 0x9a, 0xe6, 0x30, 0x30, 0xca, 0x32, 0x61, 0x14, 0x97, 0xc8, 0x27},
+    {0x51, 0xf0, 0xbe, 0xbf, 0x7e, 0x3b, 0x9d, 0x92, 0xfc, 0x49, 0x74, 0x17, 0x79, 0x36, 0x3c, 0xfe},
+};
+/* AES-CCM test vectors, SP 800-38C appendix C examples 1 to 3, key 40..4f, nonce 10.., aad 00.., payload 20.. */
+static const uint32_t s_ccmKey[4] = {0x43424140u, 0x47464544u, 0x4b4a4948u, 0x4f4e4d4cu};
+static const uint32_t s_ccmNonceLen[3] = {7, 8, 12};
+static const uint32_t s_ccmAadLen[3] = {8, 16, 20};
+static const uint32_t s_ccmLen[3] = {4, 16, 24};
+static const uint32_t s_ccmTagLen[3] = {4, 6, 8};
+static const uint8_t s_ccmCt[3][32] = {
+    {0x71, 0x62, 0x01, 0x5b, 0x4d, 0xac, 0x25, 0x5d},
+    {0xd2, 0xa1, 0xf0, 0xe0, 0x51, 0xea, 0x5f, 0x62, 0x08, 0x1a, 0x77,
+     0x92, 0x07, 0x3d, 0x59, 0x3d, 0x1f, 0xc6, 0x4f, 0xbf, 0xac, 0xcd},
+    {0xe3, 0xb2, 0x01, 0xa9, 0xf5, 0xb7, 0x1a, 0x7a, 0x9b, 0x1c, 0xea, 0xec, 0xcd, 0x97, 0xe7, 0x0b,
+     0x61, 0x76, 0xaa, 0xd9, 0xa4, 0x42, 0x8a, 0xa5, 0x48, 0x43, 0x92, 0xfb, 0xc1, 0xb0, 0x99, 0x51},
+};
+
+/* start of the firmware image */
+extern void (*const g_pfnVectors[])(void);
+
+static aes_gcm_handle_t s_benchGcm;
+static aes_ccm_record_t s_benchCcm[BENCH_CCM_RECORDS];
+static uint8_t s_benchCcmTag[2][BENCH_CCM_RECORDS][BENCH_CCM_TAG_SIZE];
+static hashcrypt_hash_ctx_t s_benchShaCtx[BENCH_SHA_STREAMS];
+static volatile uint32_t s_benchShaDone[BENCH_SHA_STREAMS];
+static volatile status_t s_benchShaStatus[BENCH_SHA_STREAMS];
+static hashcrypt_hmac_key_t s_benchHmacKey;
+static hashcrypt_hmac_ctx_t s_benchHmacCtx;
+static kdf_subkey_t s_benchKdf[BENCH_KDF_SUBKEYS];
+static uint8_t s_benchKdfLabel[BENCH_KDF_SUBKEYS][8];
+static flash_config_t s_benchFlash;
+static flash_merkle_t s_benchMerkle;
+static sha_soft_ctx_t s_benchShaSoft;
+static puf_handle_t s_benchPuf;
+static puf_get_key_job_t s_benchPufGet[kPUF_KeyIndexMax];
+static puf_set_key_job_t s_benchPufSet[kPUF_KeyIndexMax];
+static keystore_t s_benchKeystore;
+static volatile status_t s_benchPufStatus;
+static volatile bool s_benchPufDone;
+static uint32_t s_benchProgressCalls;
+static uint32_t s_benchYieldCalls;
+static drbg_t s_benchDrbg;
+
+/* FIPS 180-4 SHA-512 "abc" */
+static const uint8_t s_benchSha512Abc[64] = {
+    0xdd, 0xaf, 0x35, 0xa1, 0x93, 0x61, 0x7a, 0xba, 0xcc, 0x41, 0x73, 0x49, 0xae, 0x20, 0x41, 0x31,
+    0x12, 0xe6, 0xfa, 0x4e, 0x89, 0xa9, 0x7e, 0xa2, 0x0a, 0x9e, 0xee, 0xe6, 0x4b, 0x55, 0xd3, 0x9a,
+    0x21, 0x92, 0x99, 0x2a, 0x27, 0x4f, 0xc1, 0xa8, 0x36, 0xba, 0x3c, 0x23, 0xa3, 0xfe, 0xeb, 0xbd,
+    0x45, 0x4d, 0x44, 0x23, 0x64, 0x3c, 0xe8, 0x0e, 0x2a, 0x9a, 0xc9, 0x4f, 0xa5, 0x4c, 0xa4, 0x9f};
+
+/* RFC 5869 test case 1 */
+static const uint8_t s_benchHkdfSalt[13] = {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06,
+                                            0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c};
+static const uint8_t s_benchHkdfInfo[10] = {0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8, 0xf9};
+/* T(1) of RFC 5869 test case 1, HMAC(PRK, info || 0x01) */
+static const uint8_t s_benchHkdfOkm[32] = {0x3c, 0xb2, 0x5f, 0x25, 0xfa, 0xac, 0xd5, 0x7a, 0x90, 0x43, 0x4f,
+                                           0x64, 0xd0, 0x36, 0x2f, 0x2a, 0x2d, 0x2d, 0x0a, 0x90, 0xcf, 0x1a,
+                                           0x5a, 0x4c, 0x5d, 0xb0, 0x2d, 0x56, 0xec, 0xc4, 0xc5, 0xbf};
+
+/* KDF_Derive() of 42 bytes in HKDF mode, RFC 5869 test case 1 inputs with the info as label */
+static const uint8_t s_benchKdfOkm[42] = {0xbd, 0x6b, 0x21, 0x5c, 0xf7, 0x6f, 0x43, 0xe8, 0x37, 0x88, 0xd4,
+                                         0x3d, 0xb2, 0x5d, 0xd9, 0xca, 0x81, 0x94, 0xaa, 0xb5, 0xb1, 0xfa,
+                                         0x93, 0x47, 0x2c, 0x17, 0xc2, 0x83, 0xd9, 0x29, 0xb2, 0x24, 0x26,
+                                         0xbf, 0x6d, 0x5e, 0xd1, 0x53, 0xf3, 0x5b, 0x99, 0xd5};
+
+/* RFC 4231 test cases 1, 2 and 6 */
+static const uint8_t s_benchHmacKey1[20] = {0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b,
+                                            0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b};
+static const uint8_t s_benchHmacMac1[32] = {0xb0, 0x34, 0x4c, 0x61, 0xd8, 0xdb, 0x38, 0x53, 0x5c, 0xa8, 0xaf,
+                                            0xce, 0xaf, 0x0b, 0xf1, 0x2b, 0x88, 0x1d, 0xc2, 0x00, 0xc9, 0x83,
+                                            0x3d, 0xa7, 0x26, 0xe9, 0x37, 0x6c, 0x2e, 0x32, 0xcf, 0xf7};
+static const uint8_t s_benchHmacMac2[32] = {0x5b, 0xdc, 0xc1, 0x46, 0xbf, 0x60, 0x75, 0x4e, 0x6a, 0x04, 0x24,
+                                            0x26, 0x08, 0x95, 0x75, 0xc7, 0x5a, 0x00, 0x3f, 0x08, 0x9d, 0x27,
+                                            0x39, 0x83, 0x9d, 0xec, 0x58, 0xb9, 0x64, 0xec, 0x38, 0x43};
+static const uint8_t s_benchHmacMac6[32] = {0x60, 0xe4, 0x31, 0x59, 0x1e, 0xe0, 0xb6, 0x7f, 0x0d, 0x8a, 0x26,
+                                            0xaa, 0xcb, 0xf5, 0xb7, 0x7f, 0x8e, 0x0b, 0xc6, 0x21, 0x37, 0x28,
+                                            0xc5, 0x14, 0x05, 0x46, 0x04, 0x0f, 0x0e, 0xe3, 0x7f, 0x54};
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+static void BenchTimerStart(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+static uint32_t BenchTimerStop(void)
+{
+    return DWT->CYCCNT;
+}
+
+static void BenchFill(uint8_t *buf, uint32_t len)
+{
+    uint32_t i;
+    for (i = 0; i < len; i++)
+    {
+        buf[i] = (uint8_t)(i * 7u + 3u);
+    }
+}
+
+static void BenchPrint(const char *name, uint32_t cycles, uint32_t records, uint32_t bytes)
+{
+    uint32_t kbps = 0;
+
+    if (cycles)
+    {
+        kbps = (uint32_t)(((uint64_t)bytes * BENCH_CORE_CLK_FREQ) / cycles / 1024u);
+    }
+    PRINTF("  %-22s %8d cycles/call   %6d KB/s\r\n", name, cycles / records, kbps);
+}
+
+void BenchAesBatch(void)
+{
+    static const uint32_t sizes[] = {16, 32, 64};
+    static const hashcrypt_aes_mode_t modes[] = {kHASHCRYPT_AesEcb, kHASHCRYPT_AesCbc};
+    hashcrypt_handle_t handle;
+    uint32_t cycles, i, s, m;
+    status_t status;
+
+    HASHCRYPT_Init(HASHCRYPT);
+    handle.keyType = kHASHCRYPT_UserKey;
+    HASHCRYPT_AES_SetKey(HASHCRYPT, &handle, (const uint8_t *)s_benchKey, sizeof(s_benchKey));
+    BenchFill((uint8_t *)s_benchIn, BENCH_BUF_SIZE);
+
+    PRINTF("\r\nAES-128 encryption of %d records, per-call vs. HASHCRYPT_AES_ProcessBatch()\r\n", BENCH_RECORDS);
+    for (m = 0; m < sizeof(modes) / sizeof(modes[0]); m++)
+    {
+        for (s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+        {
+            uint32_t sz = sizes[s];
+            uint8_t *in = (uint8_t *)s_benchIn;
+            uint8_t *ref = (uint8_t *)s_benchRef;
+            uint8_t *out = (uint8_t *)s_benchOut;
+
+            PRINTF("%s, %d byte records\r\n", modes[m] == kHASHCRYPT_AesEcb ? "ECB" : "CBC", sz);
+
+            BenchTimerStart();
+            for (i = 0; i < BENCH_RECORDS; i++)
+            {
+                if (modes[m] == kHASHCRYPT_AesEcb)
+                {
+                    HASHCRYPT_AES_EncryptEcb(HASHCRYPT, &handle, in + i * sz, ref + i * sz, sz);
+                }
+                else
+                {
+                    HASHCRYPT_AES_EncryptCbc(HASHCRYPT, &handle, in + i * sz, ref + i * sz, sz, s_benchIv);
+                }
+            }
+            cycles = BenchTimerStop();
+            BenchPrint("per-call", cycles, BENCH_RECORDS, BENCH_RECORDS * sz);
+
+            for (i = 0; i < BENCH_RECORDS; i++)
+            {
+                s_benchJobs[i].mode = modes[m];
+                s_benchJobs[i].direction = AES_ENCRYPT;
+                s_benchJobs[i].handle = &handle;
+                s_benchJobs[i].iv = s_benchIv;
+                s_benchJobs[i].input = in + i * sz;
+                s_benchJobs[i].output = out + i * sz;
+                s_benchJobs[i].size = sz;
+            }
+
+            BenchTimerStart();
+            status = HASHCRYPT_AES_ProcessBatch(HASHCRYPT, s_benchJobs, BENCH_RECORDS);
+            cycles = BenchTimerStop();
+            BenchPrint("batch", cycles, BENCH_RECORDS, BENCH_RECORDS * sz);
+
+            if ((status != kStatus_Success) || memcmp(ref, out, BENCH_RECORDS * sz))
+            {
+                PRINTF("  !!! batch output differs from per-call output\r\n");
+            }
+        }
+    }
+}
+
+void BenchAesUnaligned(void)
+{
+    static const uint32_t offsets[] = {0, 1, 2};
+    static const char *names[] = {"aligned", "offset +1", "offset +2"};
+    hashcrypt_handle_t handle;
+    uint32_t cycles, i, o;
+    uint8_t *in;
+    uint8_t *out;
+
+    HASHCRYPT_Init(HASHCRYPT);
+    handle.keyType = kHASHCRYPT_UserKey;
+    HASHCRYPT_AES_SetKey(HASHCRYPT, &handle, (const uint8_t *)s_benchKey, sizeof(s_benchKey));
+    BenchFill((uint8_t *)s_benchIn, BENCH_BUF_SIZE);
+
+    PRINTF("\r\nAES-128 CBC encryption of %d byte messages, staging buffer %d bytes\r\n", BENCH_BULK_SIZE,
+           HASHCRYPT_AES_STAGING_SIZE);
+    for (o = 0; o < sizeof(offsets) / sizeof(offsets[0]); o++)
+    {
+        in = (uint8_t *)s_benchIn + offsets[o];
+        out = (uint8_t *)s_benchOut + offsets[o];
+
+        /* reference computed in place in an aligned buffer */
+        memcpy(s_benchRef, in, BENCH_BULK_SIZE);
+        HASHCRYPT_AES_EncryptCbc(HASHCRYPT, &handle, (uint8_t *)s_benchRef, (uint8_t *)s_benchRef, BENCH_BULK_SIZE,
+                                 s_benchIv);
+
+        BenchTimerStart();
+        for (i = 0; i < BENCH_BULK_LOOPS; i++)
+        {
+            HASHCRYPT_AES_EncryptCbc(HASHCRYPT, &handle, in, out, BENCH_BULK_SIZE, s_benchIv);
+        }
+        cycles = BenchTimerStop();
+
+        BenchPrint(names[o], cycles, BENCH_BULK_LOOPS, BENCH_BULK_LOOPS * BENCH_BULK_SIZE);
+
+        if (memcmp(out, s_benchRef, BENCH_BULK_SIZE))
+        {
+            PRINTF("  !!! output differs from reference\r\n");
+        }
+    }
+}
+
+/*!
+ * @brief Reference GHASH multiplication, one bit at a time (NIST SP 800-38D, algorithm 1).
+ */
+static void BenchGhashBitwise(uint8_t y[16], const uint8_t h[16])
+{
+    uint8_t z[16] = {0};
+    uint8_t v[16];
+    uint32_t i, j, lsb;
+
+    memcpy(v, h, sizeof(v));
+    for (i = 0; i < 128; i++)
+    {
+        if (y[i / 8] & (0x80u >> (i % 8)))
+        {
+            for (j = 0; j < 16; j++)
+            {
+                z[j] ^= v[j];
+            }
+        }
+        lsb = v[15] & 1u;
+        for (j = 15; j > 0; j--)
+        {
+            v[j] = (uint8_t)((v[j] >> 1) | (v[j - 1] << 7));
+        }
+        v[0] >>= 1;
+        if (lsb)
+        {
+            v[0] ^= 0xe1u;
+        }
+    }
+    memcpy(y, z, sizeof(z));
+}
+
+static bool BenchGcmVector(const char *name,
+                           const uint8_t *iv,
+                           const uint8_t *aad,
+                           size_t aadSize,
+                           const uint8_t *pt,
+                           const uint8_t *ct,
+                           size_t size,
+                           const uint8_t *tag)
+{
+    uint8_t *out = (uint8_t *)s_benchOut;
+    uint8_t outTag[AES_GCM_TAG_SIZE];
+    bool pass;
+
+    pass = (AES_GCM_Encrypt(HASHCRYPT, &s_benchGcm, iv, 12, aad, aadSize, pt, out, size, outTag, sizeof(outTag)) ==
+            kStatus_Success) &&
+           !memcmp(out, ct, size) && !memcmp(outTag, tag, sizeof(outTag));
+    pass = pass && (AES_GCM_Decrypt(HASHCRYPT, &s_benchGcm, iv, 12, aad, aadSize, ct, out, size, tag,
+                                    AES_GCM_TAG_SIZE) == kStatus_Success) &&
+           !memcmp(out, pt, size);
+
+    PRINTF("  %-22s %s\r\n", name, pass ? "PASS" : "FAIL");
+    return pass;
+}
+
+void BenchAesGcm(void)
+{
+    uint32_t zero[4] = {0};
+    uint32_t h[4] = {0};
+    uint8_t y[16] = {0};
+    uint8_t tag[AES_GCM_TAG_SIZE];
+    uint8_t *in = (uint8_t *)s_benchIn;
+    uint8_t *out = (uint8_t *)s_benchOut;
+    uint32_t cycles, i;
+
+    HASHCRYPT_Init(HASHCRYPT);
+
+    PRINTF("\r\nAES-GCM test vectors, %d-bit GHASH tables\r\n", AES_GCM_TABLE_BITS);
+    s_benchGcm.aes.keyType = kHASHCRYPT_UserKey;
+    AES_GCM_SetKey(HASHCRYPT, &s_benchGcm, (const uint8_t *)zero, sizeof(zero));
+    BenchGcmVector("test case 2", (const uint8_t *)zero, NULL, 0, (const uint8_t *)zero, s_gcmTc2Ct, 16, s_gcmTc2Tag);
+    AES_GCM_SetKey(HASHCRYPT, &s_benchGcm, (const uint8_t *)s_gcmTc3Key, sizeof(s_gcmTc3Key));
+    BenchGcmVector("test case 3", s_gcmTc3Iv, NULL, 0, s_gcmTc3Pt, s_gcmTc3Ct, sizeof(s_gcmTc3Pt), s_gcmTc3Tag);
+    BenchGcmVector("test case 4", s_gcmTc3Iv, s_gcmTc4Aad, sizeof(s_gcmTc4Aad), s_gcmTc3Pt, s_gcmTc3Ct, 60,
+                   s_gcmTc4Tag);
+
+    PRINTF("GHASH of %d bytes\r\n", BENCH_BULK_SIZE);
+    BenchFill(in, BENCH_BUF_SIZE);
+    HASHCRYPT_AES_EncryptEcb(HASHCRYPT, &s_benchGcm.aes, (uint8_t *)zero, (uint8_t *)h, sizeof(h));
+
+    BenchTimerStart();
+    for (i = 0; i < BENCH_BULK_SIZE; i += 16)
+    {
+        for (uint32_t j = 0; j < 16; j++)
+        {
+            y[j] ^= in[i + j];
+        }
+        BenchGhashBitwise(y, (uint8_t *)h);
+    }
+    cycles = BenchTimerStop();
+    BenchPrint("bitwise", cycles, 1, BENCH_BULK_SIZE);
+    memcpy(tag, y, sizeof(tag));
+
+    memset(y, 0, sizeof(y));
+    BenchTimerStart();
+    AES_GCM_Ghash(&s_benchGcm, y, in, BENCH_BULK_SIZE);
+    cycles = BenchTimerStop();
+    BenchPrint("table", cycles, 1, BENCH_BULK_SIZE);
+    if (memcmp(tag, y, sizeof(tag)))
+    {
+        PRINTF("  !!! table GHASH differs from bitwise GHASH\r\n");
+    }
+
+    PRINTF("AES-128 encryption of %d bytes\r\n", BENCH_BULK_SIZE);
+    BenchTimerStart();
+    HASHCRYPT_AES_CryptCtr(HASHCRYPT, &s_benchGcm.aes, in, out, BENCH_BULK_SIZE, (uint8_t *)zero, NULL, NULL);
+    cycles = BenchTimerStop();
+    BenchPrint("CTR only", cycles, 1, BENCH_BULK_SIZE);
+
+    BenchTimerStart();
+    AES_GCM_Encrypt(HASHCRYPT, &s_benchGcm, s_gcmTc3Iv, sizeof(s_gcmTc3Iv), NULL, 0, in, out, BENCH_BULK_SIZE, tag,
+                    sizeof(tag));
+    cycles = BenchTimerStop();
+    BenchPrint("GCM", cycles, 1, BENCH_BULK_SIZE);
+}
+
+void BenchAesCmac(void)
+{
+    static const uint32_t sizes[] = {256, 1024, 4096};
+    hashcrypt_handle_t handle;
+    hashcrypt_cmac_ctx_t ctx;
+    uint8_t mac[HASHCRYPT_AES_BLOCK_SIZE];
+    uint8_t *in = (uint8_t *)s_benchIn;
+    uint32_t cycles, i, s, n;
+    bool pass;
+
+    HASHCRYPT_Init(HASHCRYPT);
+    handle.keyType = kHASHCRYPT_UserKey;
+    HASHCRYPT_AES_SetKey(HASHCRYPT, &handle, (const uint8_t *)s_benchKey, sizeof(s_benchKey));
+
+    PRINTF("\r\nAES-CMAC test vectors\r\n");
+    for (i = 0; i < sizeof(s_cmacLen) / sizeof(s_cmacLen[0]); i++)
+    {
+        pass = (HASHCRYPT_AES_Cmac(HASHCRYPT, &handle, s_cmacMsg, s_cmacLen[i], mac) == kStatus_Success) &&
+               !memcmp(mac, s_cmacTag[i], sizeof(mac));
+
+        /* same message fed in 7 byte pieces */
+        HASHCRYPT_AES_CmacInit(HASHCRYPT, &ctx, &handle);
+        for (n = 0; n < s_cmacLen[i]; n += 7)
+        {
+            HASHCRYPT_AES_CmacUpdate(HASHCRYPT, &ctx, s_cmacMsg + n, (s_cmacLen[i] - n < 7) ? s_cmacLen[i] - n : 7);
+        }
+        HASHCRYPT_AES_CmacFinish(HASHCRYPT, &ctx, mac, sizeof(mac));
+        pass = pass && !memcmp(mac, s_cmacTag[i], sizeof(mac));
+
+        PRINTF("  %2d byte message        %s\r\n", s_cmacLen[i], pass ? "PASS" : "FAIL");
+    }
+
+    BenchFill(in, BENCH_BUF_SIZE);
+    PRINTF("AES-128 CMAC vs. CBC encryption\r\n");
+    for (s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+    {
+        PRINTF("%d bytes\r\n", sizes[s]);
+
+        BenchTimerStart();
+        HASHCRYPT_AES_EncryptCbc(HASHCRYPT, &handle, in, (uint8_t *)s_benchOut, sizes[s], s_benchIv);
+        cycles = BenchTimerStop();
+        BenchPrint("CBC encryption", cycles, 1, sizes[s]);
+
+        BenchTimerStart();
+        HASHCRYPT_AES_Cmac(HASHCRYPT, &handle, in, sizes[s], mac);
+        cycles = BenchTimerStop();
+        BenchPrint("CMAC", cycles, 1, sizes[s]);
+    }
+}
+
+void BenchAesCcm(void)
+{
+    static const uint32_t sizes[] = {32, 64, 128, 256};
+    hashcrypt_handle_t handle;
+    uint8_t vec[3][32];
+    uint8_t out[32];
+    uint8_t *in = (uint8_t *)s_benchIn;
+    uint32_t cycles, i, s;
+    bool pass;
+
+    HASHCRYPT_Init(HASHCRYPT);
+    handle.keyType = kHASHCRYPT_UserKey;
+    HASHCRYPT_AES_SetKey(HASHCRYPT, &handle, (const uint8_t *)s_ccmKey, sizeof(s_ccmKey));
+
+    /* nonce, aad and payload are counting sequences starting at 0x10, 0x00 and 0x20 */
+    for (i = 0; i < sizeof(vec[0]); i++)
+    {
+        vec[0][i] = (uint8_t)(0x10u + i);
+        vec[1][i] = (uint8_t)i;
+        vec[2][i] = (uint8_t)(0x20u + i);
+    }
+
+    PRINTF("\r\nAES-CCM test vectors\r\n");
+    for (i = 0; i < sizeof(s_ccmLen) / sizeof(s_ccmLen[0]); i++)
+    {
+        pass = (AES_CCM_Encrypt(HASHCRYPT, &handle, vec[0], s_ccmNonceLen[i], vec[1], s_ccmAadLen[i], vec[2], out,
+                                s_ccmLen[i], &out[s_ccmLen[i]], s_ccmTagLen[i]) == kStatus_Success) &&
+               !memcmp(out, s_ccmCt[i], s_ccmLen[i] + s_ccmTagLen[i]);
+        pass = pass && (AES_CCM_Decrypt(HASHCRYPT, &handle, vec[0], s_ccmNonceLen[i], vec[1], s_ccmAadLen[i],
+                                        s_ccmCt[i], out, s_ccmLen[i], &s_ccmCt[i][s_ccmLen[i]],
+                                        s_ccmTagLen[i]) == kStatus_Success) &&
+               !memcmp(out, vec[2], s_ccmLen[i]);
+        PRINTF("  example %d              %s\r\n", i + 1, pass ? "PASS" : "FAIL");
+    }
+
+    HASHCRYPT_AES_SetKey(HASHCRYPT, &handle, (const uint8_t *)s_benchKey, sizeof(s_benchKey));
+    BenchFill(in, BENCH_BUF_SIZE);
+    PRINTF("AES-128 CCM, %d records, 8 byte aad, %d byte tag\r\n", BENCH_CCM_RECORDS, BENCH_CCM_TAG_SIZE);
+    for (s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+    {
+        PRINTF("%d bytes\r\n", sizes[s]);
+
+        BenchTimerStart();
+        for (i = 0; i < BENCH_CCM_RECORDS; i++)
+        {
+            AES_CCM_Encrypt(HASHCRYPT, &handle, s_benchIv, 13, s_benchIv, 8, in + i * sizes[s],
+                            (uint8_t *)s_benchRef + i * sizes[s], sizes[s], s_benchCcmTag[0][i], BENCH_CCM_TAG_SIZE);
+        }
+        cycles = BenchTimerStop();
+        BenchPrint("per-record encrypt", cycles, BENCH_CCM_RECORDS, BENCH_CCM_RECORDS * sizes[s]);
+
+        for (i = 0; i < BENCH_CCM_RECORDS; i++)
+        {
+            s_benchCcm[i].nonce = s_benchIv;
+            s_benchCcm[i].nonceSize = 13;
+            s_benchCcm[i].aad = s_benchIv;
+            s_benchCcm[i].aadSize = 8;
+            s_benchCcm[i].input = in + i * sizes[s];
+            s_benchCcm[i].output = (uint8_t *)s_benchOut + i * sizes[s];
+            s_benchCcm[i].size = sizes[s];
+            s_benchCcm[i].tag = s_benchCcmTag[1][i];
+        }
+        BenchTimerStart();
+        AES_CCM_EncryptBatch(HASHCRYPT, &handle, s_benchCcm, BENCH_CCM_RECORDS, BENCH_CCM_TAG_SIZE);
+        cycles = BenchTimerStop();
+        BenchPrint("batch encrypt", cycles, BENCH_CCM_RECORDS, BENCH_CCM_RECORDS * sizes[s]);
+
+        pass = !memcmp(s_benchRef, s_benchOut, BENCH_CCM_RECORDS * sizes[s]) &&
+               !memcmp(s_benchCcmTag[0], s_benchCcmTag[1], sizeof(s_benchCcmTag[0]));
+
+        /* decrypt the batch output in place */
+        for (i = 0; i < BENCH_CCM_RECORDS; i++)
+        {
+            s_benchCcm[i].input = s_benchCcm[i].output;
+        }
+        BenchTimerStart();
+        pass = pass &&
+               (AES_CCM_DecryptBatch(HASHCRYPT, &handle, s_benchCcm, BENCH_CCM_RECORDS, BENCH_CCM_TAG_SIZE) ==
+                kStatus_Success);
+        cycles = BenchTimerStop();
+        BenchPrint("batch decrypt", cycles, BENCH_CCM_RECORDS, BENCH_CCM_RECORDS * sizes[s]);
+
+        pass = pass && !memcmp(in, s_benchOut, BENCH_CCM_RECORDS * sizes[s]);
+        PRINTF("  batch output           %s\r\n", pass ? "PASS" : "FAIL");
+    }
+}
+
+void BenchAesPrepared(void)
+{
+    hashcrypt_handle_t handle;
+    hashcrypt_aes_prepared_t ecbEnc, ecbDec, cbcEnc;
+    uint8_t *in = (uint8_t *)s_benchIn;
+    uint8_t *ref = (uint8_t *)s_benchRef;
+    uint8_t *out = (uint8_t *)s_benchOut;
+    const uint32_t sz = HASHCRYPT_AES_BLOCK_SIZE;
+    uint32_t cycles, i;
+    bool pass = true;
+
+    HASHCRYPT_Init(HASHCRYPT);
+    handle.keyType = kHASHCRYPT_UserKey;
+    HASHCRYPT_AES_SetKey(HASHCRYPT, &handle, (const uint8_t *)s_benchKey, sizeof(s_benchKey));
+    HASHCRYPT_AES_Prepare(HASHCRYPT, &ecbEnc, &handle, kHASHCRYPT_AesEcb, AES_ENCRYPT);
+    HASHCRYPT_AES_Prepare(HASHCRYPT, &ecbDec, &handle, kHASHCRYPT_AesEcb, AES_DECRYPT);
+    HASHCRYPT_AES_Prepare(HASHCRYPT, &cbcEnc, &handle, kHASHCRYPT_AesCbc, AES_ENCRYPT);
+    BenchFill(in, BENCH_BUF_SIZE);
+
+    PRINTF("\r\nAES-128 single block latency, %d calls, handle vs. prepared handle\r\n", BENCH_RECORDS);
+
+    PRINTF("ECB encryption\r\n");
+    BenchTimerStart();
+    for (i = 0; i < BENCH_RECORDS; i++)
+    {
+        HASHCRYPT_AES_EncryptEcb(HASHCRYPT, &handle, in + i * sz, ref + i * sz, sz);
+    }
+    cycles = BenchTimerStop();
+    BenchPrint("handle", cycles, BENCH_RECORDS, BENCH_RECORDS * sz);
+
+    BenchTimerStart();
+    for (i = 0; i < BENCH_RECORDS; i++)
+    {
+        HASHCRYPT_AES_CryptPrepared(HASHCRYPT, &ecbEnc, in + i * sz, out + i * sz, sz, NULL);
+    }
+    cycles = BenchTimerStop();
+    BenchPrint("prepared, resident", cycles, BENCH_RECORDS, BENCH_RECORDS * sz);
+    pass = pass && !memcmp(ref, out, BENCH_RECORDS * sz);
+
+    /* alternating encryption and decryption reconfigures the engine on every call */
+    PRINTF("ECB encryption + decryption\r\n");
+    BenchTimerStart();
+    for (i = 0; i < BENCH_RECORDS; i++)
+    {
+        HASHCRYPT_AES_EncryptEcb(HASHCRYPT, &handle, in + i * sz, out + i * sz, sz);
+        HASHCRYPT_AES_DecryptEcb(HASHCRYPT, &handle, out + i * sz, out + i * sz, sz);
+    }
+    cycles = BenchTimerStop();
+    BenchPrint("handle", cycles, 2 * BENCH_RECORDS, 2 * BENCH_RECORDS * sz);
+
+    BenchTimerStart();
+    for (i = 0; i < BENCH_RECORDS; i++)
+    {
+        HASHCRYPT_AES_CryptPrepared(HASHCRYPT, &ecbEnc, in + i * sz, out + i * sz, sz, NULL);
+        HASHCRYPT_AES_CryptPrepared(HASHCRYPT, &ecbDec, out + i * sz, out + i * sz, sz, NULL);
+    }
+    cycles = BenchTimerStop();
+    BenchPrint("prepared", cycles, 2 * BENCH_RECORDS, 2 * BENCH_RECORDS * sz);
+    pass = pass && !memcmp(in, out, BENCH_RECORDS * sz);
+
+    PRINTF("CBC encryption\r\n");
+    BenchTimerStart();
+    for (i = 0; i < BENCH_RECORDS; i++)
+    {
+        HASHCRYPT_AES_EncryptCbc(HASHCRYPT, &handle, in + i * sz, ref + i * sz, sz, s_benchIv);
+    }
+    cycles = BenchTimerStop();
+    BenchPrint("handle", cycles, BENCH_RECORDS, BENCH_RECORDS * sz);
+
+    BenchTimerStart();
+    for (i = 0; i < BENCH_RECORDS; i++)
+    {
+        HASHCRYPT_AES_CryptPrepared(HASHCRYPT, &cbcEnc, in + i * sz, out + i * sz, sz, s_benchIv);
+    }
+    cycles = BenchTimerStop();
+    BenchPrint("prepared", cycles, BENCH_RECORDS, BENCH_RECORDS * sz);
+    pass = pass && !memcmp(ref, out, BENCH_RECORDS * sz);
+
+    PRINTF("  output                 %s\r\n", pass ? "PASS" : "FAIL");
+}
+
+void BenchAesSoft(void)
+{
+    static const char *modes[] = {"ECB", "CBC", "CTR"};
+    static const aes_soft_impl_t impls[] = {kAES_SOFT_Table, kAES_SOFT_Bitsliced};
+    static const char *names[] = {"T-tables", "bitsliced"};
+    static aes_soft_ctx_t soft;
+    hashcrypt_handle_t handle;
+    uint8_t counter[HASHCRYPT_AES_BLOCK_SIZE];
+    uint8_t *in = (uint8_t *)s_benchIn;
+    uint8_t *ref = (uint8_t *)s_benchRef;
+    uint8_t *out = (uint8_t *)s_benchOut;
+    uint32_t cycles, m, b, i;
+
+    HASHCRYPT_Init(HASHCRYPT);
+    handle.keyType = kHASHCRYPT_UserKey;
+    BenchFill(in, BENCH_BULK_SIZE);
+
+    PRINTF("\r\nAES-128 encryption of %d byte messages, HASHCRYPT vs. software\r\n", BENCH_BULK_SIZE);
+    for (m = 0; m < sizeof(modes) / sizeof(modes[0]); m++)
+    {
+        PRINTF("%s\r\n", modes[m]);
+        for (b = 0; b <= sizeof(impls) / sizeof(impls[0]); b++)
+        {
+            uint8_t *dst = b ? out : ref;
+
+            /* SetKey selects HASHCRYPT, software is selected after it */
+            HASHCRYPT_AES_SetKey(HASHCRYPT, &handle, (const uint8_t *)s_benchKey, sizeof(s_benchKey));
+            if (b)
+            {
+                HASHCRYPT_AES_SetSoftware(HASHCRYPT, &handle, &soft, impls[b - 1]);
+            }
+
+            BenchTimerStart();
+            for (i = 0; i < BENCH_BULK_LOOPS; i++)
+            {
+                if (m == 0)
+                {
+                    HASHCRYPT_AES_EncryptEcb(HASHCRYPT, &handle, in, dst, BENCH_BULK_SIZE);
+                }
+                else if (m == 1)
+                {
+                    HASHCRYPT_AES_EncryptCbc(HASHCRYPT, &handle, in, dst, BENCH_BULK_SIZE, s_benchIv);
+                }
+                else
+                {
+                    memcpy(counter, s_benchIv, sizeof(counter));
+                    HASHCRYPT_AES_CryptCtr(HASHCRYPT, &handle, in, dst, BENCH_BULK_SIZE, counter, NULL, NULL);
+                }
+            }
+            cycles = BenchTimerStop();
+            BenchPrint(b ? names[b - 1] : "HASHCRYPT", cycles, BENCH_BULK_LOOPS, BENCH_BULK_LOOPS * BENCH_BULK_SIZE);
+
+            if (b && memcmp(ref, out, BENCH_BULK_SIZE))
+            {
+                PRINTF("  !!! software output differs from HASHCRYPT output\r\n");
+            }
+        }
+    }
+    HASHCRYPT_AES_SetSoftware(HASHCRYPT, &handle, NULL, kAES_SOFT_Auto);
+}
+
+static void BenchShaCallback(HASHCRYPT_Type *base, hashcrypt_hash_ctx_t *ctx, status_t status, void *userData)
+{
+    uint32_t i = (uint32_t)(uintptr_t)userData;
+
+    s_benchShaStatus[i] = status;
+    s_benchShaDone[i] = DWT->CYCCNT;
+}
+
+void BenchShaStreams(void)
+{
+    static const char *names[BENCH_SHA_STREAMS] = {"image", "scrub", "transcript"};
+    const uint8_t *msg[BENCH_SHA_STREAMS];
+    size_t size[BENCH_SHA_STREAMS] = {BENCH_SHA_IMAGE_SIZE, BENCH_SHA_SCRUB_SIZE, BENCH_SHA_TRANSCRIPT_SIZE};
+    uint8_t ref[BENCH_SHA_STREAMS][32];
+    uint8_t digest[32];
+    hashcrypt_sha_stats_t stats[BENCH_SHA_STREAMS];
+    bool finished[BENCH_SHA_STREAMS];
+    uint32_t i, pending;
+    bool pass = true;
+
+    msg[0] = (const uint8_t *)g_pfnVectors;
+    msg[1] = msg[0] + BENCH_SHA_IMAGE_SIZE;
+    msg[2] = (const uint8_t *)s_benchIn;
+    BenchFill((uint8_t *)s_benchIn, BENCH_SHA_TRANSCRIPT_SIZE);
+
+    HASHCRYPT_Init(HASHCRYPT);
+    for (i = 0; i < BENCH_SHA_STREAMS; i++)
+    {
+        HASHCRYPT_SHA(HASHCRYPT, kHASHCRYPT_Sha256, msg[i], size[i], ref[i], NULL);
+    }
+
+    PRINTF("\r\nSHA-256 of %d KB image, %d KB scrub and %d byte transcript started at once\r\n",
+           BENCH_SHA_IMAGE_SIZE / 1024u, BENCH_SHA_SCRUB_SIZE / 1024u, BENCH_SHA_TRANSCRIPT_SIZE);
+    for (i = 0; i < BENCH_SHA_STREAMS; i++)
+    {
+        HASHCRYPT_SHA_Init(HASHCRYPT, &s_benchShaCtx[i], kHASHCRYPT_Sha256);
+        HASHCRYPT_SHA_SetCallback(HASHCRYPT, &s_benchShaCtx[i], BenchShaCallback, (void *)(uintptr_t)i);
+        s_benchShaDone[i] = 0;
+        finished[i] = false;
+    }
+
+    BenchTimerStart();
+    for (i = 0; i < BENCH_SHA_STREAMS; i++)
+    {
+        HASHCRYPT_SHA_UpdateNonBlocking(HASHCRYPT, &s_benchShaCtx[i], msg[i], size[i]);
+    }
+    /* each hash is finished once hashed, it holds HASHCRYPT until then and the next one waits */
+    do
+    {
+        pending = 0;
+        for (i = 0; i < BENCH_SHA_STREAMS; i++)
+        {
+            if (finished[i])
+            {
+                continue;
+            }
+            if (s_benchShaDone[i] == 0u)
+            {
+                pending++;
+                continue;
+            }
+            HASHCRYPT_SHA_GetStats(HASHCRYPT, &s_benchShaCtx[i], &stats[i]);
+            HASHCRYPT_SHA_Finish(HASHCRYPT, &s_benchShaCtx[i], digest, NULL);
+            pass = pass && (s_benchShaStatus[i] == kStatus_Success) && !memcmp(digest, ref[i], sizeof(digest));
+            finished[i] = true;
+        }
+    } while (pending > 0u);
+
+    for (i = 0; i < BENCH_SHA_STREAMS; i++)
+    {
+        PRINTF("  %-10s done at %8d cycles  %6d KB/s  %4d runs\r\n", names[i], s_benchShaDone[i],
+               (uint32_t)(((uint64_t)stats[i].bytes * BENCH_CORE_CLK_FREQ) / s_benchShaDone[i] / 1024u),
+               stats[i].runs);
+    }
+
+    PRINTF("  digests                %s\r\n", pass ? "PASS" : "FAIL");
+}
+
+void BenchShaSegments(void)
+{
+    static const uint32_t frames[] = {1, 63, 64, 65, 130, 7, 500, 1024, 3, 200};
+    static const uint32_t offsets[] = {0, 1};
+    const uint8_t *msg;
+    uint8_t ref[32];
+    uint8_t digest[32];
+    uint32_t cycles, o, f, done, fed;
+    bool pass = true;
+
+    HASHCRYPT_Init(HASHCRYPT);
+    BenchFill((uint8_t *)s_benchIn, BENCH_BUF_SIZE);
+
+    PRINTF("\r\nSHA-256 of a %d byte message passed in segments of 1 to 1024 bytes\r\n", BENCH_SHA_CHAIN_SIZE);
+    for (o = 0; o < sizeof(offsets) / sizeof(offsets[0]); o++)
+    {
+        msg = (const uint8_t *)s_benchIn + offsets[o];
+        HASHCRYPT_SHA(HASHCRYPT, kHASHCRYPT_Sha256, msg, BENCH_SHA_CHAIN_SIZE, ref, NULL);
+        PRINTF("%s input\r\n", offsets[o] ? "unaligned" : "aligned");
+
+        /* blocking updates */
+        BenchTimerStart();
+        HASHCRYPT_SHA_Init(HASHCRYPT, &s_benchShaCtx[0], kHASHCRYPT_Sha256);
+        for (fed = 0, f = 0; fed < BENCH_SHA_CHAIN_SIZE; fed += done, f++)
+        {
+            done = MIN(frames[f % ARRAY_SIZE(frames)], BENCH_SHA_CHAIN_SIZE - fed);
+            HASHCRYPT_SHA_Update(HASHCRYPT, &s_benchShaCtx[0], msg + fed, done);
+        }
+        HASHCRYPT_SHA_Finish(HASHCRYPT, &s_benchShaCtx[0], digest, NULL);
+        cycles = BenchTimerStop();
+        BenchPrint("blocking", cycles, f, BENCH_SHA_CHAIN_SIZE);
+        pass = pass && !memcmp(digest, ref, sizeof(digest));
+
+        /* chained non-blocking updates, each segment passed once the previous one is done */
+        BenchTimerStart();
+        HASHCRYPT_SHA_Init(HASHCRYPT, &s_benchShaCtx[0], kHASHCRYPT_Sha256);
+        HASHCRYPT_SHA_SetCallback(HASHCRYPT, &s_benchShaCtx[0], BenchShaCallback, (void *)0);
+        for (fed = 0, f = 0; fed < BENCH_SHA_CHAIN_SIZE; fed += done, f++)
+        {
+            done = MIN(frames[f % ARRAY_SIZE(frames)], BENCH_SHA_CHAIN_SIZE - fed);
+            s_benchShaDone[0] = 0;
+            HASHCRYPT_SHA_UpdateNonBlocking(HASHCRYPT, &s_benchShaCtx[0], msg + fed, done);
+            while (s_benchShaDone[0] == 0u)
+            {
+            }
+            pass = pass && (s_benchShaStatus[0] == kStatus_Success);
+        }
+        HASHCRYPT_SHA_Finish(HASHCRYPT, &s_benchShaCtx[0], digest, NULL);
+        cycles = BenchTimerStop();
+        BenchPrint("non-blocking", cycles, f, BENCH_SHA_CHAIN_SIZE);
+        pass = pass && !memcmp(digest, ref, sizeof(digest));
+    }
+
+    PRINTF("  digests                %s\r\n", pass ? "PASS" : "FAIL");
+}
+
+/* HMAC-SHA256 padding the key for every message */
+static void BenchHmacNaive(const uint8_t *key, size_t keySize, const uint8_t *msg, size_t msgSize, uint8_t *mac)
+{
+    uint8_t pad[64];
+    uint8_t inner[32];
+    uint32_t i;
+
+    for (i = 0; i < sizeof(pad); i++)
+    {
+        pad[i] = ((i < keySize) ? key[i] : 0u) ^ 0x36u;
+    }
+    HASHCRYPT_SHA_Init(HASHCRYPT, &s_benchShaCtx[0], kHASHCRYPT_Sha256);
+    HASHCRYPT_SHA_Update(HASHCRYPT, &s_benchShaCtx[0], pad, sizeof(pad));
+    HASHCRYPT_SHA_Update(HASHCRYPT, &s_benchShaCtx[0], msg, msgSize);
+    HASHCRYPT_SHA_Finish(HASHCRYPT, &s_benchShaCtx[0], inner, NULL);
+
+    for (i = 0; i < sizeof(pad); i++)
+    {
+        pad[i] ^= 0x36u ^ 0x5cu;
+    }
+    HASHCRYPT_SHA_Init(HASHCRYPT, &s_benchShaCtx[0], kHASHCRYPT_Sha256);
+    HASHCRYPT_SHA_Update(HASHCRYPT, &s_benchShaCtx[0], pad, sizeof(pad));
+    HASHCRYPT_SHA_Update(HASHCRYPT, &s_benchShaCtx[0], inner, sizeof(inner));
+    HASHCRYPT_SHA_Finish(HASHCRYPT, &s_benchShaCtx[0], mac, NULL);
+}
+
+void BenchHmac(void)
+{
+    static const uint8_t msg2[] = "what do ya want for nothing?";
+    static const uint8_t msg6[] = "Test Using Larger Than Block-Size Key - Hash Key First";
+    const uint8_t *in = (const uint8_t *)s_benchIn;
+    uint8_t *out = (uint8_t *)s_benchOut;
+    uint8_t *ref = (uint8_t *)s_benchRef;
+    uint8_t key[131];
+    uint8_t mac[32];
+    uint32_t cycles, r, o;
+    bool pass = true;
+
+    HASHCRYPT_Init(HASHCRYPT);
+
+    /* known answers */
+    HASHCRYPT_HMAC_SetKey(HASHCRYPT, &s_benchHmacKey, s_benchHmacKey1, sizeof(s_benchHmacKey1));
+    HASHCRYPT_HMAC(HASHCRYPT, &s_benchHmacKey, (const uint8_t *)"Hi There", 8, mac, sizeof(mac));
+    pass = pass && !memcmp(mac, s_benchHmacMac1, sizeof(mac));
+    HASHCRYPT_HMAC_SetKey(HASHCRYPT, &s_benchHmacKey, (const uint8_t *)"Jefe", 4);
+    HASHCRYPT_HMAC(HASHCRYPT, &s_benchHmacKey, msg2, sizeof(msg2) - 1u, mac, sizeof(mac));
+    pass = pass && !memcmp(mac, s_benchHmacMac2, sizeof(mac));
+    memset(key, 0xaa, sizeof(key));
+    HASHCRYPT_HMAC_SetKey(HASHCRYPT, &s_benchHmacKey, key, sizeof(key));
+    HASHCRYPT_HMAC(HASHCRYPT, &s_benchHmacKey, msg6, sizeof(msg6) - 1u, mac, sizeof(mac));
+    pass = pass && !memcmp(mac, s_benchHmacMac6, sizeof(mac));
+    PRINTF("\r\nHMAC-SHA256 RFC 4231 test cases %s\r\n", pass ? "PASS" : "FAIL");
+
+    BenchFill((uint8_t *)s_benchIn, BENCH_BUF_SIZE);
+    HASHCRYPT_HMAC_SetKey(HASHCRYPT, &s_benchHmacKey, (const uint8_t *)s_benchKey, sizeof(s_benchKey));
+
+    PRINTF("HMAC-SHA256 of %d messages of %d bytes\r\n", BENCH_RECORDS, BENCH_HMAC_MSG_SIZE);
+
+    /* key padded per message, 4 blocks */
+    BenchTimerStart();
+    for (r = 0; r < BENCH_RECORDS; r++)
+    {
+        o = r * BENCH_HMAC_MSG_SIZE;
+        BenchHmacNaive((const uint8_t *)s_benchKey, sizeof(s_benchKey), &in[o], BENCH_HMAC_MSG_SIZE, &ref[o]);
+    }
+    cycles = BenchTimerStop();
+    BenchPrint("key padded per message", cycles, BENCH_RECORDS, BENCH_RECORDS * BENCH_HMAC_MSG_SIZE);
+
+    /* HASHCRYPT_HMAC(): padded key precomputed, still 4 blocks */
+    BenchTimerStart();
+    for (r = 0; r < BENCH_RECORDS; r++)
+    {
+        o = r * BENCH_HMAC_MSG_SIZE;
+        HASHCRYPT_HMAC(HASHCRYPT, &s_benchHmacKey, &in[o], BENCH_HMAC_MSG_SIZE, &out[o], HASHCRYPT_HMAC_SIZE);
+    }
+    cycles = BenchTimerStop();
+    BenchPrint("HASHCRYPT_HMAC", cycles, BENCH_RECORDS, BENCH_RECORDS * BENCH_HMAC_MSG_SIZE);
+    pass = pass && !memcmp(out, ref, BENCH_RECORDS * BENCH_HMAC_MSG_SIZE);
+
+    /* incremental API, each message passed in four parts */
+    BenchTimerStart();
+    for (r = 0; r < BENCH_RECORDS; r++)
+    {
+        o = r * BENCH_HMAC_MSG_SIZE;
+        HASHCRYPT_HMAC_Init(HASHCRYPT, &s_benchHmacCtx, &s_benchHmacKey);
+        HASHCRYPT_HMAC_Update(HASHCRYPT, &s_benchHmacCtx, &in[o], 5);
+        HASHCRYPT_HMAC_Update(HASHCRYPT, &s_benchHmacCtx, &in[o + 5u], 11);
+        HASHCRYPT_HMAC_Update(HASHCRYPT, &s_benchHmacCtx, &in[o + 16u], 9);
+        HASHCRYPT_HMAC_Update(HASHCRYPT, &s_benchHmacCtx, &in[o + 25u], BENCH_HMAC_MSG_SIZE - 25u);
+        HASHCRYPT_HMAC_Finish(HASHCRYPT, &s_benchHmacCtx, &out[o], HASHCRYPT_HMAC_SIZE);
+    }
+    cycles = BenchTimerStop();
+    BenchPrint("HASHCRYPT_HMAC_Update", cycles, BENCH_RECORDS, BENCH_RECORDS * BENCH_HMAC_MSG_SIZE);
+    pass = pass && !memcmp(out, ref, BENCH_RECORDS * BENCH_HMAC_MSG_SIZE);
+
+    PRINTF("  MACs                   %s\r\n", pass ? "PASS" : "FAIL");
+}
+
+void BenchKdf(void)
+{
+    static const uint8_t context[] = "lpc55s69 device";
+    uint8_t *out = (uint8_t *)s_benchOut;
+    uint8_t *ref = (uint8_t *)s_benchRef;
+    uint8_t ikm[22];
+    uint32_t cycles, k;
+    kdf_mode_t mode;
+    bool pass;
+
+    HASHCRYPT_Init(HASHCRYPT);
+
+    /* known answer */
+    memset(ikm, 0x0b, sizeof(ikm));
+    KDF_HKDF_Extract(HASHCRYPT, s_benchHkdfSalt, sizeof(s_benchHkdfSalt), ikm, sizeof(ikm), &s_benchHmacKey);
+    memcpy(out, s_benchHkdfInfo, sizeof(s_benchHkdfInfo));
+    out[sizeof(s_benchHkdfInfo)] = 1u;
+    HASHCRYPT_HMAC(HASHCRYPT, &s_benchHmacKey, out, sizeof(s_benchHkdfInfo) + 1u, ref, sizeof(s_benchHkdfOkm));
+    pass = !memcmp(ref, s_benchHkdfOkm, sizeof(s_benchHkdfOkm));
+    PRINTF("\r\nHKDF-SHA256 RFC 5869 test case 1 %s\r\n", pass ? "PASS" : "FAIL");
+    KDF_Derive(HASHCRYPT, &s_benchHmacKey, kKDF_Hkdf, s_benchHkdfInfo, sizeof(s_benchHkdfInfo), NULL, 0, out,
+               sizeof(s_benchKdfOkm));
+    pass = pass && !memcmp(out, s_benchKdfOkm, sizeof(s_benchKdfOkm));
+
+    for (k = 0; k < BENCH_KDF_SUBKEYS; k++)
+    {
+        memcpy(s_benchKdfLabel[k], "subkey", 6);
+        s_benchKdfLabel[k][6] = (uint8_t)('0' + k / 10u);
+        s_benchKdfLabel[k][7] = (uint8_t)('0' + k % 10u);
+        s_benchKdf[k].label = s_benchKdfLabel[k];
+        s_benchKdf[k].labelSize = sizeof(s_benchKdfLabel[k]);
+        s_benchKdf[k].key = &out[k * 32u];
+        s_benchKdf[k].keySize = 32;
+    }
+
+    PRINTF("%d subkeys of 32 bytes from one root key\r\n", BENCH_KDF_SUBKEYS);
+    for (mode = kKDF_Hkdf; mode <= kKDF_CounterMode; mode++)
+    {
+        PRINTF("%s\r\n", (mode == kKDF_Hkdf) ? "HKDF-Expand" : "SP 800-108 counter mode");
+
+        /* root key padded for every subkey */
+        BenchTimerStart();
+        for (k = 0; k < BENCH_KDF_SUBKEYS; k++)
+        {
+            HASHCRYPT_HMAC_SetKey(HASHCRYPT, &s_benchHmacKey, (const uint8_t *)s_benchKey, sizeof(s_benchKey));
+            KDF_Derive(HASHCRYPT, &s_benchHmacKey, mode, s_benchKdf[k].label, s_benchKdf[k].labelSize, context,
+                       sizeof(context) - 1u, &ref[k * 32u], 32);
+        }
+        cycles = BenchTimerStop();
+        BenchPrint("root key per subkey", cycles, BENCH_KDF_SUBKEYS, BENCH_KDF_SUBKEYS * 32u);
+
+        /* root key padded once, still four compressions per subkey */
+        BenchTimerStart();
+        HASHCRYPT_HMAC_SetKey(HASHCRYPT, &s_benchHmacKey, (const uint8_t *)s_benchKey, sizeof(s_benchKey));
+        KDF_DeriveBatch(HASHCRYPT, &s_benchHmacKey, mode, context, sizeof(context) - 1u, s_benchKdf,
+                        BENCH_KDF_SUBKEYS);
+        cycles = BenchTimerStop();
+        BenchPrint("batch", cycles, BENCH_KDF_SUBKEYS, BENCH_KDF_SUBKEYS * 32u);
+        pass = pass && !memcmp(out, ref, BENCH_KDF_SUBKEYS * 32u);
+    }
+
+    PRINTF("  subkeys                %s\r\n", pass ? "PASS" : "FAIL");
+}
+
+void BenchFlashMerkle(void)
+{
+    static const uint32_t dirtyPages[] = {1, 4, 16};
+    const uint32_t start = (uint32_t)g_pfnVectors;
+    uint8_t root[FLASH_MERKLE_DIGEST_SIZE];
+    uint8_t ref[FLASH_MERKLE_DIGEST_SIZE];
+    uint32_t pageSize = 0;
+    uint32_t cycles, d;
+    bool pass = true;
+    status_t status;
+
+    HASHCRYPT_Init(HASHCRYPT);
+    memset(&s_benchFlash, 0, sizeof(s_benchFlash));
+    FLASH_Init(&s_benchFlash);
+    FLASH_GetProperty(&s_benchFlash, kFLASH_PropertyPflashPageSize, &pageSize);
+
+    status = FLASH_MERKLE_Init(&s_benchMerkle, &s_benchFlash, start, BENCH_MERKLE_PAGES * pageSize);
+    if (kStatus_Success != status)
+    {
+        PRINTF("\r\nMerkle tree init failed %d\r\n", status);
+        return;
+    }
+
+    PRINTF("\r\nMerkle tree over %d pages of %d bytes at 0x%x\r\n", BENCH_MERKLE_PAGES, pageSize, start);
+
+    BenchTimerStart();
+    status = FLASH_MERKLE_Update(HASHCRYPT, &s_benchMerkle, ref);
+    cycles = BenchTimerStop();
+    BenchPrint("full build", cycles, s_benchMerkle.hashed, BENCH_MERKLE_PAGES * pageSize);
+    pass = pass && (kStatus_Success == status);
+
+    /* pages spread over the region, as after FLASH_Program() of separate records */
+    for (d = 0; d < sizeof(dirtyPages) / sizeof(dirtyPages[0]); d++)
+    {
+        for (uint32_t p = 0; p < dirtyPages[d]; p++)
+        {
+            FLASH_MERKLE_MarkDirty(&s_benchMerkle, start + (p * (BENCH_MERKLE_PAGES / dirtyPages[d])) * pageSize, 4);
+        }
+        BenchTimerStart();
+        status = FLASH_MERKLE_Update(HASHCRYPT, &s_benchMerkle, root);
+        cycles = BenchTimerStop();
+        PRINTF("%d dirty page(s)\r\n", dirtyPages[d]);
+        BenchPrint("incremental update", cycles, s_benchMerkle.hashed, dirtyPages[d] * pageSize);
+        pass = pass && (kStatus_Success == status) && !memcmp(root, ref, sizeof(root));
+    }
+
+    BenchTimerStart();
+    status = FLASH_MERKLE_VerifyPages(HASHCRYPT, &s_benchMerkle, start, BENCH_MERKLE_PAGES * pageSize);
+    cycles = BenchTimerStop();
+    BenchPrint("verify all pages", cycles, BENCH_MERKLE_PAGES, BENCH_MERKLE_PAGES * pageSize);
+    pass = pass && (kStatus_Success == status);
+
+    PRINTF("  root                   %s\r\n", pass ? "PASS" : "FAIL");
+}
+
+void BenchShaSoft(void)
+{
+    const uint8_t *in = (const uint8_t *)s_benchIn;
+    uint8_t ref[SHA_SOFT_SHA512_SIZE];
+    uint8_t digest[SHA_SOFT_SHA512_SIZE];
+    uint32_t cycles, o;
+    bool pass;
+
+    HASHCRYPT_Init(HASHCRYPT);
+    BenchFill((uint8_t *)s_benchIn, BENCH_BUF_SIZE);
+
+    SHA_SOFT_Init(&s_benchShaSoft, kSHA_SOFT_Sha512, kSHA_SOFT_Auto);
+    SHA_SOFT_Update(&s_benchShaSoft, (const uint8_t *)"abc", 3);
+    SHA_SOFT_Finish(&s_benchShaSoft, digest);
+    pass = !memcmp(digest, s_benchSha512Abc, sizeof(s_benchSha512Abc));
+    PRINTF("\r\nSHA-512 FIPS 180-4 \"abc\" %s\r\n", pass ? "PASS" : "FAIL");
+
+    PRINTF("Hash of %d bytes, aligned and unaligned\r\n", BENCH_BUF_SIZE - 4);
+    for (o = 0; o < 2u; o++)
+    {
+        PRINTF("offset %d\r\n", o);
+
+        BenchTimerStart();
+        HASHCRYPT_SHA(HASHCRYPT, kHASHCRYPT_Sha256, in + o, BENCH_BUF_SIZE - 4, ref, NULL);
+        cycles = BenchTimerStop();
+        BenchPrint("SHA-256 HASHCRYPT", cycles, 1, BENCH_BUF_SIZE - 4);
+
+        BenchTimerStart();
+        SHA_SOFT_Init(&s_benchShaSoft, kSHA_SOFT_Sha256, kSHA_SOFT_Portable);
+        SHA_SOFT_Update(&s_benchShaSoft, in + o, BENCH_BUF_SIZE - 4);
+        SHA_SOFT_Finish(&s_benchShaSoft, digest);
+        cycles = BenchTimerStop();
+        BenchPrint("SHA-256 software", cycles, 1, BENCH_BUF_SIZE - 4);
+        pass = pass && !memcmp(digest, ref, SHA_SOFT_SHA256_SIZE);
+
+        BenchTimerStart();
+        SHA_SOFT_Init(&s_benchShaSoft, kSHA_SOFT_Sha512, kSHA_SOFT_Portable);
+        SHA_SOFT_Update(&s_benchShaSoft, in + o, BENCH_BUF_SIZE - 4);
+        SHA_SOFT_Finish(&s_benchShaSoft, digest);
+        cycles = BenchTimerStop();
+        BenchPrint("SHA-512 software", cycles, 1, BENCH_BUF_SIZE - 4);
+    }
+
+    PRINTF("  digests                %s\r\n", pass ? "PASS" : "FAIL");
+}
+
+static void BenchShaProgress(HASHCRYPT_Type *base, hashcrypt_hash_ctx_t *ctx, size_t done, size_t total, void *userData)
+{
+    s_benchProgressCalls++;
+}
+
+static void BenchShaYield(void *userData)
+{
+    s_benchYieldCalls++;
+}
+
+void BenchShaLarge(void)
+{
+    static const uint32_t sizes[] = {4u * 1024u, 64u * 1024u, 512u * 1024u};
+    const uint8_t *image = (const uint8_t *)g_pfnVectors;
+    uint8_t ref[SHA_SOFT_SHA256_SIZE];
+    uint8_t digest[SHA_SOFT_SHA256_SIZE];
+    uint32_t pageSize = 0;
+    uint32_t cycles, n, p;
+    bool pass = true;
+
+    HASHCRYPT_Init(HASHCRYPT);
+    memset(&s_benchFlash, 0, sizeof(s_benchFlash));
+    FLASH_Init(&s_benchFlash);
+    FLASH_GetProperty(&s_benchFlash, kFLASH_PropertyPflashPageSize, &pageSize);
+
+    PRINTF("\r\nSHA-256 of flash from 0x%x in one call, %d block chunks\r\n", (uint32_t)image,
+           HASHCRYPT_SHA_CHUNK_BLOCKS);
+    for (n = 0; n < sizeof(sizes) / sizeof(sizes[0]); n++)
+    {
+        /* erased pages raise an ECC fault when read */
+        for (p = 0; p < sizes[n]; p += pageSize)
+        {
+            if (kStatus_FLASH_Success == FLASH_VerifyErase(&s_benchFlash, (uint32_t)image + p, pageSize))
+            {
+                break;
+            }
+        }
+        if (p < sizes[n])
+        {
+            PRINTF("%d KB: skipped, page at 0x%x is erased\r\n", sizes[n] / 1024u, (uint32_t)image + p);
+            continue;
+        }
+        PRINTF("%d KB\r\n", sizes[n] / 1024u);
+
+        BenchTimerStart();
+        HASHCRYPT_SHA(HASHCRYPT, kHASHCRYPT_Sha256, image, sizes[n], digest, NULL);
+        cycles = BenchTimerStop();
+        BenchPrint("no hooks", cycles, 1, sizes[n]);
+
+        s_benchProgressCalls = 0;
+        s_benchYieldCalls = 0;
+        HASHCRYPT_SHA_SetYieldHook(HASHCRYPT, BenchShaYield, NULL);
+        BenchTimerStart();
+        HASHCRYPT_SHA_Init(HASHCRYPT, &s_benchShaCtx[0], kHASHCRYPT_Sha256);
+        HASHCRYPT_SHA_SetProgress(HASHCRYPT, &s_benchShaCtx[0], BenchShaProgress, NULL);
+        HASHCRYPT_SHA_Update(HASHCRYPT, &s_benchShaCtx[0], image, sizes[n]);
+        HASHCRYPT_SHA_Finish(HASHCRYPT, &s_benchShaCtx[0], ref, NULL);
+        cycles = BenchTimerStop();
+        HASHCRYPT_SHA_SetYieldHook(HASHCRYPT, NULL, NULL);
+        BenchPrint("progress and yield", cycles, 1, sizes[n]);
+        PRINTF("  progress calls %d, yield calls %d\r\n", s_benchProgressCalls, s_benchYieldCalls);
+        pass = pass && !memcmp(digest, ref, sizeof(ref));
+
+        BenchTimerStart();
+        SHA_SOFT_Init(&s_benchShaSoft, kSHA_SOFT_Sha256, kSHA_SOFT_Portable);
+        SHA_SOFT_Update(&s_benchShaSoft, image, sizes[n]);
+        SHA_SOFT_Finish(&s_benchShaSoft, ref);
+        cycles = BenchTimerStop();
+        BenchPrint("software", cycles, 1, sizes[n]);
+        pass = pass && !memcmp(digest, ref, sizeof(ref));
+    }
+
+    PRINTF("  digests                %s\r\n", pass ? "PASS" : "FAIL");
+}
+
+void BenchDrbg(void)
+{
+    uint8_t out[96];
+    drbg_stats_t stats;
+    uint32_t cycles, i;
+    status_t status;
+    bool pass = true;
+
+    HASHCRYPT_Init(HASHCRYPT);
+
+    PRINTF("\r\nHash_DRBG SHA-256, %d byte pool\r\n", DRBG_POOL_SIZE);
+    BenchTimerStart();
+    status = DRBG_Init(HASHCRYPT, &s_benchDrbg, DRBG_EntropyRng, NULL, NULL, 0);
+    cycles = BenchTimerStop();
+    BenchPrint("instantiate", cycles, 1, 0);
+    pass = pass && (kStatus_Success == status);
+
+    BenchTimerStart();
+    status = DRBG_Refill(HASHCRYPT, &s_benchDrbg);
+    cycles = BenchTimerStop();
+    BenchPrint("refill full pool", cycles, 1, DRBG_POOL_SIZE);
+    pass = pass && (kStatus_Success == status);
+
+    PRINTF("Key masks, %d bytes\r\n", sizeof(uint32_t));
+    BenchTimerStart();
+    for (i = 0; i < BENCH_DRBG_MASKS; i++)
+    {
+        status |= DRBG_GetRandom(HASHCRYPT, &s_benchDrbg, out, sizeof(uint32_t));
+    }
+    cycles = BenchTimerStop();
+    BenchPrint("pool", cycles, BENCH_DRBG_MASKS, BENCH_DRBG_MASKS * sizeof(uint32_t));
+    BenchTimerStart();
+    for (i = 0; i < BENCH_DRBG_MASKS; i++)
+    {
+        status |= DRBG_Generate(HASHCRYPT, &s_benchDrbg, out, sizeof(uint32_t), NULL, 0);
+    }
+    cycles = BenchTimerStop();
+    BenchPrint("generate on demand", cycles, BENCH_DRBG_MASKS, BENCH_DRBG_MASKS * sizeof(uint32_t));
+
+    PRINTF("IVs, %d bytes\r\n", HASHCRYPT_AES_BLOCK_SIZE);
+    BenchTimerStart();
+    for (i = 0; i < BENCH_DRBG_IVS; i++)
+    {
+        status |= DRBG_GetRandom(HASHCRYPT, &s_benchDrbg, out, HASHCRYPT_AES_BLOCK_SIZE);
+    }
+    cycles = BenchTimerStop();
+    BenchPrint("pool", cycles, BENCH_DRBG_IVS, BENCH_DRBG_IVS * HASHCRYPT_AES_BLOCK_SIZE);
+    BenchTimerStart();
+    for (i = 0; i < BENCH_DRBG_IVS; i++)
+    {
+        status |= DRBG_Generate(HASHCRYPT, &s_benchDrbg, out, HASHCRYPT_AES_BLOCK_SIZE, NULL, 0);
+    }
+    cycles = BenchTimerStop();
+    BenchPrint("generate on demand", cycles, BENCH_DRBG_IVS, BENCH_DRBG_IVS * HASHCRYPT_AES_BLOCK_SIZE);
+
+    /* more than the rest of the pool, served on demand */
+    BenchTimerStart();
+    status |= DRBG_GetRandom(HASHCRYPT, &s_benchDrbg, out, sizeof(out));
+    cycles = BenchTimerStop();
+    BenchPrint("pool miss, 96 bytes", cycles, 1, sizeof(out));
+
+    BenchTimerStart();
+    status |= DRBG_Refill(HASHCRYPT, &s_benchDrbg);
+    cycles = BenchTimerStop();
+    BenchPrint("refill consumed part", cycles, 1, BENCH_DRBG_MASKS * sizeof(uint32_t) +
+                                                     BENCH_DRBG_IVS * HASHCRYPT_AES_BLOCK_SIZE);
+    pass = pass && (kStatus_Success == status);
+
+    DRBG_GetStats(&s_benchDrbg, &stats, true);
+    PRINTF("  hits %d, misses %d, refills %d, reseeds %d\r\n", stats.hits, stats.misses, stats.refills,
+           stats.reseeds);
+    PRINTF("  status                 %s\r\n", pass ? "PASS" : "FAIL");
+}
+
+void BenchShaUnaligned(void)
+{
+    const uint32_t size = BENCH_BUF_SIZE - 4u;
+    uint8_t ref[32];
+    uint8_t digest[32];
+    uint32_t cycles, o;
+    bool pass = true;
+
+    HASHCRYPT_Init(HASHCRYPT);
+    BenchFill((uint8_t *)s_benchIn, BENCH_BUF_SIZE);
+
+    PRINTF("\r\nSHA-256 of %d bytes, %d block staging windows\r\n", size, HASHCRYPT_SHA_STAGING_BLOCKS);
+    for (o = 0; o < 4u; o++)
+    {
+        /* same message at every offset */
+        memcpy((uint8_t *)s_benchOut + o, s_benchIn, size);
+
+        BenchTimerStart();
+        HASHCRYPT_SHA(HASHCRYPT, kHASHCRYPT_Sha256, (uint8_t *)s_benchOut + o, size, o ? digest : ref, NULL);
+        cycles = BenchTimerStop();
+        PRINTF("offset %d\r\n", o);
+        BenchPrint("HASHCRYPT_SHA", cycles, 1, size);
+        pass = pass && ((o == 0u) || !memcmp(digest, ref, sizeof(ref)));
+    }
+
+    PRINTF("  digests                %s\r\n", pass ? "PASS" : "FAIL");
+}
+
+void BenchAesEtm(void)
+{
+    static const uint32_t sizes[] = {1024u, BENCH_BUF_SIZE};
+    hashcrypt_handle_t handle;
+    uint8_t counter[HASHCRYPT_AES_BLOCK_SIZE];
+    uint8_t lengths[16];
+    uint8_t mac[AES_ETM_MAC_SIZE];
+    uint8_t ref[AES_ETM_MAC_SIZE];
+    uint32_t cycles, n, i;
+    bool pass = true;
+
+    HASHCRYPT_Init(HASHCRYPT);
+    handle.keyType = kHASHCRYPT_UserKey;
+    HASHCRYPT_AES_SetKey(HASHCRYPT, &handle, (const uint8_t *)s_benchKey, sizeof(s_benchKey));
+    HASHCRYPT_HMAC_SetKey(HASHCRYPT, &s_benchHmacKey, s_benchHmacKey1, sizeof(s_benchHmacKey1));
+    BenchFill((uint8_t *)s_benchIn, BENCH_BUF_SIZE);
+
+    PRINTF("\r\nAES-CTR then HMAC-SHA256, two passes\r\n");
+    for (n = 0; n < sizeof(sizes) / sizeof(sizes[0]); n++)
+    {
+        PRINTF("%d bytes\r\n", sizes[n]);
+
+        /* same MAC input as AES_ETM_Encrypt() without AAD: iv || ciphertext || [0]64 || [size * 8]64 */
+        memset(lengths, 0, sizeof(lengths));
+        for (i = 0; i < 4u; i++)
+        {
+            lengths[15u - i] = (uint8_t)((sizes[n] * 8u) >> (8u * i));
+        }
+        BenchTimerStart();
+        memcpy(counter, s_benchIv, sizeof(counter));
+        HASHCRYPT_AES_CryptCtr(HASHCRYPT, &handle, (const uint8_t *)s_benchIn, (uint8_t *)s_benchRef, sizes[n],
+                               counter, NULL, NULL);
+        HASHCRYPT_HMAC_Init(HASHCRYPT, &s_benchHmacCtx, &s_benchHmacKey);
+        HASHCRYPT_HMAC_Update(HASHCRYPT, &s_benchHmacCtx, s_benchIv, sizeof(s_benchIv));
+        HASHCRYPT_HMAC_Update(HASHCRYPT, &s_benchHmacCtx, (const uint8_t *)s_benchRef, sizes[n]);
+        HASHCRYPT_HMAC_Update(HASHCRYPT, &s_benchHmacCtx, lengths, sizeof(lengths));
+        HASHCRYPT_HMAC_Finish(HASHCRYPT, &s_benchHmacCtx, ref, sizeof(ref));
+        cycles = BenchTimerStop();
+        BenchPrint("CryptCtr + HMAC", cycles, 1, sizes[n]);
+
+        BenchTimerStart();
+        AES_ETM_Encrypt(HASHCRYPT, &handle, &s_benchHmacKey, s_benchIv, NULL, 0, (const uint8_t *)s_benchIn,
+                        (uint8_t *)s_benchOut, sizes[n], mac, sizeof(mac));
+        cycles = BenchTimerStop();
+        BenchPrint("AES_ETM_Encrypt", cycles, 1, sizes[n]);
+        pass = pass && !memcmp(mac, ref, sizeof(ref)) && !memcmp(s_benchOut, s_benchRef, sizes[n]);
+
+        BenchTimerStart();
+        pass = pass && (AES_ETM_Decrypt(HASHCRYPT, &handle, &s_benchHmacKey, s_benchIv, NULL, 0,
+                                        (const uint8_t *)s_benchOut, (uint8_t *)s_benchOut, sizes[n], mac,
+                                        sizeof(mac)) == kStatus_Success);
+        cycles = BenchTimerStop();
+        BenchPrint("AES_ETM_Decrypt", cycles, 1, sizes[n]);
+        pass = pass && !memcmp(s_benchOut, s_benchIn, sizes[n]);
+    }
+
+    /* a modified MAC is rejected and the plain text cleared */
+    mac[0] ^= 1u;
+    pass = pass && (AES_ETM_Decrypt(HASHCRYPT, &handle, &s_benchHmacKey, s_benchIv, NULL, 0,
+                                    (const uint8_t *)s_benchRef, (uint8_t *)s_benchOut, BENCH_BUF_SIZE, mac,
+                                    sizeof(mac)) == kStatus_Fail);
+
+    PRINTF("  MAC and round trip     %s\r\n", pass ? "PASS" : "FAIL");
+}
+
+static void BenchPufCallback(PUF_Type *base, puf_handle_t *handle, status_t status, void *userData)
+{
+    s_benchPufStatus = status;
+    s_benchPufDone = true;
+}
+
+void BenchPufAsync(const uint8_t *keyCode, size_t keyCodeSize, size_t keySize)
+{
+    uint32_t key[2][16];
+    uint8_t digest[2][32];
+    size_t digestSize;
+    uint32_t cycles, idle;
+    bool pass = true;
+
+    HASHCRYPT_Init(HASHCRYPT);
+    BenchFill((uint8_t *)s_benchIn, BENCH_BUF_SIZE);
+    PUF_SetCallback(PUF, &s_benchPuf, BenchPufCallback, NULL);
+
+    PRINTF("\r\nPUF get key (%d bytes) and SHA-256 of %d bytes\r\n", keySize, BENCH_BUF_SIZE);
+
+    /* one after the other, the CPU polls the PUF */
+    BenchTimerStart();
+    pass = pass && (PUF_GetKey(PUF, keyCode, keyCodeSize, (uint8_t *)key[0], keySize) == kStatus_Success);
+    digestSize = sizeof(digest[0]);
+    HASHCRYPT_SHA(HASHCRYPT, kHASHCRYPT_Sha256, (const uint8_t *)s_benchIn, BENCH_BUF_SIZE, digest[0], &digestSize);
+    cycles = BenchTimerStop();
+    BenchPrint("blocking", cycles, 1, BENCH_BUF_SIZE);
+
+    /* the PUF isr serves the key code and key words while the CPU hashes */
+    s_benchPufDone = false;
+    idle = 0;
+    BenchTimerStart();
+    pass = pass && (PUF_GetKeyNonBlocking(PUF, &s_benchPuf, keyCode, keyCodeSize, (uint8_t *)key[1], keySize) ==
+                    kStatus_Success);
+    digestSize = sizeof(digest[1]);
+    HASHCRYPT_SHA(HASHCRYPT, kHASHCRYPT_Sha256, (const uint8_t *)s_benchIn, BENCH_BUF_SIZE, digest[1], &digestSize);
+    while (pass && !s_benchPufDone)
+    {
+        idle++;
+    }
+    cycles = BenchTimerStop();
+    BenchPrint("non-blocking", cycles, 1, BENCH_BUF_SIZE);
+    PRINTF("  wait after hashing     %8d loops\r\n", idle);
+
+    pass = pass && (s_benchPufStatus == kStatus_Success) && !memcmp(key[0], key[1], keySize) &&
+           !memcmp(digest[0], digest[1], sizeof(digest[0]));
+    memset(key, 0, sizeof(key));
+
+    PRINTF("  key and digest         %s\r\n", pass ? "PASS" : "FAIL");
+}
+
+void BenchPufBatch(const uint8_t *keyCode, size_t keyCodeSize, size_t keySize)
+{
+    static const uint32_t counts[] = {1u, 4u, kPUF_KeyIndexMax};
+    const size_t codeSize = PUF_GET_KEY_CODE_SIZE_FOR_KEY_SIZE(BENCH_PUF_KEY_SIZE);
+    uint8_t *out = (uint8_t *)s_benchOut;
+    uint8_t *ref = (uint8_t *)s_benchRef;
+    uint32_t cycles, n, i;
+    bool pass = true;
+
+    PRINTF("\r\nPUF get key (%d bytes), per-call vs. batch\r\n", keySize);
+    for (n = 0; n < sizeof(counts) / sizeof(counts[0]); n++)
+    {
+        PRINTF("%d keys\r\n", counts[n]);
+
+        BenchTimerStart();
+        for (i = 0; i < counts[n]; i++)
+        {
+            pass = pass && (PUF_GetKey(PUF, keyCode, keyCodeSize, &ref[i * 64u], keySize) == kStatus_Success);
+        }
+        cycles = BenchTimerStop();
+        BenchPrint("per-call", cycles, counts[n], counts[n] * keySize);
+
+        for (i = 0; i < counts[n]; i++)
+        {
+            s_benchPufGet[i].keyCode = keyCode;
+            s_benchPufGet[i].keyCodeSize = keyCodeSize;
+            s_benchPufGet[i].key = &out[i * 64u];
+            s_benchPufGet[i].keySize = keySize;
+        }
+        BenchTimerStart();
+        pass = pass && (PUF_GetKeys(PUF, s_benchPufGet, counts[n]) == kStatus_Success);
+        cycles = BenchTimerStop();
+        BenchPrint("batch", cycles, counts[n], counts[n] * keySize);
+
+        for (i = 0; i < counts[n]; i++)
+        {
+            pass = pass && !memcmp(&out[i * 64u], &ref[i * 64u], keySize);
+        }
+    }
+    memset(s_benchOut, 0, BENCH_BUF_SIZE);
+    memset(s_benchRef, 0, BENCH_BUF_SIZE);
+    PRINTF("  keys                   %s\r\n", pass ? "PASS" : "FAIL");
+
+    if (!PUF_IsGetKeyAllowed(PUF) || (0x0u == (PUF->ALLOW & PUF_ALLOW_ALLOWSETKEY_MASK)))
+    {
+        PRINTF("\r\nSet key not allowed, key generation skipped\r\n");
+        return;
+    }
+
+    /* the generated key codes are thrown away, each command yields a new key anyway */
+    pass = true;
+    PRINTF("\r\nPUF set intrinsic key (%d bytes), per-call vs. batch\r\n", BENCH_PUF_KEY_SIZE);
+    for (n = 0; n < sizeof(counts) / sizeof(counts[0]); n++)
+    {
+        PRINTF("%d keys\r\n", counts[n]);
+
+        BenchTimerStart();
+        for (i = 0; i < counts[n]; i++)
+        {
+            pass = pass && (PUF_SetIntrinsicKey(PUF, (puf_key_index_register_t)(kPUF_KeyIndex_01 + i),
+                                                BENCH_PUF_KEY_SIZE, &ref[i * codeSize], codeSize) == kStatus_Success);
+        }
+        cycles = BenchTimerStop();
+        BenchPrint("per-call", cycles, counts[n], counts[n] * BENCH_PUF_KEY_SIZE);
+
+        for (i = 0; i < counts[n]; i++)
+        {
+            s_benchPufSet[i].keyIndex = (puf_key_index_register_t)(kPUF_KeyIndex_01 + i);
+            s_benchPufSet[i].keySize = BENCH_PUF_KEY_SIZE;
+            s_benchPufSet[i].keyCode = &out[i * codeSize];
+            s_benchPufSet[i].keyCodeSize = codeSize;
+        }
+        BenchTimerStart();
+        pass = pass && (PUF_SetIntrinsicKeys(PUF, s_benchPufSet, counts[n]) == kStatus_Success);
+        cycles = BenchTimerStop();
+        BenchPrint("batch", cycles, counts[n], counts[n] * BENCH_PUF_KEY_SIZE);
+    }
+    PRINTF("  key codes              %s\r\n", pass ? "PASS" : "FAIL");
+}
+
+void BenchKeystore(const uint8_t *rootKeyCode, size_t rootKeyCodeSize)
+{
+    uint8_t label[] = "bench key 00";
+    uint32_t key[2][KEYSTORE_CACHE_KEY_SIZE / sizeof(uint32_t)];
+    keystore_stats_t stats;
+    uint32_t cycles, i;
+    bool pass;
+
+    HASHCRYPT_Init(HASHCRYPT);
+
+    PRINTF("\r\nKey hierarchy, %d labeled %d byte keys from one PUF root key\r\n", BENCH_KEYSTORE_KEYS,
+           KEYSTORE_CACHE_KEY_SIZE);
+
+    /* what each key costs with one key code per key */
+    BenchTimerStart();
+    pass = (PUF_GetKey(PUF, rootKeyCode, rootKeyCodeSize, (uint8_t *)key[0], sizeof(key[0])) == kStatus_Success);
+    cycles = BenchTimerStop();
+    BenchPrint("PUF get key", cycles, 1, sizeof(key[0]));
+
+    BenchTimerStart();
+    pass = pass && (KEYSTORE_Init(HASHCRYPT, PUF, &s_benchKeystore, rootKeyCode, rootKeyCodeSize, NULL, 0) ==
+                    kStatus_Success);
+    cycles = BenchTimerStop();
+    BenchPrint("init, once per boot", cycles, 1, KEYSTORE_ROOT_KEY_SIZE);
+
+    BenchTimerStart();
+    for (i = 0; i < BENCH_KEYSTORE_KEYS; i++)
+    {
+        label[sizeof(label) - 3u] = (uint8_t)('0' + i / 10u);
+        label[sizeof(label) - 2u] = (uint8_t)('0' + i % 10u);
+        pass = pass && (KEYSTORE_GetKey(HASHCRYPT, &s_benchKeystore, label, sizeof(label) - 1u, (uint8_t *)key[0],
+                                        sizeof(key[0])) == kStatus_Success);
+    }
+    cycles = BenchTimerStop();
+    BenchPrint("derive", cycles, BENCH_KEYSTORE_KEYS, BENCH_KEYSTORE_KEYS * sizeof(key[0]));
+
+    /* the last keys derived are still in RAM */
+    BenchTimerStart();
+    for (i = BENCH_KEYSTORE_KEYS - BENCH_KEYSTORE_HOT; i < BENCH_KEYSTORE_KEYS; i++)
+    {
+        label[sizeof(label) - 3u] = (uint8_t)('0' + i / 10u);
+        label[sizeof(label) - 2u] = (uint8_t)('0' + i % 10u);
+        pass = pass && (KEYSTORE_GetKey(HASHCRYPT, &s_benchKeystore, label, sizeof(label) - 1u, (uint8_t *)key[0],
+                                        sizeof(key[0])) == kStatus_Success);
+    }
+    cycles = BenchTimerStop();
+    BenchPrint("from RAM", cycles, BENCH_KEYSTORE_HOT, BENCH_KEYSTORE_HOT * sizeof(key[0]));
+
+    /* a key dropped from RAM is derived again to the same value */
+    KEYSTORE_Evict(&s_benchKeystore, label, sizeof(label) - 1u);
+    pass = pass && (KEYSTORE_GetKey(HASHCRYPT, &s_benchKeystore, label, sizeof(label) - 1u, (uint8_t *)key[1],
+                                    sizeof(key[1])) == kStatus_Success);
+    pass = pass && !memcmp(key[0], key[1], sizeof(key[0]));
+
+    KEYSTORE_GetStats(&s_benchKeystore, &stats, true);
+    PRINTF("  hits %d, misses %d, evictions %d\r\n", stats.hits, stats.misses, stats.evictions);
+    PRINTF("  key codes in flash     %d bytes instead of %d\r\n", rootKeyCodeSize,
+           BENCH_KEYSTORE_KEYS * PUF_GET_KEY_CODE_SIZE_FOR_KEY_SIZE(KEYSTORE_CACHE_KEY_SIZE));
+    pass = pass && (stats.hits == BENCH_KEYSTORE_HOT) && (stats.misses == BENCH_KEYSTORE_KEYS + 1u);
+
+    KEYSTORE_Deinit(&s_benchKeystore);
+    memset(key, 0, sizeof(key));
+    PRINTF("  keys                   %s\r\n", pass ? "PASS" : "FAIL");
+}
+
+void BenchPufHwKey(const uint8_t *keyCode, size_t keyCodeSize, uint32_t keyMask)
+{
+    hashcrypt_handle_t handle;
+    uint32_t cycles, i;
+    bool pass = true;
+
+    HASHCRYPT_Init(HASHCRYPT);
+    handle.keyType = kHASHCRYPT_SecretKey;
+    BenchFill((uint8_t *)s_benchIn, HASHCRYPT_AES_BLOCK_SIZE);
+
+    PRINTF("\r\nAES-ECB with the secret key, %d operations, key to AES slot before each\r\n", BENCH_HWKEY_OPS);
+
+    /* the reference loads the key for every operation */
+    BenchTimerStart();
+    for (i = 0; i < BENCH_HWKEY_OPS; i++)
+    {
+        pass = pass && (PUF_GetHwKey(PUF, keyCode, keyCodeSize, kPUF_KeySlot0, keyMask) == kStatus_Success);
+        HASHCRYPT_AES_SetKey(HASHCRYPT, &handle, NULL, 16);
+        HASHCRYPT_AES_EncryptEcb(HASHCRYPT, &handle, (const uint8_t *)s_benchIn, (uint8_t *)&s_benchRef[i * 4u],
+                                 HASHCRYPT_AES_BLOCK_SIZE);
+    }
+    cycles = BenchTimerStop();
+    BenchPrint("get hw key each time", cycles, BENCH_HWKEY_OPS, BENCH_HWKEY_OPS * HASHCRYPT_AES_BLOCK_SIZE);
+
+    /* the tracker knows the key is still in the slot */
+    BenchTimerStart();
+    for (i = 0; i < BENCH_HWKEY_OPS; i++)
+    {
+        pass = pass && (PUF_GetHwKeyCached(PUF, keyCode, keyCodeSize, kPUF_KeySlot0, keyMask) == kStatus_Success);
+        HASHCRYPT_AES_SetKey(HASHCRYPT, &handle, NULL, 16);
+        HASHCRYPT_AES_EncryptEcb(HASHCRYPT, &handle, (const uint8_t *)s_benchIn, (uint8_t *)&s_benchOut[i * 4u],
+                                 HASHCRYPT_AES_BLOCK_SIZE);
+    }
+    cycles = BenchTimerStop();
+    BenchPrint("resident", cycles, BENCH_HWKEY_OPS, BENCH_HWKEY_OPS * HASHCRYPT_AES_BLOCK_SIZE);
+
+    pass = pass && PUF_IsHwKeyResident(PUF, keyCode, keyCodeSize, kPUF_KeySlot0) &&
+           !memcmp(s_benchOut, s_benchRef, BENCH_HWKEY_OPS * HASHCRYPT_AES_BLOCK_SIZE);
+
+    /* once forgotten, the key is loaded again */
+    PUF_InvalidateHwKey(PUF, kPUF_KeySlot0);
+    pass = pass && !PUF_IsHwKeyResident(PUF, keyCode, keyCodeSize, kPUF_KeySlot0) &&
+           (PUF_GetHwKeyCached(PUF, keyCode, keyCodeSize, kPUF_KeySlot0, keyMask) == kStatus_Success) &&
+           PUF_IsHwKeyResident(PUF, keyCode, keyCodeSize, kPUF_KeySlot0);
+
+    PRINTF("  cipher text and slot   %s\r\n", pass ? "PASS" : "FAIL");
+}
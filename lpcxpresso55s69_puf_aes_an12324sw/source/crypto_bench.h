@@ -0,0 +1,175 @@
+/*
+ * Copyright 2026 asvin.io
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _CRYPTO_BENCH_H_
+#define _CRYPTO_BENCH_H_
+
+#include "fsl_common.h"
+
+/*******************************************************************************
+ * API
+ ******************************************************************************/
+
+/*!
+ * @brief Compares HASHCRYPT_AES_ProcessBatch() with one call per message.
+ *
+ * Encrypts records of 16, 32 and 64 bytes with AES-128 ECB and CBC, once by one blocking call per record
+ * and once by a single batch call, checks that both produce the same cipher text and prints
+ * core cycles per record and throughput.
+ */
+void BenchAesBatch(void);
+
+/*!
+ * @brief Measures AES CBC throughput for aligned buffers and buffers at +1 and +2 byte offsets.
+ *
+ * Unaligned input is staged through the driver double buffer, see HASHCRYPT_AES_STAGING_SIZE.
+ */
+void BenchAesUnaligned(void);
+
+/*!
+ * @brief Checks AES-GCM against test vectors and compares table driven GHASH with bitwise GHASH.
+ */
+void BenchAesGcm(void);
+
+/*!
+ * @brief Checks AES-CMAC against RFC 4493 vectors and compares its throughput with CBC encryption.
+ */
+void BenchAesCmac(void);
+
+/*!
+ * @brief Checks AES-CCM against SP 800-38C examples and compares per-record and batch calls.
+ *
+ * Encrypts 16 records of 32, 64, 128 and 256 bytes once by AES_CCM_Encrypt() per record and once by
+ * AES_CCM_EncryptBatch(), then decrypts the batch output with AES_CCM_DecryptBatch().
+ */
+void BenchAesCcm(void);
+
+/*!
+ * @brief Compares single block latency of hashcrypt_handle_t and prepared handle calls.
+ *
+ * Measures ECB encryption with the engine left configured between calls, alternating ECB encryption and
+ * decryption, and CBC encryption, see HASHCRYPT_AES_Prepare().
+ */
+void BenchAesPrepared(void);
+
+/*!
+ * @brief Compares HASHCRYPT with the T-table and bitsliced software AES backends.
+ *
+ * Encrypts the same messages with ECB, CBC and CTR through the HASHCRYPT API, with the handle switched to software
+ * by HASHCRYPT_AES_SetSoftware(), and checks that the outputs are identical.
+ */
+void BenchAesSoft(void);
+
+/*!
+ * @brief Hashes three messages at once with non-blocking SHA-256, each running to completion in turn.
+ *
+ * Starts hashes of part of the firmware image, of the flash following it and of a RAM transcript together,
+ * prints when each completes with its throughput and counters, and checks the digests against HASHCRYPT_SHA().
+ */
+void BenchShaStreams(void);
+
+/*!
+ * @brief Hashes one message passed as a chain of segments of varying size, aligned and unaligned.
+ *
+ * Compares blocking HASHCRYPT_SHA_Update() calls with chained HASHCRYPT_SHA_UpdateNonBlocking() calls and checks
+ * both digests against HASHCRYPT_SHA().
+ */
+void BenchShaSegments(void);
+
+/*!
+ * @brief Checks HMAC-SHA256 against RFC 4231 and measures it on 32-byte messages.
+ *
+ * Compares padding the key for every message with the padded key precomputed by HASHCRYPT_HMAC_SetKey(),
+ * one-shot and incremental. Both hash four blocks per message.
+ */
+void BenchHmac(void);
+
+/*!
+ * @brief Checks HKDF against RFC 5869 and measures deriving 16 subkeys from one root key.
+ *
+ * Compares padding the root key for every subkey with one KDF_DeriveBatch() call, for HKDF-Expand and SP 800-108
+ * counter mode. Both hash four blocks per subkey, the difference is the key padding only.
+ */
+void BenchKdf(void);
+
+/*!
+ * @brief Builds a Merkle tree over the firmware image and measures incremental updates.
+ *
+ * Compares the full build with updates after 1, 4 and 16 pages are marked dirty, and checks that the root does not
+ * change since the flash content does not.
+ */
+void BenchFlashMerkle(void);
+
+/*!
+ * @brief Compares HASHCRYPT SHA-256 with the software SHA-256 and SHA-512 backend.
+ *
+ * Checks SHA-512 against FIPS 180-4 and the software SHA-256 digests against HASHCRYPT_SHA().
+ */
+void BenchShaSoft(void);
+
+/*!
+ * @brief Hashes 4 KB, 64 KB and 512 KB of flash in one blocking call.
+ *
+ * Compares a plain call with one reporting progress and yielding after each chunk, and checks the digests
+ * against the software SHA-256. Sizes covering an erased page are skipped.
+ */
+void BenchShaLarge(void);
+
+/*!
+ * @brief Measures key masks and IVs served from the DRBG pool against generating them on demand.
+ *
+ * Also reports instantiate and refill times and the pool hit and miss counters.
+ */
+void BenchDrbg(void);
+
+/*!
+ * @brief Hashes the same message at word aligned and unaligned addresses.
+ */
+void BenchShaUnaligned(void);
+
+/*!
+ * @brief Times the two pass AES-CTR encrypt-then-MAC helper against the same calls made directly.
+ */
+void BenchAesEtm(void);
+
+/*!
+ * @brief Compares a blocking PUF get key followed by SHA-256 with a non-blocking get key overlapped with SHA-256.
+ *
+ * @param keyCode Word aligned key code of a key index 1 to 15.
+ * @param keyCodeSize Size of keyCode in bytes.
+ * @param keySize Size of the key in bytes, up to 64.
+ */
+void BenchPufAsync(const uint8_t *keyCode, size_t keyCodeSize, size_t keySize);
+
+/*!
+ * @brief Reconstructs and generates 1, 4 and 15 keys with one PUF call per key and with the batch functions.
+ *
+ * @param keyCode Word aligned key code of a key index 1 to 15, reconstructed repeatedly.
+ * @param keyCodeSize Size of keyCode in bytes.
+ * @param keySize Size of the key in bytes, up to 64.
+ */
+void BenchPufBatch(const uint8_t *keyCode, size_t keyCodeSize, size_t keySize);
+
+/*!
+ * @brief Derives labeled keys from a PUF root key, on demand and from the RAM table.
+ *
+ * @param rootKeyCode Word aligned key code of a KEYSTORE_ROOT_KEY_SIZE byte key with key index 1 to 15.
+ * @param rootKeyCodeSize Size of rootKeyCode in bytes.
+ */
+void BenchKeystore(const uint8_t *rootKeyCode, size_t rootKeyCodeSize);
+
+/*!
+ * @brief Compares AES with the secret key reloaded by PUF_GetHwKey() before each operation against
+ * PUF_GetHwKeyCached().
+ *
+ * @param keyCode Word aligned key code of a 128-bit key with key index 0.
+ * @param keyCodeSize Size of keyCode in bytes.
+ * @param keyMask Key mask.
+ */
+void BenchPufHwKey(const uint8_t *keyCode, size_t keyCodeSize, uint32_t keyMask);
+
+#endif /* _CRYPTO_BENCH_H_ */
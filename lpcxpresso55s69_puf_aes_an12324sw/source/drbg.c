@@ -0,0 +1,374 @@
+/*
+ * Copyright 2026 asvin.io
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <string.h>
+#include "fsl_power.h"
+#include "drbg.h"
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+#define DRBG_HASH_SIZE 32u
+
+/* REFRESH_CNT value once the RNG state is entirely refreshed after a read */
+#define DRBG_RNG_REFRESHED 31u
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+static hashcrypt_hash_ctx_t s_drbgCtx;
+static bool s_drbgRngOn;
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+/*!
+ * @brief Adds a big endian number to V modulo 2^440.
+ */
+static void drbg_add(uint8_t *V, const uint8_t *value, size_t size)
+{
+    uint32_t carry = 0;
+    size_t i, j;
+
+    for (i = DRBG_SEED_SIZE, j = size; i > 0u; i--)
+    {
+        if (j > 0u)
+        {
+            carry += value[--j];
+        }
+        carry += V[i - 1u];
+        V[i - 1u] = (uint8_t)carry;
+        carry >>= 8;
+    }
+}
+
+/*!
+ * @brief Hash_df of SP 800-90A, hashes the concatenation of count inputs into DRBG_SEED_SIZE bytes.
+ */
+static status_t drbg_hash_df(HASHCRYPT_Type *base,
+                             const uint8_t *const input[],
+                             const size_t inputSize[],
+                             size_t count,
+                             uint8_t *output)
+{
+    uint8_t header[5] = {1u, 0u, 0u, (uint8_t)((DRBG_SEED_SIZE * 8u) >> 8), (uint8_t)(DRBG_SEED_SIZE * 8u)};
+    uint8_t digest[DRBG_HASH_SIZE];
+    size_t outputSize = sizeof(digest);
+    status_t status = kStatus_Success;
+    size_t done, i;
+
+    /* Hash(counter || no_of_bits_to_return || input) until seedlen bits are produced */
+    for (done = 0; (done < DRBG_SEED_SIZE) && (kStatus_Success == status); done += DRBG_HASH_SIZE, header[0]++)
+    {
+        status = HASHCRYPT_SHA_Init(base, &s_drbgCtx, kHASHCRYPT_Sha256);
+        if (kStatus_Success == status)
+        {
+            status = HASHCRYPT_SHA_Update(base, &s_drbgCtx, header, sizeof(header));
+        }
+        for (i = 0; (i < count) && (kStatus_Success == status); i++)
+        {
+            status = HASHCRYPT_SHA_Update(base, &s_drbgCtx, input[i], inputSize[i]);
+        }
+        if (kStatus_Success == status)
+        {
+            status = HASHCRYPT_SHA_Finish(base, &s_drbgCtx, digest, &outputSize);
+        }
+        memcpy(&output[done], digest, MIN(DRBG_SEED_SIZE - done, sizeof(digest)));
+    }
+    memset(digest, 0, sizeof(digest));
+
+    return status;
+}
+
+/*!
+ * @brief Derives V and C from seed material, common part of instantiate and reseed.
+ */
+static status_t drbg_seed(HASHCRYPT_Type *base,
+                          drbg_t *drbg,
+                          const uint8_t *const input[],
+                          const size_t inputSize[],
+                          size_t count)
+{
+    static const uint8_t zero = 0u;
+    uint8_t seed[DRBG_SEED_SIZE];
+    const uint8_t *cInput[2] = {&zero, seed};
+    const size_t cInputSize[2] = {1u, sizeof(seed)};
+    status_t status;
+
+    status = drbg_hash_df(base, input, inputSize, count, seed);
+    if (kStatus_Success == status)
+    {
+        memcpy(drbg->V, seed, sizeof(seed));
+        status = drbg_hash_df(base, cInput, cInputSize, 2u, drbg->C);
+    }
+    memset(seed, 0, sizeof(seed));
+    drbg->reseedCounter = 1u;
+    drbg->stats.reseeds++;
+
+    return status;
+}
+
+/*!
+ * @brief Reads entropy input from the entropy source and reseeds.
+ */
+static status_t drbg_reseed(HASHCRYPT_Type *base, drbg_t *drbg, const uint8_t *additional, size_t additionalSize)
+{
+    static const uint8_t one = 1u;
+    uint8_t entropy[DRBG_ENTROPY_SIZE];
+    const uint8_t *input[4] = {&one, drbg->V, entropy, additional};
+    const size_t inputSize[4] = {1u, DRBG_SEED_SIZE, sizeof(entropy), additionalSize};
+    status_t status;
+
+    /* seed = Hash_df(0x01 || V || entropy_input || additional_input) */
+    status = drbg->entropy(entropy, sizeof(entropy), drbg->entropyData);
+    if (kStatus_Success == status)
+    {
+        status = drbg_seed(base, drbg, input, inputSize, 4u);
+    }
+    memset(entropy, 0, sizeof(entropy));
+
+    return status;
+}
+
+status_t DRBG_Init(HASHCRYPT_Type *base,
+                   drbg_t *drbg,
+                   drbg_entropy_t entropy,
+                   void *userData,
+                   const uint8_t *personalization,
+                   size_t personalizationSize)
+{
+    uint8_t seedMaterial[DRBG_ENTROPY_SIZE + DRBG_NONCE_SIZE];
+    const uint8_t *input[2] = {seedMaterial, personalization};
+    const size_t inputSize[2] = {sizeof(seedMaterial), personalizationSize};
+    status_t status;
+
+    if ((NULL == drbg) || (NULL == entropy) || ((NULL == personalization) && (personalizationSize > 0u)))
+    {
+        return kStatus_InvalidArgument;
+    }
+
+    memset(drbg, 0, sizeof(*drbg));
+    drbg->entropy = entropy;
+    drbg->entropyData = userData;
+    drbg->poolPos = DRBG_POOL_SIZE;
+
+    /* seed = Hash_df(entropy_input || nonce || personalization_string) */
+    status = entropy(seedMaterial, sizeof(seedMaterial), userData);
+    if (kStatus_Success == status)
+    {
+        status = drbg_seed(base, drbg, input, inputSize, 2u);
+    }
+    memset(seedMaterial, 0, sizeof(seedMaterial));
+    if (kStatus_Success != status)
+    {
+        memset(drbg->V, 0, sizeof(drbg->V));
+        memset(drbg->C, 0, sizeof(drbg->C));
+    }
+
+    return status;
+}
+
+status_t DRBG_Reseed(HASHCRYPT_Type *base, drbg_t *drbg, const uint8_t *additional, size_t additionalSize)
+{
+    if ((NULL == drbg) || (NULL == drbg->entropy) || ((NULL == additional) && (additionalSize > 0u)))
+    {
+        return kStatus_InvalidArgument;
+    }
+
+    return drbg_reseed(base, drbg, additional, additionalSize);
+}
+
+status_t DRBG_Generate(HASHCRYPT_Type *base,
+                       drbg_t *drbg,
+                       uint8_t *output,
+                       size_t size,
+                       const uint8_t *additional,
+                       size_t additionalSize)
+{
+    static const uint8_t one = 1u;
+    static const uint8_t two = 2u;
+    static const uint8_t three = 3u;
+    uint8_t data[DRBG_SEED_SIZE];
+    uint8_t digest[DRBG_HASH_SIZE];
+    uint8_t counter[4];
+    size_t outputSize = sizeof(digest);
+    status_t status = kStatus_Success;
+    size_t done, chunk;
+
+    if ((NULL == drbg) || (NULL == drbg->entropy) || (NULL == output) || (size == 0u) ||
+        (size > DRBG_MAX_REQUEST_SIZE) || ((NULL == additional) && (additionalSize > 0u)))
+    {
+        return kStatus_InvalidArgument;
+    }
+
+    if (drbg->reseedCounter > DRBG_RESEED_INTERVAL)
+    {
+        /* the additional input is used by the reseed and not again below */
+        status = drbg_reseed(base, drbg, additional, additionalSize);
+        additionalSize = 0;
+    }
+
+    /* V = V + Hash(0x02 || V || additional_input) */
+    if ((kStatus_Success == status) && (additionalSize > 0u))
+    {
+        status = HASHCRYPT_SHA_Init(base, &s_drbgCtx, kHASHCRYPT_Sha256);
+        if (kStatus_Success == status)
+        {
+            status = HASHCRYPT_SHA_Update(base, &s_drbgCtx, &two, 1u);
+        }
+        if (kStatus_Success == status)
+        {
+            status = HASHCRYPT_SHA_Update(base, &s_drbgCtx, drbg->V, DRBG_SEED_SIZE);
+        }
+        if (kStatus_Success == status)
+        {
+            status = HASHCRYPT_SHA_Update(base, &s_drbgCtx, additional, additionalSize);
+        }
+        if (kStatus_Success == status)
+        {
+            status = HASHCRYPT_SHA_Finish(base, &s_drbgCtx, digest, &outputSize);
+            drbg_add(drbg->V, digest, sizeof(digest));
+        }
+    }
+
+    /* Hashgen, one compression block per 32 output bytes since data fits one block */
+    memcpy(data, drbg->V, sizeof(data));
+    for (done = 0; (done < size) && (kStatus_Success == status); done += chunk)
+    {
+        chunk = MIN(size - done, sizeof(digest));
+        outputSize = sizeof(digest);
+        if (chunk == sizeof(digest))
+        {
+            status = HASHCRYPT_SHA(base, kHASHCRYPT_Sha256, data, sizeof(data), &output[done], &outputSize);
+        }
+        else
+        {
+            status = HASHCRYPT_SHA(base, kHASHCRYPT_Sha256, data, sizeof(data), digest, &outputSize);
+            memcpy(&output[done], digest, chunk);
+        }
+        drbg_add(data, &one, 1u);
+    }
+
+    /* V = V + Hash(0x03 || V) + C + reseed_counter */
+    if (kStatus_Success == status)
+    {
+        status = HASHCRYPT_SHA_Init(base, &s_drbgCtx, kHASHCRYPT_Sha256);
+    }
+    if (kStatus_Success == status)
+    {
+        status = HASHCRYPT_SHA_Update(base, &s_drbgCtx, &three, 1u);
+    }
+    if (kStatus_Success == status)
+    {
+        status = HASHCRYPT_SHA_Update(base, &s_drbgCtx, drbg->V, DRBG_SEED_SIZE);
+    }
+    if (kStatus_Success == status)
+    {
+        outputSize = sizeof(digest);
+        status = HASHCRYPT_SHA_Finish(base, &s_drbgCtx, digest, &outputSize);
+    }
+    if (kStatus_Success == status)
+    {
+        counter[0] = (uint8_t)(drbg->reseedCounter >> 24);
+        counter[1] = (uint8_t)(drbg->reseedCounter >> 16);
+        counter[2] = (uint8_t)(drbg->reseedCounter >> 8);
+        counter[3] = (uint8_t)drbg->reseedCounter;
+        drbg_add(drbg->V, digest, sizeof(digest));
+        drbg_add(drbg->V, drbg->C, DRBG_SEED_SIZE);
+        drbg_add(drbg->V, counter, sizeof(counter));
+        drbg->reseedCounter++;
+    }
+    memset(data, 0, sizeof(data));
+    memset(digest, 0, sizeof(digest));
+
+    if (kStatus_Success != status)
+    {
+        memset(output, 0, size);
+    }
+
+    return status;
+}
+
+status_t DRBG_GetRandom(HASHCRYPT_Type *base, drbg_t *drbg, uint8_t *output, size_t size)
+{
+    if ((NULL == drbg) || (NULL == output) || (size == 0u) || (size > DRBG_MAX_REQUEST_SIZE))
+    {
+        return kStatus_InvalidArgument;
+    }
+
+    if (size > (DRBG_POOL_SIZE - drbg->poolPos))
+    {
+        drbg->stats.misses++;
+        return DRBG_Generate(base, drbg, output, size, NULL, 0);
+    }
+
+    /* consumed bytes are cleared, so the pool never holds output that was handed out */
+    memcpy(output, &drbg->pool[drbg->poolPos], size);
+    memset(&drbg->pool[drbg->poolPos], 0, size);
+    drbg->poolPos += size;
+    drbg->stats.hits++;
+
+    return kStatus_Success;
+}
+
+status_t DRBG_Refill(HASHCRYPT_Type *base, drbg_t *drbg)
+{
+    status_t status;
+
+    if (NULL == drbg)
+    {
+        return kStatus_InvalidArgument;
+    }
+    if (drbg->poolPos == 0u)
+    {
+        return kStatus_Success;
+    }
+
+    /* the unconsumed bytes stay at the end, pool bytes are independent so their order does not matter */
+    status = DRBG_Generate(base, drbg, drbg->pool, drbg->poolPos, NULL, 0);
+    if (kStatus_Success == status)
+    {
+        drbg->poolPos = 0;
+        drbg->stats.refills++;
+    }
+
+    return status;
+}
+
+void DRBG_GetStats(drbg_t *drbg, drbg_stats_t *stats, bool clear)
+{
+    *stats = drbg->stats;
+    if (clear)
+    {
+        memset(&drbg->stats, 0, sizeof(drbg->stats));
+    }
+}
+
+status_t DRBG_EntropyRng(uint8_t *entropy, size_t size, void *userData)
+{
+    uint32_t word;
+    size_t i;
+
+    if (!s_drbgRngOn)
+    {
+        POWER_DisablePD(kPDRUNCFG_PD_RNG);
+        CLOCK_EnableClock(kCLOCK_Rng);
+        s_drbgRngOn = true;
+    }
+
+    for (i = 0; i < size; i += sizeof(word))
+    {
+        while (((RNG->COUNTER_VAL & RNG_COUNTER_VAL_REFRESH_CNT_MASK) >> RNG_COUNTER_VAL_REFRESH_CNT_SHIFT) <
+               DRBG_RNG_REFRESHED)
+        {
+        }
+        word = RNG->RANDOM_NUMBER;
+        memcpy(&entropy[i], &word, MIN(size - i, sizeof(word)));
+    }
+    word = 0;
+
+    return kStatus_Success;
+}
@@ -0,0 +1,182 @@
+/*
+ * Copyright 2026 asvin.io
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _DRBG_H_
+#define _DRBG_H_
+
+#include "fsl_common.h"
+#include "fsl_hashcrypt.h"
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+
+/*! @brief Size of V and C in bytes, seedlen of Hash_DRBG with SHA-256 (440 bits). */
+#define DRBG_SEED_SIZE 55u
+
+/*! @brief Entropy input requested from the entropy source at instantiate and reseed, in bytes. */
+#define DRBG_ENTROPY_SIZE 32u
+
+/*! @brief Nonce requested from the entropy source at instantiate, in bytes. */
+#define DRBG_NONCE_SIZE 16u
+
+/*! @brief Maximum number of bytes of one DRBG_Generate() request, 2^19 bits. */
+#define DRBG_MAX_REQUEST_SIZE 65536u
+
+/*! @brief Size of the pool of pre-generated output in bytes. */
+#ifndef DRBG_POOL_SIZE
+#define DRBG_POOL_SIZE 256u
+#endif
+
+/*! @brief Number of generate requests after which the DRBG reseeds from the entropy source. */
+#ifndef DRBG_RESEED_INTERVAL
+#define DRBG_RESEED_INTERVAL 4096u
+#endif
+
+/*!
+ * @brief Entropy source.
+ *
+ * @param[out] entropy Output entropy.
+ * @param size Number of bytes requested.
+ * @param userData User data passed to DRBG_Init().
+ * @return kStatus_Success or an error status, which is returned by the DRBG function that needed the entropy.
+ */
+typedef status_t (*drbg_entropy_t)(uint8_t *entropy, size_t size, void *userData);
+
+/*! @brief DRBG counters. */
+typedef struct _drbg_stats
+{
+    uint32_t hits;    /*!< DRBG_GetRandom() requests served from the pool */
+    uint32_t misses;  /*!< DRBG_GetRandom() requests larger than the pool content, generated on demand */
+    uint32_t refills; /*!< DRBG_Refill() calls that generated output */
+    uint32_t reseeds; /*!< Reseeds from the entropy source, including the one of DRBG_Init() */
+} drbg_stats_t;
+
+/*! @brief Hash_DRBG state with its output pool. */
+typedef struct _drbg
+{
+    uint8_t V[DRBG_SEED_SIZE];    /*!< Working state V */
+    uint8_t C[DRBG_SEED_SIZE];    /*!< Working state C */
+    uint32_t reseedCounter;       /*!< Generate requests since the last reseed, plus one */
+    drbg_entropy_t entropy;       /*!< Entropy source */
+    void *entropyData;            /*!< User data of the entropy source */
+    uint8_t pool[DRBG_POOL_SIZE]; /*!< Pre-generated output, bytes below poolPos are consumed and cleared */
+    uint32_t poolPos;             /*!< Index of the first unconsumed pool byte */
+    drbg_stats_t stats;           /*!< Counters */
+} drbg_t;
+
+/*******************************************************************************
+ * API
+ ******************************************************************************/
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/*!
+ * @brief Instantiates a Hash_DRBG with SHA-256 (NIST SP 800-90A).
+ *
+ * Entropy input and nonce are read from the entropy source. The pool is empty until DRBG_Refill() is called.
+ *
+ * @param base HASHCRYPT peripheral base address.
+ * @param[out] drbg DRBG state.
+ * @param entropy Entropy source.
+ * @param userData User data passed to the entropy source.
+ * @param personalization Personalization string, for example the device UID. Can be NULL if personalizationSize is 0.
+ * @param personalizationSize Size of personalization in bytes.
+ * @return kStatus_Success, kStatus_InvalidArgument, status of the entropy source or of the hash functions.
+ */
+status_t DRBG_Init(HASHCRYPT_Type *base,
+                   drbg_t *drbg,
+                   drbg_entropy_t entropy,
+                   void *userData,
+                   const uint8_t *personalization,
+                   size_t personalizationSize);
+
+/*!
+ * @brief Reseeds the DRBG from its entropy source.
+ *
+ * @param base HASHCRYPT peripheral base address.
+ * @param[in,out] drbg DRBG state.
+ * @param additional Additional input. Can be NULL if additionalSize is 0.
+ * @param additionalSize Size of additional in bytes.
+ * @return kStatus_Success, kStatus_InvalidArgument, status of the entropy source or of the hash functions.
+ */
+status_t DRBG_Reseed(HASHCRYPT_Type *base, drbg_t *drbg, const uint8_t *additional, size_t additionalSize);
+
+/*!
+ * @brief Generates output directly, bypassing the pool.
+ *
+ * Reseeds first when DRBG_RESEED_INTERVAL requests were served since the last reseed.
+ *
+ * @param base HASHCRYPT peripheral base address.
+ * @param[in,out] drbg DRBG state.
+ * @param[out] output Output random bytes.
+ * @param size Size of output in bytes, 1 to DRBG_MAX_REQUEST_SIZE.
+ * @param additional Additional input. Can be NULL if additionalSize is 0.
+ * @param additionalSize Size of additional in bytes.
+ * @return kStatus_Success, kStatus_InvalidArgument, status of the entropy source or of the hash functions.
+ */
+status_t DRBG_Generate(HASHCRYPT_Type *base,
+                       drbg_t *drbg,
+                       uint8_t *output,
+                       size_t size,
+                       const uint8_t *additional,
+                       size_t additionalSize);
+
+/*!
+ * @brief Gets random bytes for masks, IVs and nonces.
+ *
+ * A request that the pool can hold is copied from RAM without using HASHCRYPT, and the copied pool bytes are
+ * cleared. A larger request is generated on demand and counted as a miss. The pool is not refilled here.
+ *
+ * @param base HASHCRYPT peripheral base address, used on a miss only.
+ * @param[in,out] drbg DRBG state.
+ * @param[out] output Output random bytes.
+ * @param size Size of output in bytes, 1 to DRBG_MAX_REQUEST_SIZE.
+ * @return kStatus_Success, kStatus_InvalidArgument or status of DRBG_Generate().
+ */
+status_t DRBG_GetRandom(HASHCRYPT_Type *base, drbg_t *drbg, uint8_t *output, size_t size);
+
+/*!
+ * @brief Refills the consumed part of the pool with a single generate request.
+ *
+ * Meant to be called while the application is idle, so that DRBG_GetRandom() finds the pool full.
+ *
+ * @param base HASHCRYPT peripheral base address.
+ * @param[in,out] drbg DRBG state.
+ * @return kStatus_Success, kStatus_InvalidArgument or status of DRBG_Generate().
+ */
+status_t DRBG_Refill(HASHCRYPT_Type *base, drbg_t *drbg);
+
+/*!
+ * @brief Entropy source reading the RNG peripheral.
+ *
+ * Powers and clocks the RNG on first use. Each 32-bit word is read once the RNG has refreshed its whole state
+ * since the previous read.
+ *
+ * @param[out] entropy Output entropy.
+ * @param size Number of bytes requested.
+ * @param userData Unused, can be NULL.
+ * @return kStatus_Success.
+ */
+status_t DRBG_EntropyRng(uint8_t *entropy, size_t size, void *userData);
+
+/*!
+ * @brief Gets the DRBG counters.
+ *
+ * @param drbg DRBG state.
+ * @param[out] stats Counters.
+ * @param clear Clears the counters after reading when true.
+ */
+void DRBG_GetStats(drbg_t *drbg, drbg_stats_t *stats, bool clear);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* _DRBG_H_ */
@@ -0,0 +1,207 @@
+/*
+ * Copyright 2026 asvin.io
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <string.h>
+#include "flash_merkle.h"
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+#if (FLASH_MERKLE_MAX_PAGES == 0) || (FLASH_MERKLE_MAX_PAGES & (FLASH_MERKLE_MAX_PAGES - 1))
+#error "FLASH_MERKLE_MAX_PAGES shall be a power of two"
+#endif
+
+#define FLASH_MERKLE_IS_DIRTY(tree, i) (((tree)->dirty[(i) / 32u] >> ((i) % 32u)) & 1u)
+#define FLASH_MERKLE_SET_DIRTY(tree, i) ((tree)->dirty[(i) / 32u] |= (1u << ((i) % 32u)))
+#define FLASH_MERKLE_CLR_DIRTY(tree, i) ((tree)->dirty[(i) / 32u] &= ~(1u << ((i) % 32u)))
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+static const uint8_t s_merkleErased[FLASH_MERKLE_DIGEST_SIZE] = {0};
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+/*!
+ * @brief Clips a range to the region, returns false if they do not overlap.
+ */
+static bool flash_merkle_pages(
+    const flash_merkle_t *tree, uint32_t start, uint32_t lengthInBytes, uint32_t *first, uint32_t *last)
+{
+    uint32_t end = tree->start + tree->pageCount * tree->pageSize;
+
+    if ((lengthInBytes == 0u) || (start >= end) || (start + lengthInBytes <= tree->start))
+    {
+        return false;
+    }
+
+    *first = (MAX(start, tree->start) - tree->start) / tree->pageSize;
+    *last = (MIN(start + lengthInBytes, end) - 1u - tree->start) / tree->pageSize;
+
+    return true;
+}
+
+/*!
+ * @brief Hashes one page. Erased pages are not read, reading them raises an ECC fault.
+ */
+static status_t flash_merkle_hash_page(HASHCRYPT_Type *base,
+                                       const flash_merkle_t *tree,
+                                       uint32_t page,
+                                       uint8_t digest[FLASH_MERKLE_DIGEST_SIZE])
+{
+    uint32_t addr = tree->start + page * tree->pageSize;
+
+    if (kStatus_FLASH_Success == FLASH_VerifyErase(tree->flash, addr, tree->pageSize))
+    {
+        return HASHCRYPT_SHA(base, kHASHCRYPT_Sha256, s_merkleErased, sizeof(s_merkleErased), digest, NULL);
+    }
+
+    return HASHCRYPT_SHA(base, kHASHCRYPT_Sha256, (const uint8_t *)addr, tree->pageSize, digest, NULL);
+}
+
+status_t FLASH_MERKLE_Init(flash_merkle_t *tree, flash_config_t *config, uint32_t start, uint32_t size)
+{
+    uint32_t pageSize = 0;
+    status_t status;
+
+    if ((NULL == tree) || (NULL == config))
+    {
+        return kStatus_InvalidArgument;
+    }
+
+    status = FLASH_GetProperty(config, kFLASH_PropertyPflashPageSize, &pageSize);
+    if (kStatus_FLASH_Success != status)
+    {
+        return status;
+    }
+    if ((pageSize == 0u) || (start % pageSize) || (size == 0u) || (size % pageSize) ||
+        (size / pageSize > FLASH_MERKLE_MAX_PAGES))
+    {
+        return kStatus_InvalidArgument;
+    }
+
+    memset(tree, 0, sizeof(*tree));
+    tree->flash = config;
+    tree->start = start;
+    tree->pageSize = pageSize;
+    tree->pageCount = size / pageSize;
+    for (tree->leaves = 1u; tree->leaves < tree->pageCount; tree->leaves <<= 1)
+    {
+    }
+
+    /* every node dirty, leaves past the region keep the zero digest */
+    for (uint32_t i = 1; i < tree->leaves + tree->pageCount; i++)
+    {
+        FLASH_MERKLE_SET_DIRTY(tree, i);
+    }
+
+    return kStatus_Success;
+}
+
+void FLASH_MERKLE_MarkDirty(flash_merkle_t *tree, uint32_t start, uint32_t lengthInBytes)
+{
+    uint32_t first, last;
+
+    if (flash_merkle_pages(tree, start, lengthInBytes, &first, &last))
+    {
+        for (uint32_t p = first; p <= last; p++)
+        {
+            FLASH_MERKLE_SET_DIRTY(tree, tree->leaves + p);
+        }
+    }
+}
+
+status_t FLASH_MERKLE_Erase(flash_merkle_t *tree, uint32_t start, uint32_t lengthInBytes, uint32_t key)
+{
+    status_t status = FLASH_Erase(tree->flash, start, lengthInBytes, key);
+
+    /* a failed command may have changed part of the range too */
+    FLASH_MERKLE_MarkDirty(tree, start, lengthInBytes);
+
+    return status;
+}
+
+status_t FLASH_MERKLE_Program(flash_merkle_t *tree, uint32_t start, uint8_t *src, uint32_t lengthInBytes)
+{
+    status_t status = FLASH_Program(tree->flash, start, src, lengthInBytes);
+
+    FLASH_MERKLE_MarkDirty(tree, start, lengthInBytes);
+
+    return status;
+}
+
+status_t FLASH_MERKLE_Update(HASHCRYPT_Type *base, flash_merkle_t *tree, uint8_t root[FLASH_MERKLE_DIGEST_SIZE])
+{
+    status_t status = kStatus_Success;
+    uint32_t i;
+
+    tree->hashed = 0;
+
+    /* children have higher indexes than their parent, so one descending pass rehashes bottom up */
+    for (i = tree->leaves + tree->pageCount - 1u; (i > 0u) && (kStatus_Success == status); i--)
+    {
+        if (!FLASH_MERKLE_IS_DIRTY(tree, i))
+        {
+            continue;
+        }
+
+        if (i >= tree->leaves)
+        {
+            status = flash_merkle_hash_page(base, tree, i - tree->leaves, tree->node[i]);
+        }
+        else
+        {
+            /* children are adjacent, 2i and 2i+1 */
+            status = HASHCRYPT_SHA(base, kHASHCRYPT_Sha256, tree->node[2u * i], 2u * FLASH_MERKLE_DIGEST_SIZE,
+                                   tree->node[i], NULL);
+        }
+
+        if (kStatus_Success == status)
+        {
+            tree->hashed++;
+            FLASH_MERKLE_CLR_DIRTY(tree, i);
+            FLASH_MERKLE_SET_DIRTY(tree, i / 2u);
+        }
+    }
+
+    /* bit 0 collects the parent of the root */
+    FLASH_MERKLE_CLR_DIRTY(tree, 0u);
+
+    if ((kStatus_Success == status) && (NULL != root))
+    {
+        memcpy(root, tree->node[1], FLASH_MERKLE_DIGEST_SIZE);
+    }
+
+    return status;
+}
+
+status_t FLASH_MERKLE_VerifyPages(HASHCRYPT_Type *base, flash_merkle_t *tree, uint32_t start, uint32_t lengthInBytes)
+{
+    uint8_t digest[FLASH_MERKLE_DIGEST_SIZE];
+    status_t status = kStatus_Success;
+    uint32_t first, last;
+
+    if (!flash_merkle_pages(tree, start, lengthInBytes, &first, &last))
+    {
+        return kStatus_Success;
+    }
+
+    for (uint32_t p = first; (p <= last) && (kStatus_Success == status); p++)
+    {
+        if (FLASH_MERKLE_IS_DIRTY(tree, tree->leaves + p))
+        {
+            continue;
+        }
+        status = flash_merkle_hash_page(base, tree, p, digest);
+        if ((kStatus_Success == status) && memcmp(digest, tree->node[tree->leaves + p], sizeof(digest)))
+        {
+            status = kStatus_Fail;
+        }
+    }
+
+    return status;
+}
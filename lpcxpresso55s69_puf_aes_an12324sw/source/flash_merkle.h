@@ -0,0 +1,129 @@
+/*
+ * Copyright 2026 asvin.io
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _FLASH_MERKLE_H_
+#define _FLASH_MERKLE_H_
+
+#include "fsl_common.h"
+#include "fsl_hashcrypt.h"
+#include "fsl_iap.h"
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+
+/*! @brief Maximum number of flash pages covered by one tree, a power of two. 64 pages of 512 bytes use 4 KB. */
+#ifndef FLASH_MERKLE_MAX_PAGES
+#define FLASH_MERKLE_MAX_PAGES 64
+#endif
+
+#define FLASH_MERKLE_DIGEST_SIZE 32
+#define FLASH_MERKLE_NODES (2 * FLASH_MERKLE_MAX_PAGES)
+
+/*!
+ * @brief Merkle tree of SHA-256 digests over a flash region.
+ *
+ * Nodes are stored heap ordered: node 1 is the root, children of node i are 2i and 2i+1 and the digest of page p
+ * is node leaves + p. A leaf is the SHA-256 of its page, SHA-256 of 32 zero bytes if the page is erased, and an
+ * inner node is the SHA-256 of the digests of its two children. Leaves and inner nodes differ in hashed size.
+ */
+typedef struct _flash_merkle
+{
+    flash_config_t *flash;                                      /*!< Flash driver of the region */
+    uint32_t start;                                             /*!< Start address of the region */
+    uint32_t pageSize;                                          /*!< Page size, from FLASH_GetProperty() */
+    uint32_t pageCount;                                         /*!< Number of pages in the region */
+    uint32_t leaves;                                            /*!< pageCount rounded up to a power of two */
+    uint32_t dirty[(FLASH_MERKLE_NODES + 31) / 32];             /*!< Nodes to be rehashed */
+    uint32_t hashed;                                            /*!< Nodes hashed by the last update */
+    uint8_t node[FLASH_MERKLE_NODES][FLASH_MERKLE_DIGEST_SIZE]; /*!< Cached digests */
+} flash_merkle_t;
+
+/*******************************************************************************
+ * API
+ ******************************************************************************/
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/*!
+ * @brief Initializes a tree over a flash region, all pages dirty.
+ *
+ * @param[out] tree Merkle tree.
+ * @param config Flash driver, initialized by FLASH_Init().
+ * @param start Start address of the region, page aligned.
+ * @param size Size of the region in bytes, a multiple of the page size, at most FLASH_MERKLE_MAX_PAGES pages.
+ * @return kStatus_Success, kStatus_InvalidArgument or status of FLASH_GetProperty().
+ */
+status_t FLASH_MERKLE_Init(flash_merkle_t *tree, flash_config_t *config, uint32_t start, uint32_t size);
+
+/*!
+ * @brief Marks pages changed by a flash erase or program as dirty.
+ *
+ * Only needed when the region is written without FLASH_MERKLE_Erase() or FLASH_MERKLE_Program().
+ *
+ * @param[in,out] tree Merkle tree.
+ * @param start Start address of the changed range.
+ * @param lengthInBytes Size of the changed range in bytes. Parts outside the region are ignored.
+ */
+void FLASH_MERKLE_MarkDirty(flash_merkle_t *tree, uint32_t start, uint32_t lengthInBytes);
+
+/*!
+ * @brief Erases flash with FLASH_Erase() and marks the erased pages as dirty.
+ *
+ * @param[in,out] tree Merkle tree.
+ * @param start Start address, see FLASH_Erase().
+ * @param lengthInBytes Size in bytes, see FLASH_Erase().
+ * @param key Erase key, see FLASH_Erase().
+ * @return Status of FLASH_Erase().
+ */
+status_t FLASH_MERKLE_Erase(flash_merkle_t *tree, uint32_t start, uint32_t lengthInBytes, uint32_t key);
+
+/*!
+ * @brief Programs flash with FLASH_Program() and marks the programmed pages as dirty.
+ *
+ * @param[in,out] tree Merkle tree.
+ * @param start Start address, see FLASH_Program().
+ * @param src Data to program.
+ * @param lengthInBytes Size in bytes, see FLASH_Program().
+ * @return Status of FLASH_Program().
+ */
+status_t FLASH_MERKLE_Program(flash_merkle_t *tree, uint32_t start, uint8_t *src, uint32_t lengthInBytes);
+
+/*!
+ * @brief Rehashes the dirty pages and their ancestors and returns the root digest.
+ *
+ * Cost is proportional to the number of dirty pages, each adding one page hash and one 64-byte hash per tree
+ * level not shared with another dirty page.
+ *
+ * @param base HASHCRYPT peripheral base address.
+ * @param[in,out] tree Merkle tree.
+ * @param[out] root Root digest. NULL can be passed if not needed.
+ * @return kStatus_Success or status of HASHCRYPT_SHA().
+ */
+status_t FLASH_MERKLE_Update(HASHCRYPT_Type *base, flash_merkle_t *tree, uint8_t root[FLASH_MERKLE_DIGEST_SIZE]);
+
+/*!
+ * @brief Rehashes a range of pages and compares them with the cached leaves.
+ *
+ * Detects pages changed without FLASH_MERKLE_MarkDirty(), for example while scrubbing the region page by page.
+ * Dirty pages in the range are not checked, FLASH_MERKLE_Update() shall be called first.
+ *
+ * @param base HASHCRYPT peripheral base address.
+ * @param tree Merkle tree.
+ * @param start Start address of the range, page aligned.
+ * @param lengthInBytes Size of the range in bytes. Parts outside the region are ignored.
+ * @return kStatus_Success, kStatus_Fail if a page does not match or status of HASHCRYPT_SHA().
+ */
+status_t FLASH_MERKLE_VerifyPages(HASHCRYPT_Type *base, flash_merkle_t *tree, uint32_t start, uint32_t lengthInBytes);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* _FLASH_MERKLE_H_ */
@@ -0,0 +1,241 @@
+/*
+ * Copyright 2026 asvin.io
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <string.h>
+#include "kdf.h"
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+static hashcrypt_hmac_ctx_t s_kdfCtx;
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+/*!
+ * @brief Stores a 32-bit value big endian.
+ */
+static void kdf_put_be32(uint8_t *buf, uint32_t value)
+{
+    buf[0] = (uint8_t)(value >> 24);
+    buf[1] = (uint8_t)(value >> 16);
+    buf[2] = (uint8_t)(value >> 8);
+    buf[3] = (uint8_t)value;
+}
+
+/*!
+ * @brief Computes one HMAC output block of HKDF-Expand, T(i) = HMAC(PRK, T(i-1) || info || i).
+ *
+ * The info is [labelSize]32 || label || context || [L]32, so the label and context boundary is unambiguous and
+ * keys of different sizes are unrelated.
+ */
+static status_t kdf_hkdf_block(HASHCRYPT_Type *base,
+                               const hashcrypt_hmac_key_t *root,
+                               const uint8_t *prev,
+                               const uint8_t *label,
+                               size_t labelSize,
+                               const uint8_t *context,
+                               size_t contextSize,
+                               uint32_t i,
+                               size_t keySize,
+                               uint8_t *out)
+{
+    uint8_t counter = (uint8_t)i;
+    uint8_t field[4];
+    status_t status;
+
+    status = HASHCRYPT_HMAC_Init(base, &s_kdfCtx, root);
+    if ((kStatus_Success == status) && (i > 1u))
+    {
+        status = HASHCRYPT_HMAC_Update(base, &s_kdfCtx, prev, HASHCRYPT_HMAC_SIZE);
+    }
+    if (kStatus_Success == status)
+    {
+        kdf_put_be32(field, (uint32_t)labelSize);
+        status = HASHCRYPT_HMAC_Update(base, &s_kdfCtx, field, sizeof(field));
+    }
+    if (kStatus_Success == status)
+    {
+        status = HASHCRYPT_HMAC_Update(base, &s_kdfCtx, label, labelSize);
+    }
+    if (kStatus_Success == status)
+    {
+        status = HASHCRYPT_HMAC_Update(base, &s_kdfCtx, context, contextSize);
+    }
+    if (kStatus_Success == status)
+    {
+        kdf_put_be32(field, (uint32_t)keySize * 8u);
+        status = HASHCRYPT_HMAC_Update(base, &s_kdfCtx, field, sizeof(field));
+    }
+    if (kStatus_Success == status)
+    {
+        status = HASHCRYPT_HMAC_Update(base, &s_kdfCtx, &counter, 1u);
+    }
+    if (kStatus_Success == status)
+    {
+        status = HASHCRYPT_HMAC_Finish(base, &s_kdfCtx, out, HASHCRYPT_HMAC_SIZE);
+    }
+
+    return status;
+}
+
+/*!
+ * @brief Computes one HMAC output block of SP 800-108 counter mode,
+ * K(i) = HMAC(KI, [i]32 || label || 0x00 || context || [L]32).
+ */
+static status_t kdf_counter_block(HASHCRYPT_Type *base,
+                                  const hashcrypt_hmac_key_t *root,
+                                  const uint8_t *label,
+                                  size_t labelSize,
+                                  const uint8_t *context,
+                                  size_t contextSize,
+                                  uint32_t i,
+                                  size_t keySize,
+                                  uint8_t *out)
+{
+    static const uint8_t separator = 0u;
+    uint8_t field[4];
+    status_t status;
+
+    kdf_put_be32(field, i);
+    status = HASHCRYPT_HMAC_Init(base, &s_kdfCtx, root);
+    if (kStatus_Success == status)
+    {
+        status = HASHCRYPT_HMAC_Update(base, &s_kdfCtx, field, sizeof(field));
+    }
+    if (kStatus_Success == status)
+    {
+        status = HASHCRYPT_HMAC_Update(base, &s_kdfCtx, label, labelSize);
+    }
+    if (kStatus_Success == status)
+    {
+        status = HASHCRYPT_HMAC_Update(base, &s_kdfCtx, &separator, 1u);
+    }
+    if (kStatus_Success == status)
+    {
+        status = HASHCRYPT_HMAC_Update(base, &s_kdfCtx, context, contextSize);
+    }
+    if (kStatus_Success == status)
+    {
+        kdf_put_be32(field, (uint32_t)keySize * 8u);
+        status = HASHCRYPT_HMAC_Update(base, &s_kdfCtx, field, sizeof(field));
+    }
+    if (kStatus_Success == status)
+    {
+        status = HASHCRYPT_HMAC_Finish(base, &s_kdfCtx, out, HASHCRYPT_HMAC_SIZE);
+    }
+
+    return status;
+}
+
+status_t KDF_HKDF_Extract(HASHCRYPT_Type *base,
+                          const uint8_t *salt,
+                          size_t saltSize,
+                          const uint8_t *ikm,
+                          size_t ikmSize,
+                          hashcrypt_hmac_key_t *prk)
+{
+    static const uint8_t zeroSalt[HASHCRYPT_HMAC_SIZE] = {0};
+    uint8_t prkBytes[HASHCRYPT_HMAC_SIZE];
+    status_t status;
+
+    if ((NULL == prk) || ((NULL == ikm) && (ikmSize > 0u)) || ((NULL == salt) && (saltSize > 0u)))
+    {
+        return kStatus_InvalidArgument;
+    }
+
+    /* PRK = HMAC(salt, IKM), the salt being the HMAC key */
+    if (saltSize == 0u)
+    {
+        salt = zeroSalt;
+        saltSize = sizeof(zeroSalt);
+    }
+    status = HASHCRYPT_HMAC_SetKey(base, prk, salt, saltSize);
+    if (kStatus_Success == status)
+    {
+        status = HASHCRYPT_HMAC(base, prk, ikm, ikmSize, prkBytes, sizeof(prkBytes));
+    }
+    if (kStatus_Success == status)
+    {
+        status = HASHCRYPT_HMAC_SetKey(base, prk, prkBytes, sizeof(prkBytes));
+    }
+    memset(prkBytes, 0, sizeof(prkBytes));
+
+    return status;
+}
+
+status_t KDF_Derive(HASHCRYPT_Type *base,
+                    const hashcrypt_hmac_key_t *root,
+                    kdf_mode_t mode,
+                    const uint8_t *label,
+                    size_t labelSize,
+                    const uint8_t *context,
+                    size_t contextSize,
+                    uint8_t *key,
+                    size_t keySize)
+{
+    uint8_t block[HASHCRYPT_HMAC_SIZE];
+    status_t status = kStatus_Success;
+    size_t done, chunk;
+    uint32_t i;
+
+    if ((NULL == root) || (NULL == key) || (keySize == 0u) || (keySize > KDF_MAX_KEY_SIZE) ||
+        ((NULL == label) && (labelSize > 0u)) || ((NULL == context) && (contextSize > 0u)) ||
+        ((mode != kKDF_Hkdf) && (mode != kKDF_CounterMode)))
+    {
+        return kStatus_InvalidArgument;
+    }
+
+    for (done = 0, i = 1; (done < keySize) && (kStatus_Success == status); done += chunk, i++)
+    {
+        if (mode == kKDF_Hkdf)
+        {
+            status = kdf_hkdf_block(base, root, block, label, labelSize, context, contextSize, i, keySize, block);
+        }
+        else
+        {
+            status = kdf_counter_block(base, root, label, labelSize, context, contextSize, i, keySize, block);
+        }
+        chunk = MIN(keySize - done, sizeof(block));
+        memcpy(&key[done], block, chunk);
+    }
+    memset(block, 0, sizeof(block));
+
+    if (kStatus_Success != status)
+    {
+        memset(key, 0, keySize);
+    }
+
+    return status;
+}
+
+status_t KDF_DeriveBatch(HASHCRYPT_Type *base,
+                         const hashcrypt_hmac_key_t *root,
+                         kdf_mode_t mode,
+                         const uint8_t *context,
+                         size_t contextSize,
+                         kdf_subkey_t *subkeys,
+                         size_t count)
+{
+    status_t result = kStatus_Success;
+
+    if ((NULL == subkeys) && (count > 0u))
+    {
+        return kStatus_InvalidArgument;
+    }
+
+    for (size_t k = 0; k < count; k++)
+    {
+        subkeys[k].status = KDF_Derive(base, root, mode, subkeys[k].label, subkeys[k].labelSize, context, contextSize,
+                                       subkeys[k].key, subkeys[k].keySize);
+        if (kStatus_Success != subkeys[k].status)
+        {
+            result = kStatus_Fail;
+        }
+    }
+
+    return result;
+}
@@ -0,0 +1,122 @@
+/*
+ * Copyright 2026 asvin.io
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _KDF_H_
+#define _KDF_H_
+
+#include "fsl_common.h"
+#include "fsl_hashcrypt.h"
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+
+/*! @brief Maximum size of one derived key in bytes, 255 HMAC-SHA256 outputs as allowed by HKDF. */
+#define KDF_MAX_KEY_SIZE (255u * HASHCRYPT_HMAC_SIZE)
+
+/*! @brief Key derivation function. */
+typedef enum _kdf_mode
+{
+    kKDF_Hkdf = 0U,        /*!< HKDF-Expand (RFC 5869), info is [labelSize]32 || label || context || [L]32 */
+    kKDF_CounterMode = 1U, /*!< NIST SP 800-108 counter mode with HMAC-SHA256, 32-bit counter and length */
+} kdf_mode_t;
+
+/*! @brief One subkey of KDF_DeriveBatch(). */
+typedef struct _kdf_subkey
+{
+    const uint8_t *label; /*!< Label identifying the purpose of the key, can be NULL if labelSize is 0 */
+    size_t labelSize;     /*!< Size of label in bytes */
+    uint8_t *key;         /*!< Output key */
+    size_t keySize;       /*!< Size of key in bytes, 1 to KDF_MAX_KEY_SIZE */
+    status_t status;      /*!< Output status of this subkey */
+} kdf_subkey_t;
+
+/*******************************************************************************
+ * API
+ ******************************************************************************/
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/*!
+ * @brief HKDF-Extract, computes the pseudorandom key from input keying material.
+ *
+ * The result is kept only as a padded HMAC key, ready for KDF_Derive() and KDF_DeriveBatch().
+ *
+ * @param base HASHCRYPT peripheral base address.
+ * @param salt Salt. Can be NULL if saltSize is 0, a zero salt of 32 bytes is used then.
+ * @param saltSize Size of salt in bytes.
+ * @param ikm Input keying material, for example a key reconstructed by PUF_GetKey().
+ * @param ikmSize Size of ikm in bytes.
+ * @param[out] prk Pseudorandom key.
+ * @return kStatus_Success, kStatus_InvalidArgument or status of the hash functions.
+ */
+status_t KDF_HKDF_Extract(HASHCRYPT_Type *base,
+                          const uint8_t *salt,
+                          size_t saltSize,
+                          const uint8_t *ikm,
+                          size_t ikmSize,
+                          hashcrypt_hmac_key_t *prk);
+
+/*!
+ * @brief Derives one key.
+ *
+ * Each 32 bytes of output cost one HMAC keyed by root. The output length is part of the derivation input of both
+ * modes, so keys derived with the same label and context but different keySize are unrelated.
+ *
+ * @param base HASHCRYPT peripheral base address.
+ * @param root Root key, set by KDF_HKDF_Extract() or HASHCRYPT_HMAC_SetKey().
+ * @param mode Key derivation function.
+ * @param label Label identifying the purpose of the key. Can be NULL if labelSize is 0.
+ * @param labelSize Size of label in bytes.
+ * @param context Context shared by keys of the same device or session. Can be NULL if contextSize is 0.
+ * @param contextSize Size of context in bytes.
+ * @param[out] key Output key.
+ * @param keySize Size of key in bytes, 1 to KDF_MAX_KEY_SIZE.
+ * @return kStatus_Success, kStatus_InvalidArgument or status of the hash functions.
+ */
+status_t KDF_Derive(HASHCRYPT_Type *base,
+                    const hashcrypt_hmac_key_t *root,
+                    kdf_mode_t mode,
+                    const uint8_t *label,
+                    size_t labelSize,
+                    const uint8_t *context,
+                    size_t contextSize,
+                    uint8_t *key,
+                    size_t keySize);
+
+/*!
+ * @brief Derives many labeled keys from one root key.
+ *
+ * Calls KDF_Derive() for every subkey, so the cost per key is the same: each 32 bytes of output hash the ipad
+ * block, the derivation input, the opad block and the inner digest, four SHA-256 compressions while the input fits
+ * in one block with its padding. HASHCRYPT cannot reload a hash state, so the keyed states of root are not shared
+ * between subkeys. The batch is a convenience, the only work done once is padding root in HASHCRYPT_HMAC_SetKey().
+ *
+ * @param base HASHCRYPT peripheral base address.
+ * @param root Root key, set by KDF_HKDF_Extract() or HASHCRYPT_HMAC_SetKey().
+ * @param mode Key derivation function.
+ * @param context Context shared by all keys. Can be NULL if contextSize is 0.
+ * @param contextSize Size of context in bytes.
+ * @param[in,out] subkeys Array of subkeys. Status of each subkey is stored to its status member.
+ * @param count Number of subkeys.
+ * @return kStatus_Success if all subkeys were derived, kStatus_Fail otherwise.
+ */
+status_t KDF_DeriveBatch(HASHCRYPT_Type *base,
+                         const hashcrypt_hmac_key_t *root,
+                         kdf_mode_t mode,
+                         const uint8_t *context,
+                         size_t contextSize,
+                         kdf_subkey_t *subkeys,
+                         size_t count);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* _KDF_H_ */
@@ -0,0 +1,175 @@
+/*
+ * Copyright 2026 asvin.io
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <string.h>
+#include "keystore.h"
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+#if (KEYSTORE_CACHE_KEY_SIZE > 255u) || (KEYSTORE_CACHE_LABEL_SIZE > 255u)
+#error "KEYSTORE_CACHE_KEY_SIZE and KEYSTORE_CACHE_LABEL_SIZE shall fit the 8-bit sizes of keystore_entry_t"
+#endif
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+/*!
+ * @brief Finds the entry of a label and key size, NULL if the key is not in RAM.
+ *
+ * A keySize of 0 matches the label at any size.
+ */
+static keystore_entry_t *keystore_find(keystore_t *store, const uint8_t *label, size_t labelSize, size_t keySize)
+{
+    uint32_t i;
+
+    for (i = 0; i < KEYSTORE_CACHE_ENTRIES; i++)
+    {
+        if ((store->entries[i].keySize != 0u) && ((keySize == 0u) || (store->entries[i].keySize == keySize)) &&
+            (store->entries[i].labelSize == labelSize) && !memcmp(store->entries[i].label, label, labelSize))
+        {
+            return &store->entries[i];
+        }
+    }
+
+    return NULL;
+}
+
+/*!
+ * @brief Takes a free entry, or the least recently used one.
+ */
+static keystore_entry_t *keystore_take(keystore_t *store)
+{
+    keystore_entry_t *entry = &store->entries[0];
+    uint32_t i;
+
+    for (i = 0; i < KEYSTORE_CACHE_ENTRIES; i++)
+    {
+        if (store->entries[i].keySize == 0u)
+        {
+            return &store->entries[i];
+        }
+        if ((store->useCounter - store->entries[i].lastUse) > (store->useCounter - entry->lastUse))
+        {
+            entry = &store->entries[i];
+        }
+    }
+
+    store->stats.evictions++;
+    memset(entry, 0, sizeof(*entry));
+
+    return entry;
+}
+
+status_t KEYSTORE_Init(HASHCRYPT_Type *hashBase,
+                       PUF_Type *pufBase,
+                       keystore_t *store,
+                       const uint8_t *rootKeyCode,
+                       size_t rootKeyCodeSize,
+                       const uint8_t *salt,
+                       size_t saltSize)
+{
+    uint32_t rootKey[KEYSTORE_ROOT_KEY_SIZE / sizeof(uint32_t)];
+    status_t status;
+
+    if ((NULL == store) || (NULL == rootKeyCode))
+    {
+        return kStatus_InvalidArgument;
+    }
+
+    memset(store, 0, sizeof(*store));
+
+    status = PUF_GetKey(pufBase, rootKeyCode, rootKeyCodeSize, (uint8_t *)rootKey, sizeof(rootKey));
+    if (kStatus_Success == status)
+    {
+        status = KDF_HKDF_Extract(hashBase, salt, saltSize, (const uint8_t *)rootKey, sizeof(rootKey), &store->root);
+    }
+    memset(rootKey, 0, sizeof(rootKey));
+
+    if (kStatus_Success == status)
+    {
+        store->ready = true;
+    }
+    else
+    {
+        memset(store, 0, sizeof(*store));
+    }
+
+    return status;
+}
+
+void KEYSTORE_Deinit(keystore_t *store)
+{
+    memset(store, 0, sizeof(*store));
+}
+
+status_t KEYSTORE_GetKey(
+    HASHCRYPT_Type *base, keystore_t *store, const uint8_t *label, size_t labelSize, uint8_t *key, size_t keySize)
+{
+    keystore_entry_t *entry = NULL;
+    status_t status;
+
+    if ((NULL == store) || !store->ready || (NULL == label) || (labelSize == 0u) || (NULL == key) ||
+        (keySize == 0u) || (keySize > KDF_MAX_KEY_SIZE))
+    {
+        return kStatus_InvalidArgument;
+    }
+
+    store->useCounter++;
+
+    if ((labelSize <= KEYSTORE_CACHE_LABEL_SIZE) && (keySize <= KEYSTORE_CACHE_KEY_SIZE))
+    {
+        entry = keystore_find(store, label, labelSize, keySize);
+        if (NULL != entry)
+        {
+            store->stats.hits++;
+            entry->lastUse = store->useCounter;
+            memcpy(key, entry->key, keySize);
+            return kStatus_Success;
+        }
+    }
+
+    store->stats.misses++;
+    status = KDF_Derive(base, &store->root, kKDF_Hkdf, label, labelSize, NULL, 0, key, keySize);
+
+    if ((kStatus_Success == status) && (labelSize <= KEYSTORE_CACHE_LABEL_SIZE) &&
+        (keySize <= KEYSTORE_CACHE_KEY_SIZE))
+    {
+        /* the key size is part of the HKDF info, so each size of a label is a distinct key with its own entry */
+        entry = keystore_take(store);
+        memcpy(entry->label, label, labelSize);
+        memcpy(entry->key, key, keySize);
+        entry->labelSize = (uint8_t)labelSize;
+        entry->keySize = (uint8_t)keySize;
+        entry->lastUse = store->useCounter;
+    }
+
+    return status;
+}
+
+void KEYSTORE_Evict(keystore_t *store, const uint8_t *label, size_t labelSize)
+{
+    keystore_entry_t *entry;
+
+    if ((NULL == store) || (NULL == label) || (labelSize > KEYSTORE_CACHE_LABEL_SIZE))
+    {
+        return;
+    }
+
+    while (NULL != (entry = keystore_find(store, label, labelSize, 0u)))
+    {
+        memset(entry, 0, sizeof(*entry));
+    }
+}
+
+void KEYSTORE_GetStats(keystore_t *store, keystore_stats_t *stats, bool clear)
+{
+    *stats = store->stats;
+    if (clear)
+    {
+        memset(&store->stats, 0, sizeof(store->stats));
+    }
+}
@@ -0,0 +1,149 @@
+/*
+ * Copyright 2026 asvin.io
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _KEYSTORE_H_
+#define _KEYSTORE_H_
+
+#include "fsl_common.h"
+#include "fsl_hashcrypt.h"
+#include "fsl_puf.h"
+#include "kdf.h"
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+
+/*! @brief Size of the PUF root key in bytes. */
+#define KEYSTORE_ROOT_KEY_SIZE 32u
+
+/*! @brief Number of derived keys kept in RAM. */
+#ifndef KEYSTORE_CACHE_ENTRIES
+#define KEYSTORE_CACHE_ENTRIES 8u
+#endif
+
+/*! @brief Largest derived key kept in RAM in bytes. Larger keys are derived on every request. */
+#ifndef KEYSTORE_CACHE_KEY_SIZE
+#define KEYSTORE_CACHE_KEY_SIZE 32u
+#endif
+
+/*! @brief Longest label of a key kept in RAM in bytes. Keys with longer labels are derived on every request. */
+#ifndef KEYSTORE_CACHE_LABEL_SIZE
+#define KEYSTORE_CACHE_LABEL_SIZE 32u
+#endif
+
+/*! @brief Key store counters. */
+typedef struct _keystore_stats
+{
+    uint32_t hits;      /*!< KEYSTORE_GetKey() requests served from RAM */
+    uint32_t misses;    /*!< KEYSTORE_GetKey() requests derived from the root key */
+    uint32_t evictions; /*!< Keys dropped from RAM to make room for another one */
+} keystore_stats_t;
+
+/*! @brief Derived key kept in RAM. */
+typedef struct _keystore_entry
+{
+    uint8_t label[KEYSTORE_CACHE_LABEL_SIZE]; /*!< Label of the key */
+    uint8_t key[KEYSTORE_CACHE_KEY_SIZE];     /*!< Derived key */
+    uint8_t labelSize;                        /*!< Size of label in bytes */
+    uint8_t keySize;                          /*!< Size of key in bytes, 0 if the entry is free */
+    uint32_t lastUse;                         /*!< Value of the use counter at the last request */
+} keystore_entry_t;
+
+/*! @brief Key hierarchy rooted in one PUF intrinsic key. */
+typedef struct _keystore
+{
+    hashcrypt_hmac_key_t root;                        /*!< HKDF pseudorandom key extracted from the PUF root key */
+    bool ready;                                       /*!< True between KEYSTORE_Init() and KEYSTORE_Deinit() */
+    uint32_t useCounter;                              /*!< Incremented on each request, orders entries by use */
+    keystore_entry_t entries[KEYSTORE_CACHE_ENTRIES]; /*!< Derived keys */
+    keystore_stats_t stats;                           /*!< Counters */
+} keystore_t;
+
+/*******************************************************************************
+ * API
+ ******************************************************************************/
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/*!
+ * @brief Reconstructs the PUF root key and extracts the key hierarchy root from it.
+ *
+ * Meant to be called once per boot. The root key is reconstructed by PUF_GetKey() to a local buffer, HKDF-Extract
+ * keeps it only as an HMAC key and the buffer is cleared. The root key code is generated once, at
+ * provisioning, by PUF_SetIntrinsicKey() with KEYSTORE_ROOT_KEY_SIZE bytes and a key index 1 to 15. All application
+ * keys are derived from it, so only this single key code has to be stored in flash.
+ *
+ * @param hashBase HASHCRYPT peripheral base address.
+ * @param pufBase PUF peripheral base address.
+ * @param[out] store Key store.
+ * @param rootKeyCode Word aligned key code of the root key.
+ * @param rootKeyCodeSize Size of rootKeyCode in bytes.
+ * @param salt Salt binding the hierarchy, for example a product identifier. Can be NULL if saltSize is 0.
+ * @param saltSize Size of salt in bytes.
+ * @return kStatus_Success, kStatus_InvalidArgument, status of PUF_GetKey() or of the hash functions.
+ */
+status_t KEYSTORE_Init(HASHCRYPT_Type *hashBase,
+                       PUF_Type *pufBase,
+                       keystore_t *store,
+                       const uint8_t *rootKeyCode,
+                       size_t rootKeyCodeSize,
+                       const uint8_t *salt,
+                       size_t saltSize);
+
+/*!
+ * @brief Clears the root and all derived keys.
+ *
+ * @param[in,out] store Key store.
+ */
+void KEYSTORE_Deinit(keystore_t *store);
+
+/*!
+ * @brief Gets a labeled application key.
+ *
+ * A key requested before with the same label and size is copied from RAM. Otherwise it is derived with HKDF-Expand
+ * from the root and kept in RAM, replacing the least recently used key when all entries are taken. The same label
+ * and size always give the same key on the same device. The size is part of the derivation, so the same label
+ * requested with another size gives an unrelated key, kept in its own entry.
+ *
+ * @param base HASHCRYPT peripheral base address, used on a miss only.
+ * @param[in,out] store Key store.
+ * @param label Label identifying the purpose of the key.
+ * @param labelSize Size of label in bytes, at least 1.
+ * @param[out] key Output key.
+ * @param keySize Size of key in bytes, 1 to KDF_MAX_KEY_SIZE.
+ * @return kStatus_Success, kStatus_InvalidArgument or status of KDF_Derive().
+ */
+status_t KEYSTORE_GetKey(
+    HASHCRYPT_Type *base, keystore_t *store, const uint8_t *label, size_t labelSize, uint8_t *key, size_t keySize);
+
+/*!
+ * @brief Drops the keys of a label from RAM, at all sizes.
+ *
+ * The keys can still be requested later, they are derived again then.
+ *
+ * @param[in,out] store Key store.
+ * @param label Label of the keys.
+ * @param labelSize Size of label in bytes.
+ */
+void KEYSTORE_Evict(keystore_t *store, const uint8_t *label, size_t labelSize);
+
+/*!
+ * @brief Gets the key store counters.
+ *
+ * @param store Key store.
+ * @param[out] stats Counters.
+ * @param clear Clears the counters after reading when true.
+ */
+void KEYSTORE_GetStats(keystore_t *store, keystore_stats_t *stats, bool clear);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* _KEYSTORE_H_ */
@@ -17,10 +17,13 @@
 #include "fsl_hashcrypt.h"
 #include "fsl_iap.h"
 #include "fsl_iap_ffr.h"
+#include "drbg.h"
+#include "keystore.h"
+#include "puf_discharge.h"
+#include "crypto_bench.h"
 /*******************************************************************************
  * Definitions
  ******************************************************************************/
-#define CORE_CLK_FREQ CLOCK_GetFreq(kCLOCK_CoreSysClk)
 #define PUF_DISCHARGE_TIME 400
 
 #define NUM_OF_KEYS 2
@@ -43,6 +46,13 @@ typedef struct
   keyCode_t keyCode[NUM_OF_KEYS];
 }sPufData;
 
+typedef struct
+{
+  uint32_t magic;
+  uint32_t dischargeTime;
+  uint32_t dischargeTimeInv;
+}sPufDischarge;
+
 
 /*******************************************************************************
  * Function definition
@@ -65,6 +75,8 @@ uint32_t Flash_StoreAC(uint8_t *acBuf);
 void Flash_ReadAC(uint8_t ** acBuf);
 void  Flash_ReadKC(uint8_t **kcBuf, uint32_t keyIdx);
 uint32_t Flash_StoreKC(uint8_t *kcBuf, uint32_t keyIdx, uint32_t size);
+uint32_t Flash_StoreDischarge(uint32_t dischargeTime);
+void Flash_ReadDischarge(uint32_t * dischargeTime);
 void verify_status(status_t status);
 
 /*********************** Menu functions ***********************************/
@@ -74,6 +86,7 @@ void MainMiscPuf(void);
 void MainGenerateKey(void);
 void MainGetKey(void);
 void MainAES(void);
+void MainBench(void);
 void MainBack(void);
 
 void MiscStopPuf(void);
@@ -81,11 +94,35 @@ void MiscInitPuf(void);
 void MiscZeroize(void);
 void MiscBlockEnroll(void);
 void MiscBlockSetKey(void);
+void MiscCalibrateDischarge(void);
 void MiscBack(void);
 
 void GetKey(void);
 void KeyBack(void);
 
+void BenchMenuAesBatch(void);
+void BenchMenuAesUnaligned(void);
+void BenchMenuAesGcm(void);
+void BenchMenuAesCmac(void);
+void BenchMenuAesCcm(void);
+void BenchMenuAesPrepared(void);
+void BenchMenuAesSoft(void);
+void BenchMenuShaStreams(void);
+void BenchMenuShaSegments(void);
+void BenchMenuHmac(void);
+void BenchMenuKdf(void);
+void BenchMenuFlashMerkle(void);
+void BenchMenuShaSoft(void);
+void BenchMenuShaLarge(void);
+void BenchMenuDrbg(void);
+void BenchMenuShaUnaligned(void);
+void BenchMenuAesEtm(void);
+void BenchMenuPufAsync(void);
+void BenchMenuPufBatch(void);
+void BenchMenuKeystore(void);
+void BenchMenuPufHwKey(void);
+void BenchBack(void);
+
 void EnrolPuf(void);
 void StartPuf(void);
 void StopPuf(void);
@@ -93,6 +130,7 @@ void InitPuf(void);
 void Zeroize(void);
 void BlockEnroll(void);
 void BlockSetKey(void);
+void CalibrateDischarge(void);
 void GenerateUserKey(void);
 void GenerateIntrinsicKey(void);
 void TestAesEcb(void);
@@ -100,6 +138,11 @@ void TestAesEcb(void);
 #define FLASHSTORE_BASEADR 0x80000
 #define FLASHSTORE_LEN /*sizeof(sPufData)*/ 0x1000
 
+/* calibrated discharge time, on its own page as the FLASHSTORE is erased at every boot */
+#define FLASHDISCHARGE_BASEADR 0x81000
+#define FLASHDISCHARGE_LEN 0x200
+#define FLASHDISCHARGE_MAGIC 0x44465550 /* "PUFD" */
+
 /************************ PUF variables *********************************/
 void (**actualfnc)(void);
 
@@ -110,7 +153,9 @@ status_t result;
 char ** menu;
 
 uint8_t pKeyCode[560];
+uint32_t pufDischargeTime = PUF_DISCHARGE_TIME;
 flash_config_t flashInstance;
+drbg_t drbgInstance;
 
 /*******************************************************************************
  * Code
@@ -126,6 +171,7 @@ char * mainmenu[] =
   "Generate Key Code",
   "Get Key from Key Code",
   "Encrypt / Decrypt AES block",
+  "Crypto benchmarks",
   "Back",
 };
 
@@ -137,6 +183,7 @@ void (*mainmenufnc[])(void) =
   MainGenerateKey,
   MainGetKey,
   MainAES,
+  MainBench,
   MainBack,
 };
 
@@ -148,6 +195,7 @@ char * miscmenu[] =
   "Zeroize PUF ",
   "Disable Enroll PUF ",
   "Disable Key Generation",
+  "Calibrate discharge time",
   "Back",
 };
 
@@ -158,6 +206,7 @@ void (*miscmenufnc[])(void) =
   MiscZeroize,
   MiscBlockEnroll,
   MiscBlockSetKey,
+  MiscCalibrateDischarge,
   MiscBack,
 };
 
@@ -176,12 +225,66 @@ void (*setkeymenufnc[])(void) =
   KeyBack,
 };
 
+/************************ BENCH MENU ************************************/
+char * benchmenu[] =
+{
+  "AES batch vs. per-call",
+  "AES aligned / unaligned throughput",
+  "AES-GCM test vectors and GHASH",
+  "AES-CMAC test vectors and throughput",
+  "AES-CCM records, per-record vs. batch",
+  "AES single block latency, prepared handle",
+  "Software AES vs. HASHCRYPT",
+  "SHA-256 concurrent hashes, run to completion",
+  "SHA-256 chained segments, blocking vs. non-blocking",
+  "HMAC-SHA256 with the padded key precomputed",
+  "KDF subkeys, per-key vs. batch",
+  "Flash Merkle tree, full vs. incremental",
+  "Software SHA-256/512 vs. HASHCRYPT",
+  "SHA-256 of large flash regions, chunked",
+  "DRBG pool, key masks and IVs",
+  "SHA-256 unaligned input, staged",
+  "AES-CTR encrypt-then-MAC, two passes",
+  "PUF get key, blocking vs. non-blocking",
+  "PUF get / set intrinsic key, per-call vs. batch",
+  "Key hierarchy from a PUF root key",
+  "AES secret key, reloaded vs. resident in key slot",
+  "Back",
+};
+
+void (*benchmenufnc[])(void) =
+{
+  BenchMenuAesBatch,
+  BenchMenuAesUnaligned,
+  BenchMenuAesGcm,
+  BenchMenuAesCmac,
+  BenchMenuAesCcm,
+  BenchMenuAesPrepared,
+  BenchMenuAesSoft,
+  BenchMenuShaStreams,
+  BenchMenuShaSegments,
+  BenchMenuHmac,
+  BenchMenuKdf,
+  BenchMenuFlashMerkle,
+  BenchMenuShaSoft,
+  BenchMenuShaLarge,
+  BenchMenuDrbg,
+  BenchMenuShaUnaligned,
+  BenchMenuAesEtm,
+  BenchMenuPufAsync,
+  BenchMenuPufBatch,
+  BenchMenuKeystore,
+  BenchMenuPufHwKey,
+  BenchBack,
+};
+
 /************************ MENU List **************************************/
 sMenu menulist[] =
 {
   {mainmenu, mainmenufnc},
   {miscmenu, miscmenufnc},
   {setkeymenu, setkeymenufnc},
+  {benchmenu, benchmenufnc},
 };
 
 
@@ -195,8 +298,9 @@ void EnrolPuf(void)
     memset(pufData.activationCode, 0, sizeof(pufData.activationCode));
     while (1)
     {
-        /* Before any PUF use PUF peripheral has to be initialised*/
-        result = PUF_Init(PUF, PUF_DISCHARGE_TIME, CORE_CLK_FREQ);
+        /* Before any PUF use PUF peripheral has to be initialised, the core sleeps during the SRAM discharge */
+        PUF_DISCHARGE_Wait();
+        result = PUF_DISCHARGE_Cycle(PUF, pufDischargeTime);
         if (result != kStatus_Success)
         {
             PRINTF("Error Initializing PUF!\r\n");
@@ -280,10 +384,14 @@ void StartPuf(void)
       PRINTF("Activation Code:");
       PrintMem(pac, sizeof(pufData.activationCode), 16);   
       
-      PUF_Deinit(PUF, PUF_DISCHARGE_TIME, CORE_CLK_FREQ);  
-      
-      /* Reinitialize PUF after enroll */
-      status = PUF_Init(PUF, PUF_DISCHARGE_TIME, CORE_CLK_FREQ);
+      /* Reinitialize PUF after enroll, the micro-tick timer ends the SRAM discharge
+         while the DRBG pool is refilled and the core sleeps */
+      status = PUF_DISCHARGE_Start(PUF, pufDischargeTime, NULL, NULL);
+      if (status == kStatus_Success)
+      {
+          DRBG_Refill(HASHCRYPT, &drbgInstance);
+          status = PUF_DISCHARGE_Wait();
+      }
       if (status != kStatus_Success)
       {
           PRINTF("\nError Initializing PUF!\r\n");
@@ -307,7 +415,9 @@ void StartPuf(void)
 void InitPuf(void)
 {
   status_t status;
-  status = PUF_Init(PUF, PUF_DISCHARGE_TIME, CORE_CLK_FREQ);
+  /* a Stop may still be discharging, then power cycle with the core sleeping */
+  PUF_DISCHARGE_Wait();
+  status = PUF_DISCHARGE_Cycle(PUF, pufDischargeTime);
   if(status == kStatus_Success)
     PRINTF("\n\nPUF Init succesfull\r\n");
   else
@@ -336,7 +446,43 @@ void Zeroize(void)
 
 void StopPuf(void)
 {
-  PUF_Deinit(PUF, PUF_DISCHARGE_TIME, CORE_CLK_FREQ);
+  status_t status;
+  /* the micro-tick timer ends the SRAM discharge, the menu stays responsive meanwhile */
+  PUF_DISCHARGE_Wait();
+  status = PUF_DISCHARGE_Deinit(PUF, pufDischargeTime, NULL, NULL);
+  if(status == kStatus_Success)
+    PRINTF("\n\nPUF stopped, SRAM discharging\r\n");
+  else
+    PRINTF("\n\nPUF Stop failed\r\n");
+}
+
+void CalibrateDischarge(void)
+{
+  uint8_t * pac;
+  uint32_t dischargeTime;
+  status_t status;
+
+  /* the AC in RAM if there is one, otherwise the one in flash */
+  pac = pufData.activationCode;
+  if(!IsEmptyMem(pac, sizeof(pufData.activationCode)))
+    Flash_ReadAC(&pac);
+  if(!IsEmptyMem(pac, sizeof(pufData.activationCode)))
+  {
+    PRINTF("\n\nNo Activation Code in RAM or flash, enroll PUF first\r\n");
+    return;
+  }
+
+  PRINTF("\n\nCalibrating discharge time, up to %d ms ...\r\n", PUF_DISCHARGE_TIME);
+  status = PUF_DISCHARGE_Calibrate(PUF, pac, sizeof(pufData.activationCode), PUF_DISCHARGE_TIME, &dischargeTime);
+  if(status != kStatus_Success)
+  {
+    PRINTF("Calibration failed, discharge time stays %d ms\r\n", pufDischargeTime);
+    return;
+  }
+
+  pufDischargeTime = dischargeTime;
+  Flash_StoreDischarge(pufDischargeTime);
+  PRINTF("Discharge time %d ms stored to flash, the PUF is started\r\n", pufDischargeTime);
 }
 
 
@@ -436,7 +582,7 @@ void GenerateIntrinsicKey(void)
 /************************ Intrinsic Key FUNCTIONS ******************************/
 void GetKey(void)
 {
-    uint32_t keyidx, keyslot, keycodesize, keysize, keytype, status;
+    uint32_t keyidx, keyslot, keycodesize, keysize, keytype, status, mask;
     uint8_t * keycode;
     
     uint8_t key[512];
@@ -489,7 +635,15 @@ LoadKeyCode(&keycode);
           
           PRINTF("\r\nBad value, enter again\r\n"); 
         }
-          result = PUF_GetHwKey(PUF, keycode, keycodesize, (puf_key_slot_t)keyslot, rand());
+          if (PUF_IsHwKeyResident(PUF, keycode, keycodesize, (puf_key_slot_t)keyslot))
+          {
+              PRINTF("\r\nKey is already in this keyslot, not reconstructed again");
+          }
+          result = DRBG_GetRandom(HASHCRYPT, &drbgInstance, (uint8_t *)&mask, sizeof(mask));
+          if (result == kStatus_Success)
+          {
+              result = PUF_GetHwKeyCached(PUF, keycode, keycodesize, (puf_key_slot_t)keyslot, mask);
+          }
           if (result != kStatus_Success)
           {
               PRINTF("\r\nError reconstructing key to HW bus!\r\n");
@@ -617,6 +771,11 @@ int main(void)
     FLASH_Init(&flashInstance);
     FFR_Init(&flashInstance);
 
+    /* random key masks, IVs and nonces are served from the DRBG pool, refilled while waiting for input */
+    HASHCRYPT_Init(HASHCRYPT);
+    status = DRBG_Init(HASHCRYPT, &drbgInstance, DRBG_EntropyRng, NULL, NULL, 0);
+    verify_status(status);
+
     PRINTF(" Asvin ID PUF \n");
     status = FLASH_Erase(&flashInstance, FLASHSTORE_BASEADR, sizeof(buf), kFLASH_ApiEraseKey);
     verify_status(status);
@@ -638,6 +797,9 @@ int main(void)
 		 &failedAddress, &failedData);
 	verify_status(status);
 
+    Flash_ReadDischarge(&pufDischargeTime);
+    PRINTF("PUF discharge time %d ms\r\n", pufDischargeTime);
+
     PRINTF("\r\n**************************************************\r\n");
     PRINTF(" The software coming with AN12324\r\n");
     PRINTF(" The PUF and AES application note example code v1.1\r\n");
@@ -662,6 +824,7 @@ int main(void)
       PRINTF("\n\r**************************************************\n\r");
       MenuPrint(menu);
 
+      DRBG_Refill(HASHCRYPT, &drbgInstance);
       SCANF("%d", &selection);  // scan for number choodes by user
       selection--;  // menu starts from 0 .. so sub 1
       MenuFindFnc(menulist, sizeof(menulist)/sizeof(menulist[0]), menu, &actualfnc); // find table of functions associated to menu
@@ -717,6 +880,11 @@ void MainAES(void)
     menu = mainmenu;
 }
 
+void MainBench(void)
+{
+    menu = benchmenu;
+}
+
 void MainBack(void)
 {
   PRINTF("\n\n\rGoing back \r\n\n");
@@ -755,6 +923,12 @@ void MiscBlockSetKey(void)
   menu = miscmenu;
 }
 
+void MiscCalibrateDischarge(void)
+{
+  CalibrateDischarge();
+  menu = miscmenu;
+}
+
 void MiscBack(void)
 {
    menu = mainmenu;
@@ -765,6 +939,187 @@ void KeyBack(void)
   menu = mainmenu;
 }
 
+/************************** BENCH menu func ******************************/
+/*************************************************************************/
+void BenchMenuAesBatch(void)
+{
+  BenchAesBatch();
+  menu = benchmenu;
+}
+
+void BenchMenuAesUnaligned(void)
+{
+  BenchAesUnaligned();
+  menu = benchmenu;
+}
+
+void BenchMenuAesGcm(void)
+{
+  BenchAesGcm();
+  menu = benchmenu;
+}
+
+void BenchMenuAesCmac(void)
+{
+  BenchAesCmac();
+  menu = benchmenu;
+}
+
+void BenchMenuAesCcm(void)
+{
+  BenchAesCcm();
+  menu = benchmenu;
+}
+
+void BenchMenuAesPrepared(void)
+{
+  BenchAesPrepared();
+  menu = benchmenu;
+}
+
+void BenchMenuAesSoft(void)
+{
+  BenchAesSoft();
+  menu = benchmenu;
+}
+
+void BenchMenuShaStreams(void)
+{
+  BenchShaStreams();
+  menu = benchmenu;
+}
+
+void BenchMenuShaSegments(void)
+{
+  BenchShaSegments();
+  menu = benchmenu;
+}
+
+void BenchMenuHmac(void)
+{
+  BenchHmac();
+  menu = benchmenu;
+}
+
+void BenchMenuKdf(void)
+{
+  BenchKdf();
+  menu = benchmenu;
+}
+
+void BenchMenuFlashMerkle(void)
+{
+  BenchFlashMerkle();
+  menu = benchmenu;
+}
+
+void BenchMenuShaSoft(void)
+{
+  BenchShaSoft();
+  menu = benchmenu;
+}
+
+void BenchMenuShaLarge(void)
+{
+  BenchShaLarge();
+  menu = benchmenu;
+}
+
+void BenchMenuDrbg(void)
+{
+  BenchDrbg();
+  menu = benchmenu;
+}
+
+void BenchMenuShaUnaligned(void)
+{
+  BenchShaUnaligned();
+  menu = benchmenu;
+}
+
+void BenchMenuAesEtm(void)
+{
+  BenchAesEtm();
+  menu = benchmenu;
+}
+
+void BenchMenuPufAsync(void)
+{
+  uint32_t keyidx, keysize, keytype;
+  uint8_t * keycode;
+
+  LoadKeyCode(&keycode);
+  if ((keycode == NULL) || (KeyCodeCheck(keycode, &keytype, &keyidx, &keysize) != 0) || (keyidx == 0) ||
+      (keysize > 64))
+  {
+    PRINTF("\r\nKey Code of index 1..15 and up to 64 bytes needed\r\n");
+  }
+  else
+  {
+    BenchPufAsync(keycode, PUF_GET_KEY_CODE_SIZE_FOR_KEY_SIZE(keysize), keysize);
+  }
+  menu = benchmenu;
+}
+
+void BenchMenuPufBatch(void)
+{
+  uint32_t keyidx, keysize, keytype;
+  uint8_t * keycode;
+
+  LoadKeyCode(&keycode);
+  if ((keycode == NULL) || (KeyCodeCheck(keycode, &keytype, &keyidx, &keysize) != 0) || (keyidx == 0) ||
+      (keysize > 64))
+  {
+    PRINTF("\r\nKey Code of index 1..15 and up to 64 bytes needed\r\n");
+  }
+  else
+  {
+    BenchPufBatch(keycode, PUF_GET_KEY_CODE_SIZE_FOR_KEY_SIZE(keysize), keysize);
+  }
+  menu = benchmenu;
+}
+
+void BenchMenuKeystore(void)
+{
+  uint32_t keyidx, keysize, keytype;
+  uint8_t * keycode;
+
+  LoadKeyCode(&keycode);
+  if ((keycode == NULL) || (KeyCodeCheck(keycode, &keytype, &keyidx, &keysize) != 0) || (keyidx == 0) ||
+      (keysize != KEYSTORE_ROOT_KEY_SIZE))
+  {
+    PRINTF("\r\nKey Code of index 1..15 and %d bytes needed\r\n", KEYSTORE_ROOT_KEY_SIZE);
+  }
+  else
+  {
+    BenchKeystore(keycode, PUF_GET_KEY_CODE_SIZE_FOR_KEY_SIZE(keysize));
+  }
+  menu = benchmenu;
+}
+
+void BenchMenuPufHwKey(void)
+{
+  uint32_t keyidx, keysize, keytype, mask;
+  uint8_t * keycode;
+
+  LoadKeyCode(&keycode);
+  if ((keycode == NULL) || (KeyCodeCheck(keycode, &keytype, &keyidx, &keysize) != 0) || (keyidx != 0) ||
+      (keysize != 16))
+  {
+    PRINTF("\r\nKey Code of index 0 and 16 bytes needed\r\n");
+  }
+  else if (DRBG_GetRandom(HASHCRYPT, &drbgInstance, (uint8_t *)&mask, sizeof(mask)) == kStatus_Success)
+  {
+    BenchPufHwKey(keycode, PUF_GET_KEY_CODE_SIZE_FOR_KEY_SIZE(keysize), mask);
+  }
+  menu = benchmenu;
+}
+
+void BenchBack(void)
+{
+  menu = mainmenu;
+}
+
 
 /***********************************************************************/
 /***********************************************************************/
@@ -1042,6 +1397,41 @@ void Flash_ReadAC(uint8_t ** acBuf)
 	*acBuf = &(((sPufData*)FLASHSTORE_BASEADR)->activationCode[0]);
 }
 
+uint32_t Flash_StoreDischarge(uint32_t dischargeTime)
+{
+	uint32_t failedAddress, failedData;
+	uint8_t buf[FLASHDISCHARGE_LEN] __attribute__ ((aligned (4)));
+	sPufDischarge * record = (sPufDischarge *)buf;
+	uint32_t status;
+
+	memset(buf, 0xFF, sizeof(buf));
+	record->magic = FLASHDISCHARGE_MAGIC;
+	record->dischargeTime = dischargeTime;
+	record->dischargeTimeInv = ~dischargeTime;
+
+	status = FLASH_Erase(&flashInstance, FLASHDISCHARGE_BASEADR, FLASHDISCHARGE_LEN, kFLASH_ApiEraseKey);
+	if (status == kStatus_Success)
+		status = FLASH_Program(&flashInstance, FLASHDISCHARGE_BASEADR, buf, FLASHDISCHARGE_LEN);
+	if (status == kStatus_Success)
+		status = FLASH_VerifyProgram(&flashInstance, FLASHDISCHARGE_BASEADR, FLASHDISCHARGE_LEN, buf,
+						 &failedAddress, &failedData);
+
+	return status;
+}
+
+void Flash_ReadDischarge(uint32_t * dischargeTime)
+{
+	sPufDischarge * record = (sPufDischarge *)FLASHDISCHARGE_BASEADR;
+
+	/* reading an erased page raises an ECC fault, so a never written page is left alone */
+	if (FLASH_VerifyErase(&flashInstance, FLASHDISCHARGE_BASEADR, FLASHDISCHARGE_LEN) == kStatus_Success)
+		return;
+
+	if ((record->magic == FLASHDISCHARGE_MAGIC) && (record->dischargeTime == ~record->dischargeTimeInv) &&
+	    (record->dischargeTime != 0) && (record->dischargeTime <= PUF_DISCHARGE_TIME))
+		*dischargeTime = record->dischargeTime;
+}
+
 void verify_status(status_t status)
 {
     char *tipString = "Unknown status";
@@ -0,0 +1,237 @@
+/*
+ * Copyright 2026 asvin.io
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include "puf_discharge.h"
+#include "fsl_clock.h"
+#include "fsl_power.h"
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+#define PUF_DISCHARGE_CORE_CLK_FREQ CLOCK_GetFreq(kCLOCK_CoreSysClk)
+
+/* longest discharge time in ms, the micro-tick timer counts up to 2^31 ticks of 1 us */
+#define PUF_DISCHARGE_MAX_TIME 2000000u
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+static PUF_Type *volatile s_dischargeBase;
+/* PUF powered up by the timer isr, PUF_DISCHARGE_Wait() has not waited for its init yet */
+static PUF_Type *volatile s_dischargeInitBase;
+static puf_discharge_callback_t s_dischargeCallback;
+static void *s_dischargeUserData;
+/* the timer isr leaves the PUF deinitialized instead of powering PUF SRAM up */
+static bool s_dischargeDeinit;
+static volatile status_t s_dischargeStatus;
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+/*!
+ * @brief Starts the micro-tick timer in one-shot mode.
+ */
+static void puf_discharge_timer_start(uint32_t usec)
+{
+    POWER_DisablePD(kPDRUNCFG_PD_FRO1M);
+    SYSCON->CLOCK_CTRL |= SYSCON_CLOCK_CTRL_FRO1MHZ_ENA_MASK;
+    CLOCK_EnableClock(kCLOCK_Utick0);
+
+    /* stop, clear a pending interrupt, then count usec ticks */
+    UTICK0->CTRL = 0;
+    UTICK0->STAT = UTICK_STAT_INTR_MASK;
+    EnableIRQ(UTICK0_IRQn);
+    UTICK0->CTRL = UTICK_CTRL_DELAYVAL(usec - 1u);
+}
+
+/*!
+ * @brief Starts a discharge that ends with the PUF powered up or deinitialized.
+ */
+static status_t puf_discharge_start(
+    PUF_Type *base, uint32_t dischargeTimeMsec, bool deinit, puf_discharge_callback_t callback, void *userData)
+{
+    if ((NULL == base) || (dischargeTimeMsec == 0u) || (dischargeTimeMsec > PUF_DISCHARGE_MAX_TIME))
+    {
+        return kStatus_InvalidArgument;
+    }
+    if (NULL != s_dischargeBase)
+    {
+        return kStatus_Fail;
+    }
+
+    s_dischargeCallback = callback;
+    s_dischargeUserData = userData;
+    s_dischargeDeinit   = deinit;
+    s_dischargeStatus   = kStatus_Fail;
+    s_dischargeInitBase = NULL;
+    s_dischargeBase     = base;
+
+    PUF_DischargeStart(base);
+    puf_discharge_timer_start(dischargeTimeMsec * 1000u);
+
+    return kStatus_Success;
+}
+
+status_t PUF_DISCHARGE_Start(PUF_Type *base,
+                             uint32_t dischargeTimeMsec,
+                             puf_discharge_callback_t callback,
+                             void *userData)
+{
+    return puf_discharge_start(base, dischargeTimeMsec, false, callback, userData);
+}
+
+status_t PUF_DISCHARGE_Deinit(PUF_Type *base,
+                              uint32_t dischargeTimeMsec,
+                              puf_discharge_callback_t callback,
+                              void *userData)
+{
+    return puf_discharge_start(base, dischargeTimeMsec, true, callback, userData);
+}
+
+bool PUF_DISCHARGE_IsBusy(void)
+{
+    return (NULL != s_dischargeBase);
+}
+
+status_t PUF_DISCHARGE_Wait(void)
+{
+    PUF_Type *base;
+    uint32_t regPrimask;
+
+    /* the busy flag is checked with interrupts masked, so the timer interrupt cannot fire between check and WFI,
+     * a pending interrupt still wakes the core up */
+    while (PUF_DISCHARGE_IsBusy())
+    {
+        regPrimask = DisableGlobalIRQ();
+        if (PUF_DISCHARGE_IsBusy())
+        {
+            __WFI();
+        }
+        EnableGlobalIRQ(regPrimask);
+    }
+
+    base = s_dischargeInitBase;
+    if (NULL != base)
+    {
+        s_dischargeStatus   = PUF_DischargeWaitForInit(base);
+        s_dischargeInitBase = NULL;
+    }
+
+    return s_dischargeStatus;
+}
+
+status_t PUF_DISCHARGE_Cycle(PUF_Type *base, uint32_t dischargeTimeMsec)
+{
+    status_t status;
+
+    status = PUF_DISCHARGE_Start(base, dischargeTimeMsec, NULL, NULL);
+    if (kStatus_Success == status)
+    {
+        status = PUF_DISCHARGE_Wait();
+    }
+
+    return status;
+}
+
+/*!
+ * @brief Checks that all power cycles with one discharge time give a successful Start.
+ */
+static bool puf_discharge_stable(PUF_Type *base,
+                                 const uint8_t *activationCode,
+                                 size_t activationCodeSize,
+                                 uint32_t dischargeTimeMsec)
+{
+    uint32_t i;
+
+    for (i = 0; i < PUF_DISCHARGE_CALIBRATION_TRIALS; i++)
+    {
+        if ((PUF_DISCHARGE_Cycle(base, dischargeTimeMsec) != kStatus_Success) ||
+            (PUF_Start(base, activationCode, activationCodeSize) != kStatus_Success))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+status_t PUF_DISCHARGE_Calibrate(PUF_Type *base,
+                                 const uint8_t *activationCode,
+                                 size_t activationCodeSize,
+                                 uint32_t maxTimeMsec,
+                                 uint32_t *dischargeTimeMsec)
+{
+    uint32_t stable = maxTimeMsec;
+    uint32_t unstable = 0;
+    uint32_t candidate;
+
+    if ((NULL == activationCode) || (NULL == dischargeTimeMsec) || (maxTimeMsec == 0u) ||
+        (maxTimeMsec > PUF_DISCHARGE_MAX_TIME))
+    {
+        return kStatus_InvalidArgument;
+    }
+
+    if (!puf_discharge_stable(base, activationCode, activationCodeSize, maxTimeMsec))
+    {
+        return kStatus_Fail;
+    }
+
+    /* stable above a threshold and unstable below it is assumed, so bisect */
+    while ((stable - unstable) > 1u)
+    {
+        candidate = unstable + (stable - unstable) / 2u;
+        if (puf_discharge_stable(base, activationCode, activationCodeSize, candidate))
+        {
+            stable = candidate;
+        }
+        else
+        {
+            unstable = candidate;
+        }
+    }
+
+    *dischargeTimeMsec = MIN(stable * PUF_DISCHARGE_CALIBRATION_MARGIN, maxTimeMsec);
+
+    /* leave the PUF started as the last trial did, an unstable one may have left it failed */
+    if (!puf_discharge_stable(base, activationCode, activationCodeSize, *dischargeTimeMsec))
+    {
+        return kStatus_Fail;
+    }
+
+    return kStatus_Success;
+}
+
+void UTICK0_DriverIRQHandler(void)
+{
+    PUF_Type *base = s_dischargeBase;
+
+    UTICK0->STAT = UTICK_STAT_INTR_MASK;
+
+    if (NULL != base)
+    {
+        if (s_dischargeDeinit)
+        {
+            PUF_DischargeDeinit(base);
+            s_dischargeStatus = kStatus_Success;
+        }
+        else
+        {
+            /* the PUF takes long to initialize, PUF_DISCHARGE_Wait() waits for it in thread mode */
+            PUF_DischargePowerUp(base, PUF_DISCHARGE_CORE_CLK_FREQ);
+            s_dischargeInitBase = base;
+        }
+        s_dischargeBase = NULL;
+        if (NULL != s_dischargeCallback)
+        {
+            s_dischargeCallback(base, s_dischargeUserData);
+        }
+    }
+/* Add for ARM errata 838869, affects Cortex-M4, Cortex-M4F Store immediate overlapping
+  exception return operation might vector to incorrect interrupt */
+#if defined __CORTEX_M && (__CORTEX_M == 4U)
+    __DSB();
+#endif
+}
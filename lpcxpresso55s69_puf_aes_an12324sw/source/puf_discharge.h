@@ -0,0 +1,139 @@
+/*
+ * Copyright 2026 asvin.io
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _PUF_DISCHARGE_H_
+#define _PUF_DISCHARGE_H_
+
+#include "fsl_common.h"
+#include "fsl_puf.h"
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+
+/*! @brief Power cycles tried with each candidate discharge time during calibration, all have to succeed. */
+#ifndef PUF_DISCHARGE_CALIBRATION_TRIALS
+#define PUF_DISCHARGE_CALIBRATION_TRIALS 3u
+#endif
+
+/*! @brief Factor applied to the shortest discharge time found by calibration, margin for temperature and ageing. */
+#ifndef PUF_DISCHARGE_CALIBRATION_MARGIN
+#define PUF_DISCHARGE_CALIBRATION_MARGIN 2u
+#endif
+
+/*!
+ * @brief Discharge completion callback, invoked from the micro-tick timer isr once the discharge time has elapsed.
+ *
+ * After PUF_DISCHARGE_Start(), PUF SRAM is powered up again but the PUF is still initializing, PUF_DISCHARGE_Wait()
+ * shall be called from thread mode before it is used. After PUF_DISCHARGE_Deinit(), the PUF is deinitialized.
+ *
+ * @param base PUF peripheral base address.
+ * @param userData User data passed to PUF_DISCHARGE_Start().
+ */
+typedef void (*puf_discharge_callback_t)(PUF_Type *base, void *userData);
+
+/*******************************************************************************
+ * API
+ ******************************************************************************/
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/*!
+ * @brief Power cycles PUF SRAM, the discharge time being measured by the micro-tick timer.
+ *
+ * Calls PUF_DischargeStart() and returns. The micro-tick timer, clocked by the 1 MHz FRO, interrupts when the
+ * discharge time has elapsed, its isr only calls PUF_DischargePowerUp() and then the callback. The CPU can sleep or
+ * do other work in between. PUF_DISCHARGE_Wait() waits until the PUF has initialized, the PUF is then in the same
+ * state as after PUF_Init().
+ *
+ * @param base PUF peripheral base address.
+ * @param dischargeTimeMsec Discharge time in ms, 1 to 2000000.
+ * @param callback Callback invoked from the timer isr when PUF SRAM is powered up again. Can be NULL.
+ * @param userData User data passed to callback.
+ * @return kStatus_Success, kStatus_InvalidArgument, kStatus_Fail if a discharge is already running.
+ */
+status_t PUF_DISCHARGE_Start(PUF_Type *base,
+                             uint32_t dischargeTimeMsec,
+                             puf_discharge_callback_t callback,
+                             void *userData);
+
+/*!
+ * @brief Deinitializes the PUF, the discharge time being measured by the micro-tick timer.
+ *
+ * Non-blocking PUF_Deinit(): calls PUF_DischargeStart() and returns, the timer isr calls PUF_DischargeDeinit() and
+ * then the callback once the discharge time has elapsed. A later PUF_DISCHARGE_Start() or PUF_DISCHARGE_Cycle()
+ * powers the PUF up again, PUF_DISCHARGE_Wait() has to be called first if the discharge may still be running.
+ *
+ * @param base PUF peripheral base address.
+ * @param dischargeTimeMsec Discharge time in ms, 1 to 2000000.
+ * @param callback Callback invoked from the timer isr when the PUF is deinitialized. Can be NULL.
+ * @param userData User data passed to callback.
+ * @return kStatus_Success, kStatus_InvalidArgument, kStatus_Fail if a discharge is already running.
+ */
+status_t PUF_DISCHARGE_Deinit(PUF_Type *base,
+                              uint32_t dischargeTimeMsec,
+                              puf_discharge_callback_t callback,
+                              void *userData);
+
+/*!
+ * @brief Checks if a discharge started by PUF_DISCHARGE_Start() or PUF_DISCHARGE_Deinit() is running.
+ *
+ * @return true until the callback of the discharge is invoked.
+ */
+bool PUF_DISCHARGE_IsBusy(void);
+
+/*!
+ * @brief Sleeps until the running discharge completes, then waits until the PUF initializes.
+ *
+ * The wait for the PUF is done here rather than in the timer isr, PUF_DischargeWaitForInit() is called once per
+ * discharge. Returns at once if no discharge is running and the last one was already waited for.
+ *
+ * @return Status of PUF_DischargeWaitForInit() for the last discharge, kStatus_Success if it deinitialized the PUF,
+ * kStatus_Fail if none completed.
+ */
+status_t PUF_DISCHARGE_Wait(void);
+
+/*!
+ * @brief Power cycles PUF SRAM and sleeps until the discharge time has elapsed.
+ *
+ * PUF_DISCHARGE_Start() without callback, followed by PUF_DISCHARGE_Wait().
+ *
+ * @param base PUF peripheral base address.
+ * @param dischargeTimeMsec Discharge time in ms, 1 to 2000000.
+ * @return kStatus_Success, status of PUF_DISCHARGE_Start() or of PUF_DischargeWaitForInit().
+ */
+status_t PUF_DISCHARGE_Cycle(PUF_Type *base, uint32_t dischargeTimeMsec);
+
+/*!
+ * @brief Measures the shortest discharge time that still gives a stable Start on this part.
+ *
+ * Bisects between 1 ms and maxTimeMsec. A candidate time is stable when PUF_DISCHARGE_CALIBRATION_TRIALS power
+ * cycles with it all initialize the PUF and PUF_Start() succeeds with activationCode after each of them. The result
+ * is the shortest stable time multiplied by PUF_DISCHARGE_CALIBRATION_MARGIN, at most maxTimeMsec, and is meant
+ * to be stored and passed to PUF_Init(), PUF_Deinit() or PUF_DISCHARGE_Start() on later boots.
+ * The PUF is left started with activationCode.
+ *
+ * @param base PUF peripheral base address.
+ * @param activationCode Word aligned activation code of this part.
+ * @param activationCodeSize Size of activationCode in bytes.
+ * @param maxTimeMsec Longest discharge time to consider in ms, known to be stable.
+ * @param[out] dischargeTimeMsec Calibrated discharge time in ms.
+ * @return kStatus_Success, kStatus_InvalidArgument, kStatus_Fail if maxTimeMsec itself is not stable.
+ */
+status_t PUF_DISCHARGE_Calibrate(PUF_Type *base,
+                                 const uint8_t *activationCode,
+                                 size_t activationCodeSize,
+                                 uint32_t maxTimeMsec,
+                                 uint32_t *dischargeTimeMsec);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* _PUF_DISCHARGE_H_ */
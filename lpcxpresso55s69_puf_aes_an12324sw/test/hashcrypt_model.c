@@ -0,0 +1,448 @@
+/*
+ * Copyright 2026 asvin.io
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#define _GNU_SOURCE
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <sys/mman.h>
+#include <ucontext.h>
+#include "fsl_hashcrypt.h"
+#include "hashcrypt_model.h"
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+#if !defined(__x86_64__) || !defined(__linux__)
+#error "the register model single steps register accesses, it runs on x86-64 Linux only"
+#endif
+
+/*! Trap flag of EFLAGS */
+#define EFLAGS_TF 0x100u
+
+/*! Page fault error code bit of a write access */
+#define PF_ERR_WRITE 0x2u
+
+/*! Size of the page holding the registers */
+#define MODEL_PAGE_SIZE 4096u
+
+/*! Register of the model, only accessed while the page is readable */
+#define MODEL_REG(member) (*(volatile uint32_t *)(uintptr_t)&g_hashcryptModel->member)
+
+/*! Calls of HASHCRYPT_DriverIRQHandler() in one HASHCRYPT_MODEL_Service() before the interrupt is considered stuck */
+#define MODEL_MAX_ISR_CALLS 100000u
+
+/*! Reads of STATUS without progress before the driver is considered stuck in a polling loop */
+#define MODEL_MAX_IDLE_READS 1000000u
+
+/*! STATUS bits that raise the interrupt when enabled */
+#define MODEL_IRQ_MASK (HASHCRYPT_STATUS_DIGEST_AKA_OUTDATA_MASK | HASHCRYPT_STATUS_ERROR_MASK)
+
+/*! Largest key and iv in 32-bit words */
+#define MODEL_MAX_LOAD_WORDS (8u + 4u)
+
+/*******************************************************************************
+ * Prototypes
+ ******************************************************************************/
+void HASHCRYPT_DriverIRQHandler(void);
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+HASHCRYPT_Type *g_hashcryptModel;
+
+static hashcrypt_model_record_t s_record;
+
+static bool s_aes;
+static uint32_t s_cfg;
+static uint32_t s_keyWords;
+static uint32_t s_loadWords;
+static uint32_t s_loadPos;
+static uint32_t s_load[MODEL_MAX_LOAD_WORDS];
+static uint32_t s_inPos;
+static uint32_t s_in[HASHCRYPT_AES_BLOCK_SIZE / 4];
+static uint8_t s_chain[HASHCRYPT_AES_BLOCK_SIZE];
+static aes_soft_ctx_t s_cipher;
+static uint32_t s_runAddr;
+static uint32_t s_runLeft;
+static uint32_t s_status;
+static uint32_t s_idleReads;
+
+static uint32_t s_primask;
+static bool s_irqEnabled;
+static bool s_inIsr;
+
+static size_t s_faultOffset;
+static bool s_faultWrite;
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+static void model_protect(int prot)
+{
+    if (0 != mprotect(g_hashcryptModel, MODEL_PAGE_SIZE, prot))
+    {
+        abort();
+    }
+}
+
+static void model_setStatus(uint32_t status)
+{
+    s_idleReads = 0;
+    s_status = status;
+    MODEL_REG(STATUS) = status;
+}
+
+static void model_error(void)
+{
+    s_record.errors++;
+    s_runLeft = 0;
+    model_setStatus(HASHCRYPT_STATUS_ERROR_MASK);
+}
+
+/* runs one block through the configured AES mode and presents it on OUTDATA0 */
+static void model_block(const uint8_t *input)
+{
+    uint32_t mode = (s_cfg & HASHCRYPT_CRYPTCFG_AESMODE_MASK) >> HASHCRYPT_CRYPTCFG_AESMODE_SHIFT;
+    bool decrypt = (0u != (s_cfg & HASHCRYPT_CRYPTCFG_AESDECRYPT_MASK));
+    uint8_t in[HASHCRYPT_AES_BLOCK_SIZE];
+    uint8_t out[HASHCRYPT_AES_BLOCK_SIZE];
+    uint32_t i;
+    int j;
+
+    memcpy(in, input, sizeof(in));
+    switch (mode)
+    {
+        case kHASHCRYPT_AesEcb:
+            if (decrypt)
+            {
+                AES_SOFT_DecryptEcb(&s_cipher, in, out, sizeof(out));
+            }
+            else
+            {
+                AES_SOFT_EncryptEcb(&s_cipher, in, out, sizeof(out));
+            }
+            break;
+
+        case kHASHCRYPT_AesCbc:
+            if (decrypt)
+            {
+                AES_SOFT_DecryptEcb(&s_cipher, in, out, sizeof(out));
+                for (i = 0; i < sizeof(out); i++)
+                {
+                    out[i] ^= s_chain[i];
+                }
+                memcpy(s_chain, in, sizeof(s_chain));
+            }
+            else
+            {
+                for (i = 0; i < sizeof(in); i++)
+                {
+                    in[i] ^= s_chain[i];
+                }
+                AES_SOFT_EncryptEcb(&s_cipher, in, out, sizeof(out));
+                memcpy(s_chain, out, sizeof(s_chain));
+            }
+            break;
+
+        case kHASHCRYPT_AesCtr:
+            AES_SOFT_EncryptEcb(&s_cipher, s_chain, out, sizeof(out));
+            for (i = 0; i < sizeof(out); i++)
+            {
+                out[i] ^= in[i];
+            }
+            for (j = HASHCRYPT_AES_BLOCK_SIZE - 1; (j >= 0) && (0u == ++s_chain[j]); j--)
+            {
+            }
+            break;
+
+        default:
+            model_error();
+            return;
+    }
+
+    /* the driver swaps the bytes of each OUTDATA0 word back to memory order */
+    for (i = 0; i < 4u; i++)
+    {
+        MODEL_REG(OUTDATA0[i]) = ((uint32_t)out[4u * i] << 24) | ((uint32_t)out[4u * i + 1u] << 16) |
+                                 ((uint32_t)out[4u * i + 2u] << 8) | out[4u * i + 3u];
+    }
+    s_record.blocks++;
+    model_setStatus(HASHCRYPT_STATUS_DIGEST_AKA_OUTDATA_MASK);
+}
+
+/* next block of the AHB master run */
+static void model_runNext(void)
+{
+    if ((0u == s_runLeft) || (s_loadPos < s_loadWords))
+    {
+        if (0u != s_runLeft)
+        {
+            model_error();
+        }
+        return;
+    }
+
+    s_runLeft--;
+    model_block((const uint8_t *)(uintptr_t)s_runAddr);
+    s_runAddr += HASHCRYPT_AES_BLOCK_SIZE;
+}
+
+static void model_startOperation(uint32_t ctrl)
+{
+    uint32_t keySize = (s_cfg & HASHCRYPT_CRYPTCFG_AESKEYSZ_MASK) >> HASHCRYPT_CRYPTCFG_AESKEYSZ_SHIFT;
+    uint32_t mode;
+
+    s_runLeft = 0;
+    s_loadPos = 0;
+    s_inPos = 0;
+    s_aes = (kHASHCRYPT_Aes == (ctrl & HASHCRYPT_CTRL_MODE_MASK));
+    if (!s_aes)
+    {
+        /* NEW_HASH alone, before the mode is switched */
+        model_setStatus(0);
+        return;
+    }
+
+    s_record.configs++;
+    s_cfg = MODEL_REG(CRYPTCFG);
+    mode = (s_cfg & HASHCRYPT_CRYPTCFG_AESMODE_MASK) >> HASHCRYPT_CRYPTCFG_AESMODE_SHIFT;
+    s_keyWords = (0u != (s_cfg & HASHCRYPT_CRYPTCFG_AESSECRET_MASK)) ? 0u : (4u + 2u * keySize);
+    s_loadWords = s_keyWords + ((kHASHCRYPT_AesEcb == mode) ? 0u : 4u);
+    if ((keySize > kHASHCRYPT_Aes256) || (0u == s_keyWords))
+    {
+        /* the model has no key bus from the PUF */
+        model_error();
+        return;
+    }
+    model_setStatus(HASHCRYPT_STATUS_WAITING_MASK);
+}
+
+/* INDATA and ALIAS: key, then iv, then data blocks written by the CPU */
+static void model_dataIn(uint32_t word)
+{
+    if (!s_aes)
+    {
+        model_error();
+        return;
+    }
+
+    if (s_loadPos < s_loadWords)
+    {
+        s_load[s_loadPos++] = word;
+        if (s_loadPos == s_loadWords)
+        {
+            /* key and iv words hold the bytes in memory order */
+            AES_SOFT_SetKey(&s_cipher, (const uint8_t *)s_load, s_keyWords * 4u, kAES_SOFT_Table);
+            memcpy(s_chain, &s_load[s_keyWords], sizeof(s_chain));
+        }
+        return;
+    }
+
+    s_in[s_inPos++] = word;
+    if (s_inPos == (HASHCRYPT_AES_BLOCK_SIZE / 4u))
+    {
+        s_inPos = 0;
+        model_block((const uint8_t *)s_in);
+    }
+}
+
+static void model_memCtrl(uint32_t value)
+{
+    uint32_t count = (value & HASHCRYPT_MEMCTRL_COUNT_MASK) >> HASHCRYPT_MEMCTRL_COUNT_SHIFT;
+
+    s_record.master = (0u != (value & HASHCRYPT_MEMCTRL_MASTER_MASK));
+    s_runLeft = 0;
+    if (!s_record.master || (0u == count))
+    {
+        return;
+    }
+
+    s_record.runs++;
+    if (count > s_record.maxRunBlocks)
+    {
+        s_record.maxRunBlocks = count;
+    }
+    s_runAddr = MODEL_REG(MEMADDR);
+    s_runLeft = count;
+    if (0u == (s_status & HASHCRYPT_STATUS_DIGEST_AKA_OUTDATA_MASK))
+    {
+        model_runNext();
+    }
+}
+
+/* reaction of the model to an access that has just been executed */
+static void model_access(size_t offset, bool write)
+{
+    uint32_t value = *(volatile uint32_t *)(uintptr_t)((uint8_t *)g_hashcryptModel + offset);
+
+    if (write)
+    {
+        switch (offset)
+        {
+            case offsetof(HASHCRYPT_Type, CTRL):
+                if (0u != (value & HASHCRYPT_CTRL_NEW_HASH_MASK))
+                {
+                    model_startOperation(value);
+                }
+                break;
+            case offsetof(HASHCRYPT_Type, STATUS):
+                /* read only in AES mode */
+                MODEL_REG(STATUS) = s_status;
+                break;
+            case offsetof(HASHCRYPT_Type, INTENSET):
+                s_record.intEn |= value;
+                MODEL_REG(INTENSET) = s_record.intEn;
+                break;
+            case offsetof(HASHCRYPT_Type, INTENCLR):
+                s_record.intEn &= ~value;
+                MODEL_REG(INTENSET) = s_record.intEn;
+                break;
+            case offsetof(HASHCRYPT_Type, MEMCTRL):
+                model_memCtrl(value);
+                break;
+            default:
+                if ((offset >= offsetof(HASHCRYPT_Type, INDATA)) && (offset < offsetof(HASHCRYPT_Type, OUTDATA0)))
+                {
+                    model_dataIn(value);
+                }
+                break;
+        }
+    }
+    else if ((offsetof(HASHCRYPT_Type, STATUS) == offset) && (++s_idleReads > MODEL_MAX_IDLE_READS))
+    {
+        fprintf(stderr, "HASHCRYPT driver polls STATUS 0x%x, the operation does not progress\n", value);
+        abort();
+    }
+    else if ((offsetof(HASHCRYPT_Type, OUTDATA0[3]) == offset) &&
+             (0u != (s_status & HASHCRYPT_STATUS_DIGEST_AKA_OUTDATA_MASK)))
+    {
+        /* the output block is read out, the engine takes the next one */
+        model_setStatus(HASHCRYPT_STATUS_WAITING_MASK);
+        model_runNext();
+    }
+    else
+    {
+    }
+}
+
+/* an access to the register page: let the instruction run once with the page readable and writable */
+static void model_onFault(int sig, siginfo_t *info, void *context)
+{
+    ucontext_t *uc = (ucontext_t *)context;
+    uintptr_t addr = (uintptr_t)info->si_addr;
+
+    if ((addr < (uintptr_t)g_hashcryptModel) || (addr >= ((uintptr_t)g_hashcryptModel + sizeof(HASHCRYPT_Type))))
+    {
+        /* not a register access, crash as usual */
+        signal(SIGSEGV, SIG_DFL);
+        return;
+    }
+
+    s_faultOffset = (addr - (uintptr_t)g_hashcryptModel) & ~(size_t)3u;
+    s_faultWrite = (0u != (uc->uc_mcontext.gregs[REG_ERR] & PF_ERR_WRITE));
+    model_protect(PROT_READ | PROT_WRITE);
+    uc->uc_mcontext.gregs[REG_EFL] |= EFLAGS_TF;
+}
+
+/* the access has been executed: react to it and trap the next one */
+static void model_onStep(int sig, siginfo_t *info, void *context)
+{
+    ucontext_t *uc = (ucontext_t *)context;
+
+    uc->uc_mcontext.gregs[REG_EFL] &= ~(greg_t)EFLAGS_TF;
+    model_access(s_faultOffset, s_faultWrite);
+    model_protect(PROT_NONE);
+}
+
+void HASHCRYPT_MODEL_Init(void)
+{
+    struct sigaction action;
+
+    if (NULL == g_hashcryptModel)
+    {
+        g_hashcryptModel = mmap(NULL, MODEL_PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (MAP_FAILED == g_hashcryptModel)
+        {
+            abort();
+        }
+
+        memset(&action, 0, sizeof(action));
+        action.sa_flags = SA_SIGINFO;
+        action.sa_sigaction = model_onFault;
+        sigaction(SIGSEGV, &action, NULL);
+        action.sa_sigaction = model_onStep;
+        sigaction(SIGTRAP, &action, NULL);
+    }
+    else
+    {
+        model_protect(PROT_READ | PROT_WRITE);
+    }
+
+    memset(g_hashcryptModel, 0, MODEL_PAGE_SIZE);
+    memset(&s_record, 0, sizeof(s_record));
+    s_aes = false;
+    s_cfg = 0;
+    s_loadWords = 0;
+    s_loadPos = 0;
+    s_inPos = 0;
+    s_runLeft = 0;
+    s_status = 0;
+    s_idleReads = 0;
+    s_primask = 0;
+    s_irqEnabled = false;
+    s_inIsr = false;
+
+    model_protect(PROT_NONE);
+}
+
+hashcrypt_model_record_t *HASHCRYPT_MODEL_Record(void)
+{
+    return &s_record;
+}
+
+void HASHCRYPT_MODEL_Service(void)
+{
+    uint32_t calls = 0;
+
+    while ((0u == s_primask) && s_irqEnabled && !s_inIsr && (0u != (s_status & s_record.intEn & MODEL_IRQ_MASK)))
+    {
+        if (++calls > MODEL_MAX_ISR_CALLS)
+        {
+            fprintf(stderr, "HASHCRYPT interrupt stuck, STATUS 0x%x INTEN 0x%x\n", s_status, s_record.intEn);
+            abort();
+        }
+        s_inIsr = true;
+        s_record.isrCalls++;
+        HASHCRYPT_DriverIRQHandler();
+        s_inIsr = false;
+    }
+}
+
+uint32_t DisableGlobalIRQ(void)
+{
+    uint32_t primask = s_primask;
+
+    s_primask = 1u;
+
+    return primask;
+}
+
+void EnableGlobalIRQ(uint32_t primask)
+{
+    s_primask = primask;
+    HASHCRYPT_MODEL_Service();
+}
+
+status_t EnableIRQ(IRQn_Type interrupt)
+{
+    s_irqEnabled = true;
+    HASHCRYPT_MODEL_Service();
+
+    return kStatus_Success;
+}
@@ -0,0 +1,57 @@
+/*
+ * Copyright 2026 asvin.io
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _HASHCRYPT_MODEL_H_
+#define _HASHCRYPT_MODEL_H_
+
+#include "fsl_common.h"
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+
+/*! @brief Register model counters and records, for the checks of the tests. */
+typedef struct _hashcrypt_model_record
+{
+    uint32_t configs;      /*!< AES operations started by a CTRL write with NEW_HASH */
+    uint32_t runs;         /*!< AHB master runs started by a MEMCTRL write */
+    uint32_t maxRunBlocks; /*!< Largest COUNT of the AHB master runs */
+    uint32_t blocks;       /*!< Blocks processed */
+    uint32_t errors;       /*!< Data received before the key and iv, or in a mode the model does not know */
+    uint32_t isrCalls;     /*!< Calls of HASHCRYPT_DriverIRQHandler() */
+    uint32_t intEn;        /*!< Enabled interrupts, INTENSET and INTENCLR */
+    bool master;           /*!< AHB master mode enabled by the last MEMCTRL write */
+} hashcrypt_model_record_t;
+
+/*******************************************************************************
+ * API
+ ******************************************************************************/
+
+/*!
+ * @brief Maps the HASHCRYPT registers to a page that traps every access, and resets the model.
+ *
+ * Each load or store to g_hashcryptModel faults, the access is executed in single step and the model reacts to it
+ * as HASHCRYPT does in AES mode: a CTRL write with NEW_HASH starts an operation configured by CRYPTCFG, the key
+ * and the iv are taken from INDATA and ALIAS, and the data from INDATA and ALIAS or by AHB master runs started by
+ * MEMCTRL. Each output block sets the DIGEST status, reading the last word of it from OUTDATA0 processes the next
+ * block of the run. The cipher is the software AES of fsl_aes_soft.c.
+ *
+ * AHB master reads host memory at the 32-bit MEMADDR, so the test shall be linked without PIE.
+ */
+void HASHCRYPT_MODEL_Init(void);
+
+/*!
+ * @brief Gets the model records.
+ */
+hashcrypt_model_record_t *HASHCRYPT_MODEL_Record(void);
+
+/*!
+ * @brief Calls HASHCRYPT_DriverIRQHandler() while the HASHCRYPT interrupt is pending, enabled and not masked.
+ */
+void HASHCRYPT_MODEL_Service(void);
+
+#endif /* _HASHCRYPT_MODEL_H_ */
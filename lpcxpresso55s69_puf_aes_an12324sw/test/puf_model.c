@@ -0,0 +1,467 @@
+/*
+ * Copyright 2026 asvin.io
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#define _GNU_SOURCE
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <sys/mman.h>
+#include <ucontext.h>
+#include "fsl_puf.h"
+#include "puf_model.h"
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+#if !defined(__x86_64__) || !defined(__linux__)
+#error "the register model single steps register accesses, it runs on x86-64 Linux only"
+#endif
+
+/*! Trap flag of EFLAGS */
+#define EFLAGS_TF 0x100u
+
+/*! Page fault error code bit of a write access */
+#define PF_ERR_WRITE 0x2u
+
+/*! Size of the page holding the registers */
+#define MODEL_PAGE_SIZE 4096u
+
+/*! Largest key code handled by the model in 32-bit words */
+#define MODEL_MAX_CODE_WORDS (PUF_GET_KEY_CODE_SIZE_FOR_KEY_SIZE(PUF_MODEL_MAX_KEY_WORDS * 4u) / 4u)
+
+/*! Register of the model, only accessed while the page is readable */
+#define MODEL_REG(member) (*(volatile uint32_t *)(uintptr_t)&g_pufModel->member)
+
+/*! Calls of PUF_DriverIRQHandler() in one PUF_MODEL_Service() before the interrupt is considered stuck */
+#define MODEL_MAX_ISR_CALLS 100000u
+
+/*! Reads of STAT without progress of the command before the driver is considered stuck in a polling loop */
+#define MODEL_MAX_IDLE_READS 1000000u
+
+/*! Word exchange of the running command */
+typedef enum _model_phase
+{
+    kModel_Idle = 0,
+    kModel_KeyIn,
+    kModel_CodeIn,
+    kModel_CodeOut,
+    kModel_KeyOut,
+} model_phase_t;
+
+/*******************************************************************************
+ * Prototypes
+ ******************************************************************************/
+void PUF_DriverIRQHandler(void);
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+PUF_Type *g_pufModel;
+
+static puf_model_record_t s_record;
+
+static model_phase_t s_phase;
+static uint32_t s_index;
+static uint32_t s_keyWords;
+static uint32_t s_keyPos;
+static uint32_t s_key[PUF_MODEL_MAX_KEY_WORDS];
+static uint32_t s_codeWords;
+static uint32_t s_codePos;
+static uint32_t s_code[MODEL_MAX_CODE_WORDS];
+static uint32_t s_intStat;
+static uint32_t s_intEn;
+static uint32_t s_generated;
+static uint32_t s_idleReads;
+
+static uint32_t s_primask;
+static bool s_irqEnabled;
+static bool s_inIsr;
+
+static size_t s_faultOffset;
+static bool s_faultWrite;
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+static void model_protect(int prot)
+{
+    if (0 != mprotect(g_pufModel, MODEL_PAGE_SIZE, prot))
+    {
+        abort();
+    }
+}
+
+/* raises a word request, or the end of the command with no request */
+static void model_raise(uint32_t stat, uint32_t intStat)
+{
+    s_idleReads = 0;
+    MODEL_REG(STAT) = stat;
+    s_intStat |= intStat;
+    MODEL_REG(INTSTAT) = s_intStat;
+}
+
+static void model_done(bool success)
+{
+    s_phase = kModel_Idle;
+    model_raise(success ? PUF_STAT_SUCCESS_MASK : PUF_STAT_ERROR_MASK,
+                success ? PUF_INTSTAT_SUCCESS_MASK : PUF_INTSTAT_ERROR_MASK);
+}
+
+/* key code of the model: header, key XOR PUF_MODEL_KEY_MASK, zero padding */
+static void model_buildCode(void)
+{
+    uint32_t i;
+
+    memset(s_code, 0, sizeof(s_code));
+    s_codeWords = PUF_GET_KEY_CODE_SIZE_FOR_KEY_SIZE(s_keyWords * 4u) / 4u;
+    s_code[0] = ((s_keyWords / 2u) << 24) | (s_index << 8);
+    for (i = 0; i < s_keyWords; i++)
+    {
+        s_code[1u + i] = s_key[i] ^ PUF_MODEL_KEY_MASK;
+    }
+    s_codePos = 0;
+}
+
+/* raises the next request of the running command */
+static void model_next(void)
+{
+    uint32_t slot;
+
+    switch (s_phase)
+    {
+        case kModel_KeyIn:
+            if (s_keyPos < s_keyWords)
+            {
+                model_raise(PUF_STAT_BUSY_MASK | PUF_STAT_KEYINREQ_MASK, PUF_INTSTAT_KEYINREQ_MASK);
+                return;
+            }
+            model_buildCode();
+            s_phase = kModel_CodeOut;
+            model_next();
+            break;
+
+        case kModel_CodeIn:
+            if (s_codePos < s_codeWords)
+            {
+                model_raise(PUF_STAT_BUSY_MASK | PUF_STAT_CODEINREQ_MASK, PUF_INTSTAT_CODEINREQ_MASK);
+                return;
+            }
+            for (uint32_t i = 0; i < s_keyWords; i++)
+            {
+                s_key[i] = s_code[1u + i] ^ PUF_MODEL_KEY_MASK;
+            }
+            if (0u != s_index)
+            {
+                s_keyPos = 0;
+                s_phase = kModel_KeyOut;
+                model_next();
+                return;
+            }
+            /* key index 0 goes to the enabled key slot of the hardware bus */
+            for (slot = 0; slot < FSL_FEATURE_PUF_HAS_KEYSLOTS; slot++)
+            {
+                if (2u == ((MODEL_REG(KEYENABLE) >> (2u * slot)) & 3u))
+                {
+                    MODEL_REG(SHIFT_STATUS) = (s_keyWords - 1u) << (slot << 2);
+                }
+            }
+            model_done(true);
+            break;
+
+        case kModel_CodeOut:
+            if (s_codePos < s_codeWords)
+            {
+                MODEL_REG(CODEOUTPUT) = s_code[s_codePos];
+                model_raise(PUF_STAT_BUSY_MASK | PUF_STAT_CODEOUTAVAIL_MASK, PUF_INTSTAT_CODEOUTAVAIL_MASK);
+                return;
+            }
+            model_done(true);
+            break;
+
+        case kModel_KeyOut:
+            if (s_keyPos < s_keyWords)
+            {
+                MODEL_REG(KEYOUTINDEX) = s_index;
+                MODEL_REG(KEYOUTPUT) = s_key[s_keyPos];
+                model_raise(PUF_STAT_BUSY_MASK | PUF_STAT_KEYOUTAVAIL_MASK, PUF_INTSTAT_KEYOUTAVAIL_MASK);
+                return;
+            }
+            model_done(true);
+            break;
+
+        default:
+            break;
+    }
+}
+
+static void model_startCommand(uint32_t ctrl)
+{
+    uint32_t i;
+
+    s_record.commands++;
+    s_record.lastCommand = ctrl;
+
+    if (kModel_Idle != s_phase)
+    {
+        /* a command is running, the PUF ignores the new one */
+        return;
+    }
+
+    s_index = MODEL_REG(KEYINDEX) & 0xFu;
+    s_keyWords = MODEL_REG(KEYSIZE) * 2u;
+    s_keyPos = 0;
+    s_codePos = 0;
+    MODEL_REG(STAT) = PUF_STAT_BUSY_MASK;
+
+    switch (ctrl)
+    {
+        case PUF_CTRL_SETKEY_MASK:
+            if ((s_keyWords == 0u) || (s_keyWords > PUF_MODEL_MAX_KEY_WORDS))
+            {
+                model_done(false);
+                return;
+            }
+            s_record.keyInWords = 0;
+            s_phase = kModel_KeyIn;
+            break;
+
+        case PUF_CTRL_GENERATEKEY_MASK:
+            if ((s_keyWords == 0u) || (s_keyWords > PUF_MODEL_MAX_KEY_WORDS))
+            {
+                model_done(false);
+                return;
+            }
+            for (i = 0; i < s_keyWords; i++)
+            {
+                s_key[i] = 0x1000u * ++s_generated + i;
+            }
+            model_buildCode();
+            s_phase = kModel_CodeOut;
+            break;
+
+        case PUF_CTRL_GETKEY_MASK:
+            /* the size of the key code is known once its header is received */
+            s_codeWords = 1u;
+            s_phase = kModel_CodeIn;
+            break;
+
+        case PUF_CTRL_ZEROIZE_MASK:
+            MODEL_REG(ALLOW) = 0;
+            model_done(false);
+            return;
+
+        default:
+            model_done(false);
+            return;
+    }
+
+    model_next();
+}
+
+static void model_codeIn(uint32_t word)
+{
+    if ((kModel_CodeIn != s_phase) || (0u == (MODEL_REG(STAT) & PUF_STAT_CODEINREQ_MASK)))
+    {
+        s_record.duplicateWrites++;
+        return;
+    }
+
+    s_code[s_codePos++] = word;
+    if (1u == s_codePos)
+    {
+        s_index = (word >> 8) & 0xFu;
+        s_keyWords = (word >> 24) * 2u;
+        if ((s_keyWords == 0u) || (s_keyWords > PUF_MODEL_MAX_KEY_WORDS))
+        {
+            model_done(false);
+            return;
+        }
+        s_codeWords = PUF_GET_KEY_CODE_SIZE_FOR_KEY_SIZE(s_keyWords * 4u) / 4u;
+    }
+    model_next();
+}
+
+static void model_keyIn(uint32_t word)
+{
+    if ((kModel_KeyIn != s_phase) || (0u == (MODEL_REG(STAT) & PUF_STAT_KEYINREQ_MASK)))
+    {
+        s_record.duplicateWrites++;
+        return;
+    }
+
+    s_key[s_keyPos++] = word;
+    s_record.keyIn[s_record.keyInWords++] = word;
+    model_next();
+}
+
+/* reaction of the model to an access that has just been executed */
+static void model_access(size_t offset, bool write)
+{
+    uint32_t value = *(volatile uint32_t *)(uintptr_t)((uint8_t *)g_pufModel + offset);
+
+    if (write)
+    {
+        switch (offset)
+        {
+            case offsetof(PUF_Type, CTRL):
+                model_startCommand(value);
+                break;
+            case offsetof(PUF_Type, CODEINPUT):
+                model_codeIn(value);
+                break;
+            case offsetof(PUF_Type, KEYINPUT):
+                model_keyIn(value);
+                break;
+            case offsetof(PUF_Type, INTSTAT):
+                /* write one to clear */
+                s_intStat &= ~value;
+                MODEL_REG(INTSTAT) = s_intStat;
+                break;
+            case offsetof(PUF_Type, INTEN):
+                s_intEn = value;
+                break;
+            default:
+                break;
+        }
+    }
+    else if ((offsetof(PUF_Type, STAT) == offset) && (++s_idleReads > MODEL_MAX_IDLE_READS))
+    {
+        fprintf(stderr, "PUF driver polls STAT 0x%x, the command does not progress\n", value);
+        abort();
+    }
+    else if ((offsetof(PUF_Type, CODEOUTPUT) == offset) && (kModel_CodeOut == s_phase) &&
+             (0u != (MODEL_REG(STAT) & PUF_STAT_CODEOUTAVAIL_MASK)))
+    {
+        s_codePos++;
+        model_next();
+    }
+    else if ((offsetof(PUF_Type, KEYOUTPUT) == offset) && (kModel_KeyOut == s_phase) &&
+             (0u != (MODEL_REG(STAT) & PUF_STAT_KEYOUTAVAIL_MASK)))
+    {
+        s_keyPos++;
+        model_next();
+    }
+    else
+    {
+    }
+}
+
+/* an access to the register page: let the instruction run once with the page readable and writable */
+static void model_onFault(int sig, siginfo_t *info, void *context)
+{
+    ucontext_t *uc = (ucontext_t *)context;
+    uintptr_t addr = (uintptr_t)info->si_addr;
+
+    if ((addr < (uintptr_t)g_pufModel) || (addr >= ((uintptr_t)g_pufModel + sizeof(PUF_Type))))
+    {
+        /* not a register access, crash as usual */
+        signal(SIGSEGV, SIG_DFL);
+        return;
+    }
+
+    s_faultOffset = (addr - (uintptr_t)g_pufModel) & ~(size_t)3u;
+    s_faultWrite = (0u != (uc->uc_mcontext.gregs[REG_ERR] & PF_ERR_WRITE));
+    model_protect(PROT_READ | PROT_WRITE);
+    uc->uc_mcontext.gregs[REG_EFL] |= EFLAGS_TF;
+}
+
+/* the access has been executed: react to it and trap the next one */
+static void model_onStep(int sig, siginfo_t *info, void *context)
+{
+    ucontext_t *uc = (ucontext_t *)context;
+
+    uc->uc_mcontext.gregs[REG_EFL] &= ~(greg_t)EFLAGS_TF;
+    model_access(s_faultOffset, s_faultWrite);
+    model_protect(PROT_NONE);
+}
+
+void PUF_MODEL_Init(void)
+{
+    struct sigaction action;
+
+    if (NULL == g_pufModel)
+    {
+        g_pufModel = mmap(NULL, MODEL_PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (MAP_FAILED == g_pufModel)
+        {
+            abort();
+        }
+
+        memset(&action, 0, sizeof(action));
+        action.sa_flags = SA_SIGINFO;
+        action.sa_sigaction = model_onFault;
+        sigaction(SIGSEGV, &action, NULL);
+        action.sa_sigaction = model_onStep;
+        sigaction(SIGTRAP, &action, NULL);
+    }
+    else
+    {
+        model_protect(PROT_READ | PROT_WRITE);
+    }
+
+    memset(g_pufModel, 0, MODEL_PAGE_SIZE);
+    memset(&s_record, 0, sizeof(s_record));
+    s_phase = kModel_Idle;
+    s_intStat = 0;
+    s_intEn = 0;
+    s_idleReads = 0;
+    s_primask = 0;
+    s_irqEnabled = false;
+    s_inIsr = false;
+
+    /* started PUF: keys can be set and reconstructed */
+    MODEL_REG(ALLOW) = PUF_ALLOW_ALLOWSETKEY_MASK | PUF_ALLOW_ALLOWGETKEY_MASK;
+
+    model_protect(PROT_NONE);
+}
+
+puf_model_record_t *PUF_MODEL_Record(void)
+{
+    return &s_record;
+}
+
+void PUF_MODEL_Service(void)
+{
+    uint32_t calls = 0;
+
+    while ((0u == s_primask) && s_irqEnabled && !s_inIsr && (0u != (s_intStat & s_intEn)))
+    {
+        if (++calls > MODEL_MAX_ISR_CALLS)
+        {
+            fprintf(stderr, "PUF interrupt stuck, INTSTAT 0x%x INTEN 0x%x\n", s_intStat, s_intEn);
+            abort();
+        }
+        s_inIsr = true;
+        s_record.isrCalls++;
+        PUF_DriverIRQHandler();
+        s_inIsr = false;
+    }
+}
+
+uint32_t DisableGlobalIRQ(void)
+{
+    uint32_t primask = s_primask;
+
+    s_primask = 1u;
+
+    return primask;
+}
+
+void EnableGlobalIRQ(uint32_t primask)
+{
+    s_primask = primask;
+    PUF_MODEL_Service();
+}
+
+status_t EnableIRQ(IRQn_Type interrupt)
+{
+    s_irqEnabled = true;
+    PUF_MODEL_Service();
+
+    return kStatus_Success;
+}
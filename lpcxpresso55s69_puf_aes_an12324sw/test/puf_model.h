@@ -0,0 +1,57 @@
+/*
+ * Copyright 2026 asvin.io
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _PUF_MODEL_H_
+#define _PUF_MODEL_H_
+
+#include "fsl_common.h"
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+
+/*! @brief Mask XORed into the user key stored in a key code of the model. */
+#define PUF_MODEL_KEY_MASK 0x5a5a5a5au
+
+/*! @brief Largest key handled by the model in 32-bit words. */
+#define PUF_MODEL_MAX_KEY_WORDS 16u
+
+/*! @brief Register model counters and records, for the checks of the tests. */
+typedef struct _puf_model_record
+{
+    uint32_t commands;                       /*!< Commands started by a CTRL write */
+    uint32_t lastCommand;                    /*!< CTRL value of the last command */
+    uint32_t keyIn[PUF_MODEL_MAX_KEY_WORDS]; /*!< Words received on KEYINPUT by the last set user key */
+    uint32_t keyInWords;                     /*!< Number of words in keyIn */
+    uint32_t duplicateWrites;                /*!< Words written while no request was raised */
+    uint32_t isrCalls;                       /*!< Calls of PUF_DriverIRQHandler() */
+} puf_model_record_t;
+
+/*******************************************************************************
+ * API
+ ******************************************************************************/
+
+/*!
+ * @brief Maps the PUF registers to a page that traps every access, and resets the model.
+ *
+ * Each load or store to g_pufModel faults, the access is executed in single step and the model reacts to it as the
+ * PUF does: a CTRL write starts a command, writing CODEINPUT or KEYINPUT or reading CODEOUTPUT or KEYOUTPUT
+ * completes the pending word request and raises the next one. Every raised request sets its INTSTAT bit.
+ */
+void PUF_MODEL_Init(void);
+
+/*!
+ * @brief Gets the model records.
+ */
+puf_model_record_t *PUF_MODEL_Record(void);
+
+/*!
+ * @brief Calls PUF_DriverIRQHandler() while the PUF interrupt is pending, enabled and not masked.
+ */
+void PUF_MODEL_Service(void);
+
+#endif /* _PUF_MODEL_H_ */
@@ -0,0 +1,29 @@
+/*
+ * Copyright 2026 asvin.io
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _FSL_CLOCK_H_
+#define _FSL_CLOCK_H_
+
+/* Host build of the drivers: clock gates have no effect on the register model. */
+
+#include "fsl_common.h"
+
+typedef enum _clock_ip_name
+{
+    kCLOCK_Puf = 0,
+    kCLOCK_HashCrypt = 1,
+} clock_ip_name_t;
+
+static inline void CLOCK_EnableClock(clock_ip_name_t clk)
+{
+}
+
+static inline void CLOCK_DisableClock(clock_ip_name_t clk)
+{
+}
+
+#endif /* _FSL_CLOCK_H_ */
@@ -0,0 +1,212 @@
+/*
+ * Copyright 2026 asvin.io
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _FSL_COMMON_H_
+#define _FSL_COMMON_H_
+
+/* Host build of the drivers: the parts of fsl_common.h and the device header that fsl_puf.c and fsl_hashcrypt.c
+ * use. */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+
+#define MAKE_STATUS(group, code) ((((group)*100) + (code)))
+
+#ifndef MIN
+#define MIN(a, b) (((a) < (b)) ? (a) : (b))
+#endif
+
+enum _status_groups
+{
+    kStatusGroup_Generic = 0,
+    kStatusGroup_HASHCRYPT = 77,
+    kStatusGroup_PUF = 79,
+};
+
+enum _generic_status
+{
+    kStatus_Success = MAKE_STATUS(kStatusGroup_Generic, 0),
+    kStatus_Fail = MAKE_STATUS(kStatusGroup_Generic, 1),
+    kStatus_ReadOnly = MAKE_STATUS(kStatusGroup_Generic, 2),
+    kStatus_OutOfRange = MAKE_STATUS(kStatusGroup_Generic, 3),
+    kStatus_InvalidArgument = MAKE_STATUS(kStatusGroup_Generic, 4),
+    kStatus_Timeout = MAKE_STATUS(kStatusGroup_Generic, 5),
+};
+
+typedef int32_t status_t;
+
+typedef enum IRQn
+{
+    HASHCRYPT_IRQn = 54,
+    PUF_IRQn = 56,
+} IRQn_Type;
+
+#define __IO volatile
+#define __I volatile const
+#define __O volatile
+
+#define __REV(x) __builtin_bswap32(x)
+#define __DSB()
+#define __STATIC_INLINE static inline
+#define __STATIC_FORCEINLINE static inline __attribute__((always_inline))
+
+#define FSL_FEATURE_PUF_HAS_KEYSLOTS (4)
+#define FSL_FEATURE_PUF_HAS_SHIFT_STATUS (1)
+#define FSL_FEATURE_HASHCRYPT_ALIAS_OFFSET (0x00000000)
+
+/*! PUF register layout of LPC55S69 */
+typedef struct
+{
+    __IO uint32_t CTRL;
+    __IO uint32_t KEYINDEX;
+    __IO uint32_t KEYSIZE;
+    uint8_t RESERVED_0[20];
+    __I uint32_t STAT;
+    uint8_t RESERVED_1[4];
+    __I uint32_t ALLOW;
+    uint8_t RESERVED_2[20];
+    __O uint32_t KEYINPUT;
+    __O uint32_t CODEINPUT;
+    __I uint32_t CODEOUTPUT;
+    uint8_t RESERVED_3[20];
+    __I uint32_t KEYOUTINDEX;
+    __I uint32_t KEYOUTPUT;
+    uint8_t RESERVED_4[116];
+    __IO uint32_t IFSTAT;
+    uint8_t RESERVED_5[32];
+    __IO uint32_t INTEN;
+    __IO uint32_t INTSTAT;
+    __IO uint32_t PWRCTRL;
+    __IO uint32_t CFG;
+    uint8_t RESERVED_6[240];
+    __IO uint32_t KEYLOCK;
+    __IO uint32_t KEYENABLE;
+    __O uint32_t KEYRESET;
+    __IO uint32_t IDXBLK_L;
+    __IO uint32_t IDXBLK_H_DP;
+    __O uint32_t KEYMASK[4];
+    uint8_t RESERVED_7[48];
+    __IO uint32_t IDXBLK_H;
+    __IO uint32_t IDXBLK_L_DP;
+    __I uint32_t SHIFT_STATUS;
+} PUF_Type;
+
+#define PUF_CTRL_ZEROIZE_MASK (0x1U)
+#define PUF_CTRL_ENROLL_MASK (0x2U)
+#define PUF_CTRL_START_MASK (0x4U)
+#define PUF_CTRL_GENERATEKEY_MASK (0x8U)
+#define PUF_CTRL_SETKEY_MASK (0x10U)
+#define PUF_CTRL_GETKEY_MASK (0x40U)
+#define PUF_STAT_BUSY_MASK (0x1U)
+#define PUF_STAT_SUCCESS_MASK (0x2U)
+#define PUF_STAT_ERROR_MASK (0x4U)
+#define PUF_STAT_KEYINREQ_MASK (0x10U)
+#define PUF_STAT_KEYOUTAVAIL_MASK (0x20U)
+#define PUF_STAT_CODEINREQ_MASK (0x40U)
+#define PUF_STAT_CODEOUTAVAIL_MASK (0x80U)
+#define PUF_ALLOW_ALLOWENROLL_MASK (0x1U)
+#define PUF_ALLOW_ALLOWSTART_MASK (0x2U)
+#define PUF_ALLOW_ALLOWSETKEY_MASK (0x4U)
+#define PUF_ALLOW_ALLOWGETKEY_MASK (0x8U)
+#define PUF_INTEN_READYEN_MASK (0x1U)
+#define PUF_INTEN_SUCCESEN_MASK (0x2U)
+#define PUF_INTEN_ERROREN_MASK (0x4U)
+#define PUF_INTEN_KEYINREQEN_MASK (0x10U)
+#define PUF_INTEN_KEYOUTAVAILEN_MASK (0x20U)
+#define PUF_INTEN_CODEINREQEN_MASK (0x40U)
+#define PUF_INTEN_CODEOUTAVAILEN_MASK (0x80U)
+#define PUF_INTSTAT_SUCCESS_MASK (0x2U)
+#define PUF_INTSTAT_ERROR_MASK (0x4U)
+#define PUF_INTSTAT_KEYINREQ_MASK (0x10U)
+#define PUF_INTSTAT_KEYOUTAVAIL_MASK (0x20U)
+#define PUF_INTSTAT_CODEINREQ_MASK (0x40U)
+#define PUF_INTSTAT_CODEOUTAVAIL_MASK (0x80U)
+#define PUF_PWRCTRL_RAMON_MASK (0x1U)
+#define PUF_PWRCTRL_RAMSTAT_MASK (0x2U)
+#define PUF_CFG_BLOCKENROLL_SETKEY_MASK (0x1U)
+#define PUF_CFG_BLOCKKEYOUTPUT_MASK (0x2U)
+
+/*! PUF registers of the register model, see puf_model.c */
+extern PUF_Type *g_pufModel;
+#define PUF g_pufModel
+
+/*! HASHCRYPT register layout of LPC55S69 */
+typedef struct
+{
+    __IO uint32_t CTRL;
+    __IO uint32_t STATUS;
+    __IO uint32_t INTENSET;
+    __IO uint32_t INTENCLR;
+    __IO uint32_t MEMCTRL;
+    __IO uint32_t MEMADDR;
+    uint8_t RESERVED_0[8];
+    __O uint32_t INDATA;
+    __O uint32_t ALIAS[7];
+    __I uint32_t OUTDATA0[8];
+    __I uint32_t OUTDATA1[8];
+    __IO uint32_t CRYPTCFG;
+    __I uint32_t CONFIG;
+    uint8_t RESERVED_1[4];
+    __IO uint32_t LOCK;
+    __O uint32_t MASK[4];
+} HASHCRYPT_Type;
+
+#define HASHCRYPT_CTRL_MODE_MASK (0x7U)
+#define HASHCRYPT_CTRL_MODE(x) (((uint32_t)(x)) & HASHCRYPT_CTRL_MODE_MASK)
+#define HASHCRYPT_CTRL_NEW_HASH_MASK (0x10U)
+#define HASHCRYPT_CTRL_NEW_HASH(x) ((((uint32_t)(x)) << 4U) & HASHCRYPT_CTRL_NEW_HASH_MASK)
+#define HASHCRYPT_STATUS_WAITING_MASK (0x1U)
+#define HASHCRYPT_STATUS_DIGEST_AKA_OUTDATA_MASK (0x2U)
+#define HASHCRYPT_STATUS_ERROR_MASK (0x4U)
+#define HASHCRYPT_INTENCLR_DIGEST_MASK (0x2U)
+#define HASHCRYPT_INTENCLR_ERROR_MASK (0x4U)
+#define HASHCRYPT_MEMCTRL_MASTER_MASK (0x1U)
+#define HASHCRYPT_MEMCTRL_MASTER(x) (((uint32_t)(x)) & HASHCRYPT_MEMCTRL_MASTER_MASK)
+#define HASHCRYPT_MEMCTRL_COUNT_MASK (0x7FF0000U)
+#define HASHCRYPT_MEMCTRL_COUNT_SHIFT (16U)
+#define HASHCRYPT_MEMCTRL_COUNT(x) ((((uint32_t)(x)) << HASHCRYPT_MEMCTRL_COUNT_SHIFT) & HASHCRYPT_MEMCTRL_COUNT_MASK)
+/* the register model reads host memory, addresses shall fit in 32 bits, see the Makefile */
+#define HASHCRYPT_MEMADDR_BASE(x) ((uint32_t)(uintptr_t)(x))
+#define HASHCRYPT_CRYPTCFG_MSW1ST_OUT(x) (((uint32_t)(x)) & 0x1U)
+#define HASHCRYPT_CRYPTCFG_SWAPKEY(x) ((((uint32_t)(x)) << 1U) & 0x2U)
+#define HASHCRYPT_CRYPTCFG_SWAPDAT(x) ((((uint32_t)(x)) << 2U) & 0x4U)
+#define HASHCRYPT_CRYPTCFG_MSW1ST(x) ((((uint32_t)(x)) << 3U) & 0x8U)
+#define HASHCRYPT_CRYPTCFG_AESMODE_MASK (0x30U)
+#define HASHCRYPT_CRYPTCFG_AESMODE_SHIFT (4U)
+#define HASHCRYPT_CRYPTCFG_AESMODE(x) ((((uint32_t)(x)) << HASHCRYPT_CRYPTCFG_AESMODE_SHIFT) & 0x30U)
+#define HASHCRYPT_CRYPTCFG_AESDECRYPT_MASK (0x40U)
+#define HASHCRYPT_CRYPTCFG_AESDECRYPT(x) ((((uint32_t)(x)) << 6U) & HASHCRYPT_CRYPTCFG_AESDECRYPT_MASK)
+#define HASHCRYPT_CRYPTCFG_AESSECRET_MASK (0x80U)
+#define HASHCRYPT_CRYPTCFG_AESSECRET(x) ((((uint32_t)(x)) << 7U) & HASHCRYPT_CRYPTCFG_AESSECRET_MASK)
+#define HASHCRYPT_CRYPTCFG_AESKEYSZ_MASK (0x300U)
+#define HASHCRYPT_CRYPTCFG_AESKEYSZ_SHIFT (8U)
+#define HASHCRYPT_CRYPTCFG_AESKEYSZ(x) ((((uint32_t)(x)) << HASHCRYPT_CRYPTCFG_AESKEYSZ_SHIFT) & 0x300U)
+#define HASHCRYPT_CONFIG_SHA512_MASK (0x20U)
+
+/*! HASHCRYPT registers of the register model, see hashcrypt_model.c */
+extern HASHCRYPT_Type *g_hashcryptModel;
+#define HASHCRYPT g_hashcryptModel
+
+/*******************************************************************************
+ * API
+ ******************************************************************************/
+
+uint32_t DisableGlobalIRQ(void);
+void EnableGlobalIRQ(uint32_t primask);
+status_t EnableIRQ(IRQn_Type interrupt);
+
+/* as in fsl_common.h, the clock and reset APIs come with it */
+#include "fsl_clock.h"
+#include "fsl_reset.h"
+
+#endif /* _FSL_COMMON_H_ */
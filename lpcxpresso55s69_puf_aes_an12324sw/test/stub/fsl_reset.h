@@ -0,0 +1,29 @@
+/*
+ * Copyright 2026 asvin.io
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _FSL_RESET_H_
+#define _FSL_RESET_H_
+
+/* Host build of the drivers: peripheral resets have no effect on the register model. */
+
+#include "fsl_common.h"
+
+typedef enum _SYSCON_RSTn
+{
+    kHASHCRYPT_RST_SHIFT_RSTn = 131072 | 18U,
+    kPUF_RST_SHIFT_RSTn = 131072 | 23U,
+} SYSCON_RSTn_t;
+
+static inline void RESET_PeripheralReset(SYSCON_RSTn_t peripheral)
+{
+}
+
+static inline void RESET_SetPeripheralReset(SYSCON_RSTn_t peripheral)
+{
+}
+
+#endif /* _FSL_RESET_H_ */
@@ -0,0 +1,350 @@
+/*
+ * Copyright 2026 asvin.io
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <stdio.h>
+#include "fsl_hashcrypt.h"
+#include "hashcrypt_model.h"
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+#define CHECK(cond)                                                                                \
+    do                                                                                             \
+    {                                                                                              \
+        s_checks++;                                                                                \
+        if (!(cond))                                                                               \
+        {                                                                                          \
+            s_failures++;                                                                          \
+            printf("%s:%d: %s: check failed: %s\n", __FILE__, __LINE__, __func__, #cond);          \
+        }                                                                                          \
+    } while (0)
+
+/*! AHB master run limit of fsl_hashcrypt.c */
+#define AES_MASTER_MAX_BLOCKS 2048u
+
+/*! Message longer than one AHB master run, with an incomplete last block in CTR mode */
+#define LONG_BLOCKS (AES_MASTER_MAX_BLOCKS + 5u)
+#define LONG_TAIL 7u
+#define LONG_SIZE (LONG_BLOCKS * HASHCRYPT_AES_BLOCK_SIZE + LONG_TAIL)
+
+#define VECTOR_SIZE 64u
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+static uint32_t s_checks;
+static uint32_t s_failures;
+
+static uint32_t s_callbacks;
+static status_t s_status;
+
+/* AHB master reads them at 32-bit addresses, so they are static, the test is linked without PIE */
+static hashcrypt_handle_t s_handle;
+static hashcrypt_handle_t s_other;
+static uint32_t s_in[(LONG_SIZE + 3u) / 4u];
+static uint32_t s_out[(LONG_SIZE + 3u) / 4u];
+static uint32_t s_ref[(LONG_SIZE + 3u) / 4u];
+
+/* NIST SP 800-38A F.1, F.2 and F.5, AES-128 */
+static const uint8_t s_key[16] __attribute__((aligned(4))) = {0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6,
+                                                              0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c};
+static const uint8_t s_plain[VECTOR_SIZE] __attribute__((aligned(4))) = {
+    0x6b, 0xc1, 0xbe, 0xe2, 0x2e, 0x40, 0x9f, 0x96, 0xe9, 0x3d, 0x7e, 0x11, 0x73, 0x93, 0x17, 0x2a,
+    0xae, 0x2d, 0x8a, 0x57, 0x1e, 0x03, 0xac, 0x9c, 0x9e, 0xb7, 0x6f, 0xac, 0x45, 0xaf, 0x8e, 0x51,
+    0x30, 0xc8, 0x1c, 0x46, 0xa3, 0x5c, 0xe4, 0x11, 0xe5, 0xfb, 0xc1, 0x19, 0x1a, 0x0a, 0x52, 0xef,
+    0xf6, 0x9f, 0x24, 0x45, 0xdf, 0x4f, 0x9b, 0x17, 0xad, 0x2b, 0x41, 0x7b, 0xe6, 0x6c, 0x37, 0x10};
+static const uint8_t s_ecb[VECTOR_SIZE] __attribute__((aligned(4))) = {
+    0x3a, 0xd7, 0x7b, 0xb4, 0x0d, 0x7a, 0x36, 0x60, 0xa8, 0x9e, 0xca, 0xf3, 0x24, 0x66, 0xef, 0x97,
+    0xf5, 0xd3, 0xd5, 0x85, 0x03, 0xb9, 0x69, 0x9d, 0xe7, 0x85, 0x89, 0x5a, 0x96, 0xfd, 0xba, 0xaf,
+    0x43, 0xb1, 0xcd, 0x7f, 0x59, 0x8e, 0xce, 0x23, 0x88, 0x1b, 0x00, 0xe3, 0xed, 0x03, 0x06, 0x88,
+    0x7b, 0x0c, 0x78, 0x5e, 0x27, 0xe8, 0xad, 0x3f, 0x82, 0x23, 0x20, 0x71, 0x04, 0x72, 0x5d, 0xd4};
+static const uint8_t s_cbcIv[HASHCRYPT_AES_BLOCK_SIZE] = {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+                                                         0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f};
+static const uint8_t s_cbc[VECTOR_SIZE] __attribute__((aligned(4))) = {
+    0x76, 0x49, 0xab, 0xac, 0x81, 0x19, 0xb2, 0x46, 0xce, 0xe9, 0x8e, 0x9b, 0x12, 0xe9, 0x19, 0x7d,
+    0x50, 0x86, 0xcb, 0x9b, 0x50, 0x72, 0x19, 0xee, 0x95, 0xdb, 0x11, 0x3a, 0x91, 0x76, 0x78, 0xb2,
+    0x73, 0xbe, 0xd6, 0xb8, 0xe3, 0xc1, 0x74, 0x3b, 0x71, 0x16, 0xe6, 0x9e, 0x22, 0x22, 0x95, 0x16,
+    0x3f, 0xf1, 0xca, 0xa1, 0x68, 0x1f, 0xac, 0x09, 0x12, 0x0e, 0xca, 0x30, 0x75, 0x86, 0xe1, 0xa7};
+static const uint8_t s_ctrIv[HASHCRYPT_AES_BLOCK_SIZE] = {0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7,
+                                                         0xf8, 0xf9, 0xfa, 0xfb, 0xfc, 0xfd, 0xfe, 0xff};
+static const uint8_t s_ctr[VECTOR_SIZE] = {
+    0x87, 0x4d, 0x61, 0x91, 0xb6, 0x20, 0xe3, 0x26, 0x1b, 0xef, 0x68, 0x64, 0x99, 0x0d, 0xb6, 0xce,
+    0x98, 0x06, 0xf6, 0x6b, 0x79, 0x70, 0xfd, 0xff, 0x86, 0x17, 0x18, 0x7b, 0xb9, 0xff, 0xfd, 0xff,
+    0x5a, 0xe4, 0xdf, 0x3e, 0xdb, 0xd5, 0xd3, 0x5e, 0x5b, 0x4f, 0x09, 0x02, 0x0d, 0xb0, 0x3e, 0xab,
+    0x1e, 0x03, 0x1d, 0xda, 0x2f, 0xbe, 0x03, 0xd1, 0x79, 0x21, 0x70, 0xa0, 0xf3, 0x00, 0x9c, 0xee};
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+static void callback(HASHCRYPT_Type *base, hashcrypt_handle_t *handle, status_t status, void *userData)
+{
+    s_callbacks++;
+    s_status = status;
+}
+
+static void setUp(void)
+{
+    HASHCRYPT_MODEL_Init();
+    HASHCRYPT_Init(HASHCRYPT);
+    s_callbacks = 0;
+    s_status = kStatus_Fail;
+    memset(&s_handle, 0, sizeof(s_handle));
+    s_handle.keyType = kHASHCRYPT_UserKey;
+    HASHCRYPT_AES_SetKey(HASHCRYPT, &s_handle, s_key, sizeof(s_key));
+    HASHCRYPT_AES_SetCallback(HASHCRYPT, &s_handle, callback, NULL);
+}
+
+/* runs the isr until the operation completes, true if the callback reported success once */
+static bool complete(void)
+{
+    HASHCRYPT_MODEL_Service();
+
+    return (1u == s_callbacks) && (kStatus_Success == s_status) && !HASHCRYPT_MODEL_Record()->master &&
+           (0u == HASHCRYPT_MODEL_Record()->intEn);
+}
+
+static void ctrIncrement(uint8_t *counter)
+{
+    int i;
+
+    for (i = HASHCRYPT_AES_BLOCK_SIZE - 1; (i >= 0) && (0u == ++counter[i]); i--)
+    {
+    }
+}
+
+static void fill(uint8_t *buf, size_t size)
+{
+    for (size_t i = 0; i < size; i++)
+    {
+        buf[i] = (uint8_t)(i * 7u + (i >> 8));
+    }
+}
+
+/* ECB and CBC of the SP 800-38A vectors, one AHB master run of four blocks */
+static void testEcbCbcVectors(void)
+{
+    uint8_t *out = (uint8_t *)s_out;
+
+    setUp();
+    CHECK(kStatus_Success == HASHCRYPT_AES_EncryptEcbNonBlocking(HASHCRYPT, &s_handle, s_plain, out, VECTOR_SIZE));
+    CHECK(0u == s_callbacks);
+    CHECK(complete() && !memcmp(out, s_ecb, VECTOR_SIZE));
+    CHECK((1u == HASHCRYPT_MODEL_Record()->runs) && (4u == HASHCRYPT_MODEL_Record()->isrCalls));
+
+    setUp();
+    CHECK(kStatus_Success == HASHCRYPT_AES_DecryptEcbNonBlocking(HASHCRYPT, &s_handle, s_ecb, out, VECTOR_SIZE));
+    CHECK(complete() && !memcmp(out, s_plain, VECTOR_SIZE));
+
+    setUp();
+    CHECK(kStatus_Success ==
+          HASHCRYPT_AES_EncryptCbcNonBlocking(HASHCRYPT, &s_handle, s_plain, out, VECTOR_SIZE, s_cbcIv));
+    CHECK(complete() && !memcmp(out, s_cbc, VECTOR_SIZE));
+
+    setUp();
+    CHECK(kStatus_Success ==
+          HASHCRYPT_AES_DecryptCbcNonBlocking(HASHCRYPT, &s_handle, s_cbc, out, VECTOR_SIZE, s_cbcIv));
+    CHECK(complete() && !memcmp(out, s_plain, VECTOR_SIZE));
+
+    CHECK(0u == HASHCRYPT_MODEL_Record()->errors);
+}
+
+/* CTR of the SP 800-38A vectors, whole, with an incomplete last block, and shorter than one block */
+static void testCtrVectors(void)
+{
+    static const size_t sizes[] = {VECTOR_SIZE, VECTOR_SIZE - 5u, 7u};
+    uint8_t *out = (uint8_t *)s_out;
+    uint8_t counter[HASHCRYPT_AES_BLOCK_SIZE];
+    uint8_t expected[HASHCRYPT_AES_BLOCK_SIZE];
+    uint8_t counterlast[HASHCRYPT_AES_BLOCK_SIZE];
+    size_t szLeft;
+    size_t last;
+    uint32_t i, n;
+
+    for (n = 0; n < (sizeof(sizes) / sizeof(sizes[0])); n++)
+    {
+        setUp();
+        memcpy(counter, s_ctrIv, sizeof(counter));
+        memset(out, 0xee, VECTOR_SIZE + 1u);
+        szLeft = 99u;
+        CHECK(kStatus_Success == HASHCRYPT_AES_CryptCtrNonBlocking(HASHCRYPT, &s_handle, s_plain, out, sizes[n],
+                                                                   counter, counterlast, &szLeft));
+
+        /* the counter is advanced before the operation completes, by the blocks started */
+        memcpy(expected, s_ctrIv, sizeof(expected));
+        for (i = 0; i < ((sizes[n] + 15u) / 16u); i++)
+        {
+            ctrIncrement(expected);
+        }
+        CHECK(!memcmp(counter, expected, sizeof(counter)));
+
+        CHECK(complete() && !memcmp(out, s_ctr, sizes[n]));
+        CHECK(0xeeu == out[sizes[n]]);
+        last = sizes[n] % HASHCRYPT_AES_BLOCK_SIZE;
+        if (0u == last)
+        {
+            CHECK(0u == szLeft);
+            continue;
+        }
+
+        /* key stream of the last counter, for a chained call */
+        CHECK((HASHCRYPT_AES_BLOCK_SIZE - last) == szLeft);
+        for (i = 0; i < HASHCRYPT_AES_BLOCK_SIZE; i++)
+        {
+            expected[i] = s_ctr[sizes[n] - last + i] ^ s_plain[sizes[n] - last + i];
+        }
+        CHECK(!memcmp(counterlast, expected, HASHCRYPT_AES_BLOCK_SIZE));
+    }
+
+    CHECK(0u == HASHCRYPT_MODEL_Record()->errors);
+}
+
+/* a message longer than AES_MASTER_MAX_BLOCKS - 1 blocks is split in AHB master runs, chaining across them */
+static void testLongRuns(void)
+{
+    const uint8_t *in = (const uint8_t *)s_in;
+    uint8_t *out = (uint8_t *)s_out;
+    uint8_t *ref = (uint8_t *)s_ref;
+    const size_t size = LONG_BLOCKS * HASHCRYPT_AES_BLOCK_SIZE;
+    aes_soft_ctx_t soft;
+    uint8_t counter[HASHCRYPT_AES_BLOCK_SIZE];
+    uint8_t refCounter[HASHCRYPT_AES_BLOCK_SIZE];
+    uint8_t counterlast[HASHCRYPT_AES_BLOCK_SIZE];
+    uint8_t refCounterlast[HASHCRYPT_AES_BLOCK_SIZE];
+    size_t szLeft, refSzLeft;
+
+    fill((uint8_t *)s_in, LONG_SIZE);
+    AES_SOFT_SetKey(&soft, s_key, sizeof(s_key), kAES_SOFT_Table);
+
+    setUp();
+    AES_SOFT_EncryptEcb(&soft, in, ref, size);
+    CHECK(kStatus_Success == HASHCRYPT_AES_EncryptEcbNonBlocking(HASHCRYPT, &s_handle, in, out, size));
+    CHECK(complete() && !memcmp(out, ref, size));
+    CHECK(2u == HASHCRYPT_MODEL_Record()->runs);
+    CHECK((AES_MASTER_MAX_BLOCKS - 1u) == HASHCRYPT_MODEL_Record()->maxRunBlocks);
+    CHECK(LONG_BLOCKS == HASHCRYPT_MODEL_Record()->isrCalls);
+
+    setUp();
+    AES_SOFT_DecryptEcb(&soft, in, ref, size);
+    CHECK(kStatus_Success == HASHCRYPT_AES_DecryptEcbNonBlocking(HASHCRYPT, &s_handle, in, out, size));
+    CHECK(complete() && !memcmp(out, ref, size));
+
+    setUp();
+    AES_SOFT_EncryptCbc(&soft, in, ref, size, s_cbcIv);
+    CHECK(kStatus_Success == HASHCRYPT_AES_EncryptCbcNonBlocking(HASHCRYPT, &s_handle, in, out, size, s_cbcIv));
+    CHECK(complete() && !memcmp(out, ref, size));
+    CHECK(2u == HASHCRYPT_MODEL_Record()->runs);
+
+    setUp();
+    AES_SOFT_DecryptCbc(&soft, in, ref, size, s_cbcIv);
+    CHECK(kStatus_Success == HASHCRYPT_AES_DecryptCbcNonBlocking(HASHCRYPT, &s_handle, in, out, size, s_cbcIv));
+    CHECK(complete() && !memcmp(out, ref, size));
+
+    /* two runs of full blocks, then the counter of the incomplete last block */
+    setUp();
+    memcpy(refCounter, s_ctrIv, sizeof(refCounter));
+    AES_SOFT_CryptCtr(&soft, in, ref, LONG_SIZE, refCounter, refCounterlast, &refSzLeft);
+    memcpy(counter, s_ctrIv, sizeof(counter));
+    CHECK(kStatus_Success == HASHCRYPT_AES_CryptCtrNonBlocking(HASHCRYPT, &s_handle, in, out, LONG_SIZE, counter,
+                                                               counterlast, &szLeft));
+    CHECK(complete() && !memcmp(out, ref, LONG_SIZE));
+    CHECK(!memcmp(counter, refCounter, sizeof(counter)));
+    CHECK(!memcmp(counterlast, refCounterlast, sizeof(counterlast)) && (refSzLeft == szLeft));
+    CHECK(3u == HASHCRYPT_MODEL_Record()->runs);
+    CHECK((LONG_BLOCKS + 1u) == HASHCRYPT_MODEL_Record()->isrCalls);
+
+    CHECK(0u == HASHCRYPT_MODEL_Record()->errors);
+}
+
+/* blocking AES does not reconfigure HASHCRYPT under a non-blocking operation */
+static void testBusy(void)
+{
+    const uint8_t *in = (const uint8_t *)s_in;
+    uint8_t *out = (uint8_t *)s_out;
+    uint8_t *ref = (uint8_t *)s_ref;
+    const size_t size = LONG_BLOCKS * HASHCRYPT_AES_BLOCK_SIZE;
+    hashcrypt_aes_prepared_t prepared;
+    hashcrypt_aes_job_t job;
+    uint8_t block[HASHCRYPT_AES_BLOCK_SIZE];
+    aes_soft_ctx_t soft;
+
+    fill((uint8_t *)s_in, LONG_SIZE);
+    AES_SOFT_SetKey(&soft, s_key, sizeof(s_key), kAES_SOFT_Table);
+    AES_SOFT_EncryptCbc(&soft, in, ref, size, s_cbcIv);
+
+    setUp();
+    memset(&s_other, 0, sizeof(s_other));
+    s_other.keyType = kHASHCRYPT_UserKey;
+    HASHCRYPT_AES_SetKey(HASHCRYPT, &s_other, s_key, sizeof(s_key));
+    HASHCRYPT_AES_Prepare(HASHCRYPT, &prepared, &s_other, kHASHCRYPT_AesEcb, AES_ENCRYPT);
+    memset(&job, 0, sizeof(job));
+    job.mode = kHASHCRYPT_AesEcb;
+    job.direction = AES_ENCRYPT;
+    job.handle = &s_other;
+    job.input = s_plain;
+    job.output = block;
+    job.size = sizeof(block);
+
+    CHECK(kStatus_Success == HASHCRYPT_AES_EncryptCbcNonBlocking(HASHCRYPT, &s_handle, in, out, size, s_cbcIv));
+    CHECK(kStatus_HASHCRYPT_Again == HASHCRYPT_AES_EncryptEcb(HASHCRYPT, &s_other, s_plain, block, sizeof(block)));
+    CHECK(kStatus_HASHCRYPT_Again ==
+          HASHCRYPT_AES_CryptPrepared(HASHCRYPT, &prepared, s_plain, block, sizeof(block), NULL));
+    CHECK((kStatus_HASHCRYPT_Again == HASHCRYPT_AES_ProcessBatch(HASHCRYPT, &job, 1u)) &&
+          (kStatus_HASHCRYPT_Again == job.status));
+    CHECK(kStatus_HASHCRYPT_Again ==
+          HASHCRYPT_AES_EncryptEcbNonBlocking(HASHCRYPT, &s_other, s_plain, block, sizeof(block)));
+    CHECK(1u == HASHCRYPT_MODEL_Record()->configs);
+
+    /* the engine was left alone, the CBC chain is intact */
+    CHECK(complete() && !memcmp(out, ref, size));
+
+    /* free again */
+    CHECK(kStatus_Success == HASHCRYPT_AES_EncryptEcb(HASHCRYPT, &s_other, s_plain, block, sizeof(block)));
+    CHECK(!memcmp(block, s_ecb, sizeof(block)));
+    CHECK(0u == HASHCRYPT_MODEL_Record()->errors);
+}
+
+/* HASHCRYPT_Init() and HASHCRYPT_Deinit() stop the non-blocking operation and report it failed */
+static void testInitStops(void)
+{
+    uint8_t *out = (uint8_t *)s_out;
+
+    setUp();
+    CHECK(kStatus_Success == HASHCRYPT_AES_EncryptEcbNonBlocking(HASHCRYPT, &s_handle, s_plain, out, VECTOR_SIZE));
+    HASHCRYPT_Init(HASHCRYPT);
+    CHECK((1u == s_callbacks) && (kStatus_Fail == s_status));
+    CHECK(!HASHCRYPT_MODEL_Record()->master && (0u == HASHCRYPT_MODEL_Record()->intEn));
+    HASHCRYPT_MODEL_Service();
+    CHECK((0u == HASHCRYPT_MODEL_Record()->isrCalls) && (1u == s_callbacks));
+
+    /* HASHCRYPT can be used again */
+    s_callbacks = 0;
+    CHECK(kStatus_Success == HASHCRYPT_AES_EncryptEcbNonBlocking(HASHCRYPT, &s_handle, s_plain, out, VECTOR_SIZE));
+    CHECK(complete() && !memcmp(out, s_ecb, VECTOR_SIZE));
+
+    setUp();
+    CHECK(kStatus_Success == HASHCRYPT_AES_EncryptEcbNonBlocking(HASHCRYPT, &s_handle, s_plain, out, VECTOR_SIZE));
+    HASHCRYPT_Deinit(HASHCRYPT);
+    CHECK((1u == s_callbacks) && (kStatus_Fail == s_status));
+    HASHCRYPT_Init(HASHCRYPT);
+    CHECK(1u == s_callbacks);
+}
+
+int main(void)
+{
+    /* the model aborts on a stuck driver, keep the failures printed before */
+    setvbuf(stdout, NULL, _IONBF, 0);
+
+    testEcbCbcVectors();
+    testCtrVectors();
+    testLongRuns();
+    testBusy();
+    testInitStops();
+
+    printf("%u checks, %u failed\n", s_checks, s_failures);
+
+    return (0u == s_failures) ? 0 : 1;
+}
@@ -0,0 +1,240 @@
+/*
+ * Copyright 2026 asvin.io
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <stdio.h>
+#include "fsl_puf.h"
+#include "puf_model.h"
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+#define CHECK(cond)                                                                                \
+    do                                                                                             \
+    {                                                                                              \
+        s_checks++;                                                                                \
+        if (!(cond))                                                                               \
+        {                                                                                          \
+            s_failures++;                                                                          \
+            printf("%s:%d: %s: check failed: %s\n", __FILE__, __LINE__, __func__, #cond);          \
+        }                                                                                          \
+    } while (0)
+
+#define KEY_SIZE 16u
+#define KEY_CODE_SIZE PUF_GET_KEY_CODE_SIZE_FOR_KEY_SIZE(KEY_SIZE)
+#define KEY_WORDS (KEY_SIZE / 4u)
+#define KEY_CODE_WORDS (KEY_CODE_SIZE / 4u)
+
+/*! Completion of a non-blocking command, recorded by the callback */
+typedef struct _event
+{
+    puf_handle_t *handle;
+    status_t status;
+    bool busy;            /* PUF_IsBusy() from the callback */
+    uint32_t lastCommand; /* last command started by the driver when the callback runs */
+} event_t;
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+static uint32_t s_checks;
+static uint32_t s_failures;
+
+static event_t s_events[8];
+static uint32_t s_eventCount;
+
+static puf_handle_t s_handle[3];
+
+static const uint32_t s_userKey[KEY_WORDS] = {0x03020100u, 0x07060504u, 0x0b0a0908u, 0x0f0e0d0cu};
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+static void callback(PUF_Type *base, puf_handle_t *handle, status_t status, void *userData)
+{
+    if (s_eventCount < (sizeof(s_events) / sizeof(s_events[0])))
+    {
+        s_events[s_eventCount].handle = handle;
+        s_events[s_eventCount].status = status;
+        s_events[s_eventCount].busy = PUF_IsBusy(base);
+        s_events[s_eventCount].lastCommand = PUF_MODEL_Record()->lastCommand;
+    }
+    s_eventCount++;
+}
+
+static void setUp(void)
+{
+    uint32_t i;
+
+    PUF_MODEL_Init();
+    s_eventCount = 0;
+    for (i = 0; i < (sizeof(s_handle) / sizeof(s_handle[0])); i++)
+    {
+        PUF_SetCallback(PUF, &s_handle[i], callback, NULL);
+    }
+}
+
+/* set user key exchanges KEYINPUT and CODEOUTPUT words, get key CODEINPUT and KEYOUTPUT words, all from the isr */
+static void testUserKeyRoundTrip(void)
+{
+    uint32_t key[KEY_WORDS];
+    uint32_t keyCode[KEY_CODE_WORDS];
+    uint32_t out[KEY_WORDS];
+    uint32_t i;
+
+    setUp();
+    memcpy(key, s_userKey, sizeof(key));
+    memset(keyCode, 0xff, sizeof(keyCode));
+
+    CHECK(kStatus_Success == PUF_SetUserKeyNonBlocking(PUF, &s_handle[0], kPUF_KeyIndex_01, (const uint8_t *)key,
+                                                       KEY_SIZE, (uint8_t *)keyCode, KEY_CODE_SIZE));
+    CHECK(1u == s_eventCount);
+    CHECK((&s_handle[0] == s_events[0].handle) && (kStatus_Success == s_events[0].status));
+    CHECK(!s_events[0].busy);
+    CHECK(!memcmp(PUF_MODEL_Record()->keyIn, s_userKey, KEY_SIZE));
+    CHECK(!memcmp(key, s_userKey, KEY_SIZE));
+    CHECK(keyCode[0] == ((KEY_SIZE / 8u) << 24 | (kPUF_KeyIndex_01 << 8)));
+    for (i = 0; i < KEY_WORDS; i++)
+    {
+        CHECK(keyCode[1u + i] == (s_userKey[i] ^ PUF_MODEL_KEY_MASK));
+    }
+
+    memset(out, 0, sizeof(out));
+    CHECK(kStatus_Success ==
+          PUF_GetKeyNonBlocking(PUF, &s_handle[0], (const uint8_t *)keyCode, KEY_CODE_SIZE, (uint8_t *)out, KEY_SIZE));
+    CHECK(2u == s_eventCount);
+    CHECK(kStatus_Success == s_events[1].status);
+    CHECK(!memcmp(out, s_userKey, KEY_SIZE));
+    CHECK(kPUF_KeyIndex_01 == s_handle[0].keyIndex);
+
+    /* the blocking function polls the same exchange */
+    memset(out, 0, sizeof(out));
+    CHECK(kStatus_Success == PUF_GetKey(PUF, (const uint8_t *)keyCode, KEY_CODE_SIZE, (uint8_t *)out, KEY_SIZE));
+    CHECK(!memcmp(out, s_userKey, KEY_SIZE));
+
+    CHECK(0u == PUF_MODEL_Record()->duplicateWrites);
+}
+
+/* a command queued while another runs is started by the isr before the callback of the running one */
+static void testQueuedCommand(void)
+{
+    uint32_t keyCode[KEY_CODE_WORDS];
+    uint32_t intrinsicCode[KEY_CODE_WORDS];
+    uint32_t out[KEY_WORDS];
+    uint32_t other[KEY_WORDS];
+    puf_get_key_job_t job;
+    uint32_t regPrimask;
+    uint32_t i;
+
+    setUp();
+    CHECK(kStatus_Success == PUF_SetUserKey(PUF, kPUF_KeyIndex_02, (const uint8_t *)s_userKey, KEY_SIZE,
+                                            (uint8_t *)keyCode, KEY_CODE_SIZE));
+
+    /* the isr cannot run before both commands are submitted */
+    regPrimask = DisableGlobalIRQ();
+    CHECK(kStatus_Success == PUF_SetIntrinsicKeyNonBlocking(PUF, &s_handle[0], kPUF_KeyIndex_03, KEY_SIZE,
+                                                            (uint8_t *)intrinsicCode, KEY_CODE_SIZE));
+    CHECK(PUF_IsBusy(PUF));
+    CHECK(kStatus_Success ==
+          PUF_GetKeyNonBlocking(PUF, &s_handle[1], (const uint8_t *)keyCode, KEY_CODE_SIZE, (uint8_t *)out, KEY_SIZE));
+    CHECK(kStatus_PUF_Again == PUF_GetKeyNonBlocking(PUF, &s_handle[2], (const uint8_t *)keyCode, KEY_CODE_SIZE,
+                                                     (uint8_t *)other, KEY_SIZE));
+
+    /* blocking functions would write CTRL in the middle of the running command */
+    CHECK(kStatus_PUF_Again ==
+          PUF_GetKey(PUF, (const uint8_t *)keyCode, KEY_CODE_SIZE, (uint8_t *)other, KEY_SIZE));
+    job.keyCode = (const uint8_t *)keyCode;
+    job.keyCodeSize = KEY_CODE_SIZE;
+    job.key = (uint8_t *)other;
+    job.keySize = KEY_SIZE;
+    CHECK(kStatus_PUF_Again == PUF_GetKeys(PUF, &job, 1));
+    CHECK(kStatus_PUF_Again == job.status);
+    CHECK(kStatus_PUF_Again == PUF_SetUserKey(PUF, kPUF_KeyIndex_02, (const uint8_t *)s_userKey, KEY_SIZE,
+                                              (uint8_t *)other, KEY_CODE_SIZE));
+    /* the blocking set user key and the running command, the queued one is not started */
+    CHECK(2u == PUF_MODEL_Record()->commands);
+    CHECK(0u == s_eventCount);
+    EnableGlobalIRQ(regPrimask);
+
+    CHECK(2u == s_eventCount);
+    CHECK((&s_handle[0] == s_events[0].handle) && (kStatus_Success == s_events[0].status));
+    CHECK(s_events[0].busy && (PUF_CTRL_GETKEY_MASK == s_events[0].lastCommand));
+    CHECK((&s_handle[1] == s_events[1].handle) && (kStatus_Success == s_events[1].status));
+    CHECK(!s_events[1].busy);
+    CHECK(!memcmp(out, s_userKey, KEY_SIZE));
+    CHECK(!PUF_IsBusy(PUF));
+
+    /* the generated key code reconstructs the generated key */
+    CHECK(kStatus_Success ==
+          PUF_GetKey(PUF, (const uint8_t *)intrinsicCode, KEY_CODE_SIZE, (uint8_t *)other, KEY_SIZE));
+    for (i = 0; i < KEY_WORDS; i++)
+    {
+        CHECK(other[i] == (intrinsicCode[1u + i] ^ PUF_MODEL_KEY_MASK));
+    }
+
+    CHECK(0u == PUF_MODEL_Record()->duplicateWrites);
+}
+
+/* the key of index 0 is sent reversed with swapped bytes, as by PUF_SetUserKey() */
+static void testUserKeyIndex0(void)
+{
+    uint32_t key[KEY_WORDS];
+    uint32_t swapped[KEY_WORDS];
+    uint32_t keyCode[KEY_CODE_WORDS];
+    uint32_t out[KEY_WORDS];
+    uint32_t regPrimask;
+    uint32_t i;
+
+    for (i = 0; i < KEY_WORDS; i++)
+    {
+        swapped[i] = __builtin_bswap32(s_userKey[KEY_WORDS - 1u - i]);
+    }
+
+    /* the isr runs as soon as the command is started, the key must already be swapped */
+    setUp();
+    memcpy(key, s_userKey, sizeof(key));
+    CHECK(kStatus_Success == PUF_SetUserKeyNonBlocking(PUF, &s_handle[0], kPUF_KeyIndex_00, (const uint8_t *)key,
+                                                       KEY_SIZE, (uint8_t *)keyCode, KEY_CODE_SIZE));
+    CHECK((1u == s_eventCount) && (kStatus_Success == s_events[0].status));
+    CHECK(KEY_WORDS == PUF_MODEL_Record()->keyInWords);
+    CHECK(!memcmp(PUF_MODEL_Record()->keyIn, swapped, KEY_SIZE));
+
+    /* same words as the blocking function */
+    memcpy(key, s_userKey, sizeof(key));
+    CHECK(kStatus_Success ==
+          PUF_SetUserKey(PUF, kPUF_KeyIndex_00, (const uint8_t *)key, KEY_SIZE, (uint8_t *)keyCode, KEY_CODE_SIZE));
+    CHECK(!memcmp(PUF_MODEL_Record()->keyIn, swapped, KEY_SIZE));
+
+    /* not queued, the key is given back as it was */
+    setUp();
+    memcpy(key, s_userKey, sizeof(key));
+    CHECK(kStatus_Success == PUF_SetUserKey(PUF, kPUF_KeyIndex_01, (const uint8_t *)s_userKey, KEY_SIZE,
+                                            (uint8_t *)keyCode, KEY_CODE_SIZE));
+    regPrimask = DisableGlobalIRQ();
+    CHECK(kStatus_Success ==
+          PUF_GetKeyNonBlocking(PUF, &s_handle[0], (const uint8_t *)keyCode, KEY_CODE_SIZE, (uint8_t *)out, KEY_SIZE));
+    CHECK(kStatus_Success ==
+          PUF_GetKeyNonBlocking(PUF, &s_handle[1], (const uint8_t *)keyCode, KEY_CODE_SIZE, (uint8_t *)out, KEY_SIZE));
+    CHECK(kStatus_PUF_Again == PUF_SetUserKeyNonBlocking(PUF, &s_handle[2], kPUF_KeyIndex_00, (const uint8_t *)key,
+                                                         KEY_SIZE, (uint8_t *)keyCode, KEY_CODE_SIZE));
+    CHECK(!memcmp(key, s_userKey, KEY_SIZE));
+    EnableGlobalIRQ(regPrimask);
+    CHECK(2u == s_eventCount);
+}
+
+int main(void)
+{
+    /* the model aborts on a stuck driver, keep the failures printed before */
+    setvbuf(stdout, NULL, _IONBF, 0);
+
+    testUserKeyRoundTrip();
+    testQueuedCommand();
+    testUserKeyIndex0();
+
+    printf("%u checks, %u failed\n", s_checks, s_failures);
+
+    return (0u == s_failures) ? 0 : 1;
+}